@@ -19,11 +19,27 @@
 
 /* MCAL includes. */
 #include "uart0.h"
+#include "dma.h"
 #include "gpio.h"
 #include "EEPROM.h"
 #include "adc.h"
+#include "dwt.h"
 #include "tm4c123gh6pm_registers.h"
 
+/* Application includes. */
+#include "seat.h"
+
+/* Measurements includes. */
+#include "trace.h"
+#include "runtime_stats.h"
+#include "deadline.h"
+#include "stack_stats.h"
+#include "heap_stats.h"
+#include "isr_stats.h"
+#include "bench.h"
+#include "recorder.h"
+#include "energy.h"
+
 ///////////////////////////        USED DEFINATIONS       ///////////////////////////
 
 #define mainOFF_TEMP            0
@@ -31,12 +47,6 @@
 #define mainMED_TEMP            30
 #define mainHIGH_TEMP           40
 
-#define mainERROR_NO_INTENSITY         'n'
-#define mainNO_INTENSITY               'N'
-#define mainLOW_INTENSITY              'L'
-#define mainMED_INTENSITY              'M'
-#define mainHIGH_INTENSITY             'H'
-
 /* Definitions for the event bits in the event group. */
 #define mainSW1_PRESSED_BIT                 ( 1UL << 0UL )  /* SW1 event bit 0, which is set by button SW1 task. */
 #define mainSW2_PRESSED_BIT                 ( 1UL << 1UL )  /* SW2 event bit 1, which is set by button SW2 task. */
@@ -45,24 +55,41 @@
 #define mainERROR_OVER_PASSENGER_BIT        ( 1UL << 4UL )  /* Event bit 4 set when Passenger seat is over 40 Degrees */
 #define mainERROR_UNDER_PASSENGER_BIT       ( 1UL << 5UL )  /* Event bit 5 set when Passenger seat is under 5 Degrees */
 
-///////////////////////////        QUEUES CREATED       ///////////////////////////
-
-QueueHandle_t xDriverIntensityQueue;
-QueueHandle_t xPassengerIntensityQueue;
-
-QueueHandle_t xDriverDiagnosticsQueue;
-QueueHandle_t xPassengerDiagnosticsQueue;
+/* Commands accepted by the measurements console over UART0. */
+#define mainCMD_TRACE_DUMP                  't'             /* Drain the trace ring as a binary frame */
+#define mainCMD_RUNTIME_STATS               's'             /* Print the per task CPU load over 1 s, 10 s and 60 s */
+#define mainCMD_LOCK_STATS                  'l'             /* Print the wait and hold time histograms of the locks */
+#define mainCMD_QUEUE_STATS                 'q'             /* Print the peak depth of the data queues */
+#define mainCMD_LATENCY_STATS               'e'             /* Print the end-to-end latency histograms of the driver seat */
+#define mainCMD_DEADLINE_STATS              'd'             /* Print the deadline overruns of the periodic tasks */
+#define mainCMD_STACK_STATS                 'k'             /* Print the stack size and high water mark of every task */
+#define mainCMD_HEAP_STATS                  'h'             /* Print the heap use and the startup allocation log */
+#define mainCMD_ISR_STATS                   'i'             /* Print the execution time histograms of the interrupt handlers */
+#define mainCMD_MCAL_BENCH                  'b'             /* Run the MCAL micro-benchmarks and print the cycles per call */
+#define mainCMD_TRACE_COUNTS                'c'             /* Print the number of trace events of every type */
+#define mainCMD_RECORD                      'r'             /* Start or stop streaming the sensor and button inputs */
+#define mainCMD_ENERGY                      'w'             /* Print the heater and MCU energy since reset */
+
+#define mainRECORD_DRAIN_LOOPS              10              /* Console loops between two recorder frames, 1 s */
+
+/* A constant string as a segment of a UART0 uDMA list */
+#define mainTEXT_SEGMENT(pcText)            { (const uint8 *)(pcText), sizeof(pcText) - 1 }
+
+/* The UART0 divisors are worked out from its own copy of the clock, the MCAL not seeing the kernel configuration */
+#if UART0_SYSTEM_CLOCK_HZ != configCPU_CLOCK_HZ
+#error "UART0_SYSTEM_CLOCK_HZ must be configCPU_CLOCK_HZ"
+#endif
+
+/* traceEVENT_GROUP_SET_BITS (FreeRTOSConfig.h) reads the event bits as the first word of StaticEventGroup_t */
+#if TRACE_ENABLED(TRACE_CATEGORY_COUNTERS) && \
+    ((tskKERNEL_VERSION_MAJOR != 10) || (tskKERNEL_VERSION_MINOR != 5) || (tskKERNEL_VERSION_BUILD != 1))
+#error "Check the layout of EventGroup_t against StaticEventGroup_t in this kernel, then update this check"
+#endif
 
 /////////////////////////// SEMAPHORES AND MUTEX CREATED ///////////////////////////
 
-xSemaphoreHandle xDriverMutex;
-xSemaphoreHandle xPassengerMutex;
-
-xSemaphoreHandle xDriverTempSemphr;
-xSemaphoreHandle xPassengerTempSemphr;
-
-xSemaphoreHandle xDriverErrorSemaphore;
-xSemaphoreHandle xPassengerErrorSemaphore;
+/* Mutex to Keep The Display Report Out of The Console Output on UART0 */
+xSemaphoreHandle xUart0Mutex;
 
 ///////////////////////////     EVENT GROUPS CREATED    ////////////////////////////
 
@@ -72,24 +99,21 @@ EventGroupHandle_t xEventGroup;
 
 xTaskHandle Button_Handle_Task;
 
-xTaskHandle Driver_Intensity_Task;
-xTaskHandle Passenger_Intensity_Task;
-
-xTaskHandle Driver_Heater_Task;
-xTaskHandle Passenger_Heater_Task;
-
-xTaskHandle Driver_Temp_Task;
-xTaskHandle Passenger_Temp_Task;
-
 xTaskHandle Display_Task;
 
-xTaskHandle Driver_Error_Task;
-xTaskHandle Passenger_Error_Task;
-
 xTaskHandle Diagnostic_Task;
 
+xTaskHandle Measurements_Console_Task;
+
 xTaskHandle xTask0Handle;
 
+/* Task waiting for the end of its UART0 uDMA list, notified by UART0_Handler */
+static TaskHandle_t xUart0DmaWaiter = NULL;
+
+/* Task sleeping in UART0_Write for room in the ring, notified on its own index */
+static TaskHandle_t xUart0TxWaiter = NULL;
+#define mainUART0_TX_NOTIFY_INDEX   1
+
 /////////////////////////     NEEDED STRUCT TYPEDEFS    ///////////////////////////
 
 typedef struct
@@ -98,31 +122,8 @@ typedef struct
     uint32 TimeStamp;
 } DiagnosticsTaskInformation; /* Struct to Carry Information of Diagnostic Task */
 
-typedef struct
-{
-    void (*adcUsedFun)(void);
-} TempInitConvTaskInformation; /* Struct to Carry Information of Init Conversion Task */
-
-typedef struct
-{
-    xSemaphoreHandle* usedErrorSmphr;
-    xTaskHandle *usedTask;
-    xQueueHandle *usedQueue;
-    void (*LedOnFun)(void);
-    void (*LedOffFun)(void);
-    EventBits_t UnderBit;
-    EventBits_t OverBit;
-    uint16* seatTemp;
-} ErrorHandleTaskInformation; /* Struct to Carry Information of Error Handle Task */
-
 /////////////////////////     NEEDED GLOBAL VARIABLES    ///////////////////////////
 
-uint8 gdSeatTemp;
-uint8 gpSeatTemp;
-
-uint16 gDriverTemp;
-uint16 gPassengerTemp;
-
 char* gOverDriver =         "Driver Over 40";
 char* gUnderDriver =        "Driver Below 5";
 char* gOverPassenger =      "Passenger Over 40";
@@ -131,35 +132,32 @@ char* gUnderPassenger =     "Passenger Below 5";
 DiagnosticsTaskInformation gSystemDriverLastState;
 DiagnosticsTaskInformation gSystemPassengerLastState;
 
-TempInitConvTaskInformation TempInitConvDriverTask = { ADC0_StartConv };
-TempInitConvTaskInformation TempInitConvPassengerTask = { ADC1_StartConv };
-
-ErrorHandleTaskInformation ErrorHandleDriverTask = { &xDriverErrorSemaphore,
-                                                     &Driver_Intensity_Task,
-                                                     &xDriverIntensityQueue,
-                                                     GPIO_RedLedOn,
-                                                     GPIO_RedLedOff,
-                                                     mainERROR_UNDER_DRIVER_BIT,
-                                                     mainERROR_OVER_DRIVER_BIT,
-                                                     &gDriverTemp
-                                                    };
-ErrorHandleTaskInformation ErrorHandlePassengerTask =  { &xPassengerErrorSemaphore,
-                                                         &Passenger_Intensity_Task,
-                                                         &xPassengerIntensityQueue,
-                                                         GPIO_ExRedLedOn,
-                                                         GPIO_ExRedLedOff,
-                                                         mainERROR_UNDER_PASSENGER_BIT,
-                                                         mainERROR_OVER_PASSENGER_BIT,
-                                                         &gPassengerTemp
-                                                        };
-
-uint32 ullTasksOutTime[13];
-uint32 ullTasksInTime[13];
-uint32 ullTasksExecutionTime[13];
-
-uint32 ullSmphrGiveTime[6];
-uint32 ullSmphrTakeTime[6];
-uint32 ullSmphrAquireTime[6];
+const SeatHardware xDriverHardware = { ADC0_StartConv,
+                                       GPIO_BlueLedOn, GPIO_BlueLedOff,
+                                       GPIO_GreenLedOn, GPIO_GreenLedOff,
+                                       GPIO_RedLedOn, GPIO_RedLedOff
+                                     };
+const SeatHardware xPassengerHardware = { ADC1_StartConv,
+                                          GPIO_ExBlueLedOn, GPIO_ExBlueLedOff,
+                                          GPIO_ExGreenLedOn, GPIO_ExGreenLedOff,
+                                          GPIO_ExRedLedOn, GPIO_ExRedLedOff
+                                        };
+
+/* The objects and temperatures of each seat, created in main() */
+SeatChannel xDriverSeat = { &xDriverHardware,
+                            NULL_PTR,
+                            mainERROR_UNDER_DRIVER_BIT,
+                            mainERROR_OVER_DRIVER_BIT,
+                            ENERGY_SEAT_DRIVER,
+                            TRUE
+                          };
+SeatChannel xPassengerSeat = { &xPassengerHardware,
+                               NULL_PTR,
+                               mainERROR_UNDER_PASSENGER_BIT,
+                               mainERROR_OVER_PASSENGER_BIT,
+                               ENERGY_SEAT_PASSENGER,
+                               FALSE
+                             };
 
 ///////////////////////////     FUNCTIONS USED PROTOTYPES    ////////////////////////////
 
@@ -168,25 +166,19 @@ uint32 ullSmphrAquireTime[6];
  */
 static void prvSetupHardware(void);
 
-void vButtonHandleTask(void *pvParameters);
-
-void vDriverHeaterControlTask(void *pvParameters);
-void vPassengerHeaterControlTask(void *pvParameters);
-
-void vDriverIntensityControlTask(void *pvParameters);
-void vPassengerIntensityControlTask(void *pvParameters);
+static boolean prvUart0TxWait(uint32 ulTimeoutMs);
 
-void vTempReadTask(void *pvParameters);
-
-void vTempinitConv(void *pvParameters);
+void vButtonHandleTask(void *pvParameters);
 
 void vDisplayUserTask(void *pvParameters);
 
-void vErrorHandleTask(void *pvParameters);
-
 void vDiagnosticsTask(void *pvParameters);
 
+#if configGENERATE_RUN_TIME_STATS
 void vRunTimeMeasurementsTask(void *pvParameters);
+#endif
+
+void vMeasurementsConsoleTask(void *pvParameters);
 
 
 int main()
@@ -195,34 +187,39 @@ int main()
     ///////////////////////////     EVENT GROUPS     ///////////////////////////
 
     xEventGroup = xEventGroupCreate();
+    xDriverSeat.ErrorEvents = xEventGroup;
+    xPassengerSeat.ErrorEvents = xEventGroup;
 
     /////////////////////////// SEMAPHORES AND MUTEX ///////////////////////////
 
     /* Mutex to Protect Shared Resource of The Required Seat Temperature */
-    xDriverMutex = xSemaphoreCreateMutex();                 vQueueSetQueueNumber(xDriverMutex,0);
-    xPassengerMutex = xSemaphoreCreateMutex();              vQueueSetQueueNumber(xPassengerMutex,1);
+    xDriverSeat.Mutex = xSemaphoreCreateMutex();            vQueueSetQueueNumber(xDriverSeat.Mutex,0);
+    xPassengerSeat.Mutex = xSemaphoreCreateMutex();         vQueueSetQueueNumber(xPassengerSeat.Mutex,1);
 
     /* Semaphore to Protect Shared Resource of The Current Seat Temperature */
-    xDriverTempSemphr = xSemaphoreCreateBinary();           vQueueSetQueueNumber(xDriverTempSemphr,2);
-    xPassengerTempSemphr = xSemaphoreCreateBinary();        vQueueSetQueueNumber(xPassengerTempSemphr,3);
+    xDriverSeat.TempSemphr = xSemaphoreCreateBinary();      vQueueSetQueueNumber(xDriverSeat.TempSemphr,2);
+    xPassengerSeat.TempSemphr = xSemaphoreCreateBinary();   vQueueSetQueueNumber(xPassengerSeat.TempSemphr,3);
 
     /* Give The Semaphore Initially */
-    xSemaphoreGive(xPassengerTempSemphr);
-    xSemaphoreGive(xDriverTempSemphr);
+    xSemaphoreGive(xPassengerSeat.TempSemphr);
+    xSemaphoreGive(xDriverSeat.TempSemphr);
 
     /* Semaphore to Create Synchornization of Error Task in Case Temperature is Out of Range */
-    xDriverErrorSemaphore = xSemaphoreCreateBinary();       vQueueSetQueueNumber(xDriverErrorSemaphore,4);
-    xPassengerErrorSemaphore = xSemaphoreCreateBinary();    vQueueSetQueueNumber(xPassengerErrorSemaphore,5);
+    xDriverSeat.ErrorSemaphore = xSemaphoreCreateBinary();  vQueueSetQueueNumber(xDriverSeat.ErrorSemaphore,4);
+    xPassengerSeat.ErrorSemaphore = xSemaphoreCreateBinary(); vQueueSetQueueNumber(xPassengerSeat.ErrorSemaphore,5);
+
+    /* Numbered after the queues so the lock and queue statistics leave it out */
+    xUart0Mutex = xSemaphoreCreateMutex();                  vQueueSetQueueNumber(xUart0Mutex,10);
 
     ///////////////////////////        QUEUES       ///////////////////////////
 
     /* Create a queue capable of containing 3 uint8 values to exchange Intensity Information. */
-    xDriverIntensityQueue = xQueueCreate(3, sizeof(uint8));
-    xPassengerIntensityQueue = xQueueCreate(3, sizeof(uint8));
+    xDriverSeat.IntensityQueue = xQueueCreate(3, sizeof(uint8));         vQueueSetQueueNumber(xDriverSeat.IntensityQueue,6);
+    xPassengerSeat.IntensityQueue = xQueueCreate(3, sizeof(uint8));      vQueueSetQueueNumber(xPassengerSeat.IntensityQueue,7);
 
     /* Create a queue capable of containing 10 Diagnostic values to save the Diagnostic Information. */
-    xDriverDiagnosticsQueue = xQueueCreate(10,sizeof(DiagnosticsTaskInformation));
-    xPassengerDiagnosticsQueue = xQueueCreate(10,sizeof(DiagnosticsTaskInformation));
+    xDriverSeat.DiagnosticsQueue = xQueueCreate(10,sizeof(DiagnosticsTaskInformation));  vQueueSetQueueNumber(xDriverSeat.DiagnosticsQueue,8);
+    xPassengerSeat.DiagnosticsQueue = xQueueCreate(10,sizeof(DiagnosticsTaskInformation)); vQueueSetQueueNumber(xPassengerSeat.DiagnosticsQueue,9);
 
     ///////////////////////////        TASKS       ///////////////////////////
 
@@ -230,50 +227,34 @@ int main()
     xTaskCreate(vButtonHandleTask, "Button Task", 64, NULL, 5, &Button_Handle_Task);
 
     /* Control The Intensity of The Heater Task. */
-    xTaskCreate(vDriverIntensityControlTask, "Driver Intensity Control Task", 128, NULL, 1, &Driver_Intensity_Task);
-    xTaskCreate(vPassengerIntensityControlTask, "Passenger Intensity Control Task", 128, NULL, 1, &Passenger_Intensity_Task);
+    xTaskCreate(vSeatIntensityTask, "Driver Intensity Control Task", 128, (void*)&xDriverSeat, 1, &xDriverSeat.IntensityTask);
+    xTaskCreate(vSeatIntensityTask, "Passenger Intensity Control Task", 128, (void*)&xPassengerSeat, 1, &xPassengerSeat.IntensityTask);
 
     /* Control The Output to The Heater Task. */
-    xTaskCreate(vDriverHeaterControlTask, "Driver Heater Task", 64, NULL, 2, &Driver_Heater_Task);
-    xTaskCreate(vPassengerHeaterControlTask, "Passenger Heater Task", 64, NULL, 2, &Passenger_Heater_Task);
+    xTaskCreate(vSeatHeaterTask, "Driver Heater Task", 64, (void*)&xDriverSeat, 2, &xDriverSeat.HeaterTask);
+    xTaskCreate(vSeatHeaterTask, "Passenger Heater Task", 64, (void*)&xPassengerSeat, 2, &xPassengerSeat.HeaterTask);
 
     /* Initiate The ADC Conversion to Read The Temperature Task. */
-    xTaskCreate(vTempinitConv, "Driver Temp Read Task", 64, (void*)&TempInitConvDriverTask, 3, &Driver_Temp_Task);
-    xTaskCreate(vTempinitConv, "Passenger Temp Read Task", 64, (void*)&TempInitConvPassengerTask, 3, &Passenger_Temp_Task);
+    xTaskCreate(vSeatTempTask, "Driver Temp Read Task", 64, (void*)&xDriverSeat, 3, &xDriverSeat.TempTask);
+    xTaskCreate(vSeatTempTask, "Passenger Temp Read Task", 64, (void*)&xPassengerSeat, 3, &xPassengerSeat.TempTask);
 
     /* Display The Needed Information to The User Task. */
     xTaskCreate(vDisplayUserTask, "Display User Task", 128, NULL, 2, &Display_Task);
 
     /* Handle The Errors Task. */
-    xTaskCreate(vErrorHandleTask, "Driver Handle Error Task", 64, (void*)&ErrorHandleDriverTask, 5, &Driver_Error_Task);
-    xTaskCreate(vErrorHandleTask, "Passenger Handle Error Task", 64, (void*)&ErrorHandlePassengerTask, 5, &Passenger_Error_Task);
+    xTaskCreate(vSeatErrorTask, "Driver Handle Error Task", 64, (void*)&xDriverSeat, 5, &xDriverSeat.ErrorTask);
+    xTaskCreate(vSeatErrorTask, "Passenger Handle Error Task", 64, (void*)&xPassengerSeat, 5, &xPassengerSeat.ErrorTask);
 
     /*Save The Diagnostics Information Task. */
     xTaskCreate(vDiagnosticsTask, "Diagnostic Task", 128, NULL, 4, &Diagnostic_Task);
 
-//    xTaskCreate(vRunTimeMeasurementsTask, "Run time", 64, NULL, 1, &xTask0Handle);
-
-    ///////////////////////////        TAGS       ///////////////////////////
-
-    vTaskSetApplicationTaskTag( Button_Handle_Task, ( TaskHookFunction_t ) 1 );
-
-    vTaskSetApplicationTaskTag( Driver_Intensity_Task, ( TaskHookFunction_t ) 2 );
-    vTaskSetApplicationTaskTag( Passenger_Intensity_Task, ( TaskHookFunction_t ) 3 );
-
-    vTaskSetApplicationTaskTag( Driver_Heater_Task, ( TaskHookFunction_t ) 4 );
-    vTaskSetApplicationTaskTag( Passenger_Heater_Task, ( TaskHookFunction_t ) 5 );
-
-    vTaskSetApplicationTaskTag( Driver_Temp_Task, ( TaskHookFunction_t ) 6 );
-    vTaskSetApplicationTaskTag( Passenger_Temp_Task, ( TaskHookFunction_t ) 7 );
-
-    vTaskSetApplicationTaskTag( Display_Task, ( TaskHookFunction_t ) 8 );
-
-    vTaskSetApplicationTaskTag( Driver_Error_Task, ( TaskHookFunction_t ) 9 );
-    vTaskSetApplicationTaskTag( Passenger_Error_Task, ( TaskHookFunction_t ) 10 );
-
-    vTaskSetApplicationTaskTag( xTask0Handle, ( TaskHookFunction_t ) 11 );
+#if configGENERATE_RUN_TIME_STATS
+    /* Sample The Run Time Counters Of All Tasks Every Second Task. */
+    xTaskCreate(vRunTimeMeasurementsTask, "Run time", 96, NULL, 1, &xTask0Handle);
+#endif
 
-    vTaskSetApplicationTaskTag( Diagnostic_Task, ( TaskHookFunction_t ) 12 );
+    /* Answer The Measurements Requests Received Over UART0 Task. */
+    xTaskCreate(vMeasurementsConsoleTask, "Console Task", 96, NULL, 1, &Measurements_Console_Task);
 
     /* Start the scheduler so the created tasks start executing. */
     vTaskStartScheduler();
@@ -286,7 +267,10 @@ int main()
 static void prvSetupHardware(void)
 {
     /* Place here any needed HW initialization such as GPIO, UART, etc.  */
+    DMA_Init();
     UART0_Init();
+    UART0_InitDma();
+    UART0_SetTxWait(prvUart0TxWait);
     GPIO_BuiltinButtonsLedsInit();
     GPIO_ExternalButtonsLedsInit();
     GPIO_SW1EdgeTriggeredInterruptInit();
@@ -296,76 +280,85 @@ static void prvSetupHardware(void)
     ADC_PD0D1Init();
     GPTM_WTimer0Init();
     EEPROM_Init();
+    DWT_CycleCounterInit();
+#if TRACE_RING_ENABLED
+    TRACE_Init();
+#endif
+#if TRACE_ENABLED(TRACE_CATEGORY_QUEUES)
+    LOCK_Init();
+    QSTATS_Init();
+#endif
+#if TRACE_ENABLED(TRACE_CATEGORY_PROBES)
+    LAT_Init();
+#endif
+    DEADLINE_Init();
+#if ISR_STATS_ENABLED
+    ISR_Init();
+#endif
 }
 
-void ADC0_Handler(void)
+/* Runs once in the timer task when the scheduler starts, every task exists by
+ * then. Task numbers run from 1, so the statistics need one slot more than
+ * there are tasks */
+void vApplicationDaemonTaskStartupHook(void)
 {
-    BaseType_t xHigherPriorityTaskWoken1 = pdFALSE;
-    BaseType_t xHigherPriorityTaskWoken2 = pdFALSE;
-    BaseType_t xHigherPriorityTaskWoken3 = pdFALSE;
+    configASSERT(uxTaskGetNumberOfTasks() < configMEASURED_TASKS);
+}
 
-    xSemaphoreTakeFromISR(xDriverTempSemphr,&xHigherPriorityTaskWoken1);
+void ADC0_Handler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken;
+    uint16 usSample;
 
-    gDriverTemp = ADC_PD0Read()*45/4095;
+    traceISR_ENTER(TRACE_ISR_ADC0_SS0);
 
-    xSemaphoreGiveFromISR(xDriverTempSemphr,&xHigherPriorityTaskWoken2);
+    usSample = ADC_PD0Read();
+    traceRECORD_INPUT(REC_EVENT_ADC, REC_ADC_DRIVER, usSample);
+    xHigherPriorityTaskWoken = SEAT_ConversionDone(&xDriverSeat, usSample);
 
-    if(gDriverTemp<5 || gDriverTemp>40)
-    {
-        xSemaphoreGiveFromISR(xDriverErrorSemaphore,&xHigherPriorityTaskWoken3);
-    }
     ADC0_ADCISC_REG = 0x1;
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken1 | xHigherPriorityTaskWoken2 | xHigherPriorityTaskWoken3 );
+    traceISR_EXIT(TRACE_ISR_ADC0_SS0);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
 void ADC1_Handler(void)
 {
-    BaseType_t xHigherPriorityTaskWoken1 = pdFALSE;
-    BaseType_t xHigherPriorityTaskWoken2 = pdFALSE;
-    BaseType_t xHigherPriorityTaskWoken3 = pdFALSE;
-
-    xSemaphoreTakeFromISR(xPassengerTempSemphr,&xHigherPriorityTaskWoken1);
+    BaseType_t xHigherPriorityTaskWoken;
+    uint16 usSample;
 
-    gPassengerTemp = ADC_PD1Read()*45/4095;
+    traceISR_ENTER(TRACE_ISR_ADC1_SS0);
 
-    xSemaphoreGiveFromISR(xPassengerTempSemphr,&xHigherPriorityTaskWoken2);
+    usSample = ADC_PD1Read();
+    traceRECORD_INPUT(REC_EVENT_ADC, REC_ADC_PASSENGER, usSample);
+    xHigherPriorityTaskWoken = SEAT_ConversionDone(&xPassengerSeat, usSample);
 
-    if(gPassengerTemp<5 || gPassengerTemp>40)
-    {
-        xSemaphoreGiveFromISR(xPassengerErrorSemaphore,&xHigherPriorityTaskWoken3);
-    }
     ADC1_ADCISC_REG = 0x1;
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken1 | xHigherPriorityTaskWoken2 | xHigherPriorityTaskWoken3 );
-}
-
-void vTempinitConv(void *pvParameters)
-{
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-
-    TempInitConvTaskInformation * pTaskInformation = (TempInitConvTaskInformation *) pvParameters;
-
-    for(;;)
-    {
-        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 500 ) );
-        pTaskInformation->adcUsedFun();
-    }
+    traceISR_EXIT(TRACE_ISR_ADC1_SS0);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
 void GPIOPortF_Handler(void)
 {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
+    traceISR_ENTER(TRACE_ISR_GPIO_PORTF);
+
     if(GPIO_PORTF_RIS_REG & (1<<0))           /* PF0 handler code */
     {
+        traceRECORD_INPUT(REC_EVENT_BUTTON, REC_PIN(REC_PIN_PORTF, 0), 0);
         xEventGroupSetBitsFromISR(xEventGroup, mainSW1_PRESSED_BIT,&xHigherPriorityTaskWoken);
+        traceLATENCY_START(LAT_CHAIN_DRIVER_BUTTON);
         GPIO_PORTF_ICR_REG   |= (1<<0);       /* Clear Trigger flag for PF0 (Interrupt Flag) */
     }
     else if(GPIO_PORTF_RIS_REG & (1<<4))      /* PF4 handler code */
     {
+        traceRECORD_INPUT(REC_EVENT_BUTTON, REC_PIN(REC_PIN_PORTF, 4), 0);
         xEventGroupSetBitsFromISR(xEventGroup, mainSW1_PRESSED_BIT,&xHigherPriorityTaskWoken);
+        traceLATENCY_START(LAT_CHAIN_DRIVER_BUTTON);
         GPIO_PORTF_ICR_REG   |= (1<<4);       /* Clear Trigger flag for PF4 (Interrupt Flag) */
     }
 
+    traceISR_EXIT(TRACE_ISR_GPIO_PORTF);
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
@@ -373,13 +366,104 @@ void GPIOPortE_Handler(void)
 {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
+    traceISR_ENTER(TRACE_ISR_GPIO_PORTE);
+
+    traceRECORD_INPUT(REC_EVENT_BUTTON, REC_PIN(REC_PIN_PORTE, 4), 0);
     xEventGroupSetBitsFromISR(xEventGroup, mainSW2_PRESSED_BIT,&xHigherPriorityTaskWoken);
     GPIO_PORTE_ICR_REG |= (1<<4);
 
+    traceISR_EXIT(TRACE_ISR_GPIO_PORTE);
 
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
+void UART0_Handler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint8 ucEvents;
+
+    traceISR_ENTER(TRACE_ISR_UART0);
+
+    /* Refill the transmit FIFO from the ring buffer, or go on with the uDMA list */
+    ucEvents = UART0_TxInterrupt();
+    if((ucEvents & UART0_TX_EVENT_LIST_DONE) && (xUart0DmaWaiter != NULL))
+    {
+        vTaskNotifyGiveFromISR(xUart0DmaWaiter, &xHigherPriorityTaskWoken);
+        xUart0DmaWaiter = NULL;
+    }
+    if((ucEvents & UART0_TX_EVENT_ROOM) && (xUart0TxWaiter != NULL))
+    {
+        vTaskNotifyGiveIndexedFromISR(xUart0TxWaiter, mainUART0_TX_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+        xUart0TxWaiter = NULL;
+    }
+
+    traceISR_EXIT(TRACE_ISR_UART0);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+/* UART0_Write sleeps here while the ring is full. Not before the scheduler
+ * runs nor with it suspended: the driver then sends the ring itself. */
+static boolean prvUart0TxWait(uint32 ulTimeoutMs)
+{
+    if(xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        return FALSE;
+    }
+    xUart0TxWaiter = xTaskGetCurrentTaskHandle();
+    (void)ulTaskNotifyTakeIndexed(mainUART0_TX_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(ulTimeoutMs) + 1);
+    xUart0TxWaiter = NULL;
+    return TRUE;
+}
+
+/* Send the segments in place by uDMA. The calling task gets a notification
+ * once the channel took the last byte and leaves the list and its buffers
+ * alone until then. One task at a time, it owns the list. */
+static BaseType_t prvUart0SendList(const Uart0TxSegment *pxSegments, uint8 ucCount)
+{
+    xUart0DmaWaiter = xTaskGetCurrentTaskHandle();
+    if(UART0_WriteDma(pxSegments, ucCount) == FALSE)
+    {
+        xUart0DmaWaiter = NULL;
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+/* Wait for the end of a list sent by prvUart0SendList(), for as long as the
+ * ring bytes before it and the list take at the baud rate. A list not done by
+ * then is stopped and its rest written to the ring. */
+static void prvUart0FinishList(const Uart0TxSegment *pxSegments, uint8 ucCount)
+{
+    uint32 ulBytes = UART0_TX_BUFFER_SIZE;
+    uint32 ulHanded;
+    uint8 ucIndex;
+
+    for(ucIndex = 0; ucIndex < ucCount; ucIndex++)
+    {
+        ulBytes += pxSegments[ucIndex].uLength;
+    }
+    if(ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS((ulBytes * 10000UL) / UART0_BAUD_RATE + 1) + 1) != 0)
+    {
+        return;
+    }
+
+    ulHanded = UART0_AbortDma();
+    xUart0DmaWaiter = NULL;
+    (void)ulTaskNotifyTake(pdTRUE, 0);  /* An end that came with the abort */
+    for(ucIndex = 0; ucIndex < ucCount; ucIndex++)
+    {
+        if(ulHanded >= pxSegments[ucIndex].uLength)
+        {
+            ulHanded -= pxSegments[ucIndex].uLength;
+        }
+        else
+        {
+            (void)UART0_Write(pxSegments[ucIndex].pData + ulHanded, pxSegments[ucIndex].uLength - ulHanded);
+            ulHanded = 0;
+        }
+    }
+}
+
 
 void vButtonHandleTask(void *pvParameters)
 {
@@ -401,49 +485,50 @@ void vButtonHandleTask(void *pvParameters)
         /* Check which events are set and take an action based on it. */
         if (xEventGroupValue & mainSW1_PRESSED_BIT)
         {
-            if (xSemaphoreTake(xDriverMutex, portMAX_DELAY) == pdTRUE) {
+            if (xSemaphoreTake(xDriverSeat.Mutex, portMAX_DELAY) == pdTRUE) {
                 gDriverButtonCount++;
                 gDriverButtonCount = gDriverButtonCount % 4;
                 switch(gDriverButtonCount)
                 {
                 case(0):
-                                        gdSeatTemp = mainOFF_TEMP;
+                                        xDriverSeat.SeatTemp = mainOFF_TEMP;
                 break;
                 case(1):
-                                        gdSeatTemp = mainLOW_TEMP;
+                                        xDriverSeat.SeatTemp = mainLOW_TEMP;
                 break;
                 case(2):
-                                        gdSeatTemp = mainMED_TEMP;
+                                        xDriverSeat.SeatTemp = mainMED_TEMP;
                 break;
                 case(3):
-                                        gdSeatTemp = mainHIGH_TEMP;
+                                        xDriverSeat.SeatTemp = mainHIGH_TEMP;
                 break;
                 }
+                traceLATENCY_PROBE(LAT_CHAIN_DRIVER_BUTTON, LAT_HOP_BUTTON_TASK);
 
-                xSemaphoreGive(xDriverMutex);
+                xSemaphoreGive(xDriverSeat.Mutex);
             }
         }
         else if (xEventGroupValue & mainSW2_PRESSED_BIT)
         {
-            if (xSemaphoreTake(xPassengerMutex, portMAX_DELAY) == pdTRUE) {
+            if (xSemaphoreTake(xPassengerSeat.Mutex, portMAX_DELAY) == pdTRUE) {
                 gPassengerButtonCount++;
                 gPassengerButtonCount = gPassengerButtonCount % 4;
                 switch(gPassengerButtonCount)
                 {
                 case(0):
-                                        gpSeatTemp = mainOFF_TEMP;
+                                        xPassengerSeat.SeatTemp = mainOFF_TEMP;
                 break;
                 case(1):
-                                        gpSeatTemp = mainLOW_TEMP;
+                                        xPassengerSeat.SeatTemp = mainLOW_TEMP;
                 break;
                 case(2):
-                                        gpSeatTemp = mainMED_TEMP;
+                                        xPassengerSeat.SeatTemp = mainMED_TEMP;
                 break;
                 case(3):
-                                        gpSeatTemp = mainHIGH_TEMP;
+                                        xPassengerSeat.SeatTemp = mainHIGH_TEMP;
                 break;
                 }
-                xSemaphoreGive(xPassengerMutex);
+                xSemaphoreGive(xPassengerSeat.Mutex);
             }
         }
         else
@@ -474,247 +559,94 @@ void vButtonHandleTask(void *pvParameters)
 //}
 
 
-void vDriverIntensityControlTask(void *pvParameters)
-{
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    uint8 intensity;
-
-    for(;;)
-    {
-
-        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 200 ) );
-        xSemaphoreTake(xDriverMutex, portMAX_DELAY);
-        xSemaphoreTake(xDriverTempSemphr,portMAX_DELAY);
-        if(gDriverTemp+10<=gdSeatTemp)
-        {
-            intensity = mainHIGH_INTENSITY;
-        }
-        else if(gDriverTemp+5<=gdSeatTemp)
-        {
-            intensity = mainMED_INTENSITY;
-        }
-        else if(gDriverTemp+2<=gdSeatTemp)
-        {
-            intensity = mainLOW_INTENSITY;
-        }
-        else
-        {
-            intensity = mainNO_INTENSITY;
-        }
-        xQueueSend(xDriverIntensityQueue, &intensity, portMAX_DELAY);
-        xSemaphoreGive(xDriverTempSemphr);
-        xSemaphoreGive(xDriverMutex);
-    }
-}
-
-
-void vPassengerIntensityControlTask(void *pvParameters)
+/* Intensity part of the display report */
+static const Uart0TxSegment *prvIntensityText(uint8 ucIntensity)
 {
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    uint8 intensity;
-
-    for(;;)
+    static const Uart0TxSegment xTexts[] =
     {
-
-        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 200 ) );
-        xSemaphoreTake(xPassengerMutex, portMAX_DELAY);
-        xSemaphoreTake(xPassengerTempSemphr,portMAX_DELAY);
-        if(gPassengerTemp+10<=gpSeatTemp)
-        {
-            intensity = mainHIGH_INTENSITY;
-        }
-        else if(gPassengerTemp+5<=gpSeatTemp)
-        {
-            intensity = mainMED_INTENSITY;
-        }
-        else if(gPassengerTemp+2<=gpSeatTemp)
-        {
-            intensity = mainLOW_INTENSITY;
-        }
-        else
-        {
-            intensity = mainNO_INTENSITY;
-        }
-        xQueueSend(xPassengerIntensityQueue, &intensity, portMAX_DELAY);
-        xSemaphoreGive(xPassengerTempSemphr);
-        xSemaphoreGive(xPassengerMutex);
-    }
-}
-
-
-
-void vDriverHeaterControlTask(void *pvParameters)
-{
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    uint8 intensity;
-    for (;;)
+        mainTEXT_SEGMENT("NO Intensity Because of Out of Range Error"),
+        mainTEXT_SEGMENT("NO Intensity"),
+        mainTEXT_SEGMENT("LOW Intensity"),
+        mainTEXT_SEGMENT("MEDIUM Intensity"),
+        mainTEXT_SEGMENT("HIGH Intensity"),
+        mainTEXT_SEGMENT("")
+    };
+
+    switch(ucIntensity)
     {
-        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 200 ) );
-
-        xQueueReceive(xDriverIntensityQueue, &intensity, portMAX_DELAY);
-
-        switch(intensity)
-        {
-        case(mainERROR_NO_INTENSITY):
-        GPIO_BlueLedOff();
-        GPIO_GreenLedOff();
-        break;
-        case(mainNO_INTENSITY):
-        GPIO_BlueLedOff();
-        GPIO_GreenLedOff();
-        break;
-        case(mainLOW_INTENSITY):
-        GPIO_BlueLedOff();
-        GPIO_GreenLedOn();
-        break;
-        case(mainMED_INTENSITY):
-        GPIO_BlueLedOn();
-        GPIO_GreenLedOff();
-        break;
-        case(mainHIGH_INTENSITY):
-        GPIO_BlueLedOn();
-        GPIO_GreenLedOn();
-        break;
-        }
+    case(SEAT_ERROR_NO_INTENSITY):
+            return &xTexts[0];
+    case(SEAT_NO_INTENSITY):
+            return &xTexts[1];
+    case(SEAT_LOW_INTENSITY):
+            return &xTexts[2];
+    case(SEAT_MED_INTENSITY):
+            return &xTexts[3];
+    case(SEAT_HIGH_INTENSITY):
+            return &xTexts[4];
+    default:
+            return &xTexts[5];
     }
 }
 
-void vPassengerHeaterControlTask(void *pvParameters)
-{
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    uint8 intensity;
-    for (;;)
-    {
-        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 200 ) );
-
-        xQueueReceive(xPassengerIntensityQueue, &intensity, portMAX_DELAY);
-
-        switch(intensity)
-        {
-        case(mainERROR_NO_INTENSITY):
-        GPIO_ExBlueLedOff();
-        GPIO_ExGreenLedOff();
-        break;
-        case(mainNO_INTENSITY):
-        GPIO_ExBlueLedOff();
-        GPIO_ExGreenLedOff();
-        break;
-        case(mainLOW_INTENSITY):
-        GPIO_ExBlueLedOff();
-        GPIO_ExGreenLedOn();
-        break;
-        case(mainMED_INTENSITY):
-        GPIO_ExBlueLedOn();
-        GPIO_ExGreenLedOff();
-        break;
-        case(mainHIGH_INTENSITY):
-        GPIO_ExBlueLedOn();
-        GPIO_ExGreenLedOn();
-        break;
-        }
-    }
-}
-
-
 void vDisplayUserTask(void *pvParameters)
 {
     TickType_t xLastWakeTime = xTaskGetTickCount();
     uint8 dIntensity;
     uint8 pIntensity;
+
+    /* The report as a uDMA list: the text is sent from flash, only the numbers
+     * are formatted. Static as the list stays in use after the send returns. */
+    static uint8 ucDigits[4][UART0_INTEGER_DIGITS];
+    static Uart0TxSegment xReport[] =
+    {
+        mainTEXT_SEGMENT("Driver:\r\nCurrent Temperature = "),
+        { NULL_PTR, 0 },
+        mainTEXT_SEGMENT(" Degree\r\nRequired Heating Level = "),
+        { NULL_PTR, 0 },
+        mainTEXT_SEGMENT(" Degree\r\nThe Heater is Working with "),
+        { NULL_PTR, 0 },
+        mainTEXT_SEGMENT(" \r\n\n**************************************\r\n\n"),
+        mainTEXT_SEGMENT("Passenger:\r\nCurrent Temperature = "),
+        { NULL_PTR, 0 },
+        mainTEXT_SEGMENT(" Degree\r\nRequired Heating Level = "),
+        { NULL_PTR, 0 },
+        mainTEXT_SEGMENT(" Degree\r\nThe Heater is Working with "),
+        { NULL_PTR, 0 },
+        mainTEXT_SEGMENT(" \r\n\n**************************************\r\n\n")
+    };
+
+    xReport[1].pData = ucDigits[0];
+    xReport[3].pData = ucDigits[1];
+    xReport[8].pData = ucDigits[2];
+    xReport[10].pData = ucDigits[3];
     for (;;)
     {
-        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 1000 ) );
-        xQueueReceive(xDriverIntensityQueue, &dIntensity, portMAX_DELAY);
-        xQueueReceive(xPassengerIntensityQueue, &pIntensity, portMAX_DELAY);
-        UART0_SendString("Driver:\r\nCurrent Temperature = ");
-        UART0_SendInteger(gDriverTemp);
-        UART0_SendString(" Degree\r\nRequired Heating Level = ");
-        UART0_SendInteger(gdSeatTemp);
-        UART0_SendString(" Degree\r\nThe Heater is Working with ");
-        switch(dIntensity)
+        DEADLINE_DelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 1000 ) );
+        xQueueReceive(xDriverSeat.IntensityQueue, &dIntensity, portMAX_DELAY);
+        xQueueReceive(xPassengerSeat.IntensityQueue, &pIntensity, portMAX_DELAY);
+        xReport[1].uLength = UART0_FormatInteger(xDriverSeat.Temp, ucDigits[0]);
+        xReport[3].uLength = UART0_FormatInteger(xDriverSeat.SeatTemp, ucDigits[1]);
+        xReport[5] = *prvIntensityText(dIntensity);
+        xReport[8].uLength = UART0_FormatInteger(xPassengerSeat.Temp, ucDigits[2]);
+        xReport[10].uLength = UART0_FormatInteger(xPassengerSeat.SeatTemp, ucDigits[3]);
+        xReport[12] = *prvIntensityText(pIntensity);
+        /* No waiting for the console, the inherited priority would hold the
+         * intensity tasks off for the whole report. This second is skipped.
+         * The line is ours until the list is done, 0.3 s at 9600 baud. */
+        if(xSemaphoreTake(xUart0Mutex, 0) == pdTRUE)
         {
-        case(mainERROR_NO_INTENSITY):
-                UART0_SendString("NO Intensity Because of Out of Range Error");
-                break;
-        case(mainNO_INTENSITY):
-                UART0_SendString("NO Intensity");
-                break;
-        case(mainLOW_INTENSITY):
-                UART0_SendString("LOW Intensity" );
-                break;
-        case(mainMED_INTENSITY):
-                UART0_SendString("MEDIUM Intensity");
-                break;
-        case(mainHIGH_INTENSITY):
-                UART0_SendString("HIGH Intensity");
-                break;
-        }
-        UART0_SendString(" \r\n\n**************************************\r\n\n");
-        UART0_SendString("Passenger:\r\nCurrent Temperature = ");
-        UART0_SendInteger(gPassengerTemp);
-        UART0_SendString(" Degree\r\nRequired Heating Level = ");
-        UART0_SendInteger(gpSeatTemp);
-        UART0_SendString(" Degree\r\nThe Heater is Working with ");
-        switch(pIntensity)
-        {
-        case(mainERROR_NO_INTENSITY):
-                UART0_SendString("NO Intensity Because of Out of Range Error");
-                break;
-        case(mainNO_INTENSITY):
-                UART0_SendString("NO Intensity");
-                break;
-        case(mainLOW_INTENSITY):
-                UART0_SendString("LOW Intensity" );
-                break;
-        case(mainMED_INTENSITY):
-                UART0_SendString("MEDIUM Intensity");
-                break;
-        case(mainHIGH_INTENSITY):
-                UART0_SendString("HIGH Intensity");
-                break;
+            if(prvUart0SendList(xReport, sizeof(xReport) / sizeof(xReport[0])) == pdPASS)
+            {
+                prvUart0FinishList(xReport, sizeof(xReport) / sizeof(xReport[0]));
+            }
+            xSemaphoreGive(xUart0Mutex);
         }
-        UART0_SendString(" \r\n\n**************************************\r\n\n");
     }
 }
 
 
 
-void vErrorHandleTask(void *pvParameters)
-{
-    uint8 newError = pdTRUE;
-    ErrorHandleTaskInformation * pTaskInformation = (ErrorHandleTaskInformation *) pvParameters;
-
-    xSemaphoreHandle usedErrSmphr = *(pTaskInformation->usedErrorSmphr);
-    xTaskHandle Task_Handle = *(pTaskInformation->usedTask);
-    xQueueHandle usedQueue = *(pTaskInformation->usedQueue);
-    uint16* seatTemp = (pTaskInformation->seatTemp);
-
-    xSemaphoreTake(usedErrSmphr,portMAX_DELAY);
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    uint8 no_intensity = mainERROR_NO_INTENSITY;
-    for (;;)
-    {
-        vTaskSuspend(Task_Handle);
-        xQueueSend(usedQueue, &no_intensity, portMAX_DELAY);
-        (pTaskInformation->LedOnFun)();
-        if(pdTRUE==newError)
-        {
-            if(*seatTemp<5)      xEventGroupSetBits(xEventGroup, pTaskInformation->UnderBit);
-            if(*seatTemp>40)     xEventGroupSetBits(xEventGroup, pTaskInformation->OverBit);
-            newError = pdFALSE;
-        }
-        if(*seatTemp>=5 && *seatTemp<=40)
-        {
-            vTaskResume(Task_Handle);
-            (pTaskInformation->LedOffFun)();
-            newError = pdTRUE;
-            xSemaphoreTake(usedErrSmphr,portMAX_DELAY);
-        }
-        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 200 ) );
-
-    }
-}
-
 void vDiagnosticsTask(void *pvParameters)
 {
     EventBits_t xEventGroupValue;
@@ -732,33 +664,33 @@ void vDiagnosticsTask(void *pvParameters)
         {
             ErrorInfo.Info = gOverDriver;
             EEPROM_SaveBlock1((void*)&ErrorInfo);
-            xQueueSend(xDriverDiagnosticsQueue,&ErrorInfo,0);
+            xQueueSend(xDriverSeat.DiagnosticsQueue,&ErrorInfo,0);
         }
         else if(xEventGroupValue & mainERROR_UNDER_DRIVER_BIT)
         {
             ErrorInfo.Info = gUnderDriver;
             EEPROM_SaveBlock1((void*)&ErrorInfo);
-            xQueueSend(xDriverDiagnosticsQueue,&ErrorInfo,0);
+            xQueueSend(xDriverSeat.DiagnosticsQueue,&ErrorInfo,0);
         }
         else if(xEventGroupValue & mainERROR_OVER_PASSENGER_BIT)
         {
             ErrorInfo.Info = gOverPassenger;
             EEPROM_SaveBlock1((void*)&ErrorInfo);
-            xQueueSend(xPassengerDiagnosticsQueue,&ErrorInfo,0);
+            xQueueSend(xPassengerSeat.DiagnosticsQueue,&ErrorInfo,0);
         }
         else if(xEventGroupValue & mainERROR_UNDER_PASSENGER_BIT)
         {
             ErrorInfo.Info = gUnderPassenger;
             EEPROM_SaveBlock1((void*)&ErrorInfo);
-            xQueueSend(xPassengerDiagnosticsQueue,&ErrorInfo,0);
+            xQueueSend(xPassengerSeat.DiagnosticsQueue,&ErrorInfo,0);
         }
         else
         {
             EEPROM_PointBeginBlock0();
-            xQueueReceive(xDriverIntensityQueue, &(ErrorInfo.Info), portMAX_DELAY);
+            xQueueReceive(xDriverSeat.IntensityQueue, &(ErrorInfo.Info), portMAX_DELAY);
             EEPROM_SaveBlock0((void*)&ErrorInfo);
             gSystemDriverLastState = ErrorInfo;
-            xQueueReceive(xPassengerIntensityQueue, &(ErrorInfo.Info), portMAX_DELAY);
+            xQueueReceive(xPassengerSeat.IntensityQueue, &(ErrorInfo.Info), portMAX_DELAY);
             EEPROM_SaveBlock0((void*)&ErrorInfo);
             gSystemPassengerLastState = ErrorInfo;
             EEPROM_PointBeginBlock0();
@@ -766,27 +698,133 @@ void vDiagnosticsTask(void *pvParameters)
     }
 }
 
+#if configGENERATE_RUN_TIME_STATS
 void vRunTimeMeasurementsTask(void *pvParameters)
 {
     TickType_t xLastWakeTime = xTaskGetTickCount();
     for (;;)
     {
-        uint8 ucCounter, ucCPU_Load;
-        uint32 ullTotalTasksTime = 0;
-        vTaskDelayUntil(&xLastWakeTime, 1000);
-        for(ucCounter = 1; ucCounter < 13; ucCounter++)
+        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS( RTS_SAMPLE_PERIOD_MS ));
+        RTS_Sample();
+#if ENERGY_ENABLED
+        ENERGY_Sample();
+#endif
+    }
+}
+#endif
+
+#if TRACE_ENABLED(TRACE_CATEGORY_PROBES)
+/* Copy one chain with the probes held off, as they run from tasks and ISRs */
+static void prvLatencyGetChain(uint8 ucChain, LatencyChain *pxChain)
+{
+    taskENTER_CRITICAL();
+    LAT_GetChain(ucChain, pxChain);
+    taskEXIT_CRITICAL();
+}
+#endif
+
+void vMeasurementsConsoleTask(void *pvParameters)
+{
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+#if RECORDER_ENABLED
+    uint8 ucRecordLoops = 0;
+#endif
+    for (;;)
+    {
+        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS( 100 ));
+#if RECORDER_ENABLED
+        if(REC_IsOn() && (++ucRecordLoops >= mainRECORD_DRAIN_LOOPS))
         {
-            ullTotalTasksTime += ullTasksExecutionTime[ucCounter];
+            ucRecordLoops = 0;
+            /* Keep the display report out of the frame */
+            xSemaphoreTake(xUart0Mutex, portMAX_DELAY);
+            REC_Drain(UART0_SendByte);
+            xSemaphoreGive(xUart0Mutex);
+        }
+#endif
+        if(UART0_IsDataAvailable())
+        {
+            /* The reports are sent with the other tasks running, whatever has
+             * to be consistent is copied first by the report itself. The mutex
+             * keeps the display report out of them. */
+            xSemaphoreTake(xUart0Mutex, portMAX_DELAY);
+            switch(UART0_ReceiveByte())
+            {
+#if TRACE_RING_ENABLED
+            case(mainCMD_TRACE_DUMP):
+                    /* Freeze the ring while the frame is sent */
+                    TRACE_Stop();
+                    TRACE_Drain(UART0_SendByte);
+                    TRACE_Start();
+                    break;
+#endif
+#if configGENERATE_RUN_TIME_STATS
+            case(mainCMD_RUNTIME_STATS):
+                    RTS_Report();
+                    break;
+#endif
+#if TRACE_ENABLED(TRACE_CATEGORY_QUEUES)
+            case(mainCMD_LOCK_STATS):
+                    LOCK_Report();
+                    break;
+            case(mainCMD_QUEUE_STATS):
+                    QSTATS_Report();
+                    break;
+#endif
+#if TRACE_ENABLED(TRACE_CATEGORY_PROBES)
+            case(mainCMD_LATENCY_STATS):
+                    LAT_Report(prvLatencyGetChain);
+                    break;
+#endif
+            case(mainCMD_DEADLINE_STATS):
+                    DEADLINE_Report();
+                    break;
+            case(mainCMD_STACK_STATS):
+                    STACK_Report();
+                    break;
+            case(mainCMD_HEAP_STATS):
+                    HEAP_Report();
+                    break;
+            case(mainCMD_MCAL_BENCH):
+                    /* Only the measured cases run with the scheduler suspended */
+                    vTaskSuspendAll();
+                    BENCH_Run();
+                    xTaskResumeAll();
+                    BENCH_Report();
+                    break;
+#if ISR_STATS_ENABLED
+            case(mainCMD_ISR_STATS):
+                    ISR_Report();
+                    break;
+#endif
+#if TRACE_ENABLED(TRACE_CATEGORY_COUNTERS)
+            case(mainCMD_TRACE_COUNTS):
+                    TRACE_CountsReport();
+                    break;
+#endif
+#if ENERGY_ENABLED
+            case(mainCMD_ENERGY):
+                    ENERGY_Report();
+                    break;
+#endif
+#if RECORDER_ENABLED
+            case(mainCMD_RECORD):
+                    if(REC_IsOn())
+                    {
+                        REC_Stop();
+                    }
+                    else
+                    {
+                        REC_Start();
+                    }
+                    break;
+#endif
+            default:
+                    break;
+            }
+            xSemaphoreGive(xUart0Mutex);
         }
-        ucCPU_Load = (ullTotalTasksTime * 100) /  GPTM_WTimer0Read();
-
-        taskENTER_CRITICAL();
-        UART0_SendString("CPU Load is ");
-        UART0_SendInteger(ucCPU_Load);
-        UART0_SendString("% \r\n");
-        taskEXIT_CRITICAL();
     }
 }
 
-
 /*-----------------------------------------------------------*/
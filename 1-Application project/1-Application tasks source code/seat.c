@@ -0,0 +1,192 @@
+ /******************************************************************************
+ *
+ * Module: Seat
+ *
+ * File Name: seat.c
+ *
+ * Description: Source file for the tasks of one heated seat.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "seat.h"
+#include "deadline.h"
+#include "trace.h"
+#include "energy.h"
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void vSeatTempTask(void *pvParameters)
+{
+    SeatChannel *pxSeat = (SeatChannel *)pvParameters;
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
+    for(;;)
+    {
+        DEADLINE_DelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 500 ) );
+        if(pxSeat->Converter != NULL_PTR)
+        {
+            xSemaphoreTake(pxSeat->Converter->Free, portMAX_DELAY);
+            pxSeat->Converter->Owner = pxSeat;
+        }
+        pxSeat->Hardware->StartConv();
+    }
+}
+
+void vSeatIntensityTask(void *pvParameters)
+{
+    SeatChannel *pxSeat = (SeatChannel *)pvParameters;
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint8 intensity;
+
+    for(;;)
+    {
+        DEADLINE_DelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 200 ) );
+        xSemaphoreTake(pxSeat->Mutex, portMAX_DELAY);
+        xSemaphoreTake(pxSeat->TempSemphr, portMAX_DELAY);
+        if(pxSeat->Temp+SEAT_HIGH_INTENSITY_DIFF<=pxSeat->SeatTemp)
+        {
+            intensity = SEAT_HIGH_INTENSITY;
+        }
+        else if(pxSeat->Temp+SEAT_MED_INTENSITY_DIFF<=pxSeat->SeatTemp)
+        {
+            intensity = SEAT_MED_INTENSITY;
+        }
+        else if(pxSeat->Temp+SEAT_LOW_INTENSITY_DIFF<=pxSeat->SeatTemp)
+        {
+            intensity = SEAT_LOW_INTENSITY;
+        }
+        else
+        {
+            intensity = SEAT_NO_INTENSITY;
+        }
+        if(pxSeat->LatencyChains)
+        {
+            /* Probed before sending, the heater task has the higher priority and runs as soon as the item is queued */
+            traceLATENCY_PROBE_SENT(LAT_CHAIN_DRIVER_BUTTON, LAT_HOP_BUTTON_DECISION);
+            traceLATENCY_PROBE_SENT(LAT_CHAIN_DRIVER_SENSOR, LAT_HOP_SENSOR_DECISION);
+        }
+        xQueueSend(pxSeat->IntensityQueue, &intensity, portMAX_DELAY);
+        xSemaphoreGive(pxSeat->TempSemphr);
+        xSemaphoreGive(pxSeat->Mutex);
+    }
+}
+
+void vSeatHeaterTask(void *pvParameters)
+{
+    SeatChannel *pxSeat = (SeatChannel *)pvParameters;
+    const SeatHardware *pxHardware = pxSeat->Hardware;
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint8 ucLevel = ENERGY_LEVEL_OFF;
+    uint8 intensity;
+
+    for(;;)
+    {
+        DEADLINE_DelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 200 ) );
+
+        xQueueReceive(pxSeat->IntensityQueue, &intensity, portMAX_DELAY);
+
+        switch(intensity)
+        {
+        case(SEAT_ERROR_NO_INTENSITY):
+        pxHardware->BlueLedOff();
+        pxHardware->GreenLedOff();
+        ucLevel = ENERGY_LEVEL_OFF;
+        break;
+        case(SEAT_NO_INTENSITY):
+        pxHardware->BlueLedOff();
+        pxHardware->GreenLedOff();
+        ucLevel = ENERGY_LEVEL_OFF;
+        break;
+        case(SEAT_LOW_INTENSITY):
+        pxHardware->BlueLedOff();
+        pxHardware->GreenLedOn();
+        ucLevel = ENERGY_LEVEL_LOW;
+        break;
+        case(SEAT_MED_INTENSITY):
+        pxHardware->BlueLedOn();
+        pxHardware->GreenLedOff();
+        ucLevel = ENERGY_LEVEL_MEDIUM;
+        break;
+        case(SEAT_HIGH_INTENSITY):
+        pxHardware->BlueLedOn();
+        pxHardware->GreenLedOn();
+        ucLevel = ENERGY_LEVEL_HIGH;
+        break;
+        }
+        if(pxSeat->EnergySeat != SEAT_NO_ENERGY)
+        {
+            traceHEATER_LEVEL(pxSeat->EnergySeat, ucLevel);
+        }
+        if(pxSeat->LatencyChains)
+        {
+            traceLATENCY_PROBE_RECEIVED(LAT_CHAIN_DRIVER_BUTTON, LAT_HOP_BUTTON_OUTPUT);
+            traceLATENCY_PROBE_RECEIVED(LAT_CHAIN_DRIVER_SENSOR, LAT_HOP_SENSOR_OUTPUT);
+        }
+    }
+}
+
+void vSeatErrorTask(void *pvParameters)
+{
+    SeatChannel *pxSeat = (SeatChannel *)pvParameters;
+    uint8 newError = pdTRUE;
+    uint8 no_intensity = SEAT_ERROR_NO_INTENSITY;
+    TickType_t xLastWakeTime;
+
+    xSemaphoreTake(pxSeat->ErrorSemaphore, portMAX_DELAY);
+    xLastWakeTime = xTaskGetTickCount();
+    for(;;)
+    {
+        vTaskSuspend(pxSeat->IntensityTask);
+        xQueueSend(pxSeat->IntensityQueue, &no_intensity, portMAX_DELAY);
+        pxSeat->Hardware->RedLedOn();
+        if(pdTRUE==newError)
+        {
+            if(pxSeat->Temp<SEAT_MIN_TEMP)      xEventGroupSetBits(pxSeat->ErrorEvents, pxSeat->UnderBit);
+            if(pxSeat->Temp>SEAT_MAX_TEMP)      xEventGroupSetBits(pxSeat->ErrorEvents, pxSeat->OverBit);
+            newError = pdFALSE;
+        }
+        if(pxSeat->Temp>=SEAT_MIN_TEMP && pxSeat->Temp<=SEAT_MAX_TEMP)
+        {
+            vTaskResume(pxSeat->IntensityTask);
+            pxSeat->Hardware->RedLedOff();
+            newError = pdTRUE;
+            xSemaphoreTake(pxSeat->ErrorSemaphore, portMAX_DELAY);
+            /* The next error starts a new period at once, the wait for it is no overrun */
+            xLastWakeTime = xTaskGetTickCount();
+            continue;
+        }
+        DEADLINE_DelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 200 ) );
+    }
+}
+
+BaseType_t SEAT_ConversionDone(SeatChannel *pxSeat, uint16 usSample)
+{
+    BaseType_t xHigherPriorityTaskWoken1 = pdFALSE;
+    BaseType_t xHigherPriorityTaskWoken2 = pdFALSE;
+    BaseType_t xHigherPriorityTaskWoken3 = pdFALSE;
+    BaseType_t xHigherPriorityTaskWoken4 = pdFALSE;
+
+    xSemaphoreTakeFromISR(pxSeat->TempSemphr, &xHigherPriorityTaskWoken1);
+
+    pxSeat->Temp = usSample*45/4095;
+    if(pxSeat->LatencyChains)
+    {
+        traceLATENCY_START(LAT_CHAIN_DRIVER_SENSOR);
+    }
+
+    xSemaphoreGiveFromISR(pxSeat->TempSemphr, &xHigherPriorityTaskWoken2);
+
+    if(pxSeat->Temp<SEAT_MIN_TEMP || pxSeat->Temp>SEAT_MAX_TEMP)
+    {
+        xSemaphoreGiveFromISR(pxSeat->ErrorSemaphore, &xHigherPriorityTaskWoken3);
+    }
+    if(pxSeat->Converter != NULL_PTR)
+    {
+        xSemaphoreGiveFromISR(pxSeat->Converter->Free, &xHigherPriorityTaskWoken4);
+    }
+    return xHigherPriorityTaskWoken1 | xHigherPriorityTaskWoken2 | xHigherPriorityTaskWoken3 | xHigherPriorityTaskWoken4;
+}
@@ -0,0 +1,125 @@
+ /******************************************************************************
+ *
+ * Module: Seat
+ *
+ * File Name: seat.h
+ *
+ * Description: Header file for the tasks of one heated seat: the temperature
+ *              read, intensity control, heater and error tasks and the part
+ *              of the conversion interrupt that stores the temperature. Every
+ *              task takes the SeatChannel record of its seat as parameter,
+ *              so main.c runs them for the driver and passenger seats and the
+ *              host scaling benchmark for any number of channels.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SEAT_SEAT_H_
+#define SEAT_SEAT_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#include "semphr.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SEAT_ERROR_NO_INTENSITY         'n'
+#define SEAT_NO_INTENSITY               'N'
+#define SEAT_LOW_INTENSITY              'L'
+#define SEAT_MED_INTENSITY              'M'
+#define SEAT_HIGH_INTENSITY             'H'
+
+/* Degrees the seat is under the required temperature from which the intensity
+ * control task drives each intensity (Tools/gain_sweep.py of the host project) */
+#ifndef SEAT_HIGH_INTENSITY_DIFF
+#define SEAT_HIGH_INTENSITY_DIFF        10
+#endif
+#ifndef SEAT_MED_INTENSITY_DIFF
+#define SEAT_MED_INTENSITY_DIFF         5
+#endif
+#ifndef SEAT_LOW_INTENSITY_DIFF
+#define SEAT_LOW_INTENSITY_DIFF         2
+#endif
+
+/* Valid temperature range of the sensor, in degrees */
+#define SEAT_MIN_TEMP                   5
+#define SEAT_MAX_TEMP                   40
+
+/* EnergySeat of a seat left out of the energy accounting */
+#define SEAT_NO_ENERGY                  0xFF
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Converter and heater LEDs of a seat on the board */
+typedef struct
+{
+    void (*StartConv)(void);
+    void (*BlueLedOn)(void);
+    void (*BlueLedOff)(void);
+    void (*GreenLedOn)(void);
+    void (*GreenLedOff)(void);
+    void (*RedLedOn)(void);
+    void (*RedLedOff)(void);
+} SeatHardware;
+
+struct SeatChannel;
+
+/* A converter shared by several seats, handed over by Free */
+typedef struct
+{
+    xSemaphoreHandle Free;              /* Given back by SEAT_ConversionDone() */
+    struct SeatChannel *Owner;          /* Seat of the conversion in progress */
+} SeatConverter;
+
+/* The set up, objects and globals of one seat */
+typedef struct SeatChannel
+{
+    const SeatHardware *Hardware;
+    SeatConverter *Converter;           /* NULL_PTR when the seat has a converter of its own */
+    EventBits_t UnderBit;               /* Set in ErrorEvents on a new error under SEAT_MIN_TEMP */
+    EventBits_t OverBit;                /* Set in ErrorEvents on a new error over SEAT_MAX_TEMP */
+    uint8 EnergySeat;                   /* ENERGY_SEAT_* of the heater levels, or SEAT_NO_ENERGY */
+    boolean LatencyChains;              /* The LAT_CHAIN_DRIVER_* chains follow this seat */
+    EventGroupHandle_t ErrorEvents;
+    xSemaphoreHandle Mutex;             /* Required temperature */
+    xSemaphoreHandle TempSemphr;        /* Current temperature */
+    xSemaphoreHandle ErrorSemaphore;    /* Given by the conversion interrupt out of range */
+    QueueHandle_t IntensityQueue;
+    QueueHandle_t DiagnosticsQueue;
+    xTaskHandle TempTask;
+    xTaskHandle IntensityTask;
+    xTaskHandle HeaterTask;
+    xTaskHandle ErrorTask;
+    uint16 Temp;
+    uint8 SeatTemp;
+} SeatChannel;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Start a conversion every 500 ms, once the converter is free when shared */
+void vSeatTempTask(void *pvParameters);
+
+/* Queue the intensity for the seat temperature every 200 ms */
+void vSeatIntensityTask(void *pvParameters);
+
+/* Drive the heater LEDs with the queued intensity every 200 ms */
+void vSeatHeaterTask(void *pvParameters);
+
+/* Hold the intensity task and light the red LED while the temperature is out
+ * of range, checked every 200 ms */
+void vSeatErrorTask(void *pvParameters);
+
+/* Store the converted sample of the seat, from its conversion interrupt.
+ * Returns whether a task of higher priority was woken. */
+BaseType_t SEAT_ConversionDone(SeatChannel *pxSeat, uint16 usSample);
+
+#endif /* SEAT_SEAT_H_ */
@@ -20,6 +20,15 @@
 
 #include "GPTM.h"
 #include "std_types.h"
+#include "trace.h"
+#include "lock_stats.h"
+#include "queue_stats.h"
+#include "latency.h"
+#include "stack_stats.h"
+#include "heap_stats.h"
+#include "isr_stats.h"
+#include "recorder.h"
+#include "energy.h"
 
 /******************************************************************************/
 /* Scheduling behavior related definitions. **********************************/
@@ -29,7 +38,7 @@
  * the peripheral used to generate the kernels periodic tick interrupt.
  * This is very often, but not always, equal to the main system clock frequency.
  * Default frequency in Tiva-C Micro-controllers is 16Mhz */
-#define configCPU_CLOCK_HZ                    (( unsigned long )16000000)
+#define configCPU_CLOCK_HZ                    16000000UL
 
 /* configTICK_RATE_HZ sets frequency of the tick interrupt in Hz, so
  * in our case Tick time will be 10ms */
@@ -60,12 +69,16 @@
  * or heap_4.c are included in the build. This value is defaulted to 4096 bytes but
  * it must be tailored to each application. Note the heap will appear in the .bss
  * section. */
-#define configTOTAL_HEAP_SIZE                 ((size_t)(8192))
+#define configTOTAL_HEAP_SIZE                 ((size_t)(10240))
 
 /* Set the following configUSE_* constants to 1 to include the named feature in
  * the build, or 0 to exclude the named feature from the build. */
 #define configUSE_MUTEXES                      1
 
+/* Notification 0 ends the uDMA list of a task, 1 wakes a writer waiting for
+ * room in the UART0 ring (main.c) */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES  2
+
 /******************************************************************************/
 /* Definitions that include or exclude functionality. *************************/
 /******************************************************************************/
@@ -76,6 +89,8 @@
 #define INCLUDE_vTaskDelayUntil                 1
 #define INCLUDE_xTimerPendFunctionCall          1
 #define INCLUDE_vTaskSuspend               1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
 
 /* Set the following INCLUDE_* constants to 1 to include the named API function,
  * or 0 to exclude the named API function.  Most linkers will remove unused
@@ -123,6 +138,17 @@
 #define configUSE_TICK_HOOK                   0
 #define configUSE_TRACE_FACILITY              1
 
+/* The daemon task startup hook checks configMEASURED_TASKS once every task
+ * is created, the idle and timer tasks included */
+#define configUSE_DAEMON_TASK_STARTUP_HOOK    1
+
+/* Task numbers 1 .. configMEASURED_TASKS-1 have a slot in the run time, lock,
+ * stack, deadline and trace statistics: 13 application tasks plus the idle
+ * and timer tasks, with none to spare. The host scaling benchmark sets more */
+#ifndef configMEASURED_TASKS
+#define configMEASURED_TASKS                  16
+#endif
+
 /******************************************************************************/
 /* ARM Cortex-M Specific Definitions. *****************************************/
 /******************************************************************************/
@@ -159,37 +185,276 @@ PRIORITY THAN THIS! (higher priorities are lower numeric values. */
 /* RTOS Runtime Measurements. *************************************************/
 /******************************************************************************/
 
-extern uint32 ullTasksOutTime[13];
-extern uint32 ullTasksInTime[13];
-extern uint32 ullTasksExecutionTime[13];
+/* Every hook below is built from the categories selected by TRACE_CATEGORIES
+ * (see trace.h), a disabled category leaves nothing in the kernel paths */
+
+/* The kernel keeps the run time of every task, clocked by WTimer0 (0.1 msec per count).
+ * WTimer0 runs as a periodic 32-bit counter and is started in prvSetupHardware(),
+ * it wraps every ~119 hours and the kernel drops the one slice running across the wrap.
+ * It costs a WTimer0 read on every context switch so it belongs to the scheduler category */
+#if TRACE_ENABLED(TRACE_CATEGORY_SCHEDULER)
+#define configGENERATE_RUN_TIME_STATS                 1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()              GPTM_WTimer0Read()
+#else
+#define configGENERATE_RUN_TIME_STATS                 0
+#endif
+
+/* Keep the top of every task stack in its TCB so the stack size is known */
+#define configRECORD_STACK_HIGH_ADDRESS               1
+
+/* Per category parts of the hooks, empty when the category is disabled */
+#if TRACE_ENABLED(TRACE_CATEGORY_SCHEDULER)
+#define traceRECORD_SCHEDULER( ucEvent, ucId, usArg )   TRACE_RECORD( ucEvent, ucId, usArg )
+#else
+#define traceRECORD_SCHEDULER( ucEvent, ucId, usArg )
+#endif
+
+#if TRACE_ENABLED(TRACE_CATEGORY_QUEUES)
+#define traceRECORD_QUEUES( ucEvent, ucId, usArg )      TRACE_RECORD( ucEvent, ucId, usArg )
+#else
+#define traceRECORD_QUEUES( ucEvent, ucId, usArg )
+#endif
+
+#if TRACE_ENABLED(TRACE_CATEGORY_ISRS)
+#define traceRECORD_ISRS( ucEvent, ucId, usArg )        TRACE_RECORD( ucEvent, ucId, usArg )
+#else
+#define traceRECORD_ISRS( ucEvent, ucId, usArg )
+#endif
+
+#if TRACE_ENABLED(TRACE_CATEGORY_COUNTERS)
+#define traceCOUNT( ucEvent )                           TRACE_COUNT( ucEvent )
+#else
+#define traceCOUNT( ucEvent )
+#endif
+
+#if TRACE_RING_ENABLED
+#define traceTASK_NAME( pxNewTCB )                      TRACE_TaskCreated( (uint8)((pxNewTCB)->uxTCBNumber), (pxNewTCB)->pcTaskName )
+#else
+#define traceTASK_NAME( pxNewTCB )
+#endif
+
+/* Keep the names of the tasks so the trace decoder can label the task numbers,
+ * and the usable stack size of every task for the stack report. The task number
+ * returned by uxTaskGetTaskNumber() (deadline and lock statistics) is the unique
+ * TCB number, the kernel leaves it 0 for every task otherwise */
+#define traceTASK_CREATE( pxNewTCB )                                                                 \
+do{                                                                                                  \
+    (pxNewTCB)->uxTaskNumber = (pxNewTCB)->uxTCBNumber;                                              \
+    traceTASK_NAME( pxNewTCB );                                                                      \
+    STACK_TaskCreated( (void *)(pxNewTCB), (uint32)((pxNewTCB)->pxEndOfStack - (pxNewTCB)->pxStack) + 1 ); \
+    HEAP_ObjectCreated( (void *)(pxNewTCB), HEAP_OBJECT_TASK );                                      \
+}while(0)
+
+#define traceTASK_SWITCHED_IN()                                                                      \
+do{                                                                                                  \
+    traceRECORD_SCHEDULER(TRACE_EVENT_TASK_SWITCH, pxCurrentTCB->uxTCBNumber, 0);                    \
+    traceCOUNT(TRACE_EVENT_TASK_SWITCH);                                                             \
+}while(0)
+
+/* Interrupt entry and exit are recorded by the application handlers themselves,
+ * the mask keeps a nested interrupt from tearing the event being written.
+ * The handler execution time is taken between the two trace records */
+#if TRACE_ENABLED(TRACE_CATEGORY_ISRS | TRACE_CATEGORY_COUNTERS)
+#define traceISR_ENTER( ucIsrNumber )                                                                \
+do{                                                                                                  \
+    UBaseType_t uxTraceSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();                              \
+    traceRECORD_ISRS(TRACE_EVENT_ISR_ENTER, ucIsrNumber, 0);                                         \
+    traceCOUNT(TRACE_EVENT_ISR_ENTER);                                                               \
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxTraceSavedStatus);                                           \
+    ISR_STATS_ENTER(ucIsrNumber);                                                                    \
+}while(0)
+#else
+#define traceISR_ENTER( ucIsrNumber )
+#endif
+
+#if TRACE_ENABLED(TRACE_CATEGORY_ISRS)
+#define traceISR_EXIT( ucIsrNumber )                                                                 \
+do{                                                                                                  \
+    UBaseType_t uxTraceSavedStatus;                                                                  \
+    ISR_STATS_EXIT(ucIsrNumber);                                                                     \
+    uxTraceSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();                                          \
+    TRACE_RECORD(TRACE_EVENT_ISR_EXIT, ucIsrNumber, 0);                                              \
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxTraceSavedStatus);                                           \
+}while(0)
+#else
+#define traceISR_EXIT( ucIsrNumber )
+#endif
+
+/* heap_2 calls both hooks with the scheduler suspended, the heap is never used
+ * from interrupts so no mask is needed. The create hooks name the blocks
+ * allocated since the previous one */
+#define traceMALLOC( pvAddress, uiSize )       HEAP_Malloc( (pvAddress), (uint32)(uiSize) )
+#define traceFREE( pvAddress, uiSize )         HEAP_Free( (pvAddress), (uint32)(uiSize) )
+#define traceQUEUE_CREATE( pxNewQueue )        HEAP_ObjectCreated( (void *)(pxNewQueue), HEAP_OBJECT_QUEUE )
+#define traceEVENT_GROUP_CREATE( pxEventBits ) HEAP_ObjectCreated( (void *)(pxEventBits), HEAP_OBJECT_EVENT_GROUP )
+
+/* End-to-end latency probes placed along the application chains, usable from
+ * tasks and interrupt handlers alike */
+#if TRACE_ENABLED(TRACE_CATEGORY_PROBES)
+
+#define traceLATENCY_START( ucChain )                                                                \
+do{                                                                                                  \
+    UBaseType_t uxTraceSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();                              \
+    LAT_Start(ucChain);                                                                              \
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxTraceSavedStatus);                                           \
+}while(0)
+
+#define traceLATENCY_PROBE( ucChain, ucHop )                                                         \
+do{                                                                                                  \
+    UBaseType_t uxTraceSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();                              \
+    LAT_Probe(ucChain, ucHop);                                                                       \
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxTraceSavedStatus);                                           \
+}while(0)
+
+#define traceLATENCY_PROBE_SENT( ucChain, ucHop )                                                    \
+do{                                                                                                  \
+    UBaseType_t uxTraceSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();                              \
+    LAT_ProbeSent(ucChain, ucHop);                                                                   \
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxTraceSavedStatus);                                           \
+}while(0)
+
+#define traceLATENCY_PROBE_RECEIVED( ucChain, ucHop )                                                \
+do{                                                                                                  \
+    UBaseType_t uxTraceSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();                              \
+    LAT_ProbeReceived(ucChain, ucHop);                                                               \
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxTraceSavedStatus);                                           \
+}while(0)
+
+/* The chain items are counted on the driver intensity queue */
+#define traceLATENCY_ITEM_SENT( pxQueue )                                                            \
+    if((pxQueue)->uxQueueNumber == LAT_QUEUE_NUMBER) { LAT_ItemSent(); }
+#define traceLATENCY_ITEM_RECEIVED( pxQueue )                                                        \
+    if((pxQueue)->uxQueueNumber == LAT_QUEUE_NUMBER) { LAT_ItemReceived(); }
+
+#else
+
+#define traceLATENCY_START( ucChain )
+#define traceLATENCY_PROBE( ucChain, ucHop )
+#define traceLATENCY_PROBE_SENT( ucChain, ucHop )
+#define traceLATENCY_PROBE_RECEIVED( ucChain, ucHop )
+#define traceLATENCY_ITEM_SENT( pxQueue )
+#define traceLATENCY_ITEM_RECEIVED( pxQueue )
+
+#endif /* TRACE_CATEGORY_PROBES */
+
+/* Sensor samples and button edges recorded by the application handlers for
+ * the host replay, masked like the latency probes */
+#if RECORDER_ENABLED
+#define traceRECORD_INPUT( ucEvent, ucId, usArg )                                                    \
+do{                                                                                                  \
+    UBaseType_t uxTraceSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();                              \
+    REC_Record(ucEvent, ucId, usArg);                                                                \
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxTraceSavedStatus);                                           \
+}while(0)
+#else
+#define traceRECORD_INPUT( ucEvent, ucId, usArg )
+#endif
+
+/* Heater output levels written by the heater tasks, for the energy accounting */
+#if ENERGY_ENABLED
+#define traceHEATER_LEVEL( ucSeat, ucLevel )          ENERGY_HeaterLevel(ucSeat, ucLevel)
+#else
+#define traceHEATER_LEVEL( ucSeat, ucLevel )
+#endif
+
+#define traceQUEUE_TRACE_ARG( pxQueue )     ( ((pxQueue)->ucQueueType << 8) | (uint8)((pxQueue)->uxMessagesWaiting) )
+
+/* Only the numbered semaphores and mutexes feed the lock statistics, the timer
+ * queue keeps the default queue number 0 but is a plain queue */
+#define traceQUEUE_IS_LOCK( pxQueue )       ( ((pxQueue)->uxQueueNumber < LOCK_COUNT) && ((pxQueue)->ucQueueType != queueQUEUE_TYPE_BASE) )
+
+/* The data queues numbered after the locks keep their peak depth */
+#define traceQUEUE_IS_DATA( pxQueue )       ( ((pxQueue)->uxQueueNumber - QSTATS_FIRST_QUEUE < QSTATS_COUNT) && ((pxQueue)->ucQueueType == queueQUEUE_TYPE_BASE) )
+
+#if TRACE_ENABLED(TRACE_CATEGORY_QUEUES)
+#define traceLOCK( pxQueue, LockFun )                                                                \
+    if(traceQUEUE_IS_LOCK(pxQueue)) { LockFun((uint8)(pxQueue)->uxQueueNumber); }
+#define traceQUEUE_DEPTH( pxQueue )                                                                  \
+    if(traceQUEUE_IS_DATA(pxQueue)) { QSTATS_Sent((uint8)((pxQueue)->uxQueueNumber - QSTATS_FIRST_QUEUE), (pxQueue)->uxMessagesWaiting, (pxQueue)->uxLength); }
+#define traceQUEUE_FULL( pxQueue )                                                                   \
+    if(traceQUEUE_IS_DATA(pxQueue)) { QSTATS_Full((uint8)((pxQueue)->uxQueueNumber - QSTATS_FIRST_QUEUE)); }
+#else
+#define traceLOCK( pxQueue, LockFun )
+#define traceQUEUE_DEPTH( pxQueue )
+#define traceQUEUE_FULL( pxQueue )
+#endif
+
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )                                                    \
+do{                                                                                                  \
+    traceLOCK(pxQueue, LOCK_TakeBlocked);                                                            \
+}while(0)
 
-#define traceTASK_SWITCHED_IN()                                    \
-do{                                                                \
-    uint32 taskInTag = (uint32)(pxCurrentTCB->pxTaskTag);          \
-    ullTasksInTime[taskInTag] = GPTM_WTimer0Read();                \
-}while(0);
+#define traceQUEUE_RECEIVE( pxQueue )                                                                \
+do{                                                                                                  \
+    traceRECORD_QUEUES(TRACE_EVENT_QUEUE_RECEIVE, (pxQueue)->uxQueueNumber, traceQUEUE_TRACE_ARG(pxQueue)); \
+    traceCOUNT(TRACE_EVENT_QUEUE_RECEIVE);                                                           \
+    traceLOCK(pxQueue, LOCK_Taken);                                                                  \
+    traceLATENCY_ITEM_RECEIVED(pxQueue);                                                             \
+}while(0)
 
-#define traceTASK_SWITCHED_OUT()                                                                     \
+#define traceQUEUE_RECEIVE_FAILED( pxQueue )                                                         \
 do{                                                                                                  \
-    uint32 taskOutTag = (uint32)(pxCurrentTCB->pxTaskTag);                                           \
-        ullTasksOutTime[taskOutTag] = GPTM_WTimer0Read();                                            \
-        ullTasksExecutionTime[taskOutTag] += ullTasksOutTime[taskOutTag] - ullTasksInTime[taskOutTag];   \
-}while(0);
+    traceLOCK(pxQueue, LOCK_TakeFailed);                                                             \
+}while(0)
 
-extern uint32 ullSmphrGiveTime[6];
-extern uint32 ullSmphrTakeTime[6];
-extern uint32 ullSmphrAquireTime[6];
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )                                                       \
+do{                                                                                                  \
+    traceRECORD_QUEUES(TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR, (pxQueue)->uxQueueNumber, traceQUEUE_TRACE_ARG(pxQueue)); \
+    traceCOUNT(TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR);                                                  \
+}while(0)
 
-#define traceQUEUE_RECEIVE( pxQueue )                   \
-do{                                                     \
-    uint32 SmphrNumber = pxQueue->uxQueueNumber;        \
-    ullSmphrTakeTime[SmphrNumber] = GPTM_WTimer0Read(); \
-}while(0);
+#define traceQUEUE_SEND( pxQueue )                                                                   \
+do{                                                                                                  \
+    traceRECORD_QUEUES(TRACE_EVENT_QUEUE_SEND, (pxQueue)->uxQueueNumber, traceQUEUE_TRACE_ARG(pxQueue)); \
+    traceCOUNT(TRACE_EVENT_QUEUE_SEND);                                                              \
+    traceLOCK(pxQueue, LOCK_Given);                                                                  \
+    traceQUEUE_DEPTH(pxQueue);                                                                       \
+    traceLATENCY_ITEM_SENT(pxQueue);                                                                 \
+}while(0)
+
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )                                                          \
+do{                                                                                                  \
+    traceRECORD_QUEUES(TRACE_EVENT_QUEUE_SEND_FROM_ISR, (pxQueue)->uxQueueNumber, traceQUEUE_TRACE_ARG(pxQueue)); \
+    traceCOUNT(TRACE_EVENT_QUEUE_SEND_FROM_ISR);                                                     \
+    traceLOCK(pxQueue, LOCK_Given);                                                                  \
+    traceQUEUE_DEPTH(pxQueue);                                                                       \
+}while(0)
+
+/* A full queue stalls its sender (or drops the item with no wait), a given
+ * binary semaphore that was not taken yet drops the give the same way */
+#define traceQUEUE_FULL_HOOK( pxQueue )                                                              \
+do{                                                                                                  \
+    traceCOUNT(TRACE_EVENT_QUEUE_SEND_FULL);                                                         \
+    traceQUEUE_FULL(pxQueue);                                                                        \
+}while(0)
+
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )      traceQUEUE_FULL_HOOK( pxQueue )
+#define traceQUEUE_SEND_FAILED( pxQueue )           traceQUEUE_FULL_HOOK( pxQueue )
+#define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )  traceQUEUE_FULL_HOOK( pxQueue )
+
+/* The buttons set their event group bits from the interrupts through the timer
+ * task. A set finding every bit still set merges with the event before it, a
+ * full timer command queue drops it. The set hook reads the bits of the group
+ * it is given through StaticEventGroup_t, the public mirror of the group: its
+ * first word is uxEventBits in FreeRTOS V10.5.1, which main.c checks. */
+#if TRACE_ENABLED(TRACE_CATEGORY_COUNTERS)
+#define traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet )                               \
+    traceCOUNT(TRACE_EVENT_GROUP_SET_FROM_ISR)
+#define traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet )                                        \
+do{                                                                                                  \
+    if((((StaticEventGroup_t *)(xEventGroup))->xDummy1 & (uxBitsToSet)) == (uxBitsToSet))            \
+    {                                                                                                \
+        traceCOUNT(TRACE_EVENT_GROUP_SET_COALESCED);                                                 \
+    }                                                                                                \
+}while(0)
+#define tracePEND_FUNC_CALL_FROM_ISR( xFunctionToPend, pvParameter1, ulParameter2, xReturn )        \
+do{                                                                                                  \
+    if((xReturn) != pdPASS)                                                                          \
+    {                                                                                                \
+        traceCOUNT(TRACE_EVENT_PEND_CALL_FAILED);                                                    \
+    }                                                                                                \
+}while(0)
+#endif
 
-#define traceQUEUE_SEND( pxQueue )                      \
-do{                                                     \
-    uint32 SmphrNumber = pxQueue->uxQueueNumber;        \
-    ullSmphrGiveTime[SmphrNumber] = GPTM_WTimer0Read(); \
-    ullSmphrAquireTime[SmphrNumber] = ullSmphrGiveTime[SmphrNumber]-ullSmphrTakeTime[SmphrNumber]; \
-}while(0);
 #endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,94 @@
+ /******************************************************************************
+ *
+ * Module: DMA
+ *
+ * File Name: dma.c
+ *
+ * Description: Source file for the TM4C123GH6PM uDMA driver.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "dma.h"
+#include "tm4c123gh6pm_registers.h"
+
+/* The engine needs the table on a 1024 byte boundary; the alternate half
+ * that would follow the primary structures is never used */
+static DmaControl DmaControlTable[DMA_CHANNELS] __attribute__((aligned(1024)));
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void DMA_Init(void)
+{
+    SYSCTL_RCGCDMA_REG |= 0x01;
+    while(!(SYSCTL_PRDMA_REG & 0x01));
+
+    UDMA_CFG_REG = DMA_CFG_MASTEN_MASK;
+    UDMA_CTLBASE_REG = DMA_BUS_ADDRESS(DmaControlTable);
+}
+
+void DMA_AssignChannel(uint8 ucChannel, uint8 ucEncoding)
+{
+    uint32 uShift = (ucChannel % 8) * 4;
+    uint32 uMap = (uint32)(ucEncoding & 0xF) << uShift;
+
+    switch(ucChannel / 8)
+    {
+    case 0:
+        UDMA_CHMAP0_REG = (UDMA_CHMAP0_REG & ~(0xFUL << uShift)) | uMap;
+        break;
+    case 1:
+        UDMA_CHMAP1_REG = (UDMA_CHMAP1_REG & ~(0xFUL << uShift)) | uMap;
+        break;
+    case 2:
+        UDMA_CHMAP2_REG = (UDMA_CHMAP2_REG & ~(0xFUL << uShift)) | uMap;
+        break;
+    default:
+        UDMA_CHMAP3_REG = (UDMA_CHMAP3_REG & ~(0xFUL << uShift)) | uMap;
+        break;
+    }
+
+    UDMA_ALTCLR_REG = (1UL << ucChannel);
+    UDMA_USEBURSTCLR_REG = (1UL << ucChannel);
+    UDMA_REQMASKCLR_REG = (1UL << ucChannel);
+    UDMA_PRIOCLR_REG = (1UL << ucChannel);
+}
+
+void DMA_StartMemoryToPeripheral(uint8 ucChannel, const uint8 *pSource, uint32 uDestination, uint16 usCount)
+{
+    DmaControl *pxControl = &DmaControlTable[ucChannel];
+
+    pxControl->SrcEnd = pSource + usCount - 1;
+    pxControl->DstEnd = (volatile void *)uDestination;
+    pxControl->Control = DMA_CHCTL_DSTINC_NONE | DMA_CHCTL_DSTSIZE_8 | DMA_CHCTL_SRCINC_8 | DMA_CHCTL_SRCSIZE_8 |
+                         DMA_CHCTL_ARBSIZE_4 | ((uint32)(usCount - 1) << DMA_CHCTL_XFERSIZE_BITS_POS) |
+                         DMA_CHCTL_XFERMODE_BASIC;
+
+    UDMA_ENASET_REG = (1UL << ucChannel);
+}
+
+boolean DMA_IsBusy(uint8 ucChannel)
+{
+    return (UDMA_ENASET_REG & (1UL << ucChannel)) ? TRUE : FALSE;
+}
+
+void DMA_ClearDone(uint8 ucChannel)
+{
+    UDMA_CHIS_REG = (1UL << ucChannel);
+}
+
+uint16 DMA_Stop(uint8 ucChannel)
+{
+    uint32 uControl;
+
+    UDMA_ENACLR_REG = (1UL << ucChannel);
+    uControl = DmaControlTable[ucChannel].Control;
+    if((uControl & DMA_CHCTL_XFERMODE_MASK) == 0)
+    {
+        return 0;   /* Stop mode, the engine moved the last item */
+    }
+    return (uint16)(((uControl & DMA_CHCTL_XFERSIZE_MASK) >> DMA_CHCTL_XFERSIZE_BITS_POS) + 1);
+}
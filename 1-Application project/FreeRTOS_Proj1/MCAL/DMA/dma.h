@@ -0,0 +1,86 @@
+ /******************************************************************************
+ *
+ * Module: DMA
+ *
+ * File Name: dma.h
+ *
+ * Description: Header file for the TM4C123GH6PM uDMA driver. Only the primary
+ *              control structures and the basic transfer mode are used: one
+ *              transfer of up to 1024 bytes from memory to a peripheral data
+ *              register, paced by the peripheral requests. The end of a
+ *              transfer raises the interrupt of the peripheral, whose handler
+ *              checks DMA_IsBusy() to tell it from its own sources.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MCAL_DMA_DMA_H_
+#define MCAL_DMA_DMA_H_
+
+#include "std_types.h"
+
+#define DMA_CHANNELS                 32
+#define DMA_MAX_TRANSFER             1024
+
+/* Channel 9 with encoding 0 is the UART0 transmit request */
+#define DMA_CHANNEL_UART0_TX         9
+#define DMA_ENCODING_UART0_TX        0
+
+#define DMA_CFG_MASTEN_MASK          0x00000001
+
+/* Channel control word fields */
+#define DMA_CHCTL_DSTINC_NONE        0xC0000000
+#define DMA_CHCTL_DSTSIZE_8          0x00000000
+#define DMA_CHCTL_SRCINC_8           0x00000000
+#define DMA_CHCTL_SRCSIZE_8          0x00000000
+#define DMA_CHCTL_ARBSIZE_4          0x00008000
+#define DMA_CHCTL_XFERSIZE_BITS_POS  4
+#define DMA_CHCTL_XFERSIZE_MASK      0x00003FF0
+#define DMA_CHCTL_XFERMODE_MASK      0x00000007
+#define DMA_CHCTL_XFERMODE_BASIC     0x00000001
+
+/* Bus address of a memory object as the engine sees it */
+#ifndef DMA_BUS_ADDRESS
+#define DMA_BUS_ADDRESS(pvObject)    ((uint32)(pvObject))
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Channel control structure, the end pointers are the addresses of the last
+ * item of the source and destination */
+typedef struct
+{
+    const volatile void *SrcEnd;
+    volatile void *DstEnd;
+    volatile uint32 Control;
+    uint32 Unused;
+} DmaControl;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Clock the engine, enable it and give it the control table */
+void DMA_Init(void);
+
+/* Route the requests of ucEncoding to the channel, with the primary control
+ * structure, single and burst requests and the default priority */
+void DMA_AssignChannel(uint8 ucChannel, uint8 ucEncoding);
+
+/* Send usCount bytes (1 .. DMA_MAX_TRANSFER) from pSource to the peripheral
+ * register at uDestination. pSource must stay valid until the end. */
+void DMA_StartMemoryToPeripheral(uint8 ucChannel, const uint8 *pSource, uint32 uDestination, uint16 usCount);
+
+/* A started channel stays enabled until its last item is moved */
+boolean DMA_IsBusy(uint8 ucChannel);
+
+/* Clear the completion status of the channel */
+void DMA_ClearDone(uint8 ucChannel);
+
+/* Disable the channel and return the number of items it had still to move */
+uint16 DMA_Stop(uint8 ucChannel);
+
+#endif /* MCAL_DMA_DMA_H_ */
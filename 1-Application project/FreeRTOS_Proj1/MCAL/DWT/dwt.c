@@ -0,0 +1,26 @@
+ /******************************************************************************
+ *
+ * Module: DWT
+ *
+ * File Name: dwt.c
+ *
+ * Description: Source file for the Cortex-M4 DWT cycle counter driver
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "dwt.h"
+#include "tm4c123gh6pm_registers.h"
+
+void DWT_CycleCounterInit(void)
+{
+    CORE_DEMCR_REG |= DWT_DEMCR_TRCENA_MASK;   /* Enable the DWT unit */
+    DWT_CYCCNT_REG = 0;                        /* Start counting from zero */
+    DWT_CTRL_REG   |= DWT_CTRL_CYCCNTENA_MASK; /* Enable the cycle counter */
+}
+
+uint32 DWT_CycleCounterRead(void)
+{
+    return DWT_CYCCNT_REG;
+}
@@ -0,0 +1,26 @@
+ /******************************************************************************
+ *
+ * Module: DWT
+ *
+ * File Name: dwt.h
+ *
+ * Description: Header file for the Cortex-M4 DWT cycle counter driver
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MCAL_DWT_DWT_H_
+#define MCAL_DWT_DWT_H_
+
+#include "std_types.h"
+
+#define DWT_DEMCR_TRCENA_MASK       0x01000000
+#define DWT_CTRL_CYCCNTENA_MASK     0x00000001
+
+/* Enable the free running core clock counter (one count per CPU cycle, wraps every 2^32 cycles) */
+void DWT_CycleCounterInit(void);
+
+uint32 DWT_CycleCounterRead(void);
+
+#endif /* MCAL_DWT_DWT_H_ */
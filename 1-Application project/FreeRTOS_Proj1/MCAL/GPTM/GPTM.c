@@ -14,11 +14,12 @@
 
 void GPTM_WTimer0Init(void)
 {
-    /* Configure one shot down 32bit timer with tick time = 0.1msec */
+    /* Configure periodic down 32bit timer with tick time = 0.1msec, it wraps every ~119 hours */
     SYSCTL_RCGCWTIMER_REG |= (1<<0);  /* Enable clock WTimer0 in run mode */
     WTIMER0_CTL_REG = 0;              /* Disable WTimer0 output */
     WTIMER0_CFG_REG = 0x04;           /* Select 32-bit configuration option */
-    WTIMER0_TAMR_REG = 0x01;          /* Select one-shot down counter mode of WTimer0A */
+    WTIMER0_TAMR_REG = 0x02;          /* Select periodic down counter mode of WTimer0A */
+    WTIMER0_TAILR_REG = 0xFFFFFFFF;   /* Count the full 32-bit range before reloading */
     WTIMER0_TAPR_REG = 1600 -1;       /* Set the prescaler for WTimer0A */
     WTIMER0_CTL_REG |= (0x01);        /* Enable WTimer0A module */
 }
@@ -4,15 +4,107 @@
  *
  * File Name: uart0.c
  *
- * Description: Source file for the TM4C123GH6PM UART0 driver
+ * Description: Source file for the TM4C123GH6PM UART0 driver. Transmission is
+ *              interrupt driven: the writers copy their bytes to a ring
+ *              buffer and the UART0 interrupt moves them to the 16 byte
+ *              transmit FIFO each time it runs low. Bulk output can instead
+ *              be handed to uDMA channel 9 as a list of buffers sent in
+ *              place, one interrupt per buffer (or per 1024 bytes).
  *
  * Author: Edges for Training Team
  *
  *******************************************************************************/
 
+#include <string.h>
 #include "uart0.h"
+#include "dma.h"
 #include "tm4c123gh6pm_registers.h"
 
+/* Bus address of UARTDR, the fixed destination of the transmit channel */
+#define UART0_DR_ADDRESS         0x4000C000UL
+
+#define UART0_DMA_IDLE           0
+#define UART0_DMA_QUEUED         1      /* Waiting for the ring bytes written before the list */
+#define UART0_DMA_ACTIVE         2
+
+#define UART0_TX_BUFFER_MASK     (UART0_TX_BUFFER_SIZE - 1UL)
+
+/* The writers keep UART0_Handler out of the ring and the list state with its
+ * NVIC line: the end of a uDMA transfer reaches the handler whatever UARTIM */
+#define UART0_NVIC_BIT           (1UL << 5)
+#define UART0_LOCK()             do { NVIC_DIS0_REG = UART0_NVIC_BIT; __DSB(); __ISB(); } while(0)
+#define UART0_UNLOCK()           (NVIC_EN0_REG = UART0_NVIC_BIT)
+
+/* The disable must reach the NVIC before the next access to the ring, or a
+ * UART0 interrupt already on its way is still taken after the write */
+#ifndef __DSB
+#define __DSB()                  __asm(" dsb")
+#endif
+#ifndef __ISB
+#define __ISB()                  __asm(" isb")
+#endif
+
+#if (UART0_TX_BUFFER_SIZE & (UART0_TX_BUFFER_SIZE - 1)) != 0
+#error "UART0_TX_BUFFER_SIZE must be a power of two"
+#endif
+
+/* Baud rate divisor with its 6 fraction bits, IBRD:FBRD, for uSamples system
+ * clocks per bit sample (16, or 8 in high-speed mode), rounded to the nearest */
+#define UART0_BAUD_DIVISOR(uSamples) \
+    (((128ULL * UART0_SYSTEM_CLOCK_HZ) / ((uSamples) * UART0_BAUD_RATE) + 1) / 2)
+
+/* Error of the rate this divisor gives, in ppm of UART0_BAUD_RATE */
+#define UART0_BAUD_ERROR_PPM(uSamples) \
+    ((((64ULL * UART0_SYSTEM_CLOCK_HZ) > ((uSamples) * UART0_BAUD_RATE * UART0_BAUD_DIVISOR(uSamples))) ? \
+      ((64ULL * UART0_SYSTEM_CLOCK_HZ) - ((uSamples) * UART0_BAUD_RATE * UART0_BAUD_DIVISOR(uSamples))) : \
+      (((uSamples) * UART0_BAUD_RATE * UART0_BAUD_DIVISOR(uSamples)) - (64ULL * UART0_SYSTEM_CLOCK_HZ))) * \
+     1000000ULL / ((uSamples) * UART0_BAUD_RATE * UART0_BAUD_DIVISOR(uSamples)))
+
+/* High-speed mode when the rate needs it, or when its finer divisor comes
+ * closer to the rate than 16 samples per bit do */
+#ifndef UART0_HIGH_SPEED
+#if UART0_BAUD_DIVISOR(16) < 64
+#define UART0_HIGH_SPEED         1
+#elif (UART0_BAUD_DIVISOR(8) <= 0x3FFFFF) && (UART0_BAUD_ERROR_PPM(8) < UART0_BAUD_ERROR_PPM(16))
+#define UART0_HIGH_SPEED         1
+#else
+#define UART0_HIGH_SPEED         0
+#endif
+#endif
+
+#if UART0_HIGH_SPEED
+#define UART0_BAUD_SAMPLES       8
+#else
+#define UART0_BAUD_SAMPLES       16
+#endif
+
+#if UART0_BAUD_DIVISOR(UART0_BAUD_SAMPLES) < 64
+#error "UART0_BAUD_RATE is above the system clock / 8 (or / 16 without high-speed mode)"
+#elif UART0_BAUD_DIVISOR(UART0_BAUD_SAMPLES) > 0x3FFFFF
+#error "UART0_BAUD_RATE is too low for the 16-bit integer divisor at this system clock"
+#elif UART0_BAUD_ERROR_PPM(UART0_BAUD_SAMPLES) > UART0_BAUD_TOLERANCE_PPM
+#error "UART0_BAUD_RATE cannot be reached within UART0_BAUD_TOLERANCE_PPM from this system clock"
+#endif
+
+#define UART0_IBRD               ((uint32)(UART0_BAUD_DIVISOR(UART0_BAUD_SAMPLES) >> 6))
+#define UART0_FBRD               ((uint32)(UART0_BAUD_DIVISOR(UART0_BAUD_SAMPLES) & 0x3F))
+
+/* Free running indexes, the ring holds Uart0TxHead - Uart0TxTail bytes */
+static uint8 Uart0TxBuffer[UART0_TX_BUFFER_SIZE];
+static volatile uint32 Uart0TxHead = 0;     /* Moved by the writer */
+static volatile uint32 Uart0TxTail = 0;     /* Moved by the interrupt, or by the writer with it locked out */
+static Uart0TxPolicy Uart0TxFullPolicy = UART0_TX_DEFAULT_POLICY;
+static uint32 Uart0TxTimeoutCycles = UART0_TX_DEFAULT_TIMEOUT_MS * (UART0_SYSTEM_CLOCK_HZ / 1000UL);
+static uint32 Uart0TxDropped = 0;
+static Uart0TxWaitFun Uart0TxWait = NULL_PTR;
+
+static const Uart0TxSegment *Uart0DmaSegments;
+static uint8 Uart0DmaCount = 0;
+static uint8 Uart0DmaIndex = 0;
+static uint32 Uart0DmaSent = 0;             /* Bytes of the current segment handed to the channel */
+static uint32 Uart0DmaAfter = 0;            /* Ring head when the list was queued */
+static volatile uint8 Uart0DmaState = UART0_DMA_IDLE;
+
 /*******************************************************************************
  *                         Private Functions Definitions                       *
  *******************************************************************************/
@@ -31,11 +123,80 @@ static void GPIO_SetupUART0Pins(void)
     GPIO_PORTA_DEN_REG   |= 0x03;         /* Enable Digital I/O on PA0 & PA1 */
 }
 
+/* Start the transfer of the next piece of the list, FALSE at its end */
+static boolean UART0_DmaNext(void)
+{
+    uint32 uLeft;
+
+    while(Uart0DmaIndex < Uart0DmaCount)
+    {
+        uLeft = Uart0DmaSegments[Uart0DmaIndex].uLength - Uart0DmaSent;
+        if(uLeft != 0)
+        {
+            if(uLeft > DMA_MAX_TRANSFER)
+            {
+                uLeft = DMA_MAX_TRANSFER;
+            }
+            DMA_StartMemoryToPeripheral(DMA_CHANNEL_UART0_TX, Uart0DmaSegments[Uart0DmaIndex].pData + Uart0DmaSent,
+                                        UART0_DR_ADDRESS, (uint16)uLeft);
+            Uart0DmaSent += uLeft;
+            return TRUE;
+        }
+        Uart0DmaIndex++;
+        Uart0DmaSent = 0;
+    }
+    return FALSE;
+}
+
+/* Move the bytes of the ring to the transmit FIFO until it is full. The ring
+ * waits while a list is sent, and a queued list starts once the bytes written
+ * before it are in the FIFO. */
+static void UART0_TxFill(void)
+{
+    uint32 uEnd = (Uart0DmaState == UART0_DMA_IDLE) ? Uart0TxHead : Uart0DmaAfter;
+
+    if(Uart0DmaState == UART0_DMA_ACTIVE)
+    {
+        return;
+    }
+    while((Uart0TxTail != uEnd) && !(UART0_FR_REG & UART_FR_TXFF_MASK))
+    {
+        UART0_DR_REG = Uart0TxBuffer[Uart0TxTail & UART0_TX_BUFFER_MASK];
+        Uart0TxTail++;
+    }
+    if((Uart0DmaState == UART0_DMA_QUEUED) && (Uart0TxTail == uEnd))
+    {
+        Uart0DmaState = UART0_DmaNext() ? UART0_DMA_ACTIVE : UART0_DMA_IDLE;
+    }
+}
+
+/* Copy as many bytes as the ring has room for, in at most two pieces */
+static uint32 UART0_TxCopy(const uint8 *pData, uint32 uLength)
+{
+    uint32 uFree = UART0_TX_BUFFER_SIZE - (Uart0TxHead - Uart0TxTail);
+    uint32 uStart = Uart0TxHead & UART0_TX_BUFFER_MASK;
+    uint32 uFirst;
+
+    if(uLength > uFree)
+    {
+        uLength = uFree;
+    }
+    uFirst = UART0_TX_BUFFER_SIZE - uStart;
+    if(uFirst > uLength)
+    {
+        uFirst = uLength;
+    }
+    memcpy(&Uart0TxBuffer[uStart], pData, uFirst);
+    memcpy(&Uart0TxBuffer[0], pData + uFirst, uLength - uFirst);
+    Uart0TxHead += uLength;
+    return uLength;
+}
+
 /*******************************************************************************
  *                         Public Functions Definitions                        *
  *******************************************************************************/
 
-void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1 stop bit and 9600BPS */
+void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1 stop bit and UART0_BAUD_RATE */
 {
     /* Setup UART0 pins PA0 --> U0RX & PA1 --> U0TX */
     GPIO_SetupUART0Pins();
@@ -47,34 +208,219 @@ void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1
 
     UART0_CC_REG  = 0;                    /* Use System Clock*/
     
-    /* To Configure UART0 with Baud Rate 9600 */
-    UART0_IBRD_REG = 104;
-    UART0_FBRD_REG = 11;
+    /* To Configure UART0 with Baud Rate UART0_BAUD_RATE, 208 + 21/64 in high-speed mode for 9600 at 16 MHz */
+    UART0_IBRD_REG = UART0_IBRD;
+    UART0_FBRD_REG = UART0_FBRD;
     
     /* UART Line Control Register Settings
      * BRK = 0 Normal Use
      * PEN = 0 Disable Parity
      * EPS = 0 No affect as the parity is disabled
      * STP2 = 0 1-stop bit at end of the frame
-     * FEN = 0 FIFOs are disabled
+     * FEN = 1 FIFOs are enabled, 16 bytes each
      * WLEN = 0x3 8-bits data frame
      * SPS = 0 no stick parity
      */
-    UART0_LCRH_REG = (UART_DATA_8BITS << UART_LCRH_WLEN_BITS_POS);
+    UART0_LCRH_REG = (UART_DATA_8BITS << UART_LCRH_WLEN_BITS_POS) | UART_LCRH_FEN_MASK;
+
+    /* Transmit interrupt when the FIFO falls to 1/8 full, the receive level is left at its reset value */
+    UART0_IFLS_REG = (UART0_IFLS_REG & ~0x7UL) | UART_IFLS_TX1_8;
+    Uart0TxHead = 0;
+    Uart0TxTail = 0;
+    UART0_ICR_REG = UART_ICR_TXIC_MASK;
+    UART0_IM_REG  = UART_IM_TXIM_MASK;
+
+    NVIC_PRI1_REG = (NVIC_PRI1_REG & UART0_PRIORITY_MASK) | (UART0_INTERRUPT_PRIORITY<<UART0_PRIORITY_BITS_POS);
+    UART0_UNLOCK();            /* Enable NVIC Interrupt for UART0 by set bit number 5 in EN0 Register */
     
     /* UART Control Register Settings
      * RXE = 1 Enable UART Receive
      * TXE = 1 Enable UART Transmit
-     * HSE = 0 The UART is clocked using the system clock divided by 16
+     * HSE = UART0_HIGH_SPEED The UART is clocked using the system clock divided by 16, or 8 in high-speed mode
      * UARTEN = 1 Enable UART
      */
-    UART0_CTL_REG = UART_CTL_UARTEN_MASK | UART_CTL_TXE_MASK | UART_CTL_RXE_MASK;
+    UART0_CTL_REG = UART_CTL_UARTEN_MASK | UART_CTL_TXE_MASK | UART_CTL_RXE_MASK |
+                    (UART0_HIGH_SPEED ? UART_CTL_HSE_MASK : 0);
 }
        
+uint32 UART0_Write(const uint8 *pData, uint32 uLength)
+{
+    uint32 uQueued = 0;
+    uint32 uCopied;
+    uint32 uExcess;
+    uint32 uUsed;
+    uint32 uMovable;
+    uint32 uWaitStart = 0;
+    uint32 uWaited;
+    boolean bWaiting = FALSE;
+
+    UART0_LOCK(); /* The interrupt leaves the ring alone meanwhile */
+
+    if(Uart0TxFullPolicy == UART0_TX_OVERWRITE)
+    {
+        /* Only the end of a write larger than the ring can be kept */
+        if(uLength > UART0_TX_BUFFER_SIZE)
+        {
+            uExcess = uLength - UART0_TX_BUFFER_SIZE;
+            pData += uExcess;
+            uLength = UART0_TX_BUFFER_SIZE;
+            Uart0TxDropped += uExcess;
+        }
+        /* Then the oldest bytes not in the FIFO yet make room for it. With a
+         * list not done, only those written before the list may go: the list
+         * starts when the tail reaches them, and what still does not fit is
+         * dropped below */
+        uUsed = Uart0TxHead - Uart0TxTail;
+        if(uLength > UART0_TX_BUFFER_SIZE - uUsed)
+        {
+            uExcess = uLength - (UART0_TX_BUFFER_SIZE - uUsed);
+            uMovable = (Uart0DmaState == UART0_DMA_IDLE) ? uUsed : (Uart0DmaAfter - Uart0TxTail);
+            if(uExcess > uMovable)
+            {
+                uExcess = uMovable;
+            }
+            Uart0TxTail += uExcess;
+            Uart0TxDropped += uExcess;
+        }
+    }
+
+    for(;;)
+    {
+        uCopied = UART0_TxCopy(pData + uQueued, uLength - uQueued);
+        uQueued += uCopied;
+        UART0_TxFill();
+        if((uQueued == uLength) || (Uart0TxFullPolicy != UART0_TX_BLOCK))
+        {
+            break;
+        }
+        /* The timeout counts from the last byte that found room */
+        if((uCopied != 0) || !bWaiting)
+        {
+            uWaitStart = DWT_CYCCNT_REG;
+            bWaiting = TRUE;
+        }
+        uWaited = DWT_CYCCNT_REG - uWaitStart;
+        if(uWaited >= Uart0TxTimeoutCycles)
+        {
+            break;
+        }
+        /* Sleep until the interrupt moves the ring on, or let it in at once
+         * and send the ring here when the writer cannot sleep */
+        UART0_UNLOCK();
+        if(Uart0TxWait != NULL_PTR)
+        {
+            (void)Uart0TxWait((Uart0TxTimeoutCycles - uWaited) / (UART0_SYSTEM_CLOCK_HZ / 1000UL) + 1);
+        }
+        UART0_LOCK();
+    }
+
+    UART0_UNLOCK();
+    Uart0TxDropped += uLength - uQueued;
+    return uQueued;
+}
+
+void UART0_SetTxPolicy(Uart0TxPolicy ePolicy, uint32 uTimeoutMs)
+{
+    Uart0TxFullPolicy = ePolicy;
+    Uart0TxTimeoutCycles = uTimeoutMs * (UART0_SYSTEM_CLOCK_HZ / 1000UL);
+}
+
+void UART0_SetTxWait(Uart0TxWaitFun pWaitFun)
+{
+    Uart0TxWait = pWaitFun;
+}
+
+uint32 UART0_GetTxDropped(void)
+{
+    return Uart0TxDropped;
+}
+
+uint8 UART0_TxInterrupt(void)
+{
+    uint8 ucEvents = 0;
+    uint32 uTail = Uart0TxTail;
+
+    UART0_ICR_REG = UART_ICR_TXIC_MASK; /* Cleared first, a fall below the level while filling raises it again */
+    if((Uart0DmaState == UART0_DMA_ACTIVE) && !DMA_IsBusy(DMA_CHANNEL_UART0_TX))
+    {
+        DMA_ClearDone(DMA_CHANNEL_UART0_TX);
+        if(!UART0_DmaNext())
+        {
+            Uart0DmaState = UART0_DMA_IDLE;
+            ucEvents |= UART0_TX_EVENT_LIST_DONE;
+        }
+    }
+    UART0_TxFill();
+    if(Uart0TxTail != uTail)
+    {
+        ucEvents |= UART0_TX_EVENT_ROOM;
+    }
+    return ucEvents;
+}
+
+void UART0_InitDma(void)
+{
+    DMA_AssignChannel(DMA_CHANNEL_UART0_TX, DMA_ENCODING_UART0_TX);
+    UART0_DMACTL_REG |= UART_DMACTL_TXDMAE_MASK;
+}
+
+boolean UART0_WriteDma(const Uart0TxSegment *pSegments, uint8 ucCount)
+{
+    boolean bQueued = FALSE;
+
+    UART0_LOCK(); /* The interrupt leaves the list alone meanwhile */
+    if((Uart0DmaState == UART0_DMA_IDLE) && (ucCount != 0))
+    {
+        Uart0DmaSegments = pSegments;
+        Uart0DmaCount = ucCount;
+        Uart0DmaIndex = 0;
+        Uart0DmaSent = 0;
+        Uart0DmaAfter = Uart0TxHead;
+        Uart0DmaState = UART0_DMA_QUEUED;
+        UART0_TxFill();     /* Starts the list at once when the ring is empty */
+        bQueued = TRUE;
+    }
+    UART0_UNLOCK();
+    return bQueued;
+}
+
+boolean UART0_IsDmaBusy(void)
+{
+    return (Uart0DmaState != UART0_DMA_IDLE) ? TRUE : FALSE;
+}
+
+uint32 UART0_AbortDma(void)
+{
+    uint32 uHanded = 0;
+    uint8 ucIndex;
+
+    UART0_LOCK();
+    if(Uart0DmaState == UART0_DMA_ACTIVE)
+    {
+        for(ucIndex = 0; ucIndex < Uart0DmaIndex; ucIndex++)
+        {
+            uHanded += Uart0DmaSegments[ucIndex].uLength;
+        }
+        uHanded += Uart0DmaSent - DMA_Stop(DMA_CHANNEL_UART0_TX);
+        DMA_ClearDone(DMA_CHANNEL_UART0_TX);
+    }
+    if(Uart0DmaState != UART0_DMA_IDLE)
+    {
+        Uart0DmaState = UART0_DMA_IDLE;
+        UART0_TxFill();     /* The ring held back behind the list */
+    }
+    UART0_UNLOCK();
+    return uHanded;
+}
+
 void UART0_SendByte(uint8 data)
 {
-    while(!(UART0_FR_REG & UART_FR_TXFE_MASK)); /* Wait until the transmit FIFO is empty */
-    UART0_DR_REG = data; /* Send the byte */
+    (void)UART0_Write(&data, 1);
+}
+
+boolean UART0_IsDataAvailable(void)
+{
+    return (UART0_FR_REG & UART_FR_RXFE_MASK) ? FALSE : TRUE; /* Receive FIFO is not empty */
 }
 
 uint8 UART0_ReceiveByte(void)
@@ -85,39 +431,46 @@ uint8 UART0_ReceiveByte(void)
 
 void UART0_SendString(const uint8 *pData)
 {
-    uint32 uCounter =0;
-	/* Transmit the whole string */
-    while(pData[uCounter] != '\0')
-    {
-        UART0_SendByte(pData[uCounter]); /* Send the byte */
-        uCounter++; /* increment the counter to the next byte */
-    }
+	/* Transmit the whole string in one copy */
+    (void)UART0_Write(pData, strlen((const char *)pData));
 }
 
-void UART0_SendInteger(sint64 sNumber)
+uint8 UART0_FormatInteger(sint64 sNumber, uint8 *pDigits)
 {
+    uint8 uDigits[UART0_INTEGER_DIGITS];
+    uint8 uCounter = sizeof(uDigits);
+    boolean bNegative = FALSE;
+    uint64 uNumber = (uint64)sNumber;
 
-    uint8 uDigits[20];
-    sint8 uCounter = 0;
-
-    /* Send the negative sign in case of negative numbers */
+    /* Send the negative sign in case of negative numbers. The magnitude is
+     * taken unsigned, negating INT64_MIN as an sint64 would overflow */
     if (sNumber < 0)
     {
-        UART0_SendByte('-');
-        sNumber *= -1;
+        bNegative = TRUE;
+        uNumber = 0u - (uint64)sNumber;
     }
 
-    /* Convert the number to an array of characters */
+    /* Convert the number to an array of characters, filled from its end as the digits come from right to left */
     do
     {
-        uDigits[uCounter++] = sNumber % 10 + '0'; /* Convert each digit to its corresponding ASCI character */
-        sNumber /= 10; /* Remove the already converted digit */
+        uDigits[--uCounter] = (uint8)(uNumber % 10) + '0'; /* Convert each digit to its corresponding ASCI character */
+        uNumber /= 10; /* Remove the already converted digit */
     }
-    while (sNumber != 0);
+    while (uNumber != 0);
 
-    /* Send the array of characters in a reverse order as the digits were converted from right to left */
-    for( uCounter--; uCounter>= 0; uCounter--)
+    if (bNegative)
     {
-        UART0_SendByte(uDigits[uCounter]);
+        uDigits[--uCounter] = '-';
     }
+
+    memcpy(pDigits, &uDigits[uCounter], sizeof(uDigits) - uCounter);
+    return (uint8)(sizeof(uDigits) - uCounter);
+}
+
+void UART0_SendInteger(sint64 sNumber)
+{
+    uint8 uDigits[UART0_INTEGER_DIGITS];
+
+    /* Send the whole number in one copy */
+    (void)UART0_Write(uDigits, UART0_FormatInteger(sNumber, uDigits));
 }
@@ -24,10 +24,90 @@
 #define UART_DATA_8BITS          0x3
 #define UART_LCRH_WLEN_BITS_POS  5
 #define UART_CTL_UARTEN_MASK     0x00000001
+#define UART_CTL_HSE_MASK        0x00000020
 #define UART_CTL_TXE_MASK        0x00000100
 #define UART_CTL_RXE_MASK        0x00000200
 #define UART_FR_TXFE_MASK        0x00000080
+#define UART_FR_TXFF_MASK        0x00000020
 #define UART_FR_RXFE_MASK        0x00000010
+#define UART_LCRH_FEN_MASK       0x00000010
+#define UART_IFLS_TX1_8          0x00000000
+#define UART_IM_TXIM_MASK        0x00000020
+#define UART_ICR_TXIC_MASK       0x00000020
+#define UART_DMACTL_TXDMAE_MASK  0x00000002
+
+#define UART0_PRIORITY_MASK      0xFFFF1FFF
+#define UART0_PRIORITY_BITS_POS  13
+#define UART0_INTERRUPT_PRIORITY 7
+
+/* System clock the baud rate divisors and the transmit timeout are counted in,
+ * main.c checks it against configCPU_CLOCK_HZ */
+#ifndef UART0_SYSTEM_CLOCK_HZ
+#define UART0_SYSTEM_CLOCK_HZ    16000000UL
+#endif
+
+/* Baud rate of UART0, 8N1. The divisors are worked out from the system clock
+ * at compile time; 115200, 460800, 921600 and 1000000 are all in tolerance
+ * at 16 MHz */
+#ifndef UART0_BAUD_RATE
+#define UART0_BAUD_RATE          9600UL
+#endif
+
+/* Largest error of the rate the divisors give, in ppm, or the build fails.
+ * A frame of 10 bits is still sampled right with about 4% between both ends */
+#ifndef UART0_BAUD_TOLERANCE_PPM
+#define UART0_BAUD_TOLERANCE_PPM 10000UL
+#endif
+
+/* High-speed mode samples every bit 8 times instead of 16, which doubles the
+ * highest rate (system clock / 8) and makes the divisor finer. Left undefined
+ * it is used when the rate is out of reach without it or when its divisor
+ * gives the smaller error */
+/* #define UART0_HIGH_SPEED      1 */
+
+/* Transmit ring buffer, a power of two. The bytes written are copied here and
+ * sent by the UART0 interrupt, 14 at a time each time the hardware FIFO falls
+ * to 2 bytes (1/8 of its 16) */
+#ifndef UART0_TX_BUFFER_SIZE
+#define UART0_TX_BUFFER_SIZE     512
+#endif
+
+/* What a write does when the ring buffer is full, until UART0_SetTxPolicy() */
+#ifndef UART0_TX_DEFAULT_POLICY
+#define UART0_TX_DEFAULT_POLICY  UART0_TX_BLOCK
+#endif
+#ifndef UART0_TX_DEFAULT_TIMEOUT_MS
+#define UART0_TX_DEFAULT_TIMEOUT_MS 1000
+#endif
+
+/* What UART0_TxInterrupt() reports */
+#define UART0_TX_EVENT_LIST_DONE 0x01   /* The last segment of a UART0_WriteDma() list is sent */
+#define UART0_TX_EVENT_ROOM      0x02   /* Bytes of the ring went to the FIFO */
+
+/* Characters of the longest sint64 with its sign */
+#define UART0_INTEGER_DIGITS     20
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef enum
+{
+    UART0_TX_DROP,          /* The bytes that do not fit are dropped */
+    UART0_TX_BLOCK,         /* Wait for room, dropping the rest after the timeout without any byte sent */
+    UART0_TX_OVERWRITE      /* The oldest bytes not sent yet make room for the new ones */
+} Uart0TxPolicy;
+
+/* Blocks the writer of a full ring until UART0_TX_EVENT_ROOM or uTimeoutMs,
+ * returns FALSE at once when the writer cannot block */
+typedef boolean (*Uart0TxWaitFun)(uint32 uTimeoutMs);
+
+/* One buffer of a uDMA transmit list, sent in place */
+typedef struct
+{
+    const uint8 *pData;
+    uint32 uLength;
+} Uart0TxSegment;
 
 /*******************************************************************************
  *                            Functions Prototypes                             *
@@ -35,8 +115,59 @@
 
 extern void UART0_Init(void);
 
+/* Copy the bytes to the transmit ring buffer and return the number queued.
+ * Writers are serialized by the caller (one task at a time, not from an
+ * interrupt), the driver only guards the ring against its own interrupt by
+ * disabling the UART0 line of the NVIC. */
+extern uint32 UART0_Write(const uint8 *pData, uint32 uLength);
+
+/* Behavior of UART0_Write when the ring buffer is full. With UART0_TX_BLOCK
+ * the writer sleeps in the UART0_SetTxWait() function while it waits. Without
+ * one, or when it cannot sleep, the writer sends the ring itself, so it also
+ * makes progress with the interrupts masked, but not while a UART0_WriteDma()
+ * list is queued or being sent: the ring then waits for UART0_Handler to
+ * finish the list, and with the interrupts masked the wait only ends at the
+ * timeout. The timeout is counted on the DWT cycle counter and never ends
+ * while that is stopped. With UART0_TX_OVERWRITE a list not done protects the
+ * bytes written before it, the new bytes that do not fit then are dropped. */
+extern void UART0_SetTxPolicy(Uart0TxPolicy ePolicy, uint32 uTimeoutMs);
+
+/* Where a UART0_TX_BLOCK writer sleeps, NULL_PTR to spin. The function is
+ * woken by UART0_Handler on UART0_TX_EVENT_ROOM, a missed event only delays
+ * the wake to the next FIFO interrupt as the ring still holds bytes then. */
+extern void UART0_SetTxWait(Uart0TxWaitFun pWaitFun);
+
+/* Bytes dropped or overwritten since the reset */
+extern uint32 UART0_GetTxDropped(void);
+
+/* Called by UART0_Handler when the transmit FIFO falls to its trigger level
+ * or a uDMA transfer ends, returns the UART0_TX_EVENT_* that happened */
+extern uint8 UART0_TxInterrupt(void);
+
+/* Give the transmit requests to uDMA channel 9, after DMA_Init() and UART0_Init() */
+extern void UART0_InitDma(void);
+
+/* Send the segments in order by uDMA, without copying them: the list and the
+ * buffers must stay untouched until UART0_TxInterrupt() reports the end. The
+ * list goes out after the bytes already in the ring buffer, and the ring
+ * waits for it. Returns FALSE, starting nothing, while another list is not
+ * done or when ucCount is 0. */
+extern boolean UART0_WriteDma(const Uart0TxSegment *pSegments, uint8 ucCount);
+
+extern boolean UART0_IsDmaBusy(void);
+
+/* Stop the list not done and let the ring go on. Returns the number of list
+ * bytes the channel handed to the UART, the caller sends the rest itself. */
+extern uint32 UART0_AbortDma(void);
+
+/* Write the decimal characters of sNumber at pDigits (UART0_INTEGER_DIGITS
+ * bytes) and return their number */
+extern uint8 UART0_FormatInteger(sint64 sNumber, uint8 *pDigits);
+
 extern void UART0_SendByte(uint8 data);
 
+extern boolean UART0_IsDataAvailable(void);
+
 extern uint8 UART0_ReceiveByte(void);
 
 extern void UART0_SendString(const uint8 *pData);
@@ -0,0 +1,259 @@
+ /******************************************************************************
+ *
+ * Module: Bench
+ *
+ * File Name: bench.c
+ *
+ * Description: Source file for the MCAL micro-benchmarks.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "bench.h"
+#if BENCH_KERNEL_CASES
+#include "FreeRTOS.h"
+#include "semphr.h"
+#endif
+#include "uart0.h"
+#include "adc.h"
+#include "gpio.h"
+#include "GPTM.h"
+#if BENCH_EEPROM_CASES
+#include "EEPROM.h"
+#endif
+
+/* Pins 1 .. 3 of port E (heater outputs) and port F (on-board LEDs) */
+#define BENCH_LED_PINS                  ((1U << 1) | (1U << 2) | (1U << 3))
+
+typedef struct
+{
+    const char *Name;
+    void (*RunFun)(void);
+    void (*FinishFun)(void);    /* Puts the driver state back after the samples, may be NULL_PTR */
+    uint16 Samples;
+} BenchCase;
+
+#if BENCH_EEPROM_CASES
+/* Same layout as the diagnostics record written by the application */
+typedef struct
+{
+    char *Info;
+    uint32 TimeStamp;
+} BenchDiagnostics;
+#endif
+
+static volatile uint32 BenchSink;
+static uint32 BenchOverhead = 0;
+static BenchResult BenchResults[BENCH_MAX_CASES];
+static uint8 BenchResultsCount = 0;
+#if BENCH_EEPROM_CASES
+static BenchDiagnostics BenchRecord = { "Bench", 0 };
+#endif
+/* LED pins as they were before the run */
+static uint32 BenchPortE;
+static uint32 BenchPortF;
+#if BENCH_KERNEL_CASES
+static SemaphoreHandle_t BenchSemaphore = NULL_PTR;
+#endif
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void BENCH_Empty(void)
+{
+}
+
+static void BENCH_SendInteger(void)
+{
+    UART0_SendInteger(1234567890);
+}
+
+static void BENCH_SendString(void)
+{
+    UART0_SendString((const uint8 *)"0123456789");
+}
+
+static void BENCH_AdcRead(void)
+{
+    BenchSink = ADC_PD0Read();
+}
+
+#if BENCH_EEPROM_CASES
+static void BENCH_EepromSaveBlock0(void)
+{
+    EEPROM_SaveBlock0(&BenchRecord);
+}
+
+static void BENCH_EepromSaveBlock1(void)
+{
+    EEPROM_SaveBlock1(&BenchRecord);
+}
+#endif
+
+static void BENCH_RestoreLeds(void)
+{
+    GPIO_PORTE_DATA_REG = (GPIO_PORTE_DATA_REG & ~BENCH_LED_PINS) | (BenchPortE & BENCH_LED_PINS);
+    GPIO_PORTF_DATA_REG = (GPIO_PORTF_DATA_REG & ~BENCH_LED_PINS) | (BenchPortF & BENCH_LED_PINS);
+}
+
+static void BENCH_WTimer0Read(void)
+{
+    BenchSink = GPTM_WTimer0Read();
+}
+
+#if BENCH_KERNEL_CASES
+/* Never blocks: the semaphore is given just before it is taken */
+static void BENCH_SemaphoreGiveTake(void)
+{
+    xSemaphoreGive(BenchSemaphore);
+    xSemaphoreTake(BenchSemaphore, 0);
+}
+#endif
+
+static const BenchCase BenchCases[] =
+{
+    { "UART0_SendInteger",      BENCH_SendInteger,      NULL_PTR,                   4   },
+    { "UART0_SendString",       BENCH_SendString,       NULL_PTR,                   4   },
+    { "ADC_PD0Read",            BENCH_AdcRead,          NULL_PTR,                   256 },
+#if BENCH_EEPROM_CASES
+    { "EEPROM_SaveBlock0",      BENCH_EepromSaveBlock0, EEPROM_PointBeginBlock0,    1   },
+    { "EEPROM_SaveBlock1",      BENCH_EepromSaveBlock1, NULL_PTR,                   1   },
+#endif
+    { "GPIO_RedLedOn",          GPIO_RedLedOn,          BENCH_RestoreLeds,          256 },
+    { "GPIO_RedLedOff",         GPIO_RedLedOff,         BENCH_RestoreLeds,          256 },
+    { "GPIO_BlueLedOn",         GPIO_BlueLedOn,         BENCH_RestoreLeds,          256 },
+    { "GPIO_BlueLedOff",        GPIO_BlueLedOff,        BENCH_RestoreLeds,          256 },
+    { "GPIO_GreenLedOn",        GPIO_GreenLedOn,        BENCH_RestoreLeds,          256 },
+    { "GPIO_GreenLedOff",       GPIO_GreenLedOff,       BENCH_RestoreLeds,          256 },
+    { "GPIO_ExRedLedOn",        GPIO_ExRedLedOn,        BENCH_RestoreLeds,          256 },
+    { "GPIO_ExRedLedOff",       GPIO_ExRedLedOff,       BENCH_RestoreLeds,          256 },
+    { "GPIO_ExBlueLedOn",       GPIO_ExBlueLedOn,       BENCH_RestoreLeds,          256 },
+    { "GPIO_ExBlueLedOff",      GPIO_ExBlueLedOff,      BENCH_RestoreLeds,          256 },
+    { "GPIO_ExGreenLedOn",      GPIO_ExGreenLedOn,      BENCH_RestoreLeds,          256 },
+    { "GPIO_ExGreenLedOff",     GPIO_ExGreenLedOff,     BENCH_RestoreLeds,          256 },
+    { "GPTM_WTimer0Read",       BENCH_WTimer0Read,      NULL_PTR,                   256 },
+#if BENCH_KERNEL_CASES
+    { "xSemaphoreGive+Take",    BENCH_SemaphoreGiveTake, NULL_PTR,                  256 },
+#endif
+};
+
+#define BENCH_CASES_COUNT               (sizeof(BenchCases) / sizeof(BenchCases[0]))
+
+/* Per call time of every sample of one case */
+static void BENCH_Measure(void (*RunFun)(void), uint16 usSamples, BenchResult *pxResult)
+{
+    uint16 usSample;
+    uint16 usCall;
+    uint32 ulStart;
+    uint32 ulTime;
+    uint64 ullSum = 0;
+
+    pxResult->Min = 0xFFFFFFFFUL;
+    pxResult->Max = 0;
+    for(usSample = 0; usSample < usSamples; usSample++)
+    {
+        ulStart = BENCH_TIMESTAMP();
+        for(usCall = 0; usCall < BENCH_BATCH; usCall++)
+        {
+            RunFun();
+        }
+        ulTime = (uint32)(BENCH_TIMESTAMP() - ulStart) / BENCH_BATCH;
+
+        ullSum += ulTime;
+        if(ulTime < pxResult->Min)
+        {
+            pxResult->Min = ulTime;
+        }
+        if(ulTime > pxResult->Max)
+        {
+            pxResult->Max = ulTime;
+        }
+    }
+    pxResult->Samples = usSamples;
+    pxResult->Avg = (uint32)(ullSum / usSamples);
+}
+
+static uint32 BENCH_LessOverhead(uint32 ulTime)
+{
+    return (ulTime > BenchOverhead) ? (ulTime - BenchOverhead) : 0;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void BENCH_Run(void)
+{
+    BenchResult xEmpty;
+    uint8 ucCase;
+
+#if BENCH_KERNEL_CASES
+    /* Created on the first run so an image that never runs the benchmarks keeps its heap */
+    if(BenchSemaphore == NULL_PTR)
+    {
+        BenchSemaphore = xSemaphoreCreateBinary();
+        vQueueSetQueueNumber(BenchSemaphore, BENCH_QUEUE_NUMBER);
+    }
+#endif
+
+    BenchPortE = GPIO_PORTE_DATA_REG;
+    BenchPortF = GPIO_PORTF_DATA_REG;
+
+    /* The call through the case table and the time stamps, the best of many */
+    BENCH_Measure(BENCH_Empty, 256, &xEmpty);
+    BenchOverhead = xEmpty.Min;
+
+    for(ucCase = 0; (ucCase < BENCH_CASES_COUNT) && (ucCase < BENCH_MAX_CASES); ucCase++)
+    {
+        BENCH_Measure(BenchCases[ucCase].RunFun, BenchCases[ucCase].Samples, &BenchResults[ucCase]);
+        if(BenchCases[ucCase].FinishFun != NULL_PTR)
+        {
+            BenchCases[ucCase].FinishFun();
+        }
+        BenchResults[ucCase].Name = BenchCases[ucCase].Name;
+        BenchResults[ucCase].Min = BENCH_LessOverhead(BenchResults[ucCase].Min);
+        BenchResults[ucCase].Avg = BENCH_LessOverhead(BenchResults[ucCase].Avg);
+        BenchResults[ucCase].Max = BENCH_LessOverhead(BenchResults[ucCase].Max);
+    }
+    BenchResultsCount = ucCase;
+}
+
+const BenchResult *BENCH_GetResults(uint8 *pucCount)
+{
+    *pucCount = BenchResultsCount;
+    return BenchResults;
+}
+
+uint32 BENCH_GetOverhead(void)
+{
+    return BenchOverhead;
+}
+
+void BENCH_Report(void)
+{
+    uint8 ucCase;
+
+    /* Start on a new line after the digits sent by the UART cases */
+    UART0_SendString((const uint8 *)"\r\nBENCH_BEGIN unit=" BENCH_UNIT " batch=");
+    UART0_SendInteger(BENCH_BATCH);
+    UART0_SendString((const uint8 *)" overhead=");
+    UART0_SendInteger(BenchOverhead);
+    UART0_SendString((const uint8 *)"\r\n");
+    for(ucCase = 0; ucCase < BenchResultsCount; ucCase++)
+    {
+        UART0_SendString((const uint8 *)"BENCH ");
+        UART0_SendString((const uint8 *)BenchResults[ucCase].Name);
+        UART0_SendByte(',');
+        UART0_SendInteger(BenchResults[ucCase].Samples);
+        UART0_SendByte(',');
+        UART0_SendInteger(BenchResults[ucCase].Min);
+        UART0_SendByte(',');
+        UART0_SendInteger(BenchResults[ucCase].Avg);
+        UART0_SendByte(',');
+        UART0_SendInteger(BenchResults[ucCase].Max);
+        UART0_SendString((const uint8 *)"\r\n");
+    }
+    UART0_SendString((const uint8 *)"BENCH_END\r\n");
+}
@@ -0,0 +1,100 @@
+ /******************************************************************************
+ *
+ * Module: Bench
+ *
+ * File Name: bench.h
+ *
+ * Description: Header file for the MCAL micro-benchmarks. Every benchmarked
+ *              entry point is called a fixed number of times, each sample
+ *              timing BENCH_BATCH calls between two time stamps, and the
+ *              cost of an empty call measured the same way is taken off.
+ *              Interrupts are not masked, so the minimum is the clean number
+ *              and the maximum shows the interference.
+ *
+ *              The UART cases really send their digits over UART0 (the
+ *              transmit busy waiting is part of the cost). The LED cases
+ *              switch the heater outputs and the on-board LEDs, which are
+ *              put back as they were after every case. The EEPROM cases
+ *              write two words to block 0 and two to block 4, over the last
+ *              state records and on through the error log, so they are only
+ *              built when BENCH_EEPROM_CASES is set.
+ *
+ *              The kernel case gives and takes a private binary semaphore,
+ *              it goes through the queue trace hooks and so shows the cost
+ *              of the TRACE_CATEGORIES level the image was built with.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_BENCH_BENCH_H_
+#define MEASUREMENTS_BENCH_BENCH_H_
+
+#include "std_types.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Time stamp of the samples, the host build replaces it with its own clock */
+#ifndef BENCH_TIMESTAMP
+#define BENCH_TIMESTAMP()               (DWT_CYCCNT_REG)
+#define BENCH_UNIT                      "cycles"
+#endif
+
+/* Calls timed together in one sample, raised on hosts with a coarse clock */
+#ifndef BENCH_BATCH
+#define BENCH_BATCH                     1
+#endif
+
+/* Cases calling the kernel, the host build has no kernel */
+#ifndef BENCH_KERNEL_CASES
+#define BENCH_KERNEL_CASES              1
+#endif
+
+/* Cases writing the application records in the EEPROM, see above */
+#ifndef BENCH_EEPROM_CASES
+#define BENCH_EEPROM_CASES              0
+#endif
+
+/* Queue number of the kernel case semaphore, neither a lock nor a latency queue */
+#define BENCH_QUEUE_NUMBER              0xFE
+
+#define BENCH_MAX_CASES                 20
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    const char *Name;
+    uint16 Samples;
+    uint32 Min;         /* Per call, empty call cost taken off */
+    uint32 Avg;
+    uint32 Max;
+} BenchResult;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Run every case, takes about half a second on the target (the UART cases) */
+void BENCH_Run(void);
+
+/* Results of the last run, in case order */
+const BenchResult *BENCH_GetResults(uint8 *pucCount);
+
+/* Cost of the empty call taken off every result */
+uint32 BENCH_GetOverhead(void);
+
+/*
+ * Print the results of the last run over UART0:
+ *     BENCH_BEGIN unit=<cycles> batch=<calls per sample> overhead=<>
+ *     BENCH <name>,<samples>,<min>,<avg>,<max>
+ *     BENCH_END
+ */
+void BENCH_Report(void);
+
+#endif /* MEASUREMENTS_BENCH_BENCH_H_ */
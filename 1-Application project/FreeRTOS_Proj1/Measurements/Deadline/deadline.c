@@ -0,0 +1,192 @@
+ /******************************************************************************
+ *
+ * Module: Deadline
+ *
+ * File Name: deadline.c
+ *
+ * Description: Source file for the deadline overrun monitor of the periodic tasks.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "deadline.h"
+#include "uart0.h"
+#include "tm4c123gh6pm_registers.h"
+
+#define DEADLINE_PENDSTSET_MASK         0x04000000
+#define DEADLINE_NO_LOOP                0xFF
+#define DEADLINE_TICK_US                (1000000UL / configTICK_RATE_HZ)
+#define DEADLINE_MAX_ELAPSED_TICKS      ((0xFFFFFFFFUL / DEADLINE_TICK_US) - 1)
+
+static DeadlineStats DeadlineLoops[DEADLINE_MAX_LOOPS];
+static uint8 DeadlineLoopsCount;
+
+/* Loop slot of every task number, given on the first call of the task */
+static uint8 DeadlineSlots[DEADLINE_MAX_TASKS];
+
+static DeadlineCallback DeadlineUserCallback;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Time since the release in usec, with the sub tick part taken from SysTick */
+static uint32 DEADLINE_ElapsedUs(TickType_t xRelease)
+{
+    TickType_t xNow;
+    uint32 ulTicks;
+    uint32 ulSubTickCycles;
+
+    taskENTER_CRITICAL();
+    xNow = xTaskGetTickCount();
+    ulSubTickCycles = SYSTICK_RELOAD_REG - SYSTICK_CURRENT_REG;
+    /* SysTick already wrapped but its interrupt is held off by the critical section */
+    if(NVIC_SYSTEM_INTCTRL & DEADLINE_PENDSTSET_MASK)
+    {
+        xNow++;
+        ulSubTickCycles = SYSTICK_RELOAD_REG - SYSTICK_CURRENT_REG;
+    }
+    taskEXIT_CRITICAL();
+
+    /* Saturate instead of wrapping after a very long block (~71 minutes) */
+    ulTicks = (uint32)(xNow - xRelease);
+    if(ulTicks > DEADLINE_MAX_ELAPSED_TICKS)
+    {
+        ulTicks = DEADLINE_MAX_ELAPSED_TICKS;
+    }
+    return ulTicks * DEADLINE_TICK_US + ulSubTickCycles / DEADLINE_CYCLES_PER_US;
+}
+
+static DeadlineStats *DEADLINE_GetLoop(TaskHandle_t xTask, TickType_t xPeriod, boolean bCreate)
+{
+    UBaseType_t uxTaskNumber = uxTaskGetTaskNumber(xTask);
+    uint8 ucSlot;
+
+    if(uxTaskNumber >= DEADLINE_MAX_TASKS)
+    {
+        return NULL;
+    }
+    ucSlot = DeadlineSlots[uxTaskNumber];
+    if((ucSlot == DEADLINE_NO_LOOP) && bCreate && (DeadlineLoopsCount < DEADLINE_MAX_LOOPS))
+    {
+        ucSlot = DeadlineLoopsCount++;
+        DeadlineLoops[ucSlot].Task = xTask;
+        DeadlineLoops[ucSlot].PeriodTicks = xPeriod;
+        DeadlineSlots[uxTaskNumber] = ucSlot;
+    }
+    return (ucSlot == DEADLINE_NO_LOOP) ? NULL : &DeadlineLoops[ucSlot];
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void DEADLINE_Init(void)
+{
+    uint16 usIndex;
+    for(usIndex = 0; usIndex < DEADLINE_MAX_TASKS; usIndex++)
+    {
+        DeadlineSlots[usIndex] = DEADLINE_NO_LOOP;
+    }
+    for(usIndex = 0; usIndex < DEADLINE_MAX_LOOPS; usIndex++)
+    {
+        DeadlineLoops[usIndex].Task = NULL;
+        DeadlineLoops[usIndex].Periods = 0;
+        DeadlineLoops[usIndex].Overruns = 0;
+        HISTOGRAM_Reset(&DeadlineLoops[usIndex].Lateness);
+    }
+    DeadlineLoopsCount = 0;
+    DeadlineUserCallback = NULL;
+}
+
+void DEADLINE_DelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement)
+{
+    TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+    DeadlineStats *pxLoop;
+    uint32 ulElapsedUs;
+    uint32 ulPeriodUs;
+    TickType_t xMissed;
+
+    vTaskSuspendAll();
+    pxLoop = DEADLINE_GetLoop(xTask, xTimeIncrement, TRUE);
+    xTaskResumeAll();
+
+    if(pxLoop != NULL)
+    {
+        ulElapsedUs = DEADLINE_ElapsedUs(*pxPreviousWakeTime);
+        ulPeriodUs = (uint32)xTimeIncrement * DEADLINE_TICK_US;
+
+        taskENTER_CRITICAL();
+        pxLoop->Periods++;
+        if(ulElapsedUs >= ulPeriodUs)
+        {
+            pxLoop->Overruns++;
+            HISTOGRAM_Record(&pxLoop->Lateness, ulElapsedUs - ulPeriodUs);
+        }
+        taskEXIT_CRITICAL();
+
+        if((ulElapsedUs >= ulPeriodUs) && (DeadlineUserCallback != NULL))
+        {
+            DeadlineUserCallback(xTask, ulElapsedUs - ulPeriodUs);
+        }
+    }
+
+    /* Past an overrun the releases gone are skipped and the loop waits for
+     * the next one ahead, so the lateness of one period does not carry over
+     * to all the following ones */
+    xMissed = (xTaskGetTickCount() - *pxPreviousWakeTime) / xTimeIncrement;
+    *pxPreviousWakeTime += xMissed * xTimeIncrement;
+    vTaskDelayUntil(pxPreviousWakeTime, xTimeIncrement);
+}
+
+void DEADLINE_SetCallback(DeadlineCallback pxCallback)
+{
+    DeadlineUserCallback = pxCallback;
+}
+
+boolean DEADLINE_GetStats(TaskHandle_t xTask, DeadlineStats *pxStats)
+{
+    DeadlineStats *pxLoop;
+    boolean bFound = FALSE;
+
+    taskENTER_CRITICAL();
+    pxLoop = DEADLINE_GetLoop(xTask, 0, FALSE);
+    if(pxLoop != NULL)
+    {
+        *pxStats = *pxLoop;
+        bFound = TRUE;
+    }
+    taskEXIT_CRITICAL();
+    return bFound;
+}
+
+const DeadlineStats *DEADLINE_GetLoops(uint8 *pucCount)
+{
+    *pucCount = DeadlineLoopsCount;
+    return DeadlineLoops;
+}
+
+void DEADLINE_Report(void)
+{
+    static DeadlineStats xStats;
+    uint8 ucLoop;
+
+    UART0_SendString((const uint8 *)"Deadline overruns, lateness in usec\r\n");
+    for(ucLoop = 0; ucLoop < DeadlineLoopsCount; ucLoop++)
+    {
+        if(DEADLINE_GetStats(DeadlineLoops[ucLoop].Task, &xStats) == FALSE)
+        {
+            continue;
+        }
+        UART0_SendString((const uint8 *)pcTaskGetName(xStats.Task));
+        UART0_SendString((const uint8 *)" period=");
+        UART0_SendInteger((uint32)xStats.PeriodTicks * (1000UL / configTICK_RATE_HZ));
+        UART0_SendString((const uint8 *)"ms periods=");
+        UART0_SendInteger(xStats.Periods);
+        UART0_SendString((const uint8 *)" overruns=");
+        UART0_SendInteger(xStats.Overruns);
+        UART0_SendString((const uint8 *)"\r\n  late ");
+        HISTOGRAM_Report(&xStats.Lateness, 1);
+    }
+}
@@ -0,0 +1,79 @@
+ /******************************************************************************
+ *
+ * Module: Deadline
+ *
+ * File Name: deadline.h
+ *
+ * Description: Header file for the deadline overrun monitor of the periodic
+ *              tasks. DEADLINE_DelayUntil() replaces vTaskDelayUntil() and
+ *              checks whether the period that just ended ran past the next
+ *              release time before blocking. A late loop skips the releases
+ *              it missed and waits for the next one ahead instead of running
+ *              them back to back.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_DEADLINE_DEADLINE_H_
+#define MEASUREMENTS_DEADLINE_DEADLINE_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "std_types.h"
+#include "histogram.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Number of periodic loops that can be monitored, up to 254 */
+#ifndef DEADLINE_MAX_LOOPS
+#define DEADLINE_MAX_LOOPS              10
+#endif
+
+/* Tasks with a task number at or above this value are not monitored, needs FreeRTOS.h */
+#define DEADLINE_MAX_TASKS              configMEASURED_TASKS
+
+/* Lateness is measured with the tick count and the SysTick counter, in usec */
+#define DEADLINE_CYCLES_PER_US          (configCPU_CLOCK_HZ / 1000000UL)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    TaskHandle_t Task;
+    TickType_t PeriodTicks;
+    uint32 Periods;         /* Periods completed */
+    uint32 Overruns;        /* Periods that ended after the next release time */
+    Histogram Lateness;     /* How late the overrun periods ended, in usec */
+} DeadlineStats;
+
+/* Called from the late task itself, right after the overrun is detected */
+typedef void (*DeadlineCallback)(TaskHandle_t xTask, uint32 ulLatenessUs);
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+void DEADLINE_Init(void);
+
+/* Drop in replacement for vTaskDelayUntil() in the periodic task loops. A
+ * loop that also blocks on an event takes *pxPreviousWakeTime from the tick
+ * count after that wait, which is not part of any period. */
+void DEADLINE_DelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement);
+
+void DEADLINE_SetCallback(DeadlineCallback pxCallback);
+
+/* Copy the statistics of the task, returns FALSE when it is not monitored */
+boolean DEADLINE_GetStats(TaskHandle_t xTask, DeadlineStats *pxStats);
+
+/* Every monitored loop in the order of their first period, unprotected */
+const DeadlineStats *DEADLINE_GetLoops(uint8 *pucCount);
+
+/* Print the statistics of every monitored loop over UART0 */
+void DEADLINE_Report(void);
+
+#endif /* MEASUREMENTS_DEADLINE_DEADLINE_H_ */
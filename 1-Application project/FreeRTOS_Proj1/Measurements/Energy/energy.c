@@ -0,0 +1,176 @@
+ /******************************************************************************
+ *
+ * Module: Energy
+ *
+ * File Name: energy.c
+ *
+ * Description: Source file for the energy accounting.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "energy.h"
+
+#if ENERGY_ENABLED
+
+#if !configGENERATE_RUN_TIME_STATS
+#error "ENERGY_ENABLED needs the run time counters of the SCHEDULER trace category"
+#endif
+
+#include "uart0.h"
+
+/* Run time counter clock, WTimer0 at 0.1 msec per count */
+#define ENERGY_COUNTS_PER_MS            10UL
+
+#if configUSE_TICKLESS_IDLE
+#define ENERGY_MCU_IDLE_MW              ENERGY_MCU_SLEEP_MW
+#else
+#define ENERGY_MCU_IDLE_MW              ENERGY_MCU_RUN_MW
+#endif
+
+typedef struct
+{
+    uint8 Level;
+    TickType_t Since;                   /* Tick of the last level change */
+    uint64 LevelTicks[ENERGY_LEVELS];   /* Time at every level before Since */
+} EnergyHeater;
+
+static const uint32 EnergyHeaterMw[ENERGY_LEVELS] =
+{
+    0, ENERGY_HEATER_LOW_MW, ENERGY_HEATER_MEDIUM_MW, ENERGY_HEATER_HIGH_MW
+};
+
+static const char *const EnergySeatNames[ENERGY_SEATS] = { "driver", "passenger" };
+static const char *const EnergyLevelNames[ENERGY_LEVELS] = { " off_ms=", " low_ms=", " medium_ms=", " high_ms=" };
+
+static EnergyHeater EnergyHeaters[ENERGY_SEATS];
+
+/* Totals taken by ENERGY_Report() before it prints, too big for a task stack */
+static EnergySeat EnergyReportSeats[ENERGY_SEATS];
+
+/* Counter values at the previous sample, both start from zero at reset */
+static uint32 EnergyLastTotal = 0;
+static uint32 EnergyLastIdle = 0;
+static uint64 EnergyActiveCounts = 0;
+static uint64 EnergyIdleCounts = 0;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void ENERGY_HeaterLevel(uint8 ucSeat, uint8 ucLevel)
+{
+    EnergyHeater *pxHeater = &EnergyHeaters[ucSeat % ENERGY_SEATS];
+    TickType_t xNow;
+
+    taskENTER_CRITICAL();
+    xNow = xTaskGetTickCount();
+    pxHeater->LevelTicks[pxHeater->Level] += (uint32)(xNow - pxHeater->Since);
+    pxHeater->Since = xNow;
+    pxHeater->Level = ucLevel % ENERGY_LEVELS;
+    taskEXIT_CRITICAL();
+}
+
+void ENERGY_Sample(void)
+{
+    uint32 ulTotal;
+    uint32 ulIdle;
+    uint32 ulElapsed;
+    uint32 ulIdleElapsed;
+
+    taskENTER_CRITICAL();
+    ulTotal = (uint32)portGET_RUN_TIME_COUNTER_VALUE();
+    ulIdle = (uint32)ulTaskGetIdleRunTimeCounter();
+    /* Unsigned deltas stay right across a wrap of either counter */
+    ulElapsed = ulTotal - EnergyLastTotal;
+    ulIdleElapsed = ulIdle - EnergyLastIdle;
+    if(ulIdleElapsed > ulElapsed)
+    {
+        ulIdleElapsed = ulElapsed;
+    }
+    EnergyActiveCounts += ulElapsed - ulIdleElapsed;
+    EnergyIdleCounts += ulIdleElapsed;
+    EnergyLastTotal = ulTotal;
+    EnergyLastIdle = ulIdle;
+    taskEXIT_CRITICAL();
+}
+
+void ENERGY_GetSeat(uint8 ucSeat, EnergySeat *pxSeat)
+{
+    const EnergyHeater *pxHeater = &EnergyHeaters[ucSeat % ENERGY_SEATS];
+    uint64 aullTicks[ENERGY_LEVELS];
+    uint8 ucLevel;
+
+    for(ucLevel = 0; ucLevel < ENERGY_LEVELS; ucLevel++)
+    {
+        aullTicks[ucLevel] = pxHeater->LevelTicks[ucLevel];
+    }
+    aullTicks[pxHeater->Level] += (uint32)(xTaskGetTickCount() - pxHeater->Since);
+
+    pxSeat->EnergyMj = 0;
+    for(ucLevel = 0; ucLevel < ENERGY_LEVELS; ucLevel++)
+    {
+        pxSeat->LevelMs[ucLevel] = aullTicks[ucLevel] * portTICK_PERIOD_MS;
+        /* msec times mW is uJ */
+        pxSeat->EnergyMj += (pxSeat->LevelMs[ucLevel] * EnergyHeaterMw[ucLevel]) / 1000U;
+    }
+}
+
+void ENERGY_GetMcu(EnergyMcu *pxMcu)
+{
+    pxMcu->ActiveMs = EnergyActiveCounts / ENERGY_COUNTS_PER_MS;
+    pxMcu->IdleMs = EnergyIdleCounts / ENERGY_COUNTS_PER_MS;
+    pxMcu->EnergyMj = (EnergyActiveCounts * ENERGY_MCU_RUN_MW + EnergyIdleCounts * ENERGY_MCU_IDLE_MW) /
+                      (ENERGY_COUNTS_PER_MS * 1000U);
+}
+
+void ENERGY_Report(void)
+{
+    EnergyMcu xMcu;
+    uint64 ullTotalMj = 0;
+    uint8 ucSeat;
+    uint8 ucLevel;
+
+    /* Take the totals with the scheduler suspended, print them after */
+    vTaskSuspendAll();
+    ENERGY_Sample();
+    for(ucSeat = 0; ucSeat < ENERGY_SEATS; ucSeat++)
+    {
+        ENERGY_GetSeat(ucSeat, &EnergyReportSeats[ucSeat]);
+    }
+    ENERGY_GetMcu(&xMcu);
+    xTaskResumeAll();
+
+    for(ucSeat = 0; ucSeat < ENERGY_SEATS; ucSeat++)
+    {
+        UART0_SendString((const uint8 *)"ENERGY seat=");
+        UART0_SendString((const uint8 *)EnergySeatNames[ucSeat]);
+        for(ucLevel = 0; ucLevel < ENERGY_LEVELS; ucLevel++)
+        {
+            UART0_SendString((const uint8 *)EnergyLevelNames[ucLevel]);
+            UART0_SendInteger((sint64)EnergyReportSeats[ucSeat].LevelMs[ucLevel]);
+        }
+        UART0_SendString((const uint8 *)" mwh=");
+        UART0_SendInteger((sint64)(EnergyReportSeats[ucSeat].EnergyMj / 3600U));
+        UART0_SendString((const uint8 *)"\r\n");
+        ullTotalMj += EnergyReportSeats[ucSeat].EnergyMj;
+    }
+
+    UART0_SendString((const uint8 *)"ENERGY mcu active_ms=");
+    UART0_SendInteger((sint64)xMcu.ActiveMs);
+    UART0_SendString((const uint8 *)" idle_ms=");
+    UART0_SendInteger((sint64)xMcu.IdleMs);
+    UART0_SendString((const uint8 *)" mwh=");
+    UART0_SendInteger((sint64)(xMcu.EnergyMj / 3600U));
+    UART0_SendString((const uint8 *)"\r\n");
+    ullTotalMj += xMcu.EnergyMj;
+
+    UART0_SendString((const uint8 *)"ENERGY total mwh=");
+    UART0_SendInteger((sint64)(ullTotalMj / 3600U));
+    UART0_SendString((const uint8 *)"\r\n");
+}
+
+#endif /* ENERGY_ENABLED */
@@ -0,0 +1,103 @@
+ /******************************************************************************
+ *
+ * Module: Energy
+ *
+ * File Name: energy.h
+ *
+ * Description: Header file for the energy accounting. The heater tasks give
+ *              every output they drive (traceHEATER_LEVEL), and the time each
+ *              seat spends at each level is integrated with the power of the
+ *              level. The MCU time is split into active and idle from the
+ *              kernel run time counters (the idle task against the others),
+ *              sampled every second by the run time task, and integrated
+ *              with the run and idle power of the core. The totals are
+ *              printed in mWh by the 'w' console command.
+ *
+ *              The powers are a model: set them to the heater elements and
+ *              the supply of the board being measured. The accounting needs
+ *              the COUNTERS trace category and the run time counters of the
+ *              SCHEDULER category, or build with ENERGY_ENABLED defined to 0
+ *              to remove it alone.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_ENERGY_ENERGY_H_
+#define MEASUREMENTS_ENERGY_ENERGY_H_
+
+#include "std_types.h"
+#include "trace.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#ifndef ENERGY_ENABLED
+#define ENERGY_ENABLED                  (TRACE_ENABLED(TRACE_CATEGORY_COUNTERS) && TRACE_ENABLED(TRACE_CATEGORY_SCHEDULER))
+#endif
+
+#define ENERGY_SEAT_DRIVER              0
+#define ENERGY_SEAT_PASSENGER           1
+#define ENERGY_SEATS                    2
+
+/* Heater levels as driven on the pins: green LOW, blue MEDIUM, both HIGH */
+#define ENERGY_LEVEL_OFF                0
+#define ENERGY_LEVEL_LOW                1
+#define ENERGY_LEVEL_MEDIUM             2
+#define ENERGY_LEVEL_HIGH               3
+#define ENERGY_LEVELS                   4
+
+/* Heater element power of every level, the host thermal model uses the same */
+#define ENERGY_HEATER_LOW_MW            30000UL
+#define ENERGY_HEATER_MEDIUM_MW         60000UL
+#define ENERGY_HEATER_HIGH_MW           90000UL
+
+/* TM4C123GH6PM at 16 MHz on 3.3 V, running and in sleep mode. The idle task
+ * spins unless tickless idle is on, so it is charged at the run power then */
+#define ENERGY_MCU_RUN_MW               45UL
+#define ENERGY_MCU_SLEEP_MW             20UL
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint64 LevelMs[ENERGY_LEVELS];      /* Time at every level since reset */
+    uint64 EnergyMj;
+} EnergySeat;
+
+typedef struct
+{
+    uint64 ActiveMs;                    /* Run time of every task but the idle task */
+    uint64 IdleMs;
+    uint64 EnergyMj;
+} EnergyMcu;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+#if ENERGY_ENABLED
+
+/* Called by traceHEATER_LEVEL from the heater tasks after every output write */
+void ENERGY_HeaterLevel(uint8 ucSeat, uint8 ucLevel);
+
+/* Take the MCU time since the previous sample, call at least once per wrap
+ * of the run time counter (~119 hours) */
+void ENERGY_Sample(void);
+
+/* Totals of the heater up to now and of the MCU up to the last sample, to be
+ * called with the scheduler suspended so no task changes them meanwhile */
+void ENERGY_GetSeat(uint8 ucSeat, EnergySeat *pxSeat);
+void ENERGY_GetMcu(EnergyMcu *pxMcu);
+
+/* Take an MCU sample, then print the time per level and the energy of every
+ * seat, of the MCU and their total. The totals are taken with the scheduler
+ * suspended, so call it with the scheduler running. */
+void ENERGY_Report(void);
+
+#endif /* ENERGY_ENABLED */
+
+#endif /* MEASUREMENTS_ENERGY_ENERGY_H_ */
@@ -0,0 +1,198 @@
+ /******************************************************************************
+ *
+ * Module: HeapStats
+ *
+ * File Name: heap_stats.c
+ *
+ * Description: Source file for the heap_2 telemetry.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "heap_stats.h"
+#include "uart0.h"
+
+/* Filled before the scheduler starts, no init call is needed */
+static HeapLogEntry HeapLog[HEAP_LOG_SIZE];
+static uint8 HeapLogCount = 0;
+static uint8 HeapLogClaimed = 0;
+
+static uint32 HeapMinimumEverFree = 0xFFFFFFFFUL;
+static uint32 HeapAllocs = 0;
+static uint32 HeapFrees = 0;
+static uint32 HeapFailed = 0;
+static uint32 HeapUnlogged = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void HEAP_ReportQueue(QueueHandle_t xQueue)
+{
+    uint8 ucType = ucQueueGetQueueType(xQueue);
+
+    /* The timer command queue is created by the kernel and keeps number 0 */
+    if(ucType == queueQUEUE_TYPE_MUTEX)
+    {
+        UART0_SendString((const uint8 *)"mutex ");
+    }
+    else if(ucType == queueQUEUE_TYPE_BINARY_SEMAPHORE)
+    {
+        UART0_SendString((const uint8 *)"binary semaphore ");
+    }
+    else if(ucType == queueQUEUE_TYPE_COUNTING_SEMAPHORE)
+    {
+        UART0_SendString((const uint8 *)"counting semaphore ");
+    }
+    else if(uxQueueGetQueueNumber(xQueue) == 0)
+    {
+        UART0_SendString((const uint8 *)"timer queue");
+        return;
+    }
+    else
+    {
+        UART0_SendString((const uint8 *)"queue ");
+    }
+    UART0_SendInteger(uxQueueGetQueueNumber(xQueue));
+}
+
+static void HEAP_ReportEntry(const HeapLogEntry *pxEntry)
+{
+    UART0_SendString((const uint8 *)"ALLOC ");
+    UART0_SendInteger(pxEntry->Bytes);
+    UART0_SendByte(',');
+
+    if(pxEntry->Block == NULL)
+    {
+        UART0_SendString((const uint8 *)"failed");
+    }
+    else if(pxEntry->Freed)
+    {
+        /* The object may be gone, its handle is not followed */
+        UART0_SendString((const uint8 *)"-,freed");
+    }
+    else if(pxEntry->ObjectType == HEAP_OBJECT_TASK)
+    {
+        UART0_SendString((const uint8 *)pcTaskGetName((TaskHandle_t)pxEntry->Object));
+        UART0_SendString((const uint8 *)((pxEntry->Block == pxEntry->Object) ? " TCB" : " stack"));
+    }
+    else if(pxEntry->ObjectType == HEAP_OBJECT_QUEUE)
+    {
+        HEAP_ReportQueue((QueueHandle_t)pxEntry->Object);
+    }
+    else if(pxEntry->ObjectType == HEAP_OBJECT_EVENT_GROUP)
+    {
+        UART0_SendString((const uint8 *)"event group");
+    }
+    else
+    {
+        UART0_SendString((const uint8 *)"other");
+    }
+    UART0_SendString((const uint8 *)"\r\n");
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void HEAP_Malloc(void *pvBlock, uint32 ulBlockBytes)
+{
+    uint32 ulFree = (uint32)xPortGetFreeHeapSize();
+
+    /* heap_2 keeps no low water mark of its own */
+    if(ulFree < HeapMinimumEverFree)
+    {
+        HeapMinimumEverFree = ulFree;
+    }
+
+    if(pvBlock != NULL)
+    {
+        HeapAllocs++;
+    }
+    else
+    {
+        HeapFailed++;
+    }
+
+    if(HeapLogCount < HEAP_LOG_SIZE)
+    {
+        HeapLog[HeapLogCount].Block = pvBlock;
+        HeapLog[HeapLogCount].Object = NULL;
+        HeapLog[HeapLogCount].Bytes = (uint16)ulBlockBytes;
+        HeapLog[HeapLogCount].ObjectType = HEAP_OBJECT_OTHER;
+        HeapLog[HeapLogCount].Freed = FALSE;
+        HeapLogCount++;
+    }
+    else
+    {
+        HeapUnlogged++;
+    }
+}
+
+void HEAP_Free(void *pvBlock, uint32 ulBlockBytes)
+{
+    uint8 ucEntry;
+
+    (void)ulBlockBytes;
+    HeapFrees++;
+
+    for(ucEntry = 0; ucEntry < HeapLogCount; ucEntry++)
+    {
+        if((HeapLog[ucEntry].Block == pvBlock) && !HeapLog[ucEntry].Freed)
+        {
+            HeapLog[ucEntry].Freed = TRUE;
+            break;
+        }
+    }
+}
+
+void HEAP_ObjectCreated(void *pvObject, uint8 ucObjectType)
+{
+    /* The blocks since the last create hook were allocated for this object
+     * (the stack and TCB of a task, the storage of a queue) */
+    for(; HeapLogClaimed < HeapLogCount; HeapLogClaimed++)
+    {
+        HeapLog[HeapLogClaimed].Object = pvObject;
+        HeapLog[HeapLogClaimed].ObjectType = ucObjectType;
+    }
+}
+
+uint32 HEAP_GetMinimumEverFree(void)
+{
+    uint32 ulFree = (uint32)xPortGetFreeHeapSize();
+    return (ulFree < HeapMinimumEverFree) ? ulFree : HeapMinimumEverFree;
+}
+
+void HEAP_Report(void)
+{
+    uint8 ucEntry;
+
+    UART0_SendString((const uint8 *)"HEAP size=");
+    UART0_SendInteger(configTOTAL_HEAP_SIZE);
+    UART0_SendString((const uint8 *)" free=");
+    UART0_SendInteger(xPortGetFreeHeapSize());
+    UART0_SendString((const uint8 *)" min=");
+    UART0_SendInteger(HEAP_GetMinimumEverFree());
+    UART0_SendString((const uint8 *)" allocs=");
+    UART0_SendInteger(HeapAllocs);
+    UART0_SendString((const uint8 *)" frees=");
+    UART0_SendInteger(HeapFrees);
+    UART0_SendString((const uint8 *)" failed=");
+    UART0_SendInteger(HeapFailed);
+    UART0_SendString((const uint8 *)"\r\n");
+
+    for(ucEntry = 0; ucEntry < HeapLogCount; ucEntry++)
+    {
+        HEAP_ReportEntry(&HeapLog[ucEntry]);
+    }
+    if(HeapUnlogged > 0)
+    {
+        UART0_SendString((const uint8 *)"ALLOC unlogged=");
+        UART0_SendInteger(HeapUnlogged);
+        UART0_SendString((const uint8 *)"\r\n");
+    }
+}
@@ -0,0 +1,72 @@
+ /******************************************************************************
+ *
+ * Module: HeapStats
+ *
+ * File Name: heap_stats.h
+ *
+ * Description: Header file for the heap_2 telemetry. The traceMALLOC and
+ *              traceFREE hooks keep the free bytes low water mark and the
+ *              allocation counts, and the first allocations (the startup
+ *              object creation) are logged with the task, queue or event
+ *              group they were made for, named by the create hooks.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_HEAPSTATS_HEAP_STATS_H_
+#define MEASUREMENTS_HEAPSTATS_HEAP_STATS_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Two blocks (TCB and stack) per task plus the queues and the event group of main.c */
+#define HEAP_LOG_SIZE                   48
+
+/* Kernel objects claiming the blocks allocated since the previous create hook */
+#define HEAP_OBJECT_OTHER               0
+#define HEAP_OBJECT_TASK                1
+#define HEAP_OBJECT_QUEUE               2
+#define HEAP_OBJECT_EVENT_GROUP         3
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    void *Block;        /* Address returned by pvPortMalloc(), NULL when it failed */
+    void *Object;       /* Task, queue or event group handle the block belongs to */
+    uint16 Bytes;       /* Block size taken from the heap, header and alignment included */
+    uint8 ObjectType;
+    uint8 Freed;
+} HeapLogEntry;
+
+/*******************************************************************************
+ *                            Functions Prototypes                            *
+ *******************************************************************************/
+
+/* Called from traceMALLOC with the block size (header included), pvBlock is NULL on failure */
+void HEAP_Malloc(void *pvBlock, uint32 ulBlockBytes);
+
+/* Called from traceFREE with the block size (header included) */
+void HEAP_Free(void *pvBlock, uint32 ulBlockBytes);
+
+/* Called from the create hooks once the object and its blocks are allocated */
+void HEAP_ObjectCreated(void *pvObject, uint8 ucObjectType);
+
+/* Lowest free heap in bytes seen after any allocation */
+uint32 HEAP_GetMinimumEverFree(void);
+
+/*
+ * Print over UART0:
+ *     HEAP size=<> free=<> min=<> allocs=<> frees=<> failed=<>
+ *     ALLOC <block bytes>,<object>[,freed]
+ * one ALLOC line per logged allocation.
+ */
+void HEAP_Report(void);
+
+#endif /* MEASUREMENTS_HEAPSTATS_HEAP_STATS_H_ */
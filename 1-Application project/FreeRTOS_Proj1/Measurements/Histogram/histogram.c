@@ -0,0 +1,162 @@
+ /******************************************************************************
+ *
+ * Module: Histogram
+ *
+ * File Name: histogram.c
+ *
+ * Description: Source file for the log2 bucketed histograms.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "histogram.h"
+#include "uart0.h"
+
+/* Count leading zeros, a single instruction on the Cortex-M4 */
+#if defined(__TI_ARM__)
+#define HISTOGRAM_CLZ(x)                __clz(x)
+#elif defined(__GNUC__)
+#define HISTOGRAM_CLZ(x)                ((uint32)__builtin_clz(x))
+#endif
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint8 HISTOGRAM_Bucket(uint32 ulValue)
+{
+    if(ulValue == 0)
+    {
+        return 0;
+    }
+#ifdef HISTOGRAM_CLZ
+    return (uint8)(32 - HISTOGRAM_CLZ(ulValue));
+#else
+    {
+        uint8 ucBucket = 0;
+        while(ulValue != 0)
+        {
+            ulValue >>= 1;
+            ucBucket++;
+        }
+        return ucBucket;
+    }
+#endif
+}
+
+static uint32 HISTOGRAM_BucketTop(uint8 ucBucket)
+{
+    return (ucBucket >= 32) ? 0xFFFFFFFFUL : ((1UL << ucBucket) - 1);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void HISTOGRAM_Reset(Histogram *pxHistogram)
+{
+    uint8 ucBucket;
+    pxHistogram->Count = 0;
+    pxHistogram->Min = 0xFFFFFFFFUL;
+    pxHistogram->Max = 0;
+    pxHistogram->Sum = 0;
+    for(ucBucket = 0; ucBucket < HISTOGRAM_BUCKETS; ucBucket++)
+    {
+        pxHistogram->Buckets[ucBucket] = 0;
+    }
+}
+
+void HISTOGRAM_Record(Histogram *pxHistogram, uint32 ulValue)
+{
+    pxHistogram->Count++;
+    pxHistogram->Sum += ulValue;
+    if(ulValue < pxHistogram->Min)
+    {
+        pxHistogram->Min = ulValue;
+    }
+    if(ulValue > pxHistogram->Max)
+    {
+        pxHistogram->Max = ulValue;
+    }
+    pxHistogram->Buckets[HISTOGRAM_Bucket(ulValue)]++;
+}
+
+uint32 HISTOGRAM_Percentile(const Histogram *pxHistogram, uint8 ucPercent)
+{
+    uint32 ulRank;
+    uint32 ulSeen = 0;
+    uint8 ucBucket;
+
+    if(pxHistogram->Count == 0)
+    {
+        return 0;
+    }
+
+    /* Rank of the sample at the percentile, rounded up */
+    ulRank = (uint32)(((uint64)pxHistogram->Count * ucPercent + 99) / 100);
+    for(ucBucket = 0; ucBucket < HISTOGRAM_BUCKETS; ucBucket++)
+    {
+        ulSeen += pxHistogram->Buckets[ucBucket];
+        if(ulSeen >= ulRank)
+        {
+            break;
+        }
+    }
+
+    if(HISTOGRAM_BucketTop(ucBucket) > pxHistogram->Max)
+    {
+        return pxHistogram->Max;
+    }
+    if(HISTOGRAM_BucketTop(ucBucket) < pxHistogram->Min)
+    {
+        return pxHistogram->Min;
+    }
+    return HISTOGRAM_BucketTop(ucBucket);
+}
+
+uint32 HISTOGRAM_Average(const Histogram *pxHistogram)
+{
+    if(pxHistogram->Count == 0)
+    {
+        return 0;
+    }
+    return (uint32)(pxHistogram->Sum / pxHistogram->Count);
+}
+
+void HISTOGRAM_Report(const Histogram *pxHistogram, uint32 ulDivider)
+{
+    uint8 ucBucket;
+
+    UART0_SendString((const uint8 *)"n=");
+    UART0_SendInteger(pxHistogram->Count);
+    if(pxHistogram->Count == 0)
+    {
+        UART0_SendString((const uint8 *)"\r\n");
+        return;
+    }
+    UART0_SendString((const uint8 *)" min=");
+    UART0_SendInteger(pxHistogram->Min / ulDivider);
+    UART0_SendString((const uint8 *)" avg=");
+    UART0_SendInteger(HISTOGRAM_Average(pxHistogram) / ulDivider);
+    UART0_SendString((const uint8 *)" p50=");
+    UART0_SendInteger(HISTOGRAM_Percentile(pxHistogram, 50) / ulDivider);
+    UART0_SendString((const uint8 *)" p99=");
+    UART0_SendInteger(HISTOGRAM_Percentile(pxHistogram, 99) / ulDivider);
+    UART0_SendString((const uint8 *)" max=");
+    UART0_SendInteger(pxHistogram->Max / ulDivider);
+    UART0_SendString((const uint8 *)"\r\n   ");
+
+    /* Non empty buckets as "<upper edge>:<count>" */
+    for(ucBucket = 0; ucBucket < HISTOGRAM_BUCKETS; ucBucket++)
+    {
+        if(pxHistogram->Buckets[ucBucket] != 0)
+        {
+            UART0_SendString((const uint8 *)" <=");
+            UART0_SendInteger(HISTOGRAM_BucketTop(ucBucket) / ulDivider);
+            UART0_SendByte(':');
+            UART0_SendInteger(pxHistogram->Buckets[ucBucket]);
+        }
+    }
+    UART0_SendString((const uint8 *)"\r\n");
+}
@@ -0,0 +1,59 @@
+ /******************************************************************************
+ *
+ * Module: Histogram
+ *
+ * File Name: histogram.h
+ *
+ * Description: Header file for the log2 bucketed histograms shared by the
+ *              measurement modules. Recording a sample is a few instructions
+ *              so it can be done from the kernel hooks and interrupt handlers.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_HISTOGRAM_HISTOGRAM_H_
+#define MEASUREMENTS_HISTOGRAM_HISTOGRAM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Bucket 0 holds the zero samples, bucket n holds the samples in [2^(n-1), 2^n - 1] */
+#define HISTOGRAM_BUCKETS               33
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 Count;
+    uint32 Min;
+    uint32 Max;
+    uint64 Sum;
+    uint32 Buckets[HISTOGRAM_BUCKETS];
+} Histogram;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+void HISTOGRAM_Reset(Histogram *pxHistogram);
+
+/* Not protected, the caller masks the interrupts if the histogram is shared */
+void HISTOGRAM_Record(Histogram *pxHistogram, uint32 ulValue);
+
+/* Estimate of the given percentile (1 - 100): the upper edge of the bucket
+ * holding it, clipped to the recorded min and max */
+uint32 HISTOGRAM_Percentile(const Histogram *pxHistogram, uint8 ucPercent);
+
+uint32 HISTOGRAM_Average(const Histogram *pxHistogram);
+
+/* Print "count min avg p50 p99 max" with every value divided by ulDivider
+ * (e.g. the cycles per microsecond), followed by the non empty buckets */
+void HISTOGRAM_Report(const Histogram *pxHistogram, uint32 ulDivider);
+
+#endif /* MEASUREMENTS_HISTOGRAM_HISTOGRAM_H_ */
@@ -0,0 +1,70 @@
+ /******************************************************************************
+ *
+ * Module: IsrStats
+ *
+ * File Name: isr_stats.c
+ *
+ * Description: Source file for the interrupt handler execution time profile.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "isr_stats.h"
+
+#if ISR_STATS_ENABLED
+
+#include "histogram.h"
+#include "uart0.h"
+
+volatile uint32 gIsrStatsStart[ISR_STATS_COUNT];
+
+static Histogram IsrStatsCycles[ISR_STATS_COUNT];
+
+static const char *const IsrStatsNames[ISR_STATS_COUNT] =
+{
+    "GPIOPortE_Handler",
+    "ADC0_Handler",
+    "GPIOPortF_Handler",
+    "ADC1_Handler",
+    "UART0_Handler"
+};
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void ISR_Init(void)
+{
+    uint8 ucSlot;
+    for(ucSlot = 0; ucSlot < ISR_STATS_COUNT; ucSlot++)
+    {
+        HISTOGRAM_Reset(&IsrStatsCycles[ucSlot]);
+    }
+}
+
+void ISR_Record(uint8 ucSlot, uint32 ulEndCycles)
+{
+    /* Each handler owns its slot and cannot nest with itself, no mask is needed */
+    HISTOGRAM_Record(&IsrStatsCycles[ucSlot], ulEndCycles - gIsrStatsStart[ucSlot]);
+}
+
+uint32 ISR_GetMaxCycles(uint8 ucSlot)
+{
+    return IsrStatsCycles[ucSlot].Max;
+}
+
+void ISR_Report(void)
+{
+    uint8 ucSlot;
+
+    UART0_SendString((const uint8 *)"Handler times in cycles\r\n");
+    for(ucSlot = 0; ucSlot < ISR_STATS_COUNT; ucSlot++)
+    {
+        UART0_SendString((const uint8 *)IsrStatsNames[ucSlot]);
+        UART0_SendByte(' ');
+        HISTOGRAM_Report(&IsrStatsCycles[ucSlot], 1);
+    }
+}
+
+#endif /* ISR_STATS_ENABLED */
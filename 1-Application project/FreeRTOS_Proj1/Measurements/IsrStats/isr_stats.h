@@ -0,0 +1,92 @@
+ /******************************************************************************
+ *
+ * Module: IsrStats
+ *
+ * File Name: isr_stats.h
+ *
+ * Description: Header file for the interrupt handler execution time profile.
+ *              traceISR_ENTER keeps the DWT cycle count of each handler and
+ *              traceISR_EXIT records the cycles spent since into a histogram,
+ *              so the FromISR kernel calls of the handler are included while
+ *              the exception entry, the trace recording and the final
+ *              portYIELD_FROM_ISR() are not. A handler interrupted by a
+ *              higher priority one is charged the nested handler time too.
+ *
+ *              The profile follows the ISRS trace category, or build with
+ *              ISR_STATS_ENABLED defined to 0 to remove it alone: the hooks
+ *              expand to nothing and no variable or function is left in
+ *              the image.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_ISRSTATS_ISR_STATS_H_
+#define MEASUREMENTS_ISRSTATS_ISR_STATS_H_
+
+#include "std_types.h"
+#include "tm4c123gh6pm_registers.h"
+#include "trace.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#ifndef ISR_STATS_ENABLED
+#define ISR_STATS_ENABLED               TRACE_ENABLED(TRACE_CATEGORY_ISRS)
+#endif
+
+/* Profiled handlers, one slot each */
+#define ISR_STATS_GPIO_PORTE            0
+#define ISR_STATS_ADC0_SS0              1
+#define ISR_STATS_GPIO_PORTF            2
+#define ISR_STATS_ADC1_SS0              3
+#define ISR_STATS_UART0                 4
+#define ISR_STATS_COUNT                 5
+
+/* NVIC interrupt numbers (TRACE_ISR_*) to slots, folded at compile time */
+#define ISR_STATS_SLOT(ucIsrNumber)     (((ucIsrNumber) == 4)  ? ISR_STATS_GPIO_PORTE : \
+                                         ((ucIsrNumber) == 14) ? ISR_STATS_ADC0_SS0   : \
+                                         ((ucIsrNumber) == 30) ? ISR_STATS_GPIO_PORTF : \
+                                         ((ucIsrNumber) == 5)  ? ISR_STATS_UART0      : \
+                                                                 ISR_STATS_ADC1_SS0)
+
+#if ISR_STATS_ENABLED
+
+#define ISR_STATS_ENTER(ucIsrNumber)    (gIsrStatsStart[ISR_STATS_SLOT(ucIsrNumber)] = DWT_CYCCNT_REG)
+#define ISR_STATS_EXIT(ucIsrNumber)     ISR_Record(ISR_STATS_SLOT(ucIsrNumber), DWT_CYCCNT_REG)
+
+#else
+
+#define ISR_STATS_ENTER(ucIsrNumber)
+#define ISR_STATS_EXIT(ucIsrNumber)
+
+#endif /* ISR_STATS_ENABLED */
+
+#if ISR_STATS_ENABLED
+
+/*******************************************************************************
+ *                              Shared Variables                               *
+ *******************************************************************************/
+
+/* Cycle count at the entry of each handler, written by ISR_STATS_ENTER */
+extern volatile uint32 gIsrStatsStart[ISR_STATS_COUNT];
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+void ISR_Init(void);
+
+/* Called from ISR_STATS_EXIT with the cycle count at the handler exit */
+void ISR_Record(uint8 ucSlot, uint32 ulEndCycles);
+
+/* Longest execution of the handler in the slot, in cycles */
+uint32 ISR_GetMaxCycles(uint8 ucSlot);
+
+/* Print the execution time histogram of every handler, in cycles, over UART0 */
+void ISR_Report(void);
+
+#endif /* ISR_STATS_ENABLED */
+
+#endif /* MEASUREMENTS_ISRSTATS_ISR_STATS_H_ */
@@ -0,0 +1,182 @@
+ /******************************************************************************
+ *
+ * Module: Latency
+ *
+ * File Name: latency.c
+ *
+ * Description: Source file for the end-to-end latency probes.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+/* configCPU_CLOCK_HZ, unless the build gives the rate */
+#ifndef LAT_CYCLES_PER_US
+#include "FreeRTOSConfig.h"
+#endif
+#include "latency.h"
+#include "trace.h"
+
+#if TRACE_ENABLED(TRACE_CATEGORY_PROBES)
+
+#include "uart0.h"
+
+static LatencyChain LatencyChains[LAT_CHAINS];
+
+/* Chain being printed by LAT_Report(), too big for a task stack */
+static LatencyChain LatencyReportChain;
+
+/* Items sent to and received from the LAT_QUEUE_NUMBER queue since reset */
+static uint32 LatencyItemsSent;
+static uint32 LatencyItemsReceived;
+
+static const char *const LatencyChainNames[LAT_CHAINS] =
+{
+    "Driver button -> heater output",
+    "Driver ADC sample -> heater output"
+};
+
+static const char *const LatencyHopNames[LAT_CHAINS][LAT_MAX_HOPS] =
+{
+    { "ISR -> button task", "button task -> intensity decision", "intensity decision -> GPIO" },
+    { "ISR -> intensity decision", "intensity decision -> GPIO", NULL_PTR }
+};
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void LAT_Complete(uint8 ucChain, uint8 ucHop, uint32 ulItemSeen, uint32 ulItemNext)
+{
+    LatencyChain *pxChain = &LatencyChains[ucChain];
+    uint32 ulNow;
+
+    if((pxChain->NextHop != ucHop) || ((pxChain->Item != 0) && (pxChain->Item != ulItemSeen)))
+    {
+        return;
+    }
+
+    ulNow = LAT_TIMESTAMP();
+    HISTOGRAM_Record(&pxChain->Hop[ucHop], ulNow - pxChain->HopStart);
+    pxChain->HopStart = ulNow;
+    pxChain->Item = ulItemNext;
+    pxChain->NextHop++;
+
+    if(pxChain->NextHop == pxChain->Hops)
+    {
+        HISTOGRAM_Record(&pxChain->Total, ulNow - pxChain->Start);
+        pxChain->NextHop = LAT_IDLE;
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void LAT_Init(void)
+{
+    uint8 ucChain;
+    uint8 ucHop;
+    for(ucChain = 0; ucChain < LAT_CHAINS; ucChain++)
+    {
+        for(ucHop = 0; ucHop < LAT_MAX_HOPS; ucHop++)
+        {
+            HISTOGRAM_Reset(&LatencyChains[ucChain].Hop[ucHop]);
+        }
+        HISTOGRAM_Reset(&LatencyChains[ucChain].Total);
+        LatencyChains[ucChain].NextHop = LAT_IDLE;
+        LatencyChains[ucChain].Superseded = 0;
+        LatencyChains[ucChain].Lost = 0;
+    }
+    LatencyChains[LAT_CHAIN_DRIVER_BUTTON].Hops = 3;
+    LatencyChains[LAT_CHAIN_DRIVER_SENSOR].Hops = 2;
+}
+
+void LAT_Start(uint8 ucChain)
+{
+    LatencyChain *pxChain = &LatencyChains[ucChain];
+
+    if(pxChain->NextHop != LAT_IDLE)
+    {
+        pxChain->Superseded++;
+    }
+    pxChain->Start = LAT_TIMESTAMP();
+    pxChain->HopStart = pxChain->Start;
+    pxChain->Item = 0;
+    pxChain->NextHop = 0;
+}
+
+void LAT_Probe(uint8 ucChain, uint8 ucHop)
+{
+    LAT_Complete(ucChain, ucHop, 0, 0);
+}
+
+void LAT_ProbeSent(uint8 ucChain, uint8 ucHop)
+{
+    LAT_Complete(ucChain, ucHop, 0, LatencyItemsSent + 1);
+}
+
+void LAT_ProbeReceived(uint8 ucChain, uint8 ucHop)
+{
+    LatencyChain *pxChain = &LatencyChains[ucChain];
+
+    /* Items are received in order, so once a later one is out ours went to another task */
+    if((pxChain->NextHop == ucHop) && (pxChain->Item != 0) && ((sint32)(LatencyItemsReceived - pxChain->Item) > 0))
+    {
+        pxChain->Lost++;
+        pxChain->NextHop = LAT_IDLE;
+        return;
+    }
+    LAT_Complete(ucChain, ucHop, LatencyItemsReceived, 0);
+}
+
+void LAT_ItemSent(void)
+{
+    LatencyItemsSent++;
+    if(LatencyItemsSent == 0)
+    {
+        LatencyItemsSent = 1; /* 0 is kept for "any item" */
+    }
+}
+
+void LAT_ItemReceived(void)
+{
+    LatencyItemsReceived++;
+    if(LatencyItemsReceived == 0)
+    {
+        LatencyItemsReceived = 1;
+    }
+}
+
+void LAT_GetChain(uint8 ucChain, LatencyChain *pxChain)
+{
+    *pxChain = LatencyChains[ucChain];
+}
+
+void LAT_Report(void (*GetChainFun)(uint8, LatencyChain *))
+{
+    uint8 ucChain;
+    uint8 ucHop;
+
+    UART0_SendString((const uint8 *)"Latency in usec\r\n");
+    for(ucChain = 0; ucChain < LAT_CHAINS; ucChain++)
+    {
+        GetChainFun(ucChain, &LatencyReportChain);
+        UART0_SendString((const uint8 *)LatencyChainNames[ucChain]);
+        UART0_SendString((const uint8 *)" superseded=");
+        UART0_SendInteger(LatencyReportChain.Superseded);
+        UART0_SendString((const uint8 *)" lost=");
+        UART0_SendInteger(LatencyReportChain.Lost);
+        UART0_SendString((const uint8 *)"\r\n  total ");
+        HISTOGRAM_Report(&LatencyReportChain.Total, LAT_CYCLES_PER_US);
+        for(ucHop = 0; ucHop < LatencyReportChain.Hops; ucHop++)
+        {
+            UART0_SendString((const uint8 *)"  ");
+            UART0_SendString((const uint8 *)LatencyHopNames[ucChain][ucHop]);
+            UART0_SendByte(' ');
+            HISTOGRAM_Report(&LatencyReportChain.Hop[ucHop], LAT_CYCLES_PER_US);
+        }
+    }
+}
+
+#endif /* TRACE_CATEGORY_PROBES */
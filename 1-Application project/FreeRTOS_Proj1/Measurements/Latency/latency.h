@@ -0,0 +1,109 @@
+ /******************************************************************************
+ *
+ * Module: Latency
+ *
+ * File Name: latency.h
+ *
+ * Description: Header file for the end-to-end latency probes. A chain is
+ *              started by an input (button or ADC interrupt) and every probe
+ *              point along the tasks completes one hop, so each hop and the
+ *              whole chain get their own latency histogram.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_LATENCY_LATENCY_H_
+#define MEASUREMENTS_LATENCY_LATENCY_H_
+
+#include "std_types.h"
+#include "histogram.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define LAT_MAX_HOPS                    3
+
+/* NextHop of a chain that is not running */
+#define LAT_IDLE                        0xFF
+
+/* Times are DWT cycle counts, reported in microseconds. The host builds
+ * without the kernel configuration give the rate with -D */
+#define LAT_TIMESTAMP()                 (DWT_CYCCNT_REG)
+#ifndef LAT_CYCLES_PER_US
+#define LAT_CYCLES_PER_US               (configCPU_CLOCK_HZ / 1000000UL)
+#endif
+
+/* SW1 press: GPIOPortF_Handler -> vButtonHandleTask (xDriverSeat.SeatTemp) ->
+ * vSeatIntensityTask (xDriverSeat.IntensityQueue) -> vSeatHeaterTask (GPIO) */
+#define LAT_CHAIN_DRIVER_BUTTON         0
+#define LAT_HOP_BUTTON_TASK             0
+#define LAT_HOP_BUTTON_DECISION         1
+#define LAT_HOP_BUTTON_OUTPUT           2
+
+/* Driver ADC sample: ADC0_Handler (xDriverSeat.Temp) ->
+ * vSeatIntensityTask (xDriverSeat.IntensityQueue) -> vSeatHeaterTask (GPIO) */
+#define LAT_CHAIN_DRIVER_SENSOR         1
+#define LAT_HOP_SENSOR_DECISION         0
+#define LAT_HOP_SENSOR_OUTPUT           1
+
+#define LAT_CHAINS                      2
+
+/* Queue number of xDriverSeat.IntensityQueue, its items are counted by the queue
+ * trace hooks so a chain follows its own item through the queue. The display
+ * task also receives from this queue, a chain whose item it takes is lost. */
+#define LAT_QUEUE_NUMBER                6
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 Start;       /* Cycle count of the input */
+    uint32 HopStart;    /* Cycle count of the last completed hop */
+    uint32 Item;        /* Queue item the next hop waits for, 0 for any */
+    uint8 NextHop;      /* Hop the chain waits for, LAT_IDLE when not running */
+    uint8 Hops;
+    uint32 Superseded;  /* Inputs that came before the previous one reached the output */
+    uint32 Lost;        /* Chains whose queue item was received by another task */
+    Histogram Hop[LAT_MAX_HOPS];
+    Histogram Total;
+} LatencyChain;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/*
+ * The probes are not protected, use the traceLATENCY_* wrappers of
+ * FreeRTOSConfig.h which mask the kernel interrupts around them.
+ */
+void LAT_Init(void);
+
+/* The input happened, a chain still running is restarted from here */
+void LAT_Start(uint8 ucChain);
+
+/* Complete ucHop if the chain waits for it */
+void LAT_Probe(uint8 ucChain, uint8 ucHop);
+
+/* Complete ucHop just before sending to the LAT_QUEUE_NUMBER queue, the next
+ * hop is then only completed by the receiver of that same item */
+void LAT_ProbeSent(uint8 ucChain, uint8 ucHop);
+void LAT_ProbeReceived(uint8 ucChain, uint8 ucHop);
+
+/* Called from the queue trace hooks for the LAT_QUEUE_NUMBER queue */
+void LAT_ItemSent(void);
+void LAT_ItemReceived(void);
+
+/* Copy of one chain, unprotected */
+void LAT_GetChain(uint8 ucChain, LatencyChain *pxChain);
+
+/* Print the hop and total histograms of every chain over UART0. Each chain
+ * is copied by GetChainFun first, which masks the probes around LAT_GetChain()
+ * on the target, so only the copy and not the printing holds them off. */
+void LAT_Report(void (*GetChainFun)(uint8, LatencyChain *));
+
+#endif /* MEASUREMENTS_LATENCY_LATENCY_H_ */
@@ -0,0 +1,183 @@
+ /******************************************************************************
+ *
+ * Module: LockStats
+ *
+ * File Name: lock_stats.c
+ *
+ * Description: Source file for the lock wait and hold time histograms.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lock_stats.h"
+#include "trace.h"
+
+#if TRACE_ENABLED(TRACE_CATEGORY_QUEUES)
+
+#include "uart0.h"
+#include "tm4c123gh6pm_registers.h"
+
+#define LOCK_TIMESTAMP()                (DWT_CYCCNT_REG)
+
+/* Longest time the cycle counter measures without wrapping, in whole ticks */
+#define LOCK_MAX_CYCLE_TICKS            ((LOCK_SATURATED / (configCPU_CLOCK_HZ / configTICK_RATE_HZ)) - 1)
+
+static LockStats LockStatsTable[LOCK_COUNT];
+
+/* Cycle count and tick count when each task started waiting, the cycle count
+ * is 0 when it is not waiting */
+static uint32 LockWaitStart[LOCK_MAX_TASKS];
+static TickType_t LockWaitStartTick[LOCK_MAX_TASKS];
+
+/* Cycle count and tick count of the last successful take of each lock, valid
+ * while the bit is set */
+static uint32 LockTakeTime[LOCK_COUNT];
+static TickType_t LockTakeTick[LOCK_COUNT];
+static uint8 LockTaken;
+
+static const char *const LockNames[LOCK_COUNT] =
+{
+    "xDriverMutex",
+    "xPassengerMutex",
+    "xDriverTempSemphr",
+    "xPassengerTempSemphr",
+    "xDriverErrorSemaphore",
+    "xPassengerErrorSemaphore"
+};
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Tasks above LOCK_MAX_TASKS share slot 0 */
+static uint16 LOCK_CurrentTaskNumber(void)
+{
+    UBaseType_t uxTaskNumber = uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+    return (uxTaskNumber < LOCK_MAX_TASKS) ? (uint16)uxTaskNumber : 0;
+}
+
+/* Cycles since the start, LOCK_SATURATED once the tick count shows the cycle
+ * counter wrapped on the way */
+static uint32 LOCK_Elapsed(uint32 ulStart, uint32 ulNow, TickType_t xTicks)
+{
+    return (xTicks > LOCK_MAX_CYCLE_TICKS) ? LOCK_SATURATED : (ulNow - ulStart);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void LOCK_Init(void)
+{
+    uint8 ucLock;
+    for(ucLock = 0; ucLock < LOCK_COUNT; ucLock++)
+    {
+        HISTOGRAM_Reset(&LockStatsTable[ucLock].Wait);
+        HISTOGRAM_Reset(&LockStatsTable[ucLock].Hold);
+        LockStatsTable[ucLock].Timeouts = 0;
+        LockStatsTable[ucLock].MaxWaiter = NULL;
+        LockStatsTable[ucLock].MaxWaitTicks = 0;
+    }
+    LockTaken = 0;
+}
+
+void LOCK_TakeBlocked(uint8 ucLock)
+{
+    uint16 usTask = LOCK_CurrentTaskNumber();
+    (void)ucLock;
+
+    /* The kernel calls the hook again each time the task blocks again for the same take.
+     * Bit 0 is forced so a start time is never 0, which means not waiting. */
+    if(LockWaitStart[usTask] == 0)
+    {
+        LockWaitStart[usTask] = LOCK_TIMESTAMP() | 1;
+        LockWaitStartTick[usTask] = xTaskGetTickCount();
+    }
+}
+
+void LOCK_Taken(uint8 ucLock)
+{
+    LockStats *pxStats = &LockStatsTable[ucLock];
+    uint16 usTask = LOCK_CurrentTaskNumber();
+    uint32 ulNow = LOCK_TIMESTAMP();
+    TickType_t xNowTick = xTaskGetTickCount();
+    TickType_t xWaitTicks = 0;
+    uint32 ulWait = 0;
+    boolean bLongest;
+
+    if(LockWaitStart[usTask] != 0)
+    {
+        xWaitTicks = xNowTick - LockWaitStartTick[usTask];
+        ulWait = LOCK_Elapsed(LockWaitStart[usTask], ulNow, xWaitTicks);
+        LockWaitStart[usTask] = 0;
+    }
+    /* Saturated waits are told apart by their ticks */
+    bLongest = (ulWait == LOCK_SATURATED) ? (xWaitTicks > pxStats->MaxWaitTicks) : (ulWait > pxStats->Wait.Max);
+    if(bLongest)
+    {
+        pxStats->MaxWaiter = xTaskGetCurrentTaskHandle();
+        pxStats->MaxWaitTicks = xWaitTicks;
+    }
+    HISTOGRAM_Record(&pxStats->Wait, ulWait);
+
+    LockTakeTime[ucLock] = ulNow;
+    LockTakeTick[ucLock] = xNowTick;
+    LockTaken |= (1 << ucLock);
+}
+
+void LOCK_TakeFailed(uint8 ucLock)
+{
+    LockWaitStart[LOCK_CurrentTaskNumber()] = 0;
+    LockStatsTable[ucLock].Timeouts++;
+}
+
+void LOCK_Given(uint8 ucLock)
+{
+    /* Gives without a take before them (creating a mutex gives it once) are not
+     * holds. They also come from interrupts, hence the tick count FromISR */
+    if(LockTaken & (1 << ucLock))
+    {
+        HISTOGRAM_Record(&LockStatsTable[ucLock].Hold,
+                         LOCK_Elapsed(LockTakeTime[ucLock], LOCK_TIMESTAMP(), xTaskGetTickCountFromISR() - LockTakeTick[ucLock]));
+        LockTaken &= ~(1 << ucLock);
+    }
+}
+
+void LOCK_Report(void)
+{
+    static LockStats xSnapshot;
+    uint8 ucLock;
+
+    UART0_SendString((const uint8 *)"Lock times in usec\r\n");
+    for(ucLock = 0; ucLock < LOCK_COUNT; ucLock++)
+    {
+        /* Copy first so the hooks cannot change the numbers halfway through printing */
+        taskENTER_CRITICAL();
+        xSnapshot = LockStatsTable[ucLock];
+        taskEXIT_CRITICAL();
+
+        UART0_SendString((const uint8 *)LockNames[ucLock]);
+        UART0_SendString((const uint8 *)" timeouts=");
+        UART0_SendInteger(xSnapshot.Timeouts);
+        if(xSnapshot.MaxWaiter != NULL)
+        {
+            UART0_SendString((const uint8 *)" longest wait by ");
+            UART0_SendString((const uint8 *)pcTaskGetName((TaskHandle_t)xSnapshot.MaxWaiter));
+            if(xSnapshot.Wait.Max == LOCK_SATURATED)
+            {
+                UART0_SendString((const uint8 *)" for ");
+                UART0_SendInteger((uint64)xSnapshot.MaxWaitTicks * portTICK_PERIOD_MS);
+                UART0_SendString((const uint8 *)"ms");
+            }
+        }
+        UART0_SendString((const uint8 *)"\r\n  wait ");
+        HISTOGRAM_Report(&xSnapshot.Wait, LOCK_CYCLES_PER_US);
+        UART0_SendString((const uint8 *)"  hold ");
+        HISTOGRAM_Report(&xSnapshot.Hold, LOCK_CYCLES_PER_US);
+    }
+}
+
+#endif /* TRACE_CATEGORY_QUEUES */
@@ -0,0 +1,65 @@
+ /******************************************************************************
+ *
+ * Module: LockStats
+ *
+ * File Name: lock_stats.h
+ *
+ * Description: Header file for the lock wait and hold time histograms. The
+ *              mutexes and semaphores numbered 0 .. LOCK_COUNT-1 with
+ *              vQueueSetQueueNumber() are tracked from the queue trace hooks.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_LOCKSTATS_LOCK_STATS_H_
+#define MEASUREMENTS_LOCKSTATS_LOCK_STATS_H_
+
+#include "std_types.h"
+#include "histogram.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Queue numbers 0 .. LOCK_COUNT-1 are the locks, see main.c */
+#define LOCK_COUNT                      6
+
+/* Tasks with a task number at or above this value are not tracked, needs FreeRTOS.h */
+#define LOCK_MAX_TASKS                  configMEASURED_TASKS
+
+/* Times are DWT cycle counts, reported in microseconds. Those past the
+ * ~268 s range of the counter at 16 MHz are told by the tick count and
+ * recorded as LOCK_SATURATED, needs FreeRTOS.h */
+#define LOCK_CYCLES_PER_US              (configCPU_CLOCK_HZ / 1000000UL)
+#define LOCK_SATURATED                  0xFFFFFFFFUL
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    Histogram Wait;     /* From the take blocking to the take succeeding (0 when not contended) */
+    Histogram Hold;     /* From a successful take to the next give */
+    uint32 Timeouts;    /* Takes that gave up waiting */
+    void *MaxWaiter;    /* Handle of the task that waited the longest */
+    uint32 MaxWaitTicks; /* Its wait in ticks, which still counts past LOCK_SATURATED */
+} LockStats;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+void LOCK_Init(void);
+
+/* Called from the queue trace hooks with the kernel interrupts masked */
+void LOCK_TakeBlocked(uint8 ucLock);
+void LOCK_Taken(uint8 ucLock);
+void LOCK_TakeFailed(uint8 ucLock);
+void LOCK_Given(uint8 ucLock);
+
+/* Print the histograms of every lock over UART0 */
+void LOCK_Report(void);
+
+#endif /* MEASUREMENTS_LOCKSTATS_LOCK_STATS_H_ */
@@ -0,0 +1,105 @@
+ /******************************************************************************
+ *
+ * Module: QueueStats
+ *
+ * File Name: queue_stats.c
+ *
+ * Description: Source file for the queue depth statistics.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue_stats.h"
+#include "trace.h"
+
+#if TRACE_ENABLED(TRACE_CATEGORY_QUEUES)
+
+#include "uart0.h"
+
+static QueueStats QueueStatsTable[QSTATS_COUNT];
+
+static const char *const QueueNames[QSTATS_COUNT] =
+{
+    "xDriverIntensityQueue",
+    "xPassengerIntensityQueue",
+    "xDriverDiagnosticsQueue",
+    "xPassengerDiagnosticsQueue"
+};
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void QSTATS_Init(void)
+{
+    uint8 ucQueue;
+    for(ucQueue = 0; ucQueue < QSTATS_COUNT; ucQueue++)
+    {
+        QueueStatsTable[ucQueue].Sends = 0;
+        QueueStatsTable[ucQueue].Full = 0;
+        QueueStatsTable[ucQueue].Peak = 0;
+        QueueStatsTable[ucQueue].Length = 0;
+    }
+}
+
+void QSTATS_Sent(uint8 ucQueue, uint32 ulWaiting, uint32 ulLength)
+{
+    QueueStats *pxStats = &QueueStatsTable[ucQueue];
+
+    /* An overwrite of a full queue does not add an item */
+    if(ulWaiting < ulLength)
+    {
+        ulWaiting++;
+    }
+    if(ulWaiting > pxStats->Peak)
+    {
+        pxStats->Peak = (uint16)ulWaiting;
+    }
+    pxStats->Length = (uint16)ulLength;
+    pxStats->Sends++;
+}
+
+void QSTATS_Full(uint8 ucQueue)
+{
+    QueueStatsTable[ucQueue].Full++;
+}
+
+void QSTATS_Get(uint8 ucQueue, QueueStats *pxStats)
+{
+    *pxStats = QueueStatsTable[ucQueue];
+}
+
+const char *QSTATS_GetName(uint8 ucQueue)
+{
+    return QueueNames[ucQueue];
+}
+
+void QSTATS_Report(void)
+{
+    QueueStats xSnapshot;
+    uint8 ucQueue;
+
+    UART0_SendString((const uint8 *)"Queue depth peak/length\r\n");
+    for(ucQueue = 0; ucQueue < QSTATS_COUNT; ucQueue++)
+    {
+        /* Copy first so the hooks cannot change the numbers halfway through printing */
+        taskENTER_CRITICAL();
+        QSTATS_Get(ucQueue, &xSnapshot);
+        taskEXIT_CRITICAL();
+        UART0_SendString((const uint8 *)QueueNames[ucQueue]);
+        UART0_SendByte(' ');
+        UART0_SendInteger(xSnapshot.Peak);
+        UART0_SendByte('/');
+        UART0_SendInteger(xSnapshot.Length);
+        UART0_SendString((const uint8 *)" sends=");
+        UART0_SendInteger(xSnapshot.Sends);
+        UART0_SendString((const uint8 *)" full=");
+        UART0_SendInteger(xSnapshot.Full);
+        UART0_SendString((const uint8 *)"\r\n");
+    }
+}
+
+#endif /* TRACE_CATEGORY_QUEUES */
@@ -0,0 +1,62 @@
+ /******************************************************************************
+ *
+ * Module: QueueStats
+ *
+ * File Name: queue_stats.h
+ *
+ * Description: Header file for the queue depth statistics. The data queues
+ *              numbered QSTATS_FIRST_QUEUE .. QSTATS_FIRST_QUEUE+QSTATS_COUNT-1
+ *              with vQueueSetQueueNumber() keep the highest number of items
+ *              they held, fed from the queue send trace hooks.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_QUEUESTATS_QUEUE_STATS_H_
+#define MEASUREMENTS_QUEUESTATS_QUEUE_STATS_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* The data queues follow the locks in the numbering of main.c */
+#define QSTATS_FIRST_QUEUE              6
+#define QSTATS_COUNT                    4
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 Sends;       /* Items sent, from tasks and interrupts */
+    uint32 Full;        /* Sends that found the queue full, blocked or failed */
+    uint16 Peak;        /* Most items waiting at once */
+    uint16 Length;
+} QueueStats;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+void QSTATS_Init(void);
+
+/* Called from the queue send trace hooks with the kernel interrupts masked,
+ * before the item is copied: ulWaiting is the count without the new item */
+void QSTATS_Sent(uint8 ucQueue, uint32 ulWaiting, uint32 ulLength);
+
+/* Called from the queue full trace hooks, same locking rule */
+void QSTATS_Full(uint8 ucQueue);
+
+/* Statistics of queue ucQueue (0 .. QSTATS_COUNT-1) and its name in main.c,
+ * unprotected: mask the kernel interrupts around it if the hooks can run */
+void QSTATS_Get(uint8 ucQueue, QueueStats *pxStats);
+const char *QSTATS_GetName(uint8 ucQueue);
+
+/* Print the peak depth and full count of every queue over UART0 */
+void QSTATS_Report(void);
+
+#endif /* MEASUREMENTS_QUEUESTATS_QUEUE_STATS_H_ */
@@ -0,0 +1,111 @@
+ /******************************************************************************
+ *
+ * Module: Recorder
+ *
+ * File Name: recorder.c
+ *
+ * Description: Source file for the input recorder.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "recorder.h"
+
+#if RECORDER_ENABLED
+
+static RecRecord RecBuffer[REC_BUFFER_SIZE];
+static volatile uint32 RecHead = 0;
+static uint32 RecTail = 0;
+static volatile uint8 RecOn = FALSE;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void REC_SendHalfWord(void (*SendByteFun)(uint8), uint16 usData)
+{
+    SendByteFun((uint8)(usData));
+    SendByteFun((uint8)(usData >> 8));
+}
+
+static void REC_SendWord(void (*SendByteFun)(uint8), uint32 ulData)
+{
+    REC_SendHalfWord(SendByteFun, (uint16)(ulData));
+    REC_SendHalfWord(SendByteFun, (uint16)(ulData >> 16));
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void REC_Start(void)
+{
+    RecTail = RecHead;
+    RecOn = TRUE;
+}
+
+void REC_Stop(void)
+{
+    RecOn = FALSE;
+}
+
+boolean REC_IsOn(void)
+{
+    return RecOn;
+}
+
+void REC_Record(uint8 ucEvent, uint8 ucId, uint16 usArg)
+{
+    RecRecord *pxRecord;
+
+    if(!RecOn)
+    {
+        return;
+    }
+    pxRecord = &RecBuffer[RecHead & REC_BUFFER_MASK];
+    pxRecord->TimeStamp = REC_TIMESTAMP();
+    pxRecord->Event = ucEvent;
+    pxRecord->Id = ucId;
+    pxRecord->Arg = usArg;
+    RecHead++;
+}
+
+void REC_Drain(void (*SendByteFun)(uint8))
+{
+    const char *pcMagic = REC_FRAME_MAGIC;
+    const RecRecord *pxRecord;
+    uint32 ulHead = RecHead;
+    uint32 ulCount = ulHead - RecTail;
+    uint32 ulLost = 0;
+
+    if(ulCount == 0)
+    {
+        return;
+    }
+    if(ulCount > REC_BUFFER_SIZE)
+    {
+        ulLost = ulCount - REC_BUFFER_SIZE;
+        ulCount = REC_BUFFER_SIZE;
+    }
+
+    while(*pcMagic != '\0')
+    {
+        SendByteFun((uint8)*pcMagic++);
+    }
+    REC_SendWord(SendByteFun, REC_TIMESTAMP_HZ);
+    REC_SendWord(SendByteFun, ulLost);
+    REC_SendHalfWord(SendByteFun, (uint16)ulCount);
+
+    for(RecTail = ulHead - ulCount; RecTail != ulHead; RecTail++)
+    {
+        pxRecord = &RecBuffer[RecTail & REC_BUFFER_MASK];
+        REC_SendWord(SendByteFun, pxRecord->TimeStamp);
+        SendByteFun(pxRecord->Event);
+        SendByteFun(pxRecord->Id);
+        REC_SendHalfWord(SendByteFun, pxRecord->Arg);
+    }
+}
+
+#endif /* RECORDER_ENABLED */
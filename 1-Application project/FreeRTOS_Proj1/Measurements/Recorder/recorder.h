@@ -0,0 +1,103 @@
+ /******************************************************************************
+ *
+ * Module: Recorder
+ *
+ * File Name: recorder.h
+ *
+ * Description: Header file for the input recorder. The samples read by the
+ *              seat sensor handlers and the button edges taken by the GPIO
+ *              handlers are written with their DWT time stamp into a small
+ *              RAM ring. While recording is on (console command 'r') the
+ *              console task drains the new records as one binary frame once
+ *              a second, so a field session captured from UART0 can be
+ *              replayed on the host simulation (Tools/sensor_trace.py turns
+ *              the capture into a trace file).
+ *
+ *              The recorder follows the PROBES trace category, or build with
+ *              RECORDER_ENABLED defined to 0 to remove it alone.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_RECORDER_RECORDER_H_
+#define MEASUREMENTS_RECORDER_RECORDER_H_
+
+#include "std_types.h"
+#include "tm4c123gh6pm_registers.h"
+#include "trace.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#ifndef RECORDER_ENABLED
+#define RECORDER_ENABLED                TRACE_ENABLED(TRACE_CATEGORY_PROBES)
+#endif
+
+/* Records kept between two drains, must be a power of 2 (8 bytes each).
+ * The sensors give 4 records per second, the rest is left to the buttons */
+#define REC_BUFFER_SIZE                 32
+#define REC_BUFFER_MASK                 (REC_BUFFER_SIZE - 1)
+
+/* Time stamps are raw DWT cycle counts, the counter runs at the CPU clock.
+ * The rate goes into every frame for the replay, so it follows the kernel
+ * configuration (FreeRTOS.h is included by recorder.c) */
+#define REC_TIMESTAMP_HZ                configCPU_CLOCK_HZ
+#define REC_TIMESTAMP()                 (DWT_CYCCNT_REG)
+
+/* Record types, the meaning of Id and Arg is given for each one */
+#define REC_EVENT_ADC                   0x01  /* Id: REC_ADC_*, Arg: 12-bit sample */
+#define REC_EVENT_BUTTON                0x02  /* Id: REC_PIN() of the falling edge */
+
+#define REC_ADC_DRIVER                  0     /* ADC0, AIN7 on PD0 */
+#define REC_ADC_PASSENGER               1     /* ADC1, AIN6 on PD1 */
+
+/* Port (0 for A) and pin number of a button input */
+#define REC_PIN(port, pin)              ((uint8)(((port) << 4) | (pin)))
+#define REC_PIN_PORTE                   4
+#define REC_PIN_PORTF                   5
+
+/* Drained frame: "REC1", clock Hz, records lost since the previous frame,
+ * records count, then the raw records. All multi-byte fields are little endian. */
+#define REC_FRAME_MAGIC                 "REC1"
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 TimeStamp;
+    uint8 Event;
+    uint8 Id;
+    uint16 Arg;
+} RecRecord;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+#if RECORDER_ENABLED
+
+/* Drops what was recorded before and records from now on */
+void REC_Start(void);
+
+void REC_Stop(void);
+
+boolean REC_IsOn(void);
+
+/* Called by traceRECORD_INPUT with the kernel interrupts masked, so a nested
+ * handler cannot tear the record being written */
+void REC_Record(uint8 ucEvent, uint8 ucId, uint16 usArg);
+
+/*
+ * Send the records made since the previous drain as one frame, nothing when
+ * there are none. The handlers keep recording meanwhile: the ring only wraps
+ * onto the records being sent if REC_BUFFER_SIZE of them come during the drain.
+ */
+void REC_Drain(void (*SendByteFun)(uint8));
+
+#endif /* RECORDER_ENABLED */
+
+#endif /* MEASUREMENTS_RECORDER_RECORDER_H_ */
@@ -0,0 +1,270 @@
+ /******************************************************************************
+ *
+ * Module: RunTimeStats
+ *
+ * File Name: runtime_stats.c
+ *
+ * Description: Source file for the windowed CPU load measurements.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "runtime_stats.h"
+
+#if configGENERATE_RUN_TIME_STATS
+
+#include "uart0.h"
+
+#define RTS_NAME_COLUMN_WIDTH           20
+
+/* One extra 10 s bucket is being filled while the other six are reported */
+#define RTS_LONG_RING                   (RTS_LONG_BUCKETS + 1)
+
+/* Used by uxTaskGetSystemState(), kept static as it is too big for a task stack */
+static TaskStatus_t RtsTaskStatus[RTS_MAX_TASKS];
+
+static const char *RtsTaskNames[RTS_MAX_TASKS];
+static TaskHandle_t RtsIdleTask;
+static uint16 RtsIdleTaskNumber = RTS_MAX_TASKS;
+
+/* Counter values at the previous sample. All deltas are computed with unsigned
+ * subtraction so they stay right when WTimer0 or a task counter wraps. */
+static uint32 RtsLastTaskCounter[RTS_MAX_TASKS];
+static uint32 RtsLastTotalCounter;
+
+/* Run time per task (and elapsed time) in every bucket, in WTimer0 counts.
+ * 32 bits wide as a sample that comes late by more than 6.5 s would wrap a
+ * 16 bit bucket. */
+static uint32 RtsShortTask[RTS_SHORT_BUCKETS][RTS_MAX_TASKS];
+static uint32 RtsShortTotal[RTS_SHORT_BUCKETS];
+static uint32 RtsLongTask[RTS_LONG_RING][RTS_MAX_TASKS];
+static uint32 RtsLongTotal[RTS_LONG_RING];
+
+static uint32 RtsSamples = 0;
+
+/* Loads taken by RTS_Report() before it prints, per task and CPU (last row) */
+static uint16 RtsReportLoad[RTS_MAX_TASKS + 1][RTS_WINDOW_60S + 1];
+static const char *RtsReportNames[RTS_MAX_TASKS];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Sum the task (or total when usTaskNumber >= RTS_MAX_TASKS) time over a window */
+static void RTS_SumWindow(uint16 usTaskNumber, uint8 ucWindow, uint32 *pulTask, uint32 *pulTotal)
+{
+    uint32 ulBucket;
+    uint32 ulBuckets;
+    uint32 ulNewest;
+
+    *pulTask = 0;
+    *pulTotal = 0;
+    if(RtsSamples < 2)
+    {
+        return; /* The first sample only sets the reference counters */
+    }
+
+    if(ucWindow == RTS_WINDOW_60S)
+    {
+        /* Only the completed 10 s buckets, so this window moves every 10 s */
+        ulNewest = (RtsSamples - 1) / RTS_SHORT_BUCKETS;
+        ulBuckets = (ulNewest < RTS_LONG_BUCKETS) ? ulNewest : RTS_LONG_BUCKETS;
+        for(ulBucket = 1; ulBucket <= ulBuckets; ulBucket++)
+        {
+            uint32 ulIndex = (ulNewest - ulBucket) % RTS_LONG_RING;
+            *pulTotal += RtsLongTotal[ulIndex];
+            *pulTask += (usTaskNumber < RTS_MAX_TASKS) ? RtsLongTask[ulIndex][usTaskNumber] : 0;
+        }
+    }
+    else
+    {
+        ulNewest = (RtsSamples - 2) % RTS_SHORT_BUCKETS;
+        ulBuckets = (ucWindow == RTS_WINDOW_1S) ? 1 : RTS_SHORT_BUCKETS;
+        ulBuckets = (ulBuckets < (RtsSamples - 1)) ? ulBuckets : (RtsSamples - 1);
+        for(ulBucket = 0; ulBucket < ulBuckets; ulBucket++)
+        {
+            uint32 ulIndex = (ulNewest + RTS_SHORT_BUCKETS - ulBucket) % RTS_SHORT_BUCKETS;
+            *pulTotal += RtsShortTotal[ulIndex];
+            *pulTask += (usTaskNumber < RTS_MAX_TASKS) ? RtsShortTask[ulIndex][usTaskNumber] : 0;
+        }
+    }
+}
+
+static uint16 RTS_Permille(uint32 ulPart, uint32 ulTotal)
+{
+    if(ulTotal == 0)
+    {
+        return 0;
+    }
+    /* ulPart * 1000 stays below 2^32 for windows up to 429 s at 0.1 msec per count */
+    return (uint16)((ulPart * 1000UL + ulTotal / 2) / ulTotal);
+}
+
+static void RTS_SendPermille(uint16 usPermille)
+{
+    if(usPermille < 1000)
+    {
+        UART0_SendByte(' ');
+    }
+    if(usPermille < 100)
+    {
+        UART0_SendByte(' ');
+    }
+    UART0_SendInteger(usPermille / 10);
+    UART0_SendByte('.');
+    UART0_SendInteger(usPermille % 10);
+    UART0_SendString((const uint8 *)"%  ");
+}
+
+static void RTS_SendName(const char *pcName)
+{
+    uint8 ucLength = 0;
+    while((pcName[ucLength] != '\0') && (ucLength < RTS_NAME_COLUMN_WIDTH))
+    {
+        UART0_SendByte((uint8)pcName[ucLength]);
+        ucLength++;
+    }
+    for(; ucLength < RTS_NAME_COLUMN_WIDTH; ucLength++)
+    {
+        UART0_SendByte(' ');
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void RTS_Sample(void)
+{
+    UBaseType_t uxTasks;
+    UBaseType_t uxIndex;
+    configRUN_TIME_COUNTER_TYPE ulTotalCounter;
+    uint32 ulShort;
+    uint32 ulLong;
+    uint32 ulTaskNumber;
+
+    /* 0 when the tasks outnumber RtsTaskStatus, see configMEASURED_TASKS */
+    uxTasks = uxTaskGetSystemState(RtsTaskStatus, RTS_MAX_TASKS, &ulTotalCounter);
+    configASSERT(uxTasks != 0);
+    if(RtsIdleTask == NULL)
+    {
+        RtsIdleTask = xTaskGetIdleTaskHandle();
+    }
+
+    if(RtsSamples > 0)
+    {
+        ulShort = (RtsSamples - 1) % RTS_SHORT_BUCKETS;
+        ulLong = ((RtsSamples - 1) / RTS_SHORT_BUCKETS) % RTS_LONG_RING;
+
+        /* Starting a new 10 s bucket, clear what is left from 70 s ago */
+        if(ulShort == 0)
+        {
+            RtsLongTotal[ulLong] = 0;
+            for(ulTaskNumber = 0; ulTaskNumber < RTS_MAX_TASKS; ulTaskNumber++)
+            {
+                RtsLongTask[ulLong][ulTaskNumber] = 0;
+            }
+        }
+
+        RtsShortTotal[ulShort] = ulTotalCounter - RtsLastTotalCounter;
+        RtsLongTotal[ulLong] += RtsShortTotal[ulShort];
+        for(ulTaskNumber = 0; ulTaskNumber < RTS_MAX_TASKS; ulTaskNumber++)
+        {
+            RtsShortTask[ulShort][ulTaskNumber] = 0;
+        }
+    }
+
+    for(uxIndex = 0; uxIndex < uxTasks; uxIndex++)
+    {
+        ulTaskNumber = RtsTaskStatus[uxIndex].xTaskNumber;
+        if(ulTaskNumber >= RTS_MAX_TASKS)
+        {
+            continue;
+        }
+        if(RtsSamples > 0)
+        {
+            uint32 ulDelta = RtsTaskStatus[uxIndex].ulRunTimeCounter - RtsLastTaskCounter[ulTaskNumber];
+            RtsShortTask[ulShort][ulTaskNumber] = ulDelta;
+            RtsLongTask[ulLong][ulTaskNumber] += ulDelta;
+        }
+        RtsLastTaskCounter[ulTaskNumber] = RtsTaskStatus[uxIndex].ulRunTimeCounter;
+        RtsTaskNames[ulTaskNumber] = RtsTaskStatus[uxIndex].pcTaskName;
+        if(RtsTaskStatus[uxIndex].xHandle == RtsIdleTask)
+        {
+            RtsIdleTaskNumber = (uint16)ulTaskNumber;
+        }
+    }
+
+    RtsLastTotalCounter = ulTotalCounter;
+    RtsSamples++;
+}
+
+uint16 RTS_GetTaskLoad(uint16 usTaskNumber, uint8 ucWindow)
+{
+    uint32 ulTask;
+    uint32 ulTotal;
+    RTS_SumWindow(usTaskNumber, ucWindow, &ulTask, &ulTotal);
+    return RTS_Permille(ulTask, ulTotal);
+}
+
+uint16 RTS_GetCpuLoad(uint8 ucWindow)
+{
+    uint32 ulIdle;
+    uint32 ulTotal;
+    RTS_SumWindow(RtsIdleTaskNumber, ucWindow, &ulIdle, &ulTotal);
+    if(ulTotal == 0)
+    {
+        return 0;
+    }
+    return (uint16)(1000 - RTS_Permille(ulIdle, ulTotal));
+}
+
+void RTS_Report(void)
+{
+    uint16 usTaskNumber;
+    uint8 ucWindow;
+
+    /* Take every load in one go so the table is from a single set of samples,
+     * the printing then runs with the other tasks going */
+    vTaskSuspendAll();
+    for(usTaskNumber = 1; usTaskNumber < RTS_MAX_TASKS; usTaskNumber++)
+    {
+        RtsReportNames[usTaskNumber] = RtsTaskNames[usTaskNumber];
+        for(ucWindow = RTS_WINDOW_1S; ucWindow <= RTS_WINDOW_60S; ucWindow++)
+        {
+            RtsReportLoad[usTaskNumber][ucWindow] = RTS_GetTaskLoad(usTaskNumber, ucWindow);
+        }
+    }
+    for(ucWindow = RTS_WINDOW_1S; ucWindow <= RTS_WINDOW_60S; ucWindow++)
+    {
+        RtsReportLoad[RTS_MAX_TASKS][ucWindow] = RTS_GetCpuLoad(ucWindow);
+    }
+    xTaskResumeAll();
+
+    RTS_SendName("Task");
+    UART0_SendString((const uint8 *)"   1 s    10 s    60 s\r\n");
+    for(usTaskNumber = 1; usTaskNumber < RTS_MAX_TASKS; usTaskNumber++)
+    {
+        if(RtsReportNames[usTaskNumber] == NULL)
+        {
+            continue;
+        }
+        RTS_SendName(RtsReportNames[usTaskNumber]);
+        for(ucWindow = RTS_WINDOW_1S; ucWindow <= RTS_WINDOW_60S; ucWindow++)
+        {
+            RTS_SendPermille(RtsReportLoad[usTaskNumber][ucWindow]);
+        }
+        UART0_SendString((const uint8 *)"\r\n");
+    }
+    RTS_SendName("CPU load");
+    for(ucWindow = RTS_WINDOW_1S; ucWindow <= RTS_WINDOW_60S; ucWindow++)
+    {
+        RTS_SendPermille(RtsReportLoad[RTS_MAX_TASKS][ucWindow]);
+    }
+    UART0_SendString((const uint8 *)"\r\n");
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
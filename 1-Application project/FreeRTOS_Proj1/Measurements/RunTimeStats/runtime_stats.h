@@ -0,0 +1,57 @@
+ /******************************************************************************
+ *
+ * Module: RunTimeStats
+ *
+ * File Name: runtime_stats.h
+ *
+ * Description: Header file for the windowed CPU load measurements. The kernel
+ *              run time counters (clocked by WTimer0, 0.1 msec per count) are
+ *              sampled every second and kept as per task deltas, so the load
+ *              is reported over the last 1 s, 10 s and 60 s instead of since boot.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_RUNTIMESTATS_RUNTIME_STATS_H_
+#define MEASUREMENTS_RUNTIMESTATS_RUNTIME_STATS_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Tasks with a task number at or above this value are not tracked, needs FreeRTOS.h */
+#define RTS_MAX_TASKS                   configMEASURED_TASKS
+
+/* RTS_Sample() must be called once per RTS_SAMPLE_PERIOD_MS */
+#define RTS_SAMPLE_PERIOD_MS            1000
+
+/* Ten 1 s buckets give the 10 s window, six 10 s buckets give the 60 s window */
+#define RTS_SHORT_BUCKETS               10
+#define RTS_LONG_BUCKETS                6
+
+#define RTS_WINDOW_1S                   0
+#define RTS_WINDOW_10S                  1
+#define RTS_WINDOW_60S                  2
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Take one sample of every task counter, call from a periodic task */
+void RTS_Sample(void);
+
+/* Load of the task with this task number over the window in 0.1 % units,
+ * the idle task is included like any other task */
+uint16 RTS_GetTaskLoad(uint16 usTaskNumber, uint8 ucWindow);
+
+/* Total CPU load (everything except the idle task) in 0.1 % units */
+uint16 RTS_GetCpuLoad(uint8 ucWindow);
+
+/* Print the per task table over UART0. The loads are taken with the
+ * scheduler suspended, so call it with the scheduler running. */
+void RTS_Report(void);
+
+#endif /* MEASUREMENTS_RUNTIMESTATS_RUNTIME_STATS_H_ */
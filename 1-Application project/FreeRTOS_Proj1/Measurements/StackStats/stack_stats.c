@@ -0,0 +1,56 @@
+ /******************************************************************************
+ *
+ * Module: StackStats
+ *
+ * File Name: stack_stats.c
+ *
+ * Description: Source file for the task stack usage report.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stack_stats.h"
+#include "uart0.h"
+
+static TaskHandle_t StackTasks[STACK_MAX_TASKS];
+static uint32 StackSizes[STACK_MAX_TASKS];
+static uint16 StackTasksCount = 0;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void STACK_TaskCreated(void *pvTask, uint32 ulStackWords)
+{
+    if(StackTasksCount < STACK_MAX_TASKS)
+    {
+        StackTasks[StackTasksCount] = (TaskHandle_t)pvTask;
+        StackSizes[StackTasksCount] = ulStackWords;
+        StackTasksCount++;
+    }
+}
+
+void STACK_Report(void)
+{
+    uint16 usTask;
+    uint32 ulFree;
+
+    for(usTask = 0; usTask < StackTasksCount; usTask++)
+    {
+        /* Scans the unused part of the stack for the fill pattern */
+        ulFree = uxTaskGetStackHighWaterMark(StackTasks[usTask]);
+
+        UART0_SendString((const uint8 *)"STACK ");
+        UART0_SendInteger(StackSizes[usTask]);
+        UART0_SendByte(',');
+        UART0_SendInteger(StackSizes[usTask] - ulFree);
+        UART0_SendByte(',');
+        UART0_SendInteger(ulFree);
+        UART0_SendByte(',');
+        UART0_SendString((const uint8 *)pcTaskGetName(StackTasks[usTask]));
+        UART0_SendString((const uint8 *)"\r\n");
+    }
+}
@@ -0,0 +1,42 @@
+ /******************************************************************************
+ *
+ * Module: StackStats
+ *
+ * File Name: stack_stats.h
+ *
+ * Description: Header file for the task stack usage report. Every task is
+ *              registered by the traceTASK_CREATE hook with its stack size
+ *              and the kernel high water mark (lowest free stack ever seen)
+ *              is read when the report is requested.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_STACKSTATS_STACK_STATS_H_
+#define MEASUREMENTS_STACKSTATS_STACK_STATS_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Application tasks plus the idle and timer service tasks, needs FreeRTOS.h */
+#define STACK_MAX_TASKS                 configMEASURED_TASKS
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Called from traceTASK_CREATE with the usable stack size in words */
+void STACK_TaskCreated(void *pvTask, uint32 ulStackWords);
+
+/*
+ * Print one line per task over UART0:
+ *     STACK <size>,<used>,<free>,<name>
+ * sizes in words, parsed by Tools/stack_sizing.py on the host.
+ */
+void STACK_Report(void);
+
+#endif /* MEASUREMENTS_STACKSTATS_STACK_STATS_H_ */
@@ -0,0 +1,180 @@
+ /******************************************************************************
+ *
+ * Module: Trace
+ *
+ * File Name: trace.c
+ *
+ * Description: Source file for the binary event trace recorder.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+/* configCPU_CLOCK_HZ, unless the build gives the rate */
+#ifndef TRACE_TIMESTAMP_HZ
+#include "FreeRTOSConfig.h"
+#endif
+#include "trace.h"
+#include "uart0.h"
+
+#if TRACE_ENABLED(TRACE_CATEGORY_COUNTERS)
+
+volatile uint32 gTraceCounts[TRACE_EVENT_TYPES];
+
+static const char *const TraceCountNames[TRACE_EVENT_TYPES] =
+{
+    NULL_PTR,
+    "switch",
+    "isr",
+    NULL_PTR,           /* Same as the entries */
+    "send",
+    "receive",
+    "send_from_isr",
+    "receive_from_isr",
+    "send_full",
+    "group_set_from_isr",
+    "group_coalesced",
+    "pend_failed"
+};
+
+#endif /* TRACE_CATEGORY_COUNTERS */
+
+#if TRACE_RING_ENABLED
+
+TraceEvent gTraceBuffer[TRACE_BUFFER_SIZE];
+volatile uint32 gTraceHead = 0;
+volatile uint8 gTraceEnabled = FALSE;
+
+static const char *TraceTaskNames[TRACE_MAX_TASKS];
+
+#endif /* TRACE_RING_ENABLED */
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+#if TRACE_RING_ENABLED
+
+static void TRACE_SendHalfWord(void (*SendByteFun)(uint8), uint16 usData)
+{
+    SendByteFun((uint8)(usData));
+    SendByteFun((uint8)(usData >> 8));
+}
+
+static void TRACE_SendWord(void (*SendByteFun)(uint8), uint32 ulData)
+{
+    TRACE_SendHalfWord(SendByteFun, (uint16)(ulData));
+    TRACE_SendHalfWord(SendByteFun, (uint16)(ulData >> 16));
+}
+
+#endif /* TRACE_RING_ENABLED */
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+#if TRACE_RING_ENABLED
+
+/* The DWT cycle counter must be running already */
+void TRACE_Init(void)
+{
+    gTraceHead = 0;
+    gTraceEnabled = TRUE;
+}
+
+void TRACE_TaskCreated(uint8 ucTaskNumber, const char *pcTaskName)
+{
+    if(ucTaskNumber < TRACE_MAX_TASKS)
+    {
+        TraceTaskNames[ucTaskNumber] = pcTaskName;
+    }
+}
+
+void TRACE_Start(void)
+{
+    gTraceEnabled = TRUE;
+}
+
+void TRACE_Stop(void)
+{
+    gTraceEnabled = FALSE;
+}
+
+void TRACE_Drain(void (*SendByteFun)(uint8))
+{
+    const char *pcMagic = TRACE_FRAME_MAGIC;
+    const char *pcName;
+    uint32 ulHead = gTraceHead;
+    uint32 ulCount = (ulHead < TRACE_BUFFER_SIZE) ? ulHead : TRACE_BUFFER_SIZE;
+    uint32 ulIndex;
+    uint16 usNamesCount = 0;
+    uint8 ucLength;
+
+    for(ulIndex = 0; ulIndex < TRACE_MAX_TASKS; ulIndex++)
+    {
+        if(TraceTaskNames[ulIndex] != NULL_PTR)
+        {
+            usNamesCount++;
+        }
+    }
+
+    /* Frame header */
+    while(*pcMagic != '\0')
+    {
+        SendByteFun((uint8)*pcMagic++);
+    }
+    TRACE_SendWord(SendByteFun, TRACE_TIMESTAMP_HZ);
+    TRACE_SendWord(SendByteFun, ulHead - ulCount);    /* Events overwritten before this drain */
+    TRACE_SendHalfWord(SendByteFun, usNamesCount);
+    TRACE_SendHalfWord(SendByteFun, (uint16)ulCount);
+
+    /* Task names table so the decoder can label the task numbers */
+    for(ulIndex = 0; ulIndex < TRACE_MAX_TASKS; ulIndex++)
+    {
+        if(TraceTaskNames[ulIndex] != NULL_PTR)
+        {
+            pcName = TraceTaskNames[ulIndex];
+            for(ucLength = 0; pcName[ucLength] != '\0'; ucLength++);
+            SendByteFun((uint8)ulIndex);
+            SendByteFun(ucLength);
+            while(*pcName != '\0')
+            {
+                SendByteFun((uint8)*pcName++);
+            }
+        }
+    }
+
+    /* Events from the oldest to the newest */
+    for(ulIndex = ulHead - ulCount; ulIndex != ulHead; ulIndex++)
+    {
+        const TraceEvent *pTraceEvent = &gTraceBuffer[ulIndex & TRACE_BUFFER_MASK];
+        TRACE_SendWord(SendByteFun, pTraceEvent->TimeStamp);
+        SendByteFun(pTraceEvent->Event);
+        SendByteFun(pTraceEvent->Id);
+        TRACE_SendHalfWord(SendByteFun, pTraceEvent->Arg);
+    }
+}
+
+#endif /* TRACE_RING_ENABLED */
+
+#if TRACE_ENABLED(TRACE_CATEGORY_COUNTERS)
+
+void TRACE_CountsReport(void)
+{
+    uint8 ucEvent;
+
+    UART0_SendString((const uint8 *)"COUNT");
+    for(ucEvent = 0; ucEvent < TRACE_EVENT_TYPES; ucEvent++)
+    {
+        if(TraceCountNames[ucEvent] != NULL_PTR)
+        {
+            UART0_SendByte(' ');
+            UART0_SendString((const uint8 *)TraceCountNames[ucEvent]);
+            UART0_SendByte('=');
+            UART0_SendInteger(gTraceCounts[ucEvent]);
+        }
+    }
+    UART0_SendString((const uint8 *)"\r\n");
+}
+
+#endif /* TRACE_CATEGORY_COUNTERS */
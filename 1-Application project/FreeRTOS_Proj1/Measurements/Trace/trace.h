@@ -0,0 +1,157 @@
+ /******************************************************************************
+ *
+ * Module: Trace
+ *
+ * File Name: trace.h
+ *
+ * Description: Header file for the binary event trace recorder. Events are
+ *              written by the FreeRTOS trace hooks into a fixed size RAM ring
+ *              and drained on demand as a binary frame.
+ *
+ *              What the hooks measure is fixed at compile time by the
+ *              TRACE_CATEGORIES mask (a predefined symbol of the build),
+ *              the hooks of a disabled category compile to nothing and the
+ *              modules only it uses leave no code or RAM behind.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef MEASUREMENTS_TRACE_TRACE_H_
+#define MEASUREMENTS_TRACE_TRACE_H_
+
+#include "std_types.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Trace categories, the time stamped ones cost a DWT or WTimer0 read per event */
+#define TRACE_CATEGORY_SCHEDULER            0x01  /* Context switch events, kernel run time stats (WTimer0 read per switch) */
+#define TRACE_CATEGORY_QUEUES               0x02  /* Queue events, lock wait and hold times, queue depths */
+#define TRACE_CATEGORY_ISRS                 0x04  /* Interrupt entry and exit events, handler cycle profile */
+#define TRACE_CATEGORY_PROBES               0x08  /* End-to-end latency probes of the application */
+#define TRACE_CATEGORY_COUNTERS             0x10  /* Number of events of every type, no time stamps */
+
+/* Levels: everything, the counters only for production, nothing */
+#define TRACE_LEVEL_FULL                    0x1F
+#define TRACE_LEVEL_COUNTERS                TRACE_CATEGORY_COUNTERS
+#define TRACE_LEVEL_OFF                     0x00
+
+#ifndef TRACE_CATEGORIES
+#define TRACE_CATEGORIES                    TRACE_LEVEL_FULL
+#endif
+
+#define TRACE_ENABLED(categories)           ((TRACE_CATEGORIES & (categories)) != 0)
+
+/* The ring is only kept when a category records into it */
+#define TRACE_RING_ENABLED                  TRACE_ENABLED(TRACE_CATEGORY_SCHEDULER | TRACE_CATEGORY_QUEUES | TRACE_CATEGORY_ISRS)
+
+/* Number of events kept in the ring, must be a power of 2 (8 bytes each) */
+#define TRACE_BUFFER_SIZE                   256
+#define TRACE_BUFFER_MASK                   (TRACE_BUFFER_SIZE - 1)
+
+/* Task numbers at or above this value are recorded but their names are not kept.
+ * The events hold 8 bit task numbers. The host builds without the kernel
+ * configuration give it with -D */
+#ifndef TRACE_MAX_TASKS
+#define TRACE_MAX_TASKS                     ((configMEASURED_TASKS < 256) ? configMEASURED_TASKS : 256)
+#endif
+
+/* Time stamps are raw DWT cycle counts, the counter runs at the CPU clock.
+ * The host builds without the kernel configuration give it with -D */
+#ifndef TRACE_TIMESTAMP_HZ
+#define TRACE_TIMESTAMP_HZ                  configCPU_CLOCK_HZ
+#endif
+#define TRACE_TIMESTAMP()                   (DWT_CYCCNT_REG)
+
+/* Event types, the meaning of Id and Arg is given for each one */
+#define TRACE_EVENT_TASK_SWITCH             0x01  /* Id: task number */
+#define TRACE_EVENT_ISR_ENTER               0x02  /* Id: NVIC interrupt number */
+#define TRACE_EVENT_ISR_EXIT                0x03  /* Id: NVIC interrupt number */
+#define TRACE_EVENT_QUEUE_SEND              0x04  /* Id: queue number, Arg: (queue type << 8) | messages waiting */
+#define TRACE_EVENT_QUEUE_RECEIVE           0x05  /* Id: queue number, Arg: (queue type << 8) | messages waiting */
+#define TRACE_EVENT_QUEUE_SEND_FROM_ISR     0x06  /* Id: queue number, Arg: (queue type << 8) | messages waiting */
+#define TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR  0x07  /* Id: queue number, Arg: (queue type << 8) | messages waiting */
+
+/* Counted only, never recorded in the ring */
+#define TRACE_EVENT_QUEUE_SEND_FULL         0x08  /* A send or give found the queue full, blocked or failed */
+#define TRACE_EVENT_GROUP_SET_FROM_ISR      0x09  /* Event group bits set from an interrupt, deferred to the timer task */
+#define TRACE_EVENT_GROUP_SET_COALESCED     0x0A  /* Every bit was still set, merged with the previous event */
+#define TRACE_EVENT_PEND_CALL_FAILED        0x0B  /* Timer command queue full, the deferred call is dropped */
+#define TRACE_EVENT_TYPES                   12
+
+/* NVIC interrupt numbers of the application handlers, used as ISR event Id */
+#define TRACE_ISR_GPIO_PORTE                4
+#define TRACE_ISR_UART0                     5
+#define TRACE_ISR_ADC0_SS0                  14
+#define TRACE_ISR_GPIO_PORTF                30
+#define TRACE_ISR_ADC1_SS0                  48
+
+/* Drained frame: "TRC1", clock Hz, lost events, names count, events count,
+ * then the task names (number, length, characters) and the raw events.
+ * All multi-byte fields are little endian. */
+#define TRACE_FRAME_MAGIC                   "TRC1"
+
+/*
+ * Append one event to the ring, overwriting the oldest one when full.
+ * The caller must have the kernel interrupts masked, which is always the
+ * case inside the FreeRTOS trace hooks, so no lock is ever taken.
+ */
+#define TRACE_RECORD(event, id, arg)                                                \
+do{                                                                                 \
+    if(gTraceEnabled)                                                               \
+    {                                                                               \
+        TraceEvent *pTraceEvent = &gTraceBuffer[gTraceHead & TRACE_BUFFER_MASK];    \
+        pTraceEvent->TimeStamp = TRACE_TIMESTAMP();                                 \
+        pTraceEvent->Event = (uint8)(event);                                        \
+        pTraceEvent->Id = (uint8)(id);                                              \
+        pTraceEvent->Arg = (uint16)(arg);                                           \
+        gTraceHead++;                                                               \
+    }                                                                               \
+}while(0)
+
+/* Count one event, same locking rule as TRACE_RECORD */
+#define TRACE_COUNT(event)                  (gTraceCounts[(event)]++)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 TimeStamp;
+    uint8 Event;
+    uint8 Id;
+    uint16 Arg;
+} TraceEvent;
+
+/*******************************************************************************
+ *                              Shared Variables                               *
+ *******************************************************************************/
+
+extern TraceEvent gTraceBuffer[TRACE_BUFFER_SIZE];
+extern volatile uint32 gTraceHead;
+extern volatile uint8 gTraceEnabled;
+extern volatile uint32 gTraceCounts[TRACE_EVENT_TYPES];
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+void TRACE_Init(void);
+
+void TRACE_TaskCreated(uint8 ucTaskNumber, const char *pcTaskName);
+
+void TRACE_Start(void);
+
+void TRACE_Stop(void);
+
+/* Send the ring content as one binary frame, tracing must be stopped first */
+void TRACE_Drain(void (*SendByteFun)(uint8));
+
+/* Print the number of events of every type over UART0 */
+void TRACE_CountsReport(void);
+
+#endif /* MEASUREMENTS_TRACE_TRACE_H_ */
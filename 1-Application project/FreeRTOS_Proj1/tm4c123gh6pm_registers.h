@@ -202,6 +202,13 @@ System Control Block Registers
 #define NVIC_SYSTEM_INTCTRL       (*((volatile uint32 *)0xE000ED04))
 #define NVIC_SYSTEM_CFGCTRL       (*((volatile uint32 *)0xE000ED14))
 
+/*****************************************************************************
+Debug and Data Watchpoint and Trace Registers (DWT)
+*****************************************************************************/
+#define CORE_DEMCR_REG            (*((volatile uint32 *)0xE000EDFC))
+#define DWT_CTRL_REG              (*((volatile uint32 *)0xE0001000))
+#define DWT_CYCCNT_REG            (*((volatile uint32 *)0xE0001004))
+
 /*****************************************************************************
 MPU Registers
 *****************************************************************************/
@@ -391,7 +398,7 @@ Micro Direct Memory Access Registers (UDMA)
 #define UDMA_WAITSTAT_REG         (*((volatile uint32 *)0x400FF010))
 #define UDMA_SWREQ_REG            (*((volatile uint32 *)0x400FF014))
 #define UDMA_USEBURSTSET_REG      (*((volatile uint32 *)0x400FF018))
-#define UDMA_USEBURSTCLR_R      (*((volatile uint32 *)0x400FF01C))
+#define UDMA_USEBURSTCLR_REG      (*((volatile uint32 *)0x400FF01C))
 #define UDMA_REQMASKSET_REG       (*((volatile uint32 *)0x400FF020))
 #define UDMA_REQMASKCLR_REG       (*((volatile uint32 *)0x400FF024))
 #define UDMA_ENASET_REG           (*((volatile uint32 *)0x400FF028))
@@ -64,6 +64,7 @@ extern void GPIOPortF_Handler(void);
 extern void GPIOPortE_Handler(void);
 extern void ADC0_Handler(void);
 extern void ADC1_Handler(void);
+extern void UART0_Handler(void);
 
 //*****************************************************************************
 //
@@ -97,7 +98,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port C
     IntDefaultHandler,                      // GPIO Port D
     GPIOPortE_Handler,                      // GPIO Port E
-    IntDefaultHandler,                      // UART0 Rx and Tx
+    UART0_Handler,                          // UART0 Rx and Tx
     IntDefaultHandler,                      // UART1 Rx and Tx
     IntDefaultHandler,                      // SSI0 Rx and Tx
     IntDefaultHandler,                      // I2C0 Master and Slave
@@ -0,0 +1,214 @@
+ /******************************************************************************
+ *
+ * Module: Host Application - Metrics
+ *
+ * File Name: host_metrics.c
+ *
+ * Description: Source file for the JSON summary of a host run. Times the
+ *              model could not measure (a seat that never reached its target)
+ *              are written as null.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "host_metrics.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "deadline.h"
+#include "energy.h"
+#include "heap_stats.h"
+#include "sim_clock.h"
+#include "sim_machine.h"
+#include "sim_thermal.h"
+
+static const char *const HostSeatNames[SIM_THERMAL_SEATS] = { "driver", "passenger" };
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Negative values are the "not measured" of the thermal metrics */
+static void HOST_MetricsNumber(FILE *pxFile, const char *pcName, double dValue, const char *pcSeparator)
+{
+    if(dValue < 0)
+    {
+        fprintf(pxFile, "\"%s\": null%s", pcName, pcSeparator);
+    }
+    else
+    {
+        fprintf(pxFile, "\"%s\": %.3f%s", pcName, dValue, pcSeparator);
+    }
+}
+
+static void HOST_MetricsSeats(FILE *pxFile)
+{
+    SimThermalMetrics xMetrics;
+    boolean bFirst = TRUE;
+    uint8 ucSeat;
+
+    fprintf(pxFile, "  \"seats\": {");
+    for(ucSeat = 0; ucSeat < SIM_THERMAL_SEATS; ucSeat++)
+    {
+        if(!SIM_ThermalIsOn(ucSeat))
+        {
+            continue;
+        }
+        SIM_ThermalGetMetrics(ucSeat, &xMetrics);
+        fprintf(pxFile, "%s\n    \"%s\": {", bFirst ? "" : ",", HostSeatNames[ucSeat]);
+        HOST_MetricsNumber(pxFile, "target_c", xMetrics.Target, ", ");
+        HOST_MetricsNumber(pxFile, "rise_s", xMetrics.RiseTime, ", ");
+        HOST_MetricsNumber(pxFile, "settling_s", xMetrics.SettlingTime, ", ");
+        HOST_MetricsNumber(pxFile, "overshoot_c", xMetrics.Overshoot, ", ");
+        HOST_MetricsNumber(pxFile, "ripple_c", xMetrics.Ripple, ", ");
+        HOST_MetricsNumber(pxFile, "energy_j", xMetrics.EnergyJ, ", ");
+        fprintf(pxFile, "\"seat_c\": %.3f}", xMetrics.SeatC);
+        bFirst = FALSE;
+    }
+    fprintf(pxFile, "%s},\n", bFirst ? "" : "\n  ");
+}
+
+static void HOST_MetricsLatency(FILE *pxFile)
+{
+#if TRACE_ENABLED(TRACE_CATEGORY_PROBES)
+    LatencyChain xChain;
+
+    LAT_GetChain(LAT_CHAIN_DRIVER_BUTTON, &xChain);
+    fprintf(pxFile, "  \"button_latency_us\": {\"count\": %lu, \"min\": %lu, \"avg\": %lu, \"p99\": %lu, \"max\": %lu, "
+            "\"superseded\": %lu, \"lost\": %lu},\n",
+            (unsigned long)xChain.Total.Count,
+            (unsigned long)((xChain.Total.Count != 0) ? xChain.Total.Min / LAT_CYCLES_PER_US : 0),
+            (unsigned long)(HISTOGRAM_Average(&xChain.Total) / LAT_CYCLES_PER_US),
+            (unsigned long)(HISTOGRAM_Percentile(&xChain.Total, 99) / LAT_CYCLES_PER_US),
+            (unsigned long)(xChain.Total.Max / LAT_CYCLES_PER_US),
+            (unsigned long)xChain.Superseded, (unsigned long)xChain.Lost);
+#else
+    fprintf(pxFile, "  \"button_latency_us\": null,\n");
+#endif
+}
+
+static void HOST_MetricsQueues(FILE *pxFile)
+{
+#if TRACE_ENABLED(TRACE_CATEGORY_QUEUES)
+    QueueStats xStats;
+    uint8 ucQueue;
+
+    fprintf(pxFile, "  \"queues\": {");
+    for(ucQueue = 0; ucQueue < QSTATS_COUNT; ucQueue++)
+    {
+        QSTATS_Get(ucQueue, &xStats);
+        fprintf(pxFile, "%s\n    \"%s\": {\"peak\": %u, \"length\": %u, \"sends\": %lu, \"full\": %lu}", (ucQueue == 0) ? "" : ",",
+                QSTATS_GetName(ucQueue), xStats.Peak, xStats.Length, (unsigned long)xStats.Sends, (unsigned long)xStats.Full);
+    }
+    fprintf(pxFile, "\n  },\n");
+#else
+    fprintf(pxFile, "  \"queues\": null,\n");
+#endif
+}
+
+/* A loop that completed under half the periods that fit in the run is starved */
+static void HOST_MetricsLoops(FILE *pxFile)
+{
+    const DeadlineStats *pxLoops;
+    double dExpected;
+    uint8 ucCount;
+    uint8 ucLoop;
+
+    pxLoops = DEADLINE_GetLoops(&ucCount);
+    fprintf(pxFile, "  \"loops\": {");
+    for(ucLoop = 0; ucLoop < ucCount; ucLoop++)
+    {
+        dExpected = ((double)SIM_ClockCycles() / SIM_CPU_CLOCK_HZ) * configTICK_RATE_HZ / pxLoops[ucLoop].PeriodTicks;
+        fprintf(pxFile, "%s\n    \"%s\": {\"period_ms\": %lu, \"periods\": %lu, \"overruns\": %lu, "
+                "\"max_late_us\": %lu, \"starved\": %s}", (ucLoop == 0) ? "" : ",",
+                pcTaskGetName(pxLoops[ucLoop].Task),
+                (unsigned long)(pxLoops[ucLoop].PeriodTicks * (1000UL / configTICK_RATE_HZ)),
+                (unsigned long)pxLoops[ucLoop].Periods, (unsigned long)pxLoops[ucLoop].Overruns,
+                (unsigned long)pxLoops[ucLoop].Lateness.Max,
+                ((double)pxLoops[ucLoop].Periods * 2 < dExpected) ? "true" : "false");
+    }
+    fprintf(pxFile, "\n  },\n");
+}
+
+/* Energy as accounted by the firmware from the heater outputs and the run time
+ * counters, the MCU part up to the last sample of the run time task */
+static void HOST_MetricsEnergy(FILE *pxFile)
+{
+#if ENERGY_ENABLED
+    static const char *const apcLevels[ENERGY_LEVELS] = { "off_s", "low_s", "medium_s", "high_s" };
+    EnergySeat xSeat;
+    EnergyMcu xMcu;
+    uint64 ullTotalMj = 0;
+    uint8 ucSeat;
+    uint8 ucLevel;
+
+    fprintf(pxFile, "  \"energy\": {");
+    for(ucSeat = 0; ucSeat < ENERGY_SEATS; ucSeat++)
+    {
+        ENERGY_GetSeat(ucSeat, &xSeat);
+        fprintf(pxFile, "\n    \"%s\": {", HostSeatNames[ucSeat]);
+        for(ucLevel = 0; ucLevel < ENERGY_LEVELS; ucLevel++)
+        {
+            fprintf(pxFile, "\"%s\": %.3f, ", apcLevels[ucLevel], xSeat.LevelMs[ucLevel] / 1000.0);
+        }
+        fprintf(pxFile, "\"heater_wh\": %.4f},", xSeat.EnergyMj / 3.6e6);
+        ullTotalMj += xSeat.EnergyMj;
+    }
+    ENERGY_GetMcu(&xMcu);
+    ullTotalMj += xMcu.EnergyMj;
+    fprintf(pxFile, "\n    \"mcu\": {\"active_s\": %.3f, \"idle_s\": %.3f, \"mcu_wh\": %.6f},",
+            xMcu.ActiveMs / 1000.0, xMcu.IdleMs / 1000.0, xMcu.EnergyMj / 3.6e6);
+    fprintf(pxFile, "\n    \"total_wh\": %.4f\n  },\n", ullTotalMj / 3.6e6);
+#else
+    fprintf(pxFile, "  \"energy\": null,\n");
+#endif
+}
+
+static void HOST_MetricsCounts(FILE *pxFile)
+{
+#if TRACE_ENABLED(TRACE_CATEGORY_COUNTERS)
+    fprintf(pxFile, "  \"events\": {\"send_full\": %lu, \"group_set_from_isr\": %lu, \"group_coalesced\": %lu, "
+            "\"pend_failed\": %lu}\n",
+            (unsigned long)gTraceCounts[TRACE_EVENT_QUEUE_SEND_FULL],
+            (unsigned long)gTraceCounts[TRACE_EVENT_GROUP_SET_FROM_ISR],
+            (unsigned long)gTraceCounts[TRACE_EVENT_GROUP_SET_COALESCED],
+            (unsigned long)gTraceCounts[TRACE_EVENT_PEND_CALL_FAILED]);
+#else
+    fprintf(pxFile, "  \"events\": null\n");
+#endif
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void HOST_MetricsWrite(FILE *pxFile, const char *pcScenario, boolean bRandom, uint64 ullSeed)
+{
+    uint64 ullCycles = SIM_ClockCycles();
+    uint64 ullIdle = SIM_MachineGetIdleCycles();
+
+    fprintf(pxFile, "{\n  \"scenario\": \"%s\",\n", pcScenario);
+    if(bRandom)
+    {
+        fprintf(pxFile, "  \"seed\": %llu,\n", (unsigned long long)ullSeed);
+    }
+    else
+    {
+        fprintf(pxFile, "  \"seed\": null,\n");
+    }
+    fprintf(pxFile, "  \"simulated_s\": %.3f,\n", (double)ullCycles / SIM_CPU_CLOCK_HZ);
+    fprintf(pxFile, "  \"intensity_diff_c\": {\"high\": %u, \"medium\": %u, \"low\": %u},\n",
+            SEAT_HIGH_INTENSITY_DIFF, SEAT_MED_INTENSITY_DIFF, SEAT_LOW_INTENSITY_DIFF);
+    fprintf(pxFile, "  \"cpu_load_pct\": %.3f,\n",
+            (ullCycles != 0) ? (100.0 * (double)(ullCycles - ullIdle) / (double)ullCycles) : 0.0);
+    /* Host block sizes (64-bit pointers), comparable between two host runs only */
+    fprintf(pxFile, "  \"heap\": {\"size\": %lu, \"peak\": %lu},\n", (unsigned long)configTOTAL_HEAP_SIZE,
+            (unsigned long)(configTOTAL_HEAP_SIZE - HEAP_GetMinimumEverFree()));
+    HOST_MetricsSeats(pxFile);
+    HOST_MetricsLatency(pxFile);
+    HOST_MetricsQueues(pxFile);
+    HOST_MetricsLoops(pxFile);
+    HOST_MetricsEnergy(pxFile);
+    HOST_MetricsCounts(pxFile);
+    fprintf(pxFile, "}\n");
+}
@@ -0,0 +1,33 @@
+ /******************************************************************************
+ *
+ * Module: Host Application - Metrics
+ *
+ * File Name: host_metrics.h
+ *
+ * Description: Header file for the JSON summary of a host run: the intensity
+ *              thresholds of the control tasks, the step response of every
+ *              seat under the thermal model, the driver button to heater
+ *              output latency, the CPU load, the peak heap use, the peak
+ *              depth and full count of the data queues, the periods and
+ *              overruns of the periodic loops, the heater and MCU energy in
+ *              Wh and the event group saturation counters. The numbers are
+ *              the ones kept by the simulated board and the target
+ *              measurement modules, so two firmware revisions run on the same
+ *              script and seed compare field by field (see
+ *              Tools/scenario_suite.py and Tools/perf_gate.py).
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef HOST_METRICS_H_
+#define HOST_METRICS_H_
+
+#include <stdio.h>
+#include "std_types.h"
+
+/* Called at the end of the run, the kernel calls nothing while it is written.
+ * pcScenario names the run, bRandom tells if the seed was used. */
+void HOST_MetricsWrite(FILE *pxFile, const char *pcScenario, boolean bRandom, uint64 ullSeed);
+
+#endif /* HOST_METRICS_H_ */
@@ -0,0 +1,616 @@
+ /******************************************************************************
+ *
+ * Module: Host Application - Scaling
+ *
+ * File Name: host_scaling.c
+ *
+ * Description: Scaling benchmark of the seat heater design. The tasks, queues
+ *              and semaphores main.c creates for one seat are created for N
+ *              heating channels (2 to 64) on the simulated board, with the
+ *              shared display and diagnostics tasks looping over all of
+ *              them, and the run reports the RAM taken per channel and by
+ *              which structures, the CPU load, the lateness of the control
+ *              loops and the heap use.
+ *
+ *              Every channel runs the seat tasks of the application
+ *              (Seat/seat.c) on a SeatChannel record of its own. The board
+ *              has two converters and two heater LED pairs: channel k uses
+ *              those of seat k % 2, the converter handed over by a semaphore
+ *              given back from its conversion interrupt, so the register
+ *              traffic of every channel is the one of a seat. An event group
+ *              has the error bits of 11 channels, every 11 channels add one.
+ *              Channels 0 and 1 keep the queue numbers, energy seats and
+ *              latency chains of the driver and passenger seats, so the
+ *              statistics cover them as in the application. The buttons, the
+ *              console and the run time sampling do not grow with the
+ *              channels and are left out.
+ *
+ *              Usage: seat_scaling [-n channels] [-t seconds] [-o uart.txt] [-j metrics.json]
+ *                  -n  heating channels, 2 by default
+ *                  -t  simulated run time, 60 s by default
+ *                  -o  file receiving the UART0 output, dropped by default
+ *                  -j  file receiving the JSON metrics of the run
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#include "semphr.h"
+
+/* MCAL includes. */
+#include "uart0.h"
+#include "gpio.h"
+#include "EEPROM.h"
+#include "adc.h"
+#include "GPTM.h"
+#include "dwt.h"
+#include "tm4c123gh6pm_registers.h"
+
+/* Measurements includes. */
+#include "trace.h"
+#include "deadline.h"
+#include "isr_stats.h"
+
+/* Simulation includes. */
+#include "sim_machine.h"
+#include "sim_clock.h"
+#include "sim_nvic.h"
+#include "sim_adc.h"
+#include "sim_uart.h"
+#include "sim_eeprom.h"
+#include "sim_script.h"
+
+/* Application includes. */
+#include "seat.h"
+
+#define HOST_SCALING_MAX_CHANNELS       64
+#define HOST_SCALING_DEFAULT_SECONDS    60
+
+/* Interrupt numbers of the conversion and UART0 transmit handlers */
+#define HOST_IRQ_UART0                  5
+#define HOST_IRQ_ADC0_SS0               14
+#define HOST_IRQ_ADC1_SS0               48
+
+/* Number of the objects outside the lock and queue statistics */
+#define HOST_SCALING_QUEUE_NUMBER       0x80
+
+/* Both sensors read 20 C and every channel asks for MEDIUM, so the heaters run */
+#define HOST_SCALING_SENSOR_CODE        1820
+#define HOST_SCALING_SEAT_TEMP          30
+
+/* Event group bits left after the two button bits of main.c, two per channel */
+#define HOST_SCALING_EVENT_BITS         ((configUSE_16_BIT_TICKS != 0) ? 8 : 24)
+#define HOST_SCALING_GROUP_CHANNELS     ((HOST_SCALING_EVENT_BITS - 2) / 2)
+#define HOST_SCALING_EVENT_GROUPS       ((HOST_SCALING_MAX_CHANNELS + HOST_SCALING_GROUP_CHANNELS - 1) / HOST_SCALING_GROUP_CHANNELS)
+#define HOST_SCALING_ERROR_BITS         ((((EventBits_t)1 << HOST_SCALING_EVENT_BITS) - 1) & ~(EventBits_t)0x3)
+
+/* Notification index of a writer sleeping for room in the UART0 ring, as in main.c */
+#define HOST_UART0_TX_NOTIFY_INDEX      1
+
+/* Stack depths and priorities of the seat tasks of main.c */
+#define HOST_SCALING_TEMP_STACK         64
+#define HOST_SCALING_INTENSITY_STACK    128
+#define HOST_SCALING_HEATER_STACK       64
+#define HOST_SCALING_ERROR_STACK        64
+#define HOST_SCALING_DISPLAY_STACK      128
+#define HOST_SCALING_DIAGNOSTIC_STACK   128
+
+typedef struct
+{
+    char* Info;
+    uint32 TimeStamp;
+} DiagnosticsTaskInformation; /* Struct to Carry Information of Diagnostic Task */
+
+/* The seat record of a channel and its name in the reports */
+typedef struct
+{
+    SeatChannel Seat;
+    char Name[16];
+} HostChannel;
+
+/* Heap taken from heap_2 by the objects of all the channels, host sizes */
+typedef struct
+{
+    uint32 Tasks;                       /* TCBs and stacks */
+    uint32 Queues;                      /* Intensity and diagnostics queues */
+    uint32 Semaphores;                  /* Mutex, temperature and error semaphores */
+    uint32 EventGroups;                 /* Error event groups */
+} HostChannelHeap;
+
+static const SeatHardware HostHardware[2] =
+{
+    { ADC0_StartConv, GPIO_BlueLedOn, GPIO_BlueLedOff, GPIO_GreenLedOn, GPIO_GreenLedOff, GPIO_RedLedOn, GPIO_RedLedOff },
+    { ADC1_StartConv, GPIO_ExBlueLedOn, GPIO_ExBlueLedOff, GPIO_ExGreenLedOn, GPIO_ExGreenLedOff, GPIO_ExRedLedOn, GPIO_ExRedLedOff }
+};
+
+static HostChannel HostChannels[HOST_SCALING_MAX_CHANNELS];
+static uint8 HostChannelsCount = 2;
+static SeatConverter HostConverters[2];
+static HostChannelHeap HostHeap;
+static uint32 HostStackWords = 0;
+
+static EventGroupHandle_t xEventGroups[HOST_SCALING_EVENT_GROUPS];
+static uint8 HostEventGroupsCount = 0;
+static xTaskHandle Display_Task;
+static xTaskHandle Diagnostic_Task;
+
+static TaskHandle_t xUart0TxWaiter = NULL;
+
+/* The thresholds of seat.c, read through the SEAT_xxx_INTENSITY_DIFF of Port/FreeRTOSConfig.h */
+unsigned char HostIntensityDiff[3] = { 10, 5, 2 };
+
+static FILE *HostUartFile = NULL_PTR;
+static FILE *HostMetricsFile = NULL_PTR;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void HOST_UartOutput(uint8 ucByte)
+{
+    if(HostUartFile != NULL_PTR)
+    {
+        fputc(ucByte, HostUartFile);
+    }
+}
+
+static const char *HOST_IntensityText(uint8 intensity)
+{
+    switch(intensity)
+    {
+    case(SEAT_ERROR_NO_INTENSITY):
+        return "NO Intensity Because of Out of Range Error";
+    case(SEAT_NO_INTENSITY):
+        return "NO Intensity";
+    case(SEAT_LOW_INTENSITY):
+        return "LOW Intensity";
+    case(SEAT_MED_INTENSITY):
+        return "MEDIUM Intensity";
+    default:
+        return "HIGH Intensity";
+    }
+}
+
+void ADC0_Handler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken;
+
+    traceISR_ENTER(TRACE_ISR_ADC0_SS0);
+    xHigherPriorityTaskWoken = SEAT_ConversionDone(HostConverters[0].Owner, ADC_PD0Read());
+    ADC0_ADCISC_REG = 0x1;
+    traceISR_EXIT(TRACE_ISR_ADC0_SS0);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+void ADC1_Handler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken;
+
+    traceISR_ENTER(TRACE_ISR_ADC1_SS0);
+    xHigherPriorityTaskWoken = SEAT_ConversionDone(HostConverters[1].Owner, ADC_PD1Read());
+    ADC1_ADCISC_REG = 0x1;
+    traceISR_EXIT(TRACE_ISR_ADC1_SS0);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+/* The transmit part of the UART0 handler of main.c, the display has no uDMA list */
+void UART0_Handler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    traceISR_ENTER(TRACE_ISR_UART0);
+    if((UART0_TxInterrupt() & UART0_TX_EVENT_ROOM) && (xUart0TxWaiter != NULL))
+    {
+        vTaskNotifyGiveIndexedFromISR(xUart0TxWaiter, HOST_UART0_TX_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+        xUart0TxWaiter = NULL;
+    }
+    traceISR_EXIT(TRACE_ISR_UART0);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+/* The UART0_Write wait of main.c: the display sleeps while the ring is full */
+static boolean HOST_Uart0TxWait(uint32 ulTimeoutMs)
+{
+    if(xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        return FALSE;
+    }
+    xUart0TxWaiter = xTaskGetCurrentTaskHandle();
+    (void)ulTaskNotifyTakeIndexed(HOST_UART0_TX_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(ulTimeoutMs) + 1);
+    xUart0TxWaiter = NULL;
+    return TRUE;
+}
+
+/* The display of main.c with one block per channel */
+static void vChannelsDisplayTask(void *pvParameters)
+{
+    static uint8 intensities[HOST_SCALING_MAX_CHANNELS];
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint8 ucChannel;
+
+    for(;;)
+    {
+        DEADLINE_DelayUntil( &xLastWakeTime, pdMS_TO_TICKS( 1000 ) );
+        for(ucChannel = 0; ucChannel < HostChannelsCount; ucChannel++)
+        {
+            xQueueReceive(HostChannels[ucChannel].Seat.IntensityQueue, &intensities[ucChannel], portMAX_DELAY);
+        }
+        for(ucChannel = 0; ucChannel < HostChannelsCount; ucChannel++)
+        {
+            UART0_SendString((const uint8 *)HostChannels[ucChannel].Name);
+            UART0_SendString((const uint8 *)":\r\nCurrent Temperature = ");
+            UART0_SendInteger(HostChannels[ucChannel].Seat.Temp);
+            UART0_SendString((const uint8 *)" Degree\r\nRequired Heating Level = ");
+            UART0_SendInteger(HostChannels[ucChannel].Seat.SeatTemp);
+            UART0_SendString((const uint8 *)" Degree\r\nThe Heater is Working with ");
+            UART0_SendString((const uint8 *)HOST_IntensityText(intensities[ucChannel]));
+            UART0_SendString((const uint8 *)" \r\n\n**************************************\r\n\n");
+        }
+    }
+}
+
+/* The diagnostics of main.c: an error record for the first channel with an
+ * error bit set, else the last intensity of every channel in block 0 (16
+ * words, the records of channels past the 8th wrap over the first ones).
+ * It waits on the first event group and collects the bits of the others on
+ * every loop, so their errors are seen within the 500 ms timeout. */
+static void vChannelsDiagnosticsTask(void *pvParameters)
+{
+    static EventBits_t axGroupBits[HOST_SCALING_EVENT_GROUPS];
+    DiagnosticsTaskInformation ErrorInfo;
+    SeatChannel *pxSeat;
+    HostChannel *pxChannel;
+    uint8 ucChannel;
+    uint8 ucGroup;
+
+    for(;;)
+    {
+        axGroupBits[0] = xEventGroupWaitBits(xEventGroups[0], HOST_SCALING_ERROR_BITS, pdTRUE, pdFALSE, pdMS_TO_TICKS(500));
+        for(ucGroup = 1; ucGroup < HostEventGroupsCount; ucGroup++)
+        {
+            axGroupBits[ucGroup] = xEventGroupClearBits(xEventGroups[ucGroup], HOST_SCALING_ERROR_BITS);
+        }
+        ErrorInfo.TimeStamp = GPTM_WTimer0Read();
+        pxChannel = NULL_PTR;
+        for(ucChannel = 0; (ucChannel < HostChannelsCount) && (pxChannel == NULL_PTR); ucChannel++)
+        {
+            pxSeat = &HostChannels[ucChannel].Seat;
+            if(axGroupBits[ucChannel / HOST_SCALING_GROUP_CHANNELS] & (pxSeat->UnderBit | pxSeat->OverBit))
+            {
+                pxChannel = &HostChannels[ucChannel];
+            }
+        }
+        if(pxChannel != NULL_PTR)
+        {
+            ErrorInfo.Info = pxChannel->Name;
+            EEPROM_SaveBlock1((void*)&ErrorInfo);
+            xQueueSend(pxChannel->Seat.DiagnosticsQueue, &ErrorInfo, 0);
+        }
+        else
+        {
+            EEPROM_PointBeginBlock0();
+            for(ucChannel = 0; ucChannel < HostChannelsCount; ucChannel++)
+            {
+                xQueueReceive(HostChannels[ucChannel].Seat.IntensityQueue, &(ErrorInfo.Info), portMAX_DELAY);
+                EEPROM_SaveBlock0((void*)&ErrorInfo);
+            }
+            EEPROM_PointBeginBlock0();
+        }
+    }
+}
+
+/* The statistics are sized for HOST_SCALING_MAX_CHANNELS, see main.c */
+void vApplicationDaemonTaskStartupHook(void)
+{
+    configASSERT(uxTaskGetNumberOfTasks() < configMEASURED_TASKS);
+}
+
+static void HOST_SetupHardware(void)
+{
+    UART0_Init();
+    UART0_SetTxWait(HOST_Uart0TxWait);
+    GPIO_BuiltinButtonsLedsInit();
+    GPIO_ExternalButtonsLedsInit();
+    GPIO_ADCPD0D1Init();
+    ADC_PD0D1Init();
+    GPTM_WTimer0Init();
+    EEPROM_Init();
+    DWT_CycleCounterInit();
+#if TRACE_RING_ENABLED
+    TRACE_Init();
+#endif
+#if TRACE_ENABLED(TRACE_CATEGORY_QUEUES)
+    LOCK_Init();
+    QSTATS_Init();
+#endif
+#if TRACE_ENABLED(TRACE_CATEGORY_PROBES)
+    LAT_Init();
+#endif
+    DEADLINE_Init();
+#if ISR_STATS_ENABLED
+    ISR_Init();
+#endif
+}
+
+static boolean HOST_CreateTask(TaskFunction_t pxCode, const char *pcName, uint16 usStackWords,
+                               void *pvParameters, UBaseType_t uxPriority, xTaskHandle *pxTask)
+{
+    HostStackWords += usStackWords;
+    return xTaskCreate(pxCode, pcName, usStackWords, pvParameters, uxPriority, pxTask) == pdPASS;
+}
+
+/* Queue numbers of the driver (0) and passenger (1) objects in main.c */
+static UBaseType_t HOST_QueueNumber(uint8 ucChannel, UBaseType_t uxDriverNumber)
+{
+    return (ucChannel < 2) ? (uxDriverNumber + ucChannel) : HOST_SCALING_QUEUE_NUMBER;
+}
+
+/* The objects of one seat of main.c, in the same order, and the event group
+ * of the first channel of a group, FALSE when the heap ran out */
+static boolean HOST_CreateChannel(uint8 ucChannel)
+{
+    HostChannel *pxChannel = &HostChannels[ucChannel];
+    SeatChannel *pxSeat = &pxChannel->Seat;
+    uint8 ucGroup = ucChannel / HOST_SCALING_GROUP_CHANNELS;
+    uint8 ucBit = ucChannel % HOST_SCALING_GROUP_CHANNELS;
+    size_t xFree;
+    boolean bCreated;
+
+    if(ucBit == 0)
+    {
+        xFree = xPortGetFreeHeapSize();
+        xEventGroups[ucGroup] = xEventGroupCreate();
+        if(xEventGroups[ucGroup] == NULL)
+        {
+            return FALSE;
+        }
+        HostEventGroupsCount = ucGroup + 1;
+        HostHeap.EventGroups += xFree - xPortGetFreeHeapSize();
+    }
+
+    pxSeat->Hardware = &HostHardware[ucChannel % 2];
+    pxSeat->Converter = &HostConverters[ucChannel % 2];
+    pxSeat->OverBit = (EventBits_t)1 << (2 + 2 * ucBit);
+    pxSeat->UnderBit = (EventBits_t)1 << (3 + 2 * ucBit);
+    pxSeat->EnergySeat = (ucChannel < ENERGY_SEATS) ? ucChannel : SEAT_NO_ENERGY;
+    pxSeat->LatencyChains = (ucChannel == 0) ? TRUE : FALSE;
+    pxSeat->ErrorEvents = xEventGroups[ucGroup];
+    pxSeat->SeatTemp = HOST_SCALING_SEAT_TEMP;
+    pxSeat->Temp = 0;
+    snprintf(pxChannel->Name, sizeof(pxChannel->Name), "Seat %u", ucChannel);
+
+    xFree = xPortGetFreeHeapSize();
+    pxSeat->Mutex = xSemaphoreCreateMutex();
+    pxSeat->TempSemphr = xSemaphoreCreateBinary();
+    pxSeat->ErrorSemaphore = xSemaphoreCreateBinary();
+    if((pxSeat->Mutex == NULL) || (pxSeat->TempSemphr == NULL) || (pxSeat->ErrorSemaphore == NULL))
+    {
+        return FALSE;
+    }
+    vQueueSetQueueNumber(pxSeat->Mutex, HOST_QueueNumber(ucChannel, 0));
+    vQueueSetQueueNumber(pxSeat->TempSemphr, HOST_QueueNumber(ucChannel, 2));
+    vQueueSetQueueNumber(pxSeat->ErrorSemaphore, HOST_QueueNumber(ucChannel, 4));
+    xSemaphoreGive(pxSeat->TempSemphr);
+    HostHeap.Semaphores += xFree - xPortGetFreeHeapSize();
+
+    xFree = xPortGetFreeHeapSize();
+    pxSeat->IntensityQueue = xQueueCreate(3, sizeof(uint8));
+    pxSeat->DiagnosticsQueue = xQueueCreate(10, sizeof(DiagnosticsTaskInformation));
+    if((pxSeat->IntensityQueue == NULL) || (pxSeat->DiagnosticsQueue == NULL))
+    {
+        return FALSE;
+    }
+    vQueueSetQueueNumber(pxSeat->IntensityQueue, HOST_QueueNumber(ucChannel, 6));
+    vQueueSetQueueNumber(pxSeat->DiagnosticsQueue, HOST_QueueNumber(ucChannel, 8));
+    HostHeap.Queues += xFree - xPortGetFreeHeapSize();
+
+    xFree = xPortGetFreeHeapSize();
+    bCreated = HOST_CreateTask(vSeatIntensityTask, "Intensity Task", HOST_SCALING_INTENSITY_STACK, pxSeat, 1, &pxSeat->IntensityTask)
+            && HOST_CreateTask(vSeatHeaterTask, "Heater Task", HOST_SCALING_HEATER_STACK, pxSeat, 2, &pxSeat->HeaterTask)
+            && HOST_CreateTask(vSeatTempTask, "Temp Read Task", HOST_SCALING_TEMP_STACK, pxSeat, 3, &pxSeat->TempTask)
+            && HOST_CreateTask(vSeatErrorTask, "Error Task", HOST_SCALING_ERROR_STACK, pxSeat, 5, &pxSeat->ErrorTask);
+    HostHeap.Tasks += xFree - xPortGetFreeHeapSize();
+    return bCreated;
+}
+
+static const DeadlineStats *HOST_FindLoop(const DeadlineStats *pxLoops, uint8 ucCount, xTaskHandle xTask)
+{
+    uint8 ucLoop;
+    for(ucLoop = 0; ucLoop < ucCount; ucLoop++)
+    {
+        if(pxLoops[ucLoop].Task == xTask)
+        {
+            return &pxLoops[ucLoop];
+        }
+    }
+    return NULL_PTR;
+}
+
+/* Overruns, worst lateness and starvation of a set of loops, as the "loops" of App/host_metrics.c */
+static void HOST_WriteLoops(FILE *pxFile, const char *pcName, xTaskHandle *pxTasks, uint8 ucTasks, const char *pcSeparator)
+{
+    const DeadlineStats *pxLoops;
+    const DeadlineStats *pxLoop;
+    uint32 ulOverruns = 0;
+    uint32 ulMaxLate = 0;
+    uint32 ulStarved = 0;
+    TickType_t xPeriod = 0;
+    double dExpected;
+    uint8 ucCount;
+    uint8 ucTask;
+
+    pxLoops = DEADLINE_GetLoops(&ucCount);
+    for(ucTask = 0; ucTask < ucTasks; ucTask++)
+    {
+        pxLoop = HOST_FindLoop(pxLoops, ucCount, pxTasks[ucTask]);
+        if(pxLoop == NULL_PTR)
+        {
+            /* Never ran a whole period */
+            ulStarved++;
+            continue;
+        }
+        dExpected = ((double)SIM_ClockCycles() / SIM_CPU_CLOCK_HZ) * configTICK_RATE_HZ / pxLoop->PeriodTicks;
+        xPeriod = pxLoop->PeriodTicks;
+        ulOverruns += pxLoop->Overruns;
+        ulMaxLate = (pxLoop->Lateness.Max > ulMaxLate) ? pxLoop->Lateness.Max : ulMaxLate;
+        ulStarved += ((double)pxLoop->Periods * 2 < dExpected) ? 1 : 0;
+    }
+    fprintf(pxFile, "  \"%s\": {\"loops\": %u, \"period_ms\": %lu, \"overruns\": %lu, \"max_late_us\": %lu, \"starved\": %lu}%s\n",
+            pcName, ucTasks, (unsigned long)(xPeriod * (1000UL / configTICK_RATE_HZ)),
+            (unsigned long)ulOverruns, (unsigned long)ulMaxLate, (unsigned long)ulStarved, pcSeparator);
+}
+
+static void HOST_WriteMetrics(FILE *pxFile)
+{
+    static xTaskHandle axTasks[HOST_SCALING_MAX_CHANNELS];
+    uint64 ullCycles = SIM_ClockCycles();
+    uint64 ullIdle = SIM_MachineGetIdleCycles();
+    uint32 ulUsed = (uint32)(configTOTAL_HEAP_SIZE - xPortGetFreeHeapSize());
+    uint32 ulChannels = HostHeap.Tasks + HostHeap.Queues + HostHeap.Semaphores + HostHeap.EventGroups;
+    uint8 ucChannel;
+
+    fprintf(pxFile, "{\n  \"channels\": %u,\n", HostChannelsCount);
+    fprintf(pxFile, "  \"simulated_s\": %.3f,\n", (double)ullCycles / SIM_CPU_CLOCK_HZ);
+    fprintf(pxFile, "  \"cpu_load_pct\": %.3f,\n",
+            (ullCycles != 0) ? (100.0 * (double)(ullCycles - ullIdle) / (double)ullCycles) : 0.0);
+    fprintf(pxFile, "  \"heap\": {\"size\": %lu, \"used\": %lu, \"shared\": %lu},\n",
+            (unsigned long)configTOTAL_HEAP_SIZE, (unsigned long)ulUsed, (unsigned long)(ulUsed - ulChannels));
+    fprintf(pxFile, "  \"per_channel\": {\"heap\": %lu, \"tasks\": %lu, \"queues\": %lu, \"semaphores\": %lu, "
+            "\"event_groups\": %lu, \"static\": %lu, \"stack_words\": %lu},\n",
+            (unsigned long)(ulChannels / HostChannelsCount), (unsigned long)(HostHeap.Tasks / HostChannelsCount),
+            (unsigned long)(HostHeap.Queues / HostChannelsCount), (unsigned long)(HostHeap.Semaphores / HostChannelsCount),
+            (unsigned long)(HostHeap.EventGroups / HostChannelsCount),
+            (unsigned long)sizeof(HostChannel),
+            (unsigned long)(HOST_SCALING_TEMP_STACK + HOST_SCALING_INTENSITY_STACK + HOST_SCALING_HEATER_STACK + HOST_SCALING_ERROR_STACK));
+    /* Every task stack including the idle and timer tasks, in words of the target */
+    fprintf(pxFile, "  \"stack_words\": %lu,\n",
+            (unsigned long)(HostStackWords + configMINIMAL_STACK_SIZE + configTIMER_TASK_STACK_DEPTH));
+    fprintf(pxFile, "  \"event_groups\": %u,\n", HostEventGroupsCount);
+
+    for(ucChannel = 0; ucChannel < HostChannelsCount; ucChannel++)
+    {
+        axTasks[ucChannel] = HostChannels[ucChannel].Seat.IntensityTask;
+    }
+    HOST_WriteLoops(pxFile, "control_loops", axTasks, HostChannelsCount, ",");
+    for(ucChannel = 0; ucChannel < HostChannelsCount; ucChannel++)
+    {
+        axTasks[ucChannel] = HostChannels[ucChannel].Seat.TempTask;
+    }
+    HOST_WriteLoops(pxFile, "sensor_loops", axTasks, HostChannelsCount, ",");
+    HOST_WriteLoops(pxFile, "display_loop", &Display_Task, 1, "");
+    fprintf(pxFile, "}\n");
+}
+
+static void HOST_End(void)
+{
+    fprintf(stderr, "sim: %u channels, %.3f s simulated, uart0 tx=%lu bytes, eeprom writes=%lu\n",
+            HostChannelsCount, (double)SIM_ClockCycles() / SIM_CPU_CLOCK_HZ,
+            (unsigned long)SIM_UartGetTxBytes(), (unsigned long)SIM_EepromGetWrites());
+    if(HostMetricsFile != NULL_PTR)
+    {
+        HOST_WriteMetrics(HostMetricsFile);
+        fclose(HostMetricsFile);
+    }
+    if(HostUartFile != NULL_PTR)
+    {
+        fclose(HostUartFile);
+    }
+    /* The task threads are parked on their semaphores */
+    _exit(EXIT_SUCCESS);
+}
+
+static void HOST_Usage(const char *pcName)
+{
+    fprintf(stderr, "usage: %s [-n channels] [-t seconds] [-o uart.txt] [-j metrics.json]\n", pcName);
+    exit(2);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    double dSeconds = HOST_SCALING_DEFAULT_SECONDS;
+    int iChannels = 2;
+    uint8 ucChannel;
+    int iOption;
+
+    while((iOption = getopt(argc, argv, "n:t:o:j:")) != -1)
+    {
+        switch(iOption)
+        {
+        case 'n':
+            iChannels = atoi(optarg);
+            break;
+        case 't':
+            dSeconds = atof(optarg);
+            break;
+        case 'o':
+            HostUartFile = fopen(optarg, "w");
+            if(HostUartFile == NULL_PTR)
+            {
+                perror(optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'j':
+            HostMetricsFile = fopen(optarg, "w");
+            if(HostMetricsFile == NULL_PTR)
+            {
+                perror(optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            HOST_Usage(argv[0]);
+        }
+    }
+    if((iChannels < 1) || (iChannels > HOST_SCALING_MAX_CHANNELS) || (dSeconds <= 0))
+    {
+        HOST_Usage(argv[0]);
+    }
+    HostChannelsCount = (uint8)iChannels;
+
+    SIM_MachineInit();
+    SIM_AdcSetInput(SIM_SCRIPT_DRIVER_AIN, HOST_SCALING_SENSOR_CODE);
+    SIM_AdcSetInput(SIM_SCRIPT_PASSENGER_AIN, HOST_SCALING_SENSOR_CODE);
+    SIM_NvicSetHandler(HOST_IRQ_ADC0_SS0, ADC0_Handler);
+    SIM_NvicSetHandler(HOST_IRQ_ADC1_SS0, ADC1_Handler);
+    SIM_NvicSetHandler(HOST_IRQ_UART0, UART0_Handler);
+    SIM_UartSetOutput(HOST_UartOutput);
+    SIM_MachineSetEnd((uint64)(dSeconds * SIM_CPU_CLOCK_HZ), HOST_End);
+
+    HOST_SetupHardware();
+    for(ucChannel = 0; ucChannel < 2; ucChannel++)
+    {
+        HostConverters[ucChannel].Free = xSemaphoreCreateBinary();
+        vQueueSetQueueNumber(HostConverters[ucChannel].Free, HOST_SCALING_QUEUE_NUMBER);
+        xSemaphoreGive(HostConverters[ucChannel].Free);
+    }
+    for(ucChannel = 0; ucChannel < HostChannelsCount; ucChannel++)
+    {
+        if(!HOST_CreateChannel(ucChannel))
+        {
+            fprintf(stderr, "sim: the %lu byte heap ran out at channel %u\n", (unsigned long)configTOTAL_HEAP_SIZE, ucChannel);
+            return EXIT_FAILURE;
+        }
+    }
+    if(!HOST_CreateTask(vChannelsDisplayTask, "Display User Task", HOST_SCALING_DISPLAY_STACK, NULL, 2, &Display_Task)
+       || !HOST_CreateTask(vChannelsDiagnosticsTask, "Diagnostic Task", HOST_SCALING_DIAGNOSTIC_STACK, NULL, 4, &Diagnostic_Task))
+    {
+        fprintf(stderr, "sim: the %lu byte heap ran out\n", (unsigned long)configTOTAL_HEAP_SIZE);
+        return EXIT_FAILURE;
+    }
+
+    vTaskStartScheduler();
+    return EXIT_FAILURE;
+}
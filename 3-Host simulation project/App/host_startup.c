@@ -0,0 +1,363 @@
+ /******************************************************************************
+ *
+ * Module: Host Application
+ *
+ * File Name: host_startup.c
+ *
+ * Description: Start-up code of the host build, in place of the CCS start-up
+ *              file: builds the vector table of the simulated NVIC, loads
+ *              the stimulus script, then calls the unchanged main() of the
+ *              application (renamed APP_Main). Bytes sent on UART0 go to
+ *              stdout or to a file, the run summary goes to stderr.
+ *
+ *              Time is virtual: it moves as fast as the host runs the code,
+ *              and a run only depends on the script and the seed, so it is
+ *              reproduced exactly by running it again.
+ *
+ *              Usage: seat_heater [-s script] [-t seconds] [-r seed] [-p seconds] [-o uart.txt] [-l] [-T thermal.csv] [-j metrics.json] [-m mmio.csv] [-R trace.rec] [-g high,medium,low]
+ *                  -s  stimulus script (see Sim/sim_script.h)
+ *                  -t  simulated run time, 10 s, the "end" of the script or the end of the trace
+ *                  -r  add the random stimulus of the soak runs, drawn from this seed
+ *                  -p  print the progress every so many simulated seconds
+ *                  -o  file receiving the UART0 output
+ *                  -l  log the LED changes on stderr
+ *                  -T  file receiving the thermal model samples (see Sim/sim_thermal.h)
+ *                  -j  file receiving the JSON metrics of the run (see App/host_metrics.h)
+ *                  -m  file receiving the register access profile (see Sim/sim_mmio.h)
+ *                  -R  sensor trace recorded on the board, replayed on the inputs (see Sim/sim_replay.h)
+ *                  -g  degrees under the required temperature from which the control tasks drive
+ *                      the HIGH, MEDIUM and LOW intensity, 10,5,2 as in main.c
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sim_machine.h"
+#include "sim_clock.h"
+#include "sim_nvic.h"
+#include "sim_uart.h"
+#include "sim_dma.h"
+#include "sim_adc.h"
+#include "sim_gpio.h"
+#include "sim_eeprom.h"
+#include "sim_script.h"
+#include "sim_thermal.h"
+#include "sim_mmio.h"
+#include "sim_replay.h"
+#include "host_metrics.h"
+
+#define HOST_DEFAULT_SECONDS        10
+
+/* Full scale of the sensor, the largest difference the control tasks can see */
+#define HOST_MAX_INTENSITY_DIFF     45
+
+/* Interrupt numbers of the handlers installed in tm4c123gh6pm_startup_ccs.c */
+#define HOST_IRQ_GPIO_PORTE         4
+#define HOST_IRQ_UART0              5
+#define HOST_IRQ_ADC0_SS0           14
+#define HOST_IRQ_GPIO_PORTF         30
+#define HOST_IRQ_ADC1_SS0           48
+
+extern int APP_Main(void);
+extern void GPIOPortE_Handler(void);
+extern void ADC0_Handler(void);
+extern void GPIOPortF_Handler(void);
+extern void ADC1_Handler(void);
+extern void UART0_Handler(void);
+
+static FILE *HostUartFile = NULL_PTR;
+static FILE *HostThermalFile = NULL_PTR;
+static FILE *HostMetricsFile = NULL_PTR;
+static FILE *HostMmioFile = NULL_PTR;
+static char HostScenario[64] = "none";
+static struct timespec HostStart;
+static boolean HostRandom = FALSE;
+static uint64 HostSeed = 0;
+
+/* Read by the control tasks through the SEAT_xxx_INTENSITY_DIFF of Port/FreeRTOSConfig.h */
+unsigned char HostIntensityDiff[3] = { 10, 5, 2 };
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void HOST_UartOutput(uint8 ucByte)
+{
+    fputc(ucByte, HostUartFile);
+}
+
+static void HOST_LedOutput(uint8 ucPort, uint8 ucBefore, uint8 ucAfter)
+{
+    (void)ucBefore;
+    fprintf(stderr, "[%10.3f ms] LED P%c = 0x%02X\n",
+            (double)SIM_ClockCycles() * 1000.0 / SIM_CPU_CLOCK_HZ, 'A' + ucPort, ucAfter);
+}
+
+static double HOST_Seconds(const struct timespec *pxFrom)
+{
+    struct timespec xNow;
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return (double)(xNow.tv_sec - pxFrom->tv_sec) + (double)(xNow.tv_nsec - pxFrom->tv_nsec) / 1e9;
+}
+
+/* Simulated seconds so far, host seconds and simulated seconds per host second */
+static void HOST_Throughput(void)
+{
+    double dSimulated = (double)SIM_ClockCycles() / SIM_CPU_CLOCK_HZ;
+    double dHost = HOST_Seconds(&HostStart);
+    fprintf(stderr, "sim: %.3f s simulated in %.3f s, %.0f simulated s per s\n",
+            dSimulated, dHost, (dHost > 0) ? (dSimulated / dHost) : 0.0);
+}
+
+static void HOST_Progress(void)
+{
+    fflush(HostUartFile);
+    HOST_Throughput();
+}
+
+static void HOST_End(void)
+{
+    fflush(HostUartFile);
+    HOST_Throughput();
+    if(HostRandom)
+    {
+        fprintf(stderr, "sim: random stimulus seed=%llu\n", (unsigned long long)HostSeed);
+    }
+    fprintf(stderr, "sim: interrupts SysTick=%lu GPIOE=%lu GPIOF=%lu ADC0=%lu ADC1=%lu UART0=%lu\n",
+            (unsigned long)SIM_NvicGetCount(SIM_NVIC_SYSTICK),
+            (unsigned long)SIM_NvicGetCount(HOST_IRQ_GPIO_PORTE),
+            (unsigned long)SIM_NvicGetCount(HOST_IRQ_GPIO_PORTF),
+            (unsigned long)SIM_NvicGetCount(HOST_IRQ_ADC0_SS0),
+            (unsigned long)SIM_NvicGetCount(HOST_IRQ_ADC1_SS0),
+            (unsigned long)SIM_NvicGetCount(HOST_IRQ_UART0));
+    fprintf(stderr, "sim: uart0 tx=%lu bytes (%lu by %lu uDMA transfers) rx overruns=%lu, eeprom writes=%lu\n",
+            (unsigned long)SIM_UartGetTxBytes(), (unsigned long)SIM_DmaGetBytes(),
+            (unsigned long)SIM_DmaGetTransfers(), (unsigned long)SIM_UartGetRxOverruns(),
+            (unsigned long)SIM_EepromGetWrites());
+    SIM_ThermalReport(stderr);
+    if(HostMetricsFile != NULL_PTR)
+    {
+        HOST_MetricsWrite(HostMetricsFile, HostScenario, HostRandom, HostSeed);
+        fclose(HostMetricsFile);
+    }
+    if(HostMmioFile != NULL_PTR)
+    {
+        SIM_MmioReport(HostMmioFile);
+        fclose(HostMmioFile);
+    }
+    if(HostUartFile != stdout)
+    {
+        fclose(HostUartFile);
+    }
+    if(HostThermalFile != NULL_PTR)
+    {
+        fclose(HostThermalFile);
+    }
+    /* The task threads are parked on their semaphores */
+    _exit(EXIT_SUCCESS);
+}
+
+/* Script file name without its directory and extension */
+static void HOST_SetScenario(const char *pcScript)
+{
+    const char *pcName = strrchr(pcScript, '/');
+    char *pcDot;
+
+    snprintf(HostScenario, sizeof(HostScenario), "%s", (pcName != NULL_PTR) ? (pcName + 1) : pcScript);
+    pcDot = strrchr(HostScenario, '.');
+    if(pcDot != NULL_PTR)
+    {
+        *pcDot = '\0';
+    }
+}
+
+/* "high,medium,low" in degrees, each within the sensor range */
+static boolean HOST_SetIntensityDiffs(const char *pcDiffs)
+{
+    unsigned int auiDiffs[3];
+    char cEnd;
+    uint8 ucLevel;
+
+    if(sscanf(pcDiffs, "%u,%u,%u%c", &auiDiffs[0], &auiDiffs[1], &auiDiffs[2], &cEnd) != 3)
+    {
+        return FALSE;
+    }
+    for(ucLevel = 0; ucLevel < 3; ucLevel++)
+    {
+        if(auiDiffs[ucLevel] > HOST_MAX_INTENSITY_DIFF)
+        {
+            return FALSE;
+        }
+        HostIntensityDiff[ucLevel] = (unsigned char)auiDiffs[ucLevel];
+    }
+    return TRUE;
+}
+
+static void HOST_Usage(const char *pcName)
+{
+    fprintf(stderr, "usage: %s [-s script] [-t seconds] [-r seed] [-p seconds] [-o uart.txt] [-l] [-T thermal.csv] [-j metrics.json] [-m mmio.csv] [-R trace.rec] [-g high,medium,low]\n", pcName);
+    exit(2);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    const char *pcScript = NULL_PTR;
+    const char *pcOutput = NULL_PTR;
+    const char *pcThermal = NULL_PTR;
+    const char *pcMetrics = NULL_PTR;
+    const char *pcMmio = NULL_PTR;
+    const char *pcReplay = NULL_PTR;
+    double dSeconds = 0;
+    double dProgress = 0;
+    boolean bLeds = FALSE;
+    uint64 ullEnd;
+    int iOption;
+
+    while((iOption = getopt(argc, argv, "s:t:r:p:o:lT:j:m:R:g:")) != -1)
+    {
+        switch(iOption)
+        {
+        case 's':
+            pcScript = optarg;
+            break;
+        case 't':
+            dSeconds = atof(optarg);
+            break;
+        case 'r':
+            HostRandom = TRUE;
+            HostSeed = strtoull(optarg, NULL, 0);
+            break;
+        case 'p':
+            dProgress = atof(optarg);
+            break;
+        case 'o':
+            pcOutput = optarg;
+            break;
+        case 'l':
+            bLeds = TRUE;
+            break;
+        case 'T':
+            pcThermal = optarg;
+            break;
+        case 'j':
+            pcMetrics = optarg;
+            break;
+        case 'm':
+            pcMmio = optarg;
+            break;
+        case 'R':
+            pcReplay = optarg;
+            break;
+        case 'g':
+            if(!HOST_SetIntensityDiffs(optarg))
+            {
+                fprintf(stderr, "%s: -g takes three degrees from 0 to %d, as 10,5,2\n", argv[0], HOST_MAX_INTENSITY_DIFF);
+                HOST_Usage(argv[0]);
+            }
+            break;
+        default:
+            HOST_Usage(argv[0]);
+        }
+    }
+
+    HostUartFile = (pcOutput != NULL_PTR) ? fopen(pcOutput, "w") : stdout;
+    if(HostUartFile == NULL_PTR)
+    {
+        perror(pcOutput);
+        return EXIT_FAILURE;
+    }
+
+    if(pcThermal != NULL_PTR)
+    {
+        HostThermalFile = fopen(pcThermal, "w");
+        if(HostThermalFile == NULL_PTR)
+        {
+            perror(pcThermal);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(pcMetrics != NULL_PTR)
+    {
+        HostMetricsFile = fopen(pcMetrics, "w");
+        if(HostMetricsFile == NULL_PTR)
+        {
+            perror(pcMetrics);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(pcMmio != NULL_PTR)
+    {
+        HostMmioFile = fopen(pcMmio, "w");
+        if(HostMmioFile == NULL_PTR)
+        {
+            perror(pcMmio);
+            return EXIT_FAILURE;
+        }
+    }
+    if(pcScript != NULL_PTR)
+    {
+        HOST_SetScenario(pcScript);
+    }
+    else if(HostRandom)
+    {
+        strcpy(HostScenario, "random");
+    }
+
+    SIM_MachineInit();
+    SIM_ThermalSetLog(HostThermalFile);
+    SIM_MmioEnable((HostMmioFile != NULL_PTR) ? TRUE : FALSE);
+    if((pcScript != NULL_PTR) && !SIM_ScriptLoad(pcScript))
+    {
+        return EXIT_FAILURE;
+    }
+    if((pcReplay != NULL_PTR) && !SIM_ReplayLoad(pcReplay))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if(HostRandom)
+    {
+        SIM_ScriptRandom(HostSeed);
+    }
+
+    SIM_NvicSetHandler(HOST_IRQ_GPIO_PORTE, GPIOPortE_Handler);
+    SIM_NvicSetHandler(HOST_IRQ_ADC0_SS0, ADC0_Handler);
+    SIM_NvicSetHandler(HOST_IRQ_GPIO_PORTF, GPIOPortF_Handler);
+    SIM_NvicSetHandler(HOST_IRQ_ADC1_SS0, ADC1_Handler);
+    SIM_NvicSetHandler(HOST_IRQ_UART0, UART0_Handler);
+    SIM_UartSetOutput(HOST_UartOutput);
+    if(bLeds)
+    {
+        SIM_GpioSetOutputHook(HOST_LedOutput);
+    }
+
+    /* An explicit run time wins over the end of the script, which wins over the end of the trace */
+    ullEnd = (dSeconds > 0) ? (uint64)(dSeconds * SIM_CPU_CLOCK_HZ) : SIM_ScriptEnd();
+    if(ullEnd == SIM_CLOCK_NEVER)
+    {
+        ullEnd = SIM_ReplayEnd();
+    }
+    if(ullEnd == SIM_CLOCK_NEVER)
+    {
+        ullEnd = (uint64)HOST_DEFAULT_SECONDS * SIM_CPU_CLOCK_HZ;
+    }
+    SIM_MachineSetEnd(ullEnd, HOST_End);
+    if(dProgress > 0)
+    {
+        SIM_MachineSetMonitor((uint64)(dProgress * SIM_CPU_CLOCK_HZ), HOST_Progress);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &HostStart);
+    return APP_Main();
+}
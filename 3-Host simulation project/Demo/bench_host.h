@@ -0,0 +1,30 @@
+ /******************************************************************************
+ *
+ * Module: Demo - MCAL Bench
+ *
+ * File Name: bench_host.h
+ *
+ * Description: Host clock for the MCAL micro-benchmarks, forced into the
+ *              build of bench.c with -include. The host clock is far coarser
+ *              than the DWT counter, so every sample times a batch of calls
+ *              and the time is kept in picoseconds to see below one ns per
+ *              call (the 32-bit difference stays exact up to ~4 ms).
+ *              There is no kernel on the host, the kernel cases are left out.
+ *              The simulated EEPROM holds no records, the EEPROM cases are in.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef DEMO_BENCH_HOST_H_
+#define DEMO_BENCH_HOST_H_
+
+#include "sim_clock.h"
+
+#define BENCH_TIMESTAMP()               ((uint32)(SIM_HostNanoseconds() * 1000UL))
+#define BENCH_UNIT                      "ps"
+#define BENCH_BATCH                     64
+#define BENCH_KERNEL_CASES              0
+#define BENCH_EEPROM_CASES              1
+
+#endif /* DEMO_BENCH_HOST_H_ */
@@ -0,0 +1,37 @@
+ /******************************************************************************
+ *
+ * Module: Demo - UART
+ *
+ * File Name: demo_uart.c
+ *
+ * Description: UART0 transmit functions of uart0.h writing to stdout, so the
+ *              reports of the measurement modules can be printed by the demos.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include "uart0.h"
+
+void UART0_SendByte(uint8 data)
+{
+    /* The target reports end lines with "\r\n" */
+    if(data != '\r')
+    {
+        putchar(data);
+    }
+}
+
+void UART0_SendString(const uint8 *pData)
+{
+    while(*pData != '\0')
+    {
+        UART0_SendByte(*pData++);
+    }
+}
+
+void UART0_SendInteger(sint64 sNumber)
+{
+    printf("%lld", (long long)sNumber);
+}
@@ -0,0 +1,192 @@
+ /******************************************************************************
+ *
+ * Module: Demo - ISR
+ *
+ * File Name: isr_demo.c
+ *
+ * Description: Runs the four application interrupt handlers of main.c as a
+ *              cycle cost model on the simulated clock, through the real
+ *              ISR_STATS_ENTER/ISR_STATS_EXIT hooks and report. Every step
+ *              of a handler (FromISR kernel call, register access, the
+ *              temperature scaling) advances the clock by its cost, the
+ *              branches follow the handler code: out of range temperatures
+ *              give the error semaphore, a give wakes a task only when one
+ *              is waiting.
+ *
+ *              The step costs are estimates for the Cortex-M4 at 16 MHz with
+ *              no flash wait states; calibrate them with the 'i' report of
+ *              the board. With a budget given the demo exits with 1 when a
+ *              handler took longer, so a change of a handler path shows up
+ *              without hardware.
+ *
+ *              Usage: isr_demo [seconds] [seed] [budget cycles]
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isr_stats.h"
+#include "trace.h"
+#include "dwt.h"
+#include "sim_clock.h"
+#include "sim_registers.h"
+
+/* Step costs in cycles */
+#define DEMO_COST_SEMAPHORE_TAKE_FROM_ISR   58      /* xQueueReceiveFromISR() on a full binary semaphore */
+#define DEMO_COST_SEMAPHORE_GIVE_FROM_ISR   52      /* xQueueGiveFromISR() with no task waiting */
+#define DEMO_COST_TASK_WAKE                 64      /* Moving the unblocked task to the ready list */
+#define DEMO_COST_SET_BITS_FROM_ISR         96      /* xEventGroupSetBitsFromISR(): pends the set on the timer queue */
+#define DEMO_COST_TEMP_SCALING              18      /* ADC read, *45/4095 */
+#define DEMO_COST_REGISTER_ACCESS           4       /* One peripheral register read or write */
+#define DEMO_COST_LATENCY_PROBE             30      /* traceLATENCY_START() */
+
+/* Handler periods and the chance of the rarer paths */
+#define DEMO_ADC_PERIOD_US                  500000
+#define DEMO_PRESS_MEAN_MS                  3000
+#define DEMO_OUT_OF_RANGE_PERCENT           10
+#define DEMO_TASK_WAITING_PERCENT           30
+
+static uint32 DemoRandom;
+
+static uint32 DEMO_Random(void)
+{
+    DemoRandom = DemoRandom * 1103515245UL + 12345UL;
+    return (DemoRandom >> 8) & 0xFFFFFF;
+}
+
+static boolean DEMO_Chance(uint32 ulPercent)
+{
+    return ((DEMO_Random() % 100) < ulPercent) ? TRUE : FALSE;
+}
+
+static void DEMO_Step(uint32 ulCycles)
+{
+    SIM_ClockAdvance(ulCycles);
+}
+
+static void DEMO_SemaphoreGive(void)
+{
+    DEMO_Step(DEMO_COST_SEMAPHORE_GIVE_FROM_ISR);
+    if(DEMO_Chance(DEMO_TASK_WAITING_PERCENT))
+    {
+        DEMO_Step(DEMO_COST_TASK_WAKE);
+    }
+}
+
+/* ADC0_Handler and ADC1_Handler, the driver one also starts the sensor chain */
+static void DEMO_AdcHandler(uint8 ucIsrNumber)
+{
+    ISR_STATS_ENTER(ucIsrNumber);
+
+    DEMO_Step(DEMO_COST_SEMAPHORE_TAKE_FROM_ISR);
+    DEMO_Step(DEMO_COST_REGISTER_ACCESS + DEMO_COST_TEMP_SCALING);
+    if(ucIsrNumber == TRACE_ISR_ADC0_SS0)
+    {
+        DEMO_Step(DEMO_COST_LATENCY_PROBE);
+    }
+    DEMO_SemaphoreGive();
+    if(DEMO_Chance(DEMO_OUT_OF_RANGE_PERCENT))
+    {
+        DEMO_SemaphoreGive();
+    }
+    DEMO_Step(DEMO_COST_REGISTER_ACCESS);
+
+    ISR_STATS_EXIT(ucIsrNumber);
+}
+
+/* GPIOPortF_Handler: one RIS read per branch tested, then the set and the flag clear */
+static void DEMO_PortFHandler(void)
+{
+    ISR_STATS_ENTER(TRACE_ISR_GPIO_PORTF);
+
+    DEMO_Step(DEMO_COST_REGISTER_ACCESS);
+    if(DEMO_Chance(50))
+    {
+        DEMO_Step(DEMO_COST_REGISTER_ACCESS); /* SW2 on PF4 is tested second */
+    }
+    DEMO_Step(DEMO_COST_SET_BITS_FROM_ISR);
+    DEMO_Step(DEMO_COST_LATENCY_PROBE);
+    DEMO_Step(2 * DEMO_COST_REGISTER_ACCESS);
+
+    ISR_STATS_EXIT(TRACE_ISR_GPIO_PORTF);
+}
+
+static void DEMO_PortEHandler(void)
+{
+    ISR_STATS_ENTER(TRACE_ISR_GPIO_PORTE);
+
+    DEMO_Step(DEMO_COST_SET_BITS_FROM_ISR);
+    DEMO_Step(2 * DEMO_COST_REGISTER_ACCESS);
+
+    ISR_STATS_EXIT(TRACE_ISR_GPIO_PORTE);
+}
+
+static uint64 DEMO_NextPress(void)
+{
+    return SIM_ClockCycles() + SIM_MS_TO_CYCLES(1 + DEMO_Random() % (2 * DEMO_PRESS_MEAN_MS));
+}
+
+int main(int argc, char *argv[])
+{
+    uint32 ulSeconds = (argc > 1) ? (uint32)strtoul(argv[1], NULL, 0) : 120;
+    uint32 ulSeed = (argc > 2) ? (uint32)strtoul(argv[2], NULL, 0) : 1;
+    uint32 ulBudget = (argc > 3) ? (uint32)strtoul(argv[3], NULL, 0) : 0;
+    uint64 ullEnd;
+    uint64 ullNextAdc;
+    uint64 ullNextPortF;
+    uint64 ullNextPortE;
+    uint8 ucSlot;
+    int iResult = 0;
+
+    DemoRandom = ulSeed;
+
+    SIM_RegistersReset();
+    SIM_ClockReset();
+    DWT_CycleCounterInit();
+    ISR_Init();
+
+    ullEnd = SIM_MS_TO_CYCLES((uint64)ulSeconds * 1000);
+    ullNextAdc = SIM_US_TO_CYCLES(DEMO_ADC_PERIOD_US);
+    ullNextPortF = DEMO_NextPress();
+    ullNextPortE = DEMO_NextPress();
+
+    /* Jump from one interrupt to the next, the handlers never overlap */
+    while(SIM_ClockCycles() < ullEnd)
+    {
+        if((ullNextAdc <= ullNextPortF) && (ullNextAdc <= ullNextPortE))
+        {
+            SIM_ClockAdvance(ullNextAdc - SIM_ClockCycles());
+            DEMO_AdcHandler(TRACE_ISR_ADC0_SS0);
+            DEMO_AdcHandler(TRACE_ISR_ADC1_SS0);
+            ullNextAdc += SIM_US_TO_CYCLES(DEMO_ADC_PERIOD_US);
+        }
+        else if(ullNextPortF <= ullNextPortE)
+        {
+            SIM_ClockAdvance(ullNextPortF - SIM_ClockCycles());
+            DEMO_PortFHandler();
+            ullNextPortF = DEMO_NextPress();
+        }
+        else
+        {
+            SIM_ClockAdvance(ullNextPortE - SIM_ClockCycles());
+            DEMO_PortEHandler();
+            ullNextPortE = DEMO_NextPress();
+        }
+    }
+
+    printf("%lu simulated seconds, seed %lu\n", (unsigned long)ulSeconds, (unsigned long)ulSeed);
+    ISR_Report();
+
+    for(ucSlot = 0; (ulBudget > 0) && (ucSlot < ISR_STATS_COUNT); ucSlot++)
+    {
+        if(ISR_GetMaxCycles(ucSlot) > ulBudget)
+        {
+            printf("slot %u over budget: %lu > %lu cycles\n", ucSlot,
+                   (unsigned long)ISR_GetMaxCycles(ucSlot), (unsigned long)ulBudget);
+            iResult = 1;
+        }
+    }
+    return iResult;
+}
@@ -0,0 +1,282 @@
+ /******************************************************************************
+ *
+ * Module: Demo - Latency
+ *
+ * File Name: latency_demo.c
+ *
+ * Description: Runs the driver seat response chains against the simulated
+ *              clock and prints the latency report of the real probe code.
+ *              The tasks on the chain are modelled with the priorities,
+ *              periods and queue use of main.c: a fixed priority scheduler
+ *              with 10 msec time slices steps through the tasks in 10 usec
+ *              steps, button presses come at seeded random times.
+ *
+ *              Usage: latency_demo [seconds] [seed]
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "latency.h"
+#include "dwt.h"
+#include "sim_clock.h"
+#include "sim_registers.h"
+
+#define DEMO_STEP_US                    10
+#define DEMO_TICK_US                    10000
+
+/* Button presses come on average every DEMO_PRESS_MEAN_MS */
+#define DEMO_PRESS_MEAN_MS              3000
+
+/* The display prints about 330 characters at 9600 baud with busy waiting,
+ * its receive from the passenger queue is taken as immediate */
+#define DEMO_DISPLAY_WORK_US            344000
+
+#define DEMO_QUEUE_LENGTH               3
+#define DEMO_NO_WAKE                    0xFFFFFFFFUL
+
+typedef enum
+{
+    DEMO_BUTTON, DEMO_TEMP, DEMO_HEATER, DEMO_DISPLAY, DEMO_INTENSITY, DEMO_TASKS
+} DemoTaskId;
+
+typedef enum
+{
+    DEMO_DELAYED, DEMO_READY, DEMO_RECEIVING, DEMO_BLOCKED
+} DemoState;
+
+typedef struct
+{
+    uint8 Priority;
+    uint32 PeriodUs;        /* vTaskDelayUntil() period, 0 for event driven tasks */
+    uint32 WorkUs;          /* CPU time of one activation */
+    uint32 NextWakeUs;
+    uint32 LastWakeUs;
+    uint32 RemainingUs;
+    DemoState State;
+    uint32 BlockedSince;    /* Orders the receivers blocked on the queue */
+} DemoTask;
+
+/* Priorities and periods of main.c */
+static DemoTask DemoTasks[DEMO_TASKS] =
+{
+    { 5, 0,       20,                   DEMO_NO_WAKE, 0,       0, DEMO_DELAYED, 0 },
+    { 3, 500000,  10,                   500000,       500000,  0, DEMO_DELAYED, 0 },
+    { 2, 200000,  10,                   200000,       200000,  0, DEMO_DELAYED, 0 },
+    { 2, 1000000, DEMO_DISPLAY_WORK_US, 1000000,      1000000, 0, DEMO_DELAYED, 0 },
+    { 1, 200000,  30,                   200000,       200000,  0, DEMO_DELAYED, 0 },
+};
+
+static uint32 DemoNowUs;
+static uint32 DemoQueueItems;
+static uint32 DemoAdcDoneUs = DEMO_NO_WAKE;
+static uint32 DemoRandom;
+
+/* Ready task of the same priority that had the CPU last, for the time slices */
+static int DemoLastRunning = -1;
+
+static uint32 DEMO_Random(void)
+{
+    DemoRandom = DemoRandom * 1103515245UL + 12345UL;
+    return (DemoRandom >> 8) & 0xFFFFFF;
+}
+
+static uint32 DEMO_NextPressUs(void)
+{
+    return DemoNowUs + 1000 + (DEMO_Random() % (2 * DEMO_PRESS_MEAN_MS)) * 1000 + (DEMO_Random() % 1000);
+}
+
+static void DEMO_Delay(DemoTaskId eTask)
+{
+    DemoTask *pxTask = &DemoTasks[eTask];
+
+    /* vTaskDelayUntil(): a late task wakes again at once */
+    pxTask->LastWakeUs += pxTask->PeriodUs;
+    pxTask->NextWakeUs = pxTask->LastWakeUs;
+    pxTask->State = DEMO_DELAYED;
+}
+
+static void DEMO_Received(DemoTaskId eTask)
+{
+    LAT_ItemReceived();
+    DemoTasks[eTask].State = DEMO_READY;
+    DemoTasks[eTask].RemainingUs = DemoTasks[eTask].WorkUs;
+}
+
+/* xQueueReceive(): take an item or block until the intensity task sends one */
+static void DEMO_Receive(DemoTaskId eTask)
+{
+    if(DemoQueueItems > 0)
+    {
+        DemoQueueItems--;
+        DEMO_Received(eTask);
+    }
+    else
+    {
+        DemoTasks[eTask].State = DEMO_BLOCKED;
+        DemoTasks[eTask].BlockedSince = DemoNowUs;
+    }
+}
+
+/* xQueueSend(): hand the item to the highest priority, longest waiting receiver */
+static void DEMO_Send(void)
+{
+    int iTask;
+    int iReceiver = -1;
+
+    LAT_ItemSent();
+    for(iTask = 0; iTask < DEMO_TASKS; iTask++)
+    {
+        if((DemoTasks[iTask].State == DEMO_BLOCKED) &&
+           ((iReceiver < 0) || (DemoTasks[iTask].Priority > DemoTasks[iReceiver].Priority) ||
+            ((DemoTasks[iTask].Priority == DemoTasks[iReceiver].Priority) &&
+             (DemoTasks[iTask].BlockedSince < DemoTasks[iReceiver].BlockedSince))))
+        {
+            iReceiver = iTask;
+        }
+    }
+    if(iReceiver >= 0)
+    {
+        DEMO_Received((DemoTaskId)iReceiver);
+    }
+    else if(DemoQueueItems < DEMO_QUEUE_LENGTH)
+    {
+        DemoQueueItems++;
+    }
+}
+
+static void DEMO_Finished(DemoTaskId eTask)
+{
+    switch(eTask)
+    {
+    case DEMO_BUTTON:
+        LAT_Probe(LAT_CHAIN_DRIVER_BUTTON, LAT_HOP_BUTTON_TASK);
+        DemoTasks[eTask].State = DEMO_DELAYED;
+        break;
+    case DEMO_TEMP:
+        /* The conversion completes and ADC0_Handler runs a few usec later */
+        DemoAdcDoneUs = DemoNowUs + 8;
+        DEMO_Delay(eTask);
+        break;
+    case DEMO_INTENSITY:
+        LAT_ProbeSent(LAT_CHAIN_DRIVER_BUTTON, LAT_HOP_BUTTON_DECISION);
+        LAT_ProbeSent(LAT_CHAIN_DRIVER_SENSOR, LAT_HOP_SENSOR_DECISION);
+        DEMO_Send();
+        DEMO_Delay(eTask);
+        break;
+    case DEMO_HEATER:
+        LAT_ProbeReceived(LAT_CHAIN_DRIVER_BUTTON, LAT_HOP_BUTTON_OUTPUT);
+        LAT_ProbeReceived(LAT_CHAIN_DRIVER_SENSOR, LAT_HOP_SENSOR_OUTPUT);
+        DEMO_Delay(eTask);
+        break;
+    case DEMO_DISPLAY:
+        DEMO_Delay(eTask);
+        break;
+    default:
+        break;
+    }
+}
+
+static int DEMO_PickTask(void)
+{
+    int iTask;
+    int iPicked = -1;
+    boolean bSliceEnd = ((DemoNowUs % DEMO_TICK_US) == 0) ? TRUE : FALSE;
+
+    for(iTask = 0; iTask < DEMO_TASKS; iTask++)
+    {
+        if((DemoTasks[iTask].State != DEMO_READY) && (DemoTasks[iTask].State != DEMO_RECEIVING))
+        {
+            continue;
+        }
+        if((iPicked < 0) || (DemoTasks[iTask].Priority > DemoTasks[iPicked].Priority))
+        {
+            iPicked = iTask;
+        }
+        else if((DemoTasks[iTask].Priority == DemoTasks[iPicked].Priority) &&
+                (iPicked == DemoLastRunning) && bSliceEnd)
+        {
+            iPicked = iTask; /* Round robin between equal priorities on each tick */
+        }
+        else if((DemoTasks[iTask].Priority == DemoTasks[iPicked].Priority) &&
+                (iTask == DemoLastRunning) && !bSliceEnd)
+        {
+            iPicked = iTask; /* Keep the running task until the slice ends */
+        }
+    }
+    return iPicked;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32 ulSeconds = (argc > 1) ? (uint32)strtoul(argv[1], NULL, 0) : 120;
+    uint32 ulSeed = (argc > 2) ? (uint32)strtoul(argv[2], NULL, 0) : 1;
+    uint32 ulNextPressUs;
+    int iTask;
+    int iFinished;
+
+    DemoRandom = ulSeed;
+
+    SIM_RegistersReset();
+    SIM_ClockReset();
+    DWT_CycleCounterInit();
+    LAT_Init();
+    ulNextPressUs = DEMO_NextPressUs();
+
+    for(DemoNowUs = 0; DemoNowUs < ulSeconds * 1000000UL; DemoNowUs += DEMO_STEP_US)
+    {
+        /* Interrupts first, they preempt every task */
+        if(DemoNowUs >= ulNextPressUs)
+        {
+            LAT_Start(LAT_CHAIN_DRIVER_BUTTON);
+            DemoTasks[DEMO_BUTTON].State = DEMO_READY;
+            DemoTasks[DEMO_BUTTON].RemainingUs = DemoTasks[DEMO_BUTTON].WorkUs;
+            ulNextPressUs = DEMO_NextPressUs();
+        }
+        if(DemoNowUs >= DemoAdcDoneUs)
+        {
+            LAT_Start(LAT_CHAIN_DRIVER_SENSOR);
+            DemoAdcDoneUs = DEMO_NO_WAKE;
+        }
+
+        for(iTask = 0; iTask < DEMO_TASKS; iTask++)
+        {
+            if((DemoTasks[iTask].State == DEMO_DELAYED) && (DemoNowUs >= DemoTasks[iTask].NextWakeUs))
+            {
+                /* The heater and display tasks start with xQueueReceive() */
+                DemoTasks[iTask].State = ((iTask == DEMO_HEATER) || (iTask == DEMO_DISPLAY)) ? DEMO_RECEIVING : DEMO_READY;
+                DemoTasks[iTask].RemainingUs = DemoTasks[iTask].WorkUs;
+            }
+        }
+
+        iTask = DEMO_PickTask();
+        iFinished = -1;
+        if(iTask >= 0)
+        {
+            DemoLastRunning = iTask;
+            if(DemoTasks[iTask].State == DEMO_RECEIVING)
+            {
+                DEMO_Receive((DemoTaskId)iTask);
+            }
+            else
+            {
+                DemoTasks[iTask].RemainingUs -= (DemoTasks[iTask].RemainingUs < DEMO_STEP_US) ?
+                                                DemoTasks[iTask].RemainingUs : DEMO_STEP_US;
+                iFinished = (DemoTasks[iTask].RemainingUs == 0) ? iTask : -1;
+            }
+        }
+
+        /* The probes at the end of a task see the time its work took */
+        SIM_ClockAdvance(SIM_US_TO_CYCLES(DEMO_STEP_US));
+        if(iFinished >= 0)
+        {
+            DEMO_Finished((DemoTaskId)iFinished);
+        }
+    }
+
+    printf("%lu simulated seconds, seed %lu\n", (unsigned long)ulSeconds, (unsigned long)ulSeed);
+    LAT_Report(LAT_GetChain);
+    return 0;
+}
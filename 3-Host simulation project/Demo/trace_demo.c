@@ -0,0 +1,140 @@
+ /******************************************************************************
+ *
+ * Module: Demo - Trace
+ *
+ * File Name: trace_demo.c
+ *
+ * Description: Writes a scripted two second session of the seat heater
+ *              through the trace ring against the simulated clock and drains
+ *              it to a file, so Tools/trace_decode.py can be checked without
+ *              a board.
+ *
+ *              Usage: trace_demo <output.bin>
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include "trace.h"
+#include "dwt.h"
+#include "sim_clock.h"
+#include "sim_registers.h"
+
+/* Task numbers in creation order of main.c */
+#define DEMO_BUTTON_TASK                1
+#define DEMO_DRIVER_INTENSITY_TASK      2
+#define DEMO_DRIVER_HEATER_TASK         4
+#define DEMO_DRIVER_TEMP_TASK           6
+#define DEMO_IDLE_TASK                  13
+
+/* Queue numbers and types used by main.c */
+#define DEMO_DRIVER_MUTEX               0
+#define DEMO_DRIVER_TEMP_SMPHR          2
+#define DEMO_DRIVER_INTENSITY_QUEUE     6
+#define DEMO_TYPE_BASE                  0
+#define DEMO_TYPE_MUTEX                 1
+#define DEMO_TYPE_BINARY                3
+
+static FILE *DemoOutput;
+
+static void DEMO_SendByte(uint8 data)
+{
+    fputc(data, DemoOutput);
+}
+
+static void DEMO_Run(uint8 ucTask, uint32 ulMicroSeconds)
+{
+    TRACE_RECORD(TRACE_EVENT_TASK_SWITCH, ucTask, 0);
+    SIM_ClockAdvance(SIM_US_TO_CYCLES(ulMicroSeconds));
+}
+
+static void DEMO_Queue(uint8 ucEvent, uint8 ucQueue, uint8 ucType, uint8 ucWaiting)
+{
+    TRACE_RECORD(ucEvent, ucQueue, (ucType << 8) | ucWaiting);
+    SIM_ClockAdvance(SIM_US_TO_CYCLES(15));
+}
+
+static void DEMO_AdcInterrupt(void)
+{
+    TRACE_RECORD(TRACE_EVENT_ISR_ENTER, TRACE_ISR_ADC0_SS0, 0);
+    SIM_ClockAdvance(SIM_US_TO_CYCLES(4));
+    DEMO_Queue(TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR, DEMO_DRIVER_TEMP_SMPHR, DEMO_TYPE_BINARY, 0);
+    DEMO_Queue(TRACE_EVENT_QUEUE_SEND_FROM_ISR, DEMO_DRIVER_TEMP_SMPHR, DEMO_TYPE_BINARY, 1);
+    TRACE_RECORD(TRACE_EVENT_ISR_EXIT, TRACE_ISR_ADC0_SS0, 0);
+}
+
+static void DEMO_ButtonInterrupt(void)
+{
+    TRACE_RECORD(TRACE_EVENT_ISR_ENTER, TRACE_ISR_GPIO_PORTF, 0);
+    SIM_ClockAdvance(SIM_US_TO_CYCLES(12));
+    TRACE_RECORD(TRACE_EVENT_ISR_EXIT, TRACE_ISR_GPIO_PORTF, 0);
+    DEMO_Run(DEMO_BUTTON_TASK, 30);
+    DEMO_Queue(TRACE_EVENT_QUEUE_RECEIVE, DEMO_DRIVER_MUTEX, DEMO_TYPE_MUTEX, 0);
+    DEMO_Queue(TRACE_EVENT_QUEUE_SEND, DEMO_DRIVER_MUTEX, DEMO_TYPE_MUTEX, 1);
+}
+
+static void DEMO_ControlPeriod(void)
+{
+    DEMO_Run(DEMO_DRIVER_INTENSITY_TASK, 20);
+    DEMO_Queue(TRACE_EVENT_QUEUE_RECEIVE, DEMO_DRIVER_MUTEX, DEMO_TYPE_MUTEX, 0);
+    DEMO_Queue(TRACE_EVENT_QUEUE_RECEIVE, DEMO_DRIVER_TEMP_SMPHR, DEMO_TYPE_BINARY, 0);
+    DEMO_Queue(TRACE_EVENT_QUEUE_SEND, DEMO_DRIVER_INTENSITY_QUEUE, DEMO_TYPE_BASE, 1);
+    DEMO_Queue(TRACE_EVENT_QUEUE_SEND, DEMO_DRIVER_TEMP_SMPHR, DEMO_TYPE_BINARY, 1);
+    DEMO_Queue(TRACE_EVENT_QUEUE_SEND, DEMO_DRIVER_MUTEX, DEMO_TYPE_MUTEX, 1);
+    DEMO_Run(DEMO_DRIVER_HEATER_TASK, 25);
+    DEMO_Queue(TRACE_EVENT_QUEUE_RECEIVE, DEMO_DRIVER_INTENSITY_QUEUE, DEMO_TYPE_BASE, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32 ulMilliSeconds;
+
+    if(argc != 2)
+    {
+        fprintf(stderr, "usage: %s <output.bin>\n", argv[0]);
+        return 2;
+    }
+    DemoOutput = fopen(argv[1], "wb");
+    if(DemoOutput == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    SIM_RegistersReset();
+    SIM_ClockReset();
+    DWT_CycleCounterInit();
+    TRACE_Init();
+
+    TRACE_TaskCreated(DEMO_BUTTON_TASK, "Button Task");
+    TRACE_TaskCreated(DEMO_DRIVER_INTENSITY_TASK, "Driver Intensit");
+    TRACE_TaskCreated(DEMO_DRIVER_HEATER_TASK, "Driver Heater T");
+    TRACE_TaskCreated(DEMO_DRIVER_TEMP_TASK, "Driver Temp Rea");
+    TRACE_TaskCreated(DEMO_IDLE_TASK, "IDLE");
+
+    for(ulMilliSeconds = 0; ulMilliSeconds < 2000; ulMilliSeconds += 10)
+    {
+        if((ulMilliSeconds % 500) == 0)
+        {
+            DEMO_Run(DEMO_DRIVER_TEMP_TASK, 10);
+            DEMO_AdcInterrupt();
+        }
+        if((ulMilliSeconds % 200) == 0)
+        {
+            DEMO_ControlPeriod();
+        }
+        if(ulMilliSeconds == 730)
+        {
+            DEMO_ButtonInterrupt();
+        }
+        DEMO_Run(DEMO_IDLE_TASK, 0);
+        SIM_ClockAdvance(SIM_MS_TO_CYCLES(10) - (SIM_ClockCycles() % SIM_MS_TO_CYCLES(10)));
+    }
+
+    TRACE_Stop();
+    TRACE_Drain(DEMO_SendByte);
+    fclose(DemoOutput);
+    printf("%lu events recorded, %u kept in the ring\n", (unsigned long)gTraceHead, TRACE_BUFFER_SIZE);
+    return 0;
+}
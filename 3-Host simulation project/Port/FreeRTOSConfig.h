@@ -0,0 +1,44 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - FreeRTOS Port
+ *
+ * File Name: FreeRTOSConfig.h
+ *
+ * Description: Host overrides of the application FreeRTOSConfig.h, which is
+ *              included first so that every other setting (tick rate, trace
+ *              hooks, run time counter) stays the one of the target build.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef HOST_FREERTOS_CONFIG_H
+#define HOST_FREERTOS_CONFIG_H
+
+#include_next "FreeRTOSConfig.h"
+
+/* Pointers are 64-bit on the host, so the TCBs and queues are larger. The
+ * scaling benchmark passes a heap for its 64 channels */
+#ifndef HOST_HEAP_SIZE
+#define HOST_HEAP_SIZE              (32 * 1024)
+#endif
+#undef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE       ((size_t)(HOST_HEAP_SIZE))
+
+/* The idle task sleeps the simulated CPU until the next event, see port.c */
+#undef configUSE_IDLE_HOOK
+#define configUSE_IDLE_HOOK         1
+
+/* A failed assertion stops the simulation instead of spinning forever */
+void vPortAssert(const char *pcFile, unsigned long ulLine);
+#undef configASSERT
+#define configASSERT(x)             if((x) == 0) { vPortAssert(__FILE__, __LINE__); }
+
+/* The intensity thresholds of the control tasks of seat.c, 10/5/2 degrees
+ * unless seat_heater -g sets others (Tools/gain_sweep.py) */
+extern unsigned char HostIntensityDiff[3];
+#define SEAT_HIGH_INTENSITY_DIFF    (HostIntensityDiff[0])
+#define SEAT_MED_INTENSITY_DIFF     (HostIntensityDiff[1])
+#define SEAT_LOW_INTENSITY_DIFF     (HostIntensityDiff[2])
+
+#endif /* HOST_FREERTOS_CONFIG_H */
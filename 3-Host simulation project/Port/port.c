@@ -0,0 +1,267 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - FreeRTOS Port
+ *
+ * File Name: port.c
+ *
+ * Description: FreeRTOS port of the host build. A task is a POSIX thread
+ *              waiting on its own semaphore; a context switch posts the
+ *              semaphore of the next task and waits on the one of the task
+ *              switched out, so exactly one task thread runs at any time.
+ *              The simulated machine calls the interrupt point between
+ *              register accesses, where the pending NVIC interrupts are
+ *              taken on the running thread, then the yield they asked for.
+ *              The code between register accesses runs in zero simulated
+ *              time, so the kernel work is charged in cycles: every outer
+ *              critical section or interrupt mask, which each kernel call
+ *              takes at least once, and every context switch.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "sim_machine.h"
+#include "sim_nvic.h"
+
+/* Host stack of every task thread, the FreeRTOS stack only holds the thread record */
+#define portTHREAD_STACK_SIZE       (256 * 1024)
+
+/* Cortex-M4 estimates: a kernel call without a switch, and PendSV with
+ * vTaskSwitchContext() */
+#define portKERNEL_CALL_CYCLES      200
+#define portSWITCH_CYCLES           150
+
+typedef struct
+{
+    pthread_t xThread;
+    sem_t xResume;
+    TaskFunction_t pxCode;
+    void *pvParameters;
+} SimThread_t;
+
+/* Start of the scheduler: interrupts masked, nesting never reaching zero */
+static UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
+static UBaseType_t uxInterruptMask = 1;
+static BaseType_t xInsideInterrupt = pdFALSE;
+static BaseType_t xSwitching = pdFALSE;
+static BaseType_t xYieldPending = pdFALSE;
+static BaseType_t xSchedulerRunning = pdFALSE;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* The thread record sits at the top of the task stack, pxTopOfStack is the
+ * first member of the TCB and is never moved by this port */
+static SimThread_t *prvGetThread(void *pvTCB)
+{
+    return (SimThread_t *)(*(StackType_t **)pvTCB + 1);
+}
+
+static void prvWait(SimThread_t *pxThread)
+{
+    while(sem_wait(&pxThread->xResume) != 0)
+    {
+    }
+}
+
+static void prvSwitchContext(void)
+{
+    SimThread_t *pxFrom = prvGetThread(xTaskGetCurrentTaskHandle());
+    SimThread_t *pxTo;
+
+    xYieldPending = pdFALSE;
+    xSwitching = pdTRUE;
+    /* Interrupts due meanwhile are taken by the task switched in */
+    SIM_MachineExecute(portSWITCH_CYCLES);
+    vTaskSwitchContext();
+    xSwitching = pdFALSE;
+    pxTo = prvGetThread(xTaskGetCurrentTaskHandle());
+
+    if(pxTo != pxFrom)
+    {
+        sem_post(&pxTo->xResume);
+        prvWait(pxFrom);
+    }
+}
+
+/* Takes the pending interrupts one after the other, then the yield requested
+ * by their handlers */
+static void prvServiceInterrupts(void)
+{
+    uint16 usIrq;
+
+    if(!xSchedulerRunning || xInsideInterrupt || xSwitching || (uxInterruptMask != 0) || (uxCriticalNesting != 0))
+    {
+        return;
+    }
+
+    while((usIrq = SIM_NvicTakePending()) != SIM_NVIC_NONE)
+    {
+        xInsideInterrupt = pdTRUE;
+        SIM_NvicGetHandler(usIrq)();
+        xInsideInterrupt = pdFALSE;
+    }
+
+    if(xYieldPending)
+    {
+        prvSwitchContext();
+    }
+}
+
+/* End of a kernel call: its cycles, then the interrupts that came due */
+static void prvCharge(void)
+{
+    if(xSchedulerRunning)
+    {
+        SIM_MachineExecute(portKERNEL_CALL_CYCLES);
+    }
+    prvServiceInterrupts();
+}
+
+static void prvTickHandler(void)
+{
+    UBaseType_t uxSavedMask = ulPortSetInterruptMask();
+    if(xTaskIncrementTick() != pdFALSE)
+    {
+        xYieldPending = pdTRUE;
+    }
+    vPortClearInterruptMask(uxSavedMask);
+}
+
+static void *prvThreadEntry(void *pvThread)
+{
+    SimThread_t *pxThread = pvThread;
+
+    prvWait(pxThread);
+    pxThread->pxCode(pxThread->pvParameters);
+
+    /* Tasks must not return */
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    SimThread_t *pxThread = (SimThread_t *)(((size_t)(pxTopOfStack + 1) - sizeof(SimThread_t)) & ~(size_t)7);
+    pthread_attr_t xAttributes;
+
+    pxThread->pxCode = pxCode;
+    pxThread->pvParameters = pvParameters;
+    sem_init(&pxThread->xResume, 0, 0);
+
+    pthread_attr_init(&xAttributes);
+    pthread_attr_setstacksize(&xAttributes, portTHREAD_STACK_SIZE);
+    if(pthread_create(&pxThread->xThread, &xAttributes, prvThreadEntry, pxThread) != 0)
+    {
+        fprintf(stderr, "port: cannot create the task thread\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_attr_destroy(&xAttributes);
+
+    return (StackType_t *)pxThread - 1;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    SIM_NvicSetHandler(SIM_NVIC_SYSTICK, prvTickHandler);
+    SIM_MachineSetInterruptPoint(prvServiceInterrupts);
+    SIM_MachineStartSysTick(configCPU_CLOCK_HZ / configTICK_RATE_HZ);
+
+    uxCriticalNesting = 0;
+    uxInterruptMask = 0;
+    xSchedulerRunning = pdTRUE;
+    sem_post(&prvGetThread(xTaskGetCurrentTaskHandle())->xResume);
+
+    /* The main thread is not a task, it only waits for the end of the run */
+    for(;;)
+    {
+        pause();
+    }
+    return pdFALSE;
+}
+
+void vPortEndScheduler(void)
+{
+    exit(EXIT_SUCCESS);
+}
+
+void vPortYield(void)
+{
+    if(!xSchedulerRunning || xInsideInterrupt || (uxInterruptMask != 0) || (uxCriticalNesting != 0))
+    {
+        xYieldPending = pdTRUE;
+        return;
+    }
+    prvSwitchContext();
+}
+
+void vPortYieldFromISR(void)
+{
+    xYieldPending = pdTRUE;
+}
+
+void vPortEnterCritical(void)
+{
+    uxInterruptMask = 1;
+    uxCriticalNesting++;
+}
+
+void vPortExitCritical(void)
+{
+    uxCriticalNesting--;
+    if(uxCriticalNesting == 0)
+    {
+        uxInterruptMask = 0;
+        prvCharge();
+    }
+}
+
+UBaseType_t ulPortSetInterruptMask(void)
+{
+    UBaseType_t uxSavedMask = uxInterruptMask;
+    uxInterruptMask = 1;
+    return uxSavedMask;
+}
+
+void vPortClearInterruptMask(UBaseType_t uxMask)
+{
+    uxInterruptMask = uxMask;
+    if(uxMask == 0)
+    {
+        prvCharge();
+    }
+}
+
+void vPortCleanUpTCB(void *pvTCB)
+{
+    SimThread_t *pxThread = prvGetThread(pvTCB);
+
+    /* Never the running thread: a task deleting itself is freed by the idle task */
+    pthread_cancel(pxThread->xThread);
+    pthread_join(pxThread->xThread, NULL);
+    sem_destroy(&pxThread->xResume);
+}
+
+void vPortAssert(const char *pcFile, unsigned long ulLine)
+{
+    fprintf(stderr, "port: assertion failed at %s:%lu\n", pcFile, ulLine);
+    abort();
+}
+
+/* Nothing else is ready: sleep until the next event, like the WFI of the target */
+void vApplicationIdleHook(void)
+{
+    SIM_MachineIdle();
+}
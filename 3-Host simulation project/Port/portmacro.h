@@ -0,0 +1,80 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - FreeRTOS Port
+ *
+ * File Name: portmacro.h
+ *
+ * Description: Port definitions of the host build of the application. Every
+ *              task runs on its own POSIX thread but only the thread holding
+ *              the simulated CPU runs, so the kernel sees a single core.
+ *              Interrupts are the handlers registered with the simulated
+ *              NVIC, taken between register accesses while unmasked.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Type definitions, the same widths as the Cortex-M4 port */
+#define portCHAR                    char
+#define portFLOAT                   float
+#define portDOUBLE                  double
+#define portLONG                    long
+#define portSHORT                   short
+#define portSTACK_TYPE              uint32_t
+#define portBASE_TYPE               long
+#define portPOINTER_SIZE_TYPE       size_t
+
+typedef portSTACK_TYPE              StackType_t;
+typedef long                        BaseType_t;
+typedef unsigned long               UBaseType_t;
+typedef uint32_t                    TickType_t;
+
+#define portMAX_DELAY               (TickType_t)0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC     1
+
+/* Architecture specifics */
+#define portSTACK_GROWTH            (-1)
+#define portTICK_PERIOD_MS          ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portBYTE_ALIGNMENT          8
+#define portNOP()
+
+/* No count leading zeros intrinsic is assumed on the host */
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION     0
+
+/* Scheduler utilities */
+extern void vPortYield(void);
+extern void vPortYieldFromISR(void);
+
+#define portYIELD()                                 vPortYield()
+#define portEND_SWITCHING_ISR(xSwitchRequired)      do { if((xSwitchRequired) != pdFALSE) vPortYieldFromISR(); } while(0)
+#define portYIELD_FROM_ISR(x)                       portEND_SWITCHING_ISR(x)
+
+/* Critical section management: one mask level, like BASEPRI with every
+ * interrupt at or below configMAX_SYSCALL_INTERRUPT_PRIORITY */
+extern void vPortEnterCritical(void);
+extern void vPortExitCritical(void);
+extern UBaseType_t ulPortSetInterruptMask(void);
+extern void vPortClearInterruptMask(UBaseType_t uxMask);
+
+#define portDISABLE_INTERRUPTS()                    (void)ulPortSetInterruptMask()
+#define portENABLE_INTERRUPTS()                     vPortClearInterruptMask(0)
+#define portENTER_CRITICAL()                        vPortEnterCritical()
+#define portEXIT_CRITICAL()                         vPortExitCritical()
+#define portSET_INTERRUPT_MASK_FROM_ISR()           ulPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)        vPortClearInterruptMask(x)
+
+/* Stops the thread of a deleted task before its stack is freed */
+extern void vPortCleanUpTCB(void *pvTCB);
+#define portCLEAN_UP_TCB(pxTCB)                     vPortCleanUpTCB(pxTCB)
+
+/* Task function macros */
+#define portTASK_FUNCTION_PROTO(vFunction, pvParameters)    void vFunction(void *pvParameters)
+#define portTASK_FUNCTION(vFunction, pvParameters)          void vFunction(void *pvParameters)
+
+#endif /* PORTMACRO_H */
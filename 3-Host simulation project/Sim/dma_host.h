@@ -0,0 +1,22 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - uDMA
+ *
+ * File Name: dma_host.h
+ *
+ * Description: Host bus addresses for the uDMA driver, forced into the build
+ *              of dma.c with -include, so the uDMA model finds the control
+ *              table behind the 32-bit DMACTLBASE (see sim_dma.h).
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_DMA_HOST_H_
+#define SIM_DMA_HOST_H_
+
+#include "sim_dma.h"
+
+#define DMA_BUS_ADDRESS(pvObject)   SIM_DmaBusAddress(pvObject)
+
+#endif /* SIM_DMA_HOST_H_ */
@@ -0,0 +1,256 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - ADC
+ *
+ * File Name: sim_adc.c
+ *
+ * Description: Source file for the ADC0/ADC1 model.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "sim_adc.h"
+#include "sim_clock.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+
+#define SIM_ADC_ACTSS               0x000
+#define SIM_ADC_RIS                 0x004
+#define SIM_ADC_IM                  0x008
+#define SIM_ADC_ISC                 0x00C
+#define SIM_ADC_PSSI                0x028
+#define SIM_ADC_SSMUX0              0x040
+#define SIM_ADC_SSCTL0              0x044
+#define SIM_ADC_SSFIFO0             0x048
+#define SIM_ADC_SSFSTAT0            0x04C
+
+#define SIM_ADC_SS0                 0x01
+#define SIM_ADC_SSCTL_END           0x2
+#define SIM_ADC_SSCTL_IE            0x4
+#define SIM_ADC_SSFSTAT_EMPTY       0x100
+#define SIM_ADC_SSFSTAT_FULL        0x1000
+
+#define SIM_ADC_FIFO_DEPTH          8
+#define SIM_ADC_SEQUENCE_STEPS      8
+#define SIM_ADC_COUNT               2
+
+typedef struct
+{
+    uint32 Base;
+    uint16 Irq;
+    boolean Converting;
+    uint64 DoneAt;
+    uint16 Fifo[SIM_ADC_FIFO_DEPTH];
+    uint8 Head;
+    uint8 Count;
+    uint16 LastRead;
+    uint32 Conversions;
+} SimAdc;
+
+static SimAdc SimAdcs[SIM_ADC_COUNT] =
+{
+    { SIM_ADC0_BASE, 14 },
+    { SIM_ADC1_BASE, 48 },
+};
+
+static uint16 SimInputs[SIM_ADC_CHANNELS];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static SimAdc *SIM_AdcFind(uint32 ulAddress)
+{
+    uint8 ucAdc;
+    for(ucAdc = 0; ucAdc < SIM_ADC_COUNT; ucAdc++)
+    {
+        if((ulAddress & ~(SIM_ADC_SIZE - 1)) == SimAdcs[ucAdc].Base)
+        {
+            return &SimAdcs[ucAdc];
+        }
+    }
+    return NULL_PTR;
+}
+
+static void SIM_AdcUpdateStatus(SimAdc *pxAdc)
+{
+    SIM_REG_WORD(pxAdc->Base + SIM_ADC_SSFSTAT0) = ((pxAdc->Count == 0) ? SIM_ADC_SSFSTAT_EMPTY : 0) |
+                                                   ((pxAdc->Count >= SIM_ADC_FIFO_DEPTH) ? SIM_ADC_SSFSTAT_FULL : 0) |
+                                                   (((pxAdc->Head + pxAdc->Count) % SIM_ADC_FIFO_DEPTH) << 4) |
+                                                   pxAdc->Head;
+}
+
+/* Number of steps up to and including the one with the END bit */
+static uint8 SIM_AdcSteps(SimAdc *pxAdc)
+{
+    uint32 ulControl = SIM_REG_WORD(pxAdc->Base + SIM_ADC_SSCTL0);
+    uint8 ucStep;
+    for(ucStep = 0; ucStep < SIM_ADC_SEQUENCE_STEPS; ucStep++)
+    {
+        if((ulControl >> (4 * ucStep)) & SIM_ADC_SSCTL_END)
+        {
+            return ucStep + 1;
+        }
+    }
+    return SIM_ADC_SEQUENCE_STEPS;
+}
+
+static void SIM_AdcFinish(SimAdc *pxAdc)
+{
+    uint32 ulMux = SIM_REG_WORD(pxAdc->Base + SIM_ADC_SSMUX0);
+    uint32 ulControl = SIM_REG_WORD(pxAdc->Base + SIM_ADC_SSCTL0);
+    uint8 ucSteps = SIM_AdcSteps(pxAdc);
+    boolean bInterrupt = FALSE;
+    uint8 ucStep;
+
+    for(ucStep = 0; ucStep < ucSteps; ucStep++)
+    {
+        uint8 ucChannel = (ulMux >> (4 * ucStep)) & 0xF;
+        /* A full FIFO drops the new samples */
+        if(pxAdc->Count < SIM_ADC_FIFO_DEPTH)
+        {
+            pxAdc->Fifo[(pxAdc->Head + pxAdc->Count) % SIM_ADC_FIFO_DEPTH] =
+                (ucChannel < SIM_ADC_CHANNELS) ? SimInputs[ucChannel] : 0;
+            pxAdc->Count++;
+        }
+        if((ulControl >> (4 * ucStep)) & SIM_ADC_SSCTL_IE)
+        {
+            bInterrupt = TRUE;
+        }
+    }
+    pxAdc->Converting = FALSE;
+    pxAdc->Conversions++;
+    SIM_AdcUpdateStatus(pxAdc);
+
+    if(bInterrupt)
+    {
+        SIM_REG_WORD(pxAdc->Base + SIM_ADC_RIS) |= SIM_ADC_SS0;
+        if(SIM_REG_WORD(pxAdc->Base + SIM_ADC_IM) & SIM_ADC_SS0)
+        {
+            SIM_NvicPend(pxAdc->Irq);
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_AdcReset(void)
+{
+    uint8 ucAdc;
+    uint8 ucChannel;
+    for(ucAdc = 0; ucAdc < SIM_ADC_COUNT; ucAdc++)
+    {
+        SimAdcs[ucAdc].Converting = FALSE;
+        SimAdcs[ucAdc].DoneAt = SIM_CLOCK_NEVER;
+        SimAdcs[ucAdc].Head = 0;
+        SimAdcs[ucAdc].Count = 0;
+        SimAdcs[ucAdc].LastRead = 0;
+        SimAdcs[ucAdc].Conversions = 0;
+        SIM_AdcUpdateStatus(&SimAdcs[ucAdc]);
+    }
+    for(ucChannel = 0; ucChannel < SIM_ADC_CHANNELS; ucChannel++)
+    {
+        SimInputs[ucChannel] = 0;
+    }
+}
+
+void SIM_AdcSetInput(uint8 ucChannel, uint16 usCode)
+{
+    if(ucChannel < SIM_ADC_CHANNELS)
+    {
+        SimInputs[ucChannel] = (usCode > SIM_ADC_MAX_CODE) ? SIM_ADC_MAX_CODE : usCode;
+    }
+}
+
+uint16 SIM_AdcGetInput(uint8 ucChannel)
+{
+    return (ucChannel < SIM_ADC_CHANNELS) ? SimInputs[ucChannel] : 0;
+}
+
+uint32 SIM_AdcGetConversions(uint8 ucAdc)
+{
+    return (ucAdc < SIM_ADC_COUNT) ? SimAdcs[ucAdc].Conversions : 0;
+}
+
+void SIM_AdcPrepare(uint32 ulAddress)
+{
+    SimAdc *pxAdc = SIM_AdcFind(ulAddress);
+    uint32 ulOffset = ulAddress & (SIM_ADC_SIZE - 1);
+
+    if(pxAdc == NULL_PTR)
+    {
+        return;
+    }
+    if(ulOffset == SIM_ADC_SSFIFO0)
+    {
+        /* An empty FIFO keeps returning the last sample */
+        SIM_REG_WORD(ulAddress) = (pxAdc->Count != 0) ? pxAdc->Fifo[pxAdc->Head] : pxAdc->LastRead;
+    }
+    else if((ulOffset == SIM_ADC_ISC) || (ulOffset == SIM_ADC_PSSI))
+    {
+        /* Write-only here: reading 0 makes every write of a 1 visible */
+        SIM_REG_WORD(ulAddress) = 0;
+    }
+}
+
+void SIM_AdcComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter)
+{
+    SimAdc *pxAdc = SIM_AdcFind(ulAddress);
+    uint32 ulOffset = ulAddress & (SIM_ADC_SIZE - 1);
+
+    if(pxAdc == NULL_PTR)
+    {
+        return;
+    }
+    if(ulOffset == SIM_ADC_SSFIFO0)
+    {
+        if(pxAdc->Count != 0)
+        {
+            pxAdc->LastRead = pxAdc->Fifo[pxAdc->Head];
+            pxAdc->Head = (pxAdc->Head + 1) % SIM_ADC_FIFO_DEPTH;
+            pxAdc->Count--;
+            SIM_AdcUpdateStatus(pxAdc);
+        }
+    }
+    else if(ulOffset == SIM_ADC_ISC)
+    {
+        SIM_REG_WORD(pxAdc->Base + SIM_ADC_RIS) &= ~ulAfter;
+    }
+    else if(ulOffset == SIM_ADC_PSSI)
+    {
+        if((ulAfter & SIM_ADC_SS0) && (SIM_REG_WORD(pxAdc->Base + SIM_ADC_ACTSS) & SIM_ADC_SS0) && !pxAdc->Converting)
+        {
+            pxAdc->Converting = TRUE;
+            pxAdc->DoneAt = SIM_ClockCycles() + SIM_US_TO_CYCLES(SIM_ADC_CONVERSION_US) * SIM_AdcSteps(pxAdc);
+        }
+    }
+}
+
+uint64 SIM_AdcNextEvent(void)
+{
+    uint64 ullNext = SIM_CLOCK_NEVER;
+    uint8 ucAdc;
+    for(ucAdc = 0; ucAdc < SIM_ADC_COUNT; ucAdc++)
+    {
+        if(SimAdcs[ucAdc].Converting && (SimAdcs[ucAdc].DoneAt < ullNext))
+        {
+            ullNext = SimAdcs[ucAdc].DoneAt;
+        }
+    }
+    return ullNext;
+}
+
+void SIM_AdcProcess(uint64 ullNow)
+{
+    uint8 ucAdc;
+    for(ucAdc = 0; ucAdc < SIM_ADC_COUNT; ucAdc++)
+    {
+        if(SimAdcs[ucAdc].Converting && (SimAdcs[ucAdc].DoneAt <= ullNow))
+        {
+            SIM_AdcFinish(&SimAdcs[ucAdc]);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - ADC
+ *
+ * File Name: sim_adc.h
+ *
+ * Description: Header file for the ADC0/ADC1 model. A write of SS0 to ADCPSSI
+ *              starts sample sequencer 0; after the conversion time every
+ *              step up to the END bit of ADCSSCTL0 samples the input of the
+ *              AIN channel chosen by ADCSSMUX0 into the FIFO, and a step with
+ *              the IE bit raises the interrupt. Inputs are raw 12-bit codes
+ *              set per channel, shared by both converters like on the chip.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_ADC_H_
+#define SIM_ADC_H_
+
+#include "std_types.h"
+
+#define SIM_ADC0_BASE               0x40038000UL
+#define SIM_ADC1_BASE               0x40039000UL
+#define SIM_ADC_SIZE                0x1000UL
+#define SIM_ADC_CHANNELS            12
+#define SIM_ADC_MAX_CODE            0x0FFF
+
+/* 1 Msps converter, one step of the sequence */
+#define SIM_ADC_CONVERSION_US       1
+
+void SIM_AdcReset(void);
+
+void SIM_AdcSetInput(uint8 ucChannel, uint16 usCode);
+
+uint16 SIM_AdcGetInput(uint8 ucChannel);
+
+/* Sequences completed by one converter since the reset */
+uint32 SIM_AdcGetConversions(uint8 ucAdc);
+
+/* Register access hooks called by the machine */
+void SIM_AdcPrepare(uint32 ulAddress);
+void SIM_AdcComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter);
+
+uint64 SIM_AdcNextEvent(void);
+void SIM_AdcProcess(uint64 ullNow);
+
+#endif /* SIM_ADC_H_ */
@@ -0,0 +1,76 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Clock
+ *
+ * File Name: sim_clock.c
+ *
+ * Description: Source file for the simulated time base.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <time.h>
+#include "sim_clock.h"
+#include "tm4c123gh6pm_registers.h"
+
+#define SIM_DWT_CYCCNTENA_MASK      0x00000001
+#define SIM_GPTM_TAEN_MASK          0x00000001
+#define SIM_GPTM_TAMR_MODE_MASK     0x00000003
+#define SIM_GPTM_TAMR_ONE_SHOT      0x00000001
+
+static uint64 SimCycles = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void SIM_ClockUpdateTimers(uint64 ullDelta)
+{
+    if(DWT_CTRL_REG & SIM_DWT_CYCCNTENA_MASK)
+    {
+        DWT_CYCCNT_REG = (uint32)(DWT_CYCCNT_REG + ullDelta);
+    }
+
+    /* WTimer0A counts down from 0xFFFFFFFF once per (prescaler + 1) cycles.
+     * In one-shot mode it stops at zero, exactly like the hardware does. */
+    if(WTIMER0_CTL_REG & SIM_GPTM_TAEN_MASK)
+    {
+        uint64 ullTicks = SimCycles / ((WTIMER0_TAPR_REG & 0xFFFF) + 1);
+        if(((WTIMER0_TAMR_REG & SIM_GPTM_TAMR_MODE_MASK) == SIM_GPTM_TAMR_ONE_SHOT) && (ullTicks >= 0xFFFFFFFFULL))
+        {
+            WTIMER0_TAR_REG = 0;
+        }
+        else
+        {
+            WTIMER0_TAR_REG = (uint32)(0xFFFFFFFFULL - (ullTicks & 0xFFFFFFFFULL));
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_ClockReset(void)
+{
+    SimCycles = 0;
+}
+
+void SIM_ClockAdvance(uint64 ullCycles)
+{
+    SimCycles += ullCycles;
+    SIM_ClockUpdateTimers(ullCycles);
+}
+
+uint64 SIM_ClockCycles(void)
+{
+    return SimCycles;
+}
+
+uint32 SIM_HostNanoseconds(void)
+{
+    struct timespec xNow;
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return (uint32)((uint64)xNow.tv_sec * 1000000000ULL + (uint64)xNow.tv_nsec);
+}
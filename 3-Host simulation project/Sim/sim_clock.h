@@ -0,0 +1,39 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Clock
+ *
+ * File Name: sim_clock.h
+ *
+ * Description: Header file for the simulated time base. Time only moves when
+ *              SIM_ClockAdvance() is called, and the DWT cycle counter and
+ *              WTimer0 registers are updated from it.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_CLOCK_H_
+#define SIM_CLOCK_H_
+
+#include "std_types.h"
+
+/* Same core clock as configCPU_CLOCK_HZ on the target */
+#define SIM_CPU_CLOCK_HZ            16000000UL
+
+#define SIM_US_TO_CYCLES(us)        ((uint64)(us) * (SIM_CPU_CLOCK_HZ / 1000000UL))
+#define SIM_MS_TO_CYCLES(ms)        ((uint64)(ms) * (SIM_CPU_CLOCK_HZ / 1000UL))
+
+/* Time of an event that is not scheduled */
+#define SIM_CLOCK_NEVER             0xFFFFFFFFFFFFFFFFULL
+
+void SIM_ClockReset(void);
+
+void SIM_ClockAdvance(uint64 ullCycles);
+
+uint64 SIM_ClockCycles(void);
+
+/* Wall clock of the host in nanoseconds (wraps every ~4.3 s), for timing the
+ * host build itself rather than the simulated target */
+uint32 SIM_HostNanoseconds(void);
+
+#endif /* SIM_CLOCK_H_ */
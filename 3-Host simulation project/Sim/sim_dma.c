@@ -0,0 +1,154 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - uDMA
+ *
+ * File Name: sim_dma.c
+ *
+ * Description: Source file for the uDMA model.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "sim_dma.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+#include "sim_uart.h"
+
+#define SIM_DMA_CFG                 (SIM_DMA_BASE + 0x004)
+#define SIM_DMA_CTLBASE             (SIM_DMA_BASE + 0x008)
+#define SIM_DMA_ENASET              (SIM_DMA_BASE + 0x028)
+#define SIM_DMA_ENACLR              (SIM_DMA_BASE + 0x02C)
+#define SIM_DMA_CHIS                (SIM_DMA_BASE + 0x504)
+#define SIM_DMA_CHMAP1              (SIM_DMA_BASE + 0x514)
+
+#define SIM_DMA_CFG_MASTEN          0x1
+#define SIM_DMA_XFERSIZE_POS        4
+#define SIM_DMA_XFERSIZE_MASK       (0x3FFUL << SIM_DMA_XFERSIZE_POS)
+#define SIM_DMA_XFERMODE_MASK       0x7UL
+#define SIM_DMA_XFERMODE_BASIC      0x1UL
+
+/* UART0 transmit: channel 9, encoding 0 in bits 7:4 of DMACHMAP1 */
+#define SIM_DMA_UART0_TX            9
+#define SIM_DMA_UART0_TX_MAP_POS    4
+
+static const volatile void *SimBusObject = NULL_PTR;
+static SimDmaControl *SimTable = NULL_PTR;
+static uint32 SimEnabled = 0;
+static uint32 SimTransfers = 0;
+static uint32 SimBytes = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void SIM_DmaRun(void)
+{
+    SimDmaControl *pxControl;
+    uint32 ulLeft;
+
+    if(!(SimEnabled & (1UL << SIM_DMA_UART0_TX)) || (SimTable == NULL_PTR) ||
+       !(SIM_REG_WORD(SIM_DMA_CFG) & SIM_DMA_CFG_MASTEN) ||
+       (((SIM_REG_WORD(SIM_DMA_CHMAP1) >> SIM_DMA_UART0_TX_MAP_POS) & 0xF) != 0))
+    {
+        return;
+    }
+    pxControl = &SimTable[SIM_DMA_UART0_TX];
+    if(((pxControl->Control & SIM_DMA_XFERMODE_MASK) != SIM_DMA_XFERMODE_BASIC) ||
+       ((uintptr_t)pxControl->DstEnd != SIM_UART0_BASE))
+    {
+        return;
+    }
+
+    while((SimEnabled & (1UL << SIM_DMA_UART0_TX)) && SIM_UartTxDmaRequest())
+    {
+        ulLeft = ((pxControl->Control & SIM_DMA_XFERSIZE_MASK) >> SIM_DMA_XFERSIZE_POS) + 1;
+        SIM_UartDmaWrite(*(pxControl->SrcEnd - (ulLeft - 1)));
+        SimBytes++;
+        if(ulLeft == 1)
+        {
+            /* Stop mode and the channel disabled, as the engine leaves them */
+            pxControl->Control &= ~(SIM_DMA_XFERSIZE_MASK | SIM_DMA_XFERMODE_MASK);
+            SimEnabled &= ~(1UL << SIM_DMA_UART0_TX);
+            SimTransfers++;
+            SIM_NvicPend(SIM_UART0_IRQ);
+        }
+        else
+        {
+            pxControl->Control = (pxControl->Control & ~SIM_DMA_XFERSIZE_MASK) |
+                                 ((ulLeft - 2) << SIM_DMA_XFERSIZE_POS);
+        }
+    }
+    SIM_REG_WORD(SIM_DMA_ENASET) = SimEnabled;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_DmaReset(void)
+{
+    SimBusObject = NULL_PTR;
+    SimTable = NULL_PTR;
+    SimEnabled = 0;
+    SimTransfers = 0;
+    SimBytes = 0;
+}
+
+uint32 SIM_DmaBusAddress(const volatile void *pvObject)
+{
+    SimBusObject = pvObject;
+    return (uint32)(uintptr_t)pvObject;
+}
+
+uint32 SIM_DmaGetTransfers(void)
+{
+    return SimTransfers;
+}
+
+uint32 SIM_DmaGetBytes(void)
+{
+    return SimBytes;
+}
+
+void SIM_DmaPrepare(uint32 ulAddress)
+{
+    if(ulAddress == SIM_DMA_ENASET)
+    {
+        SIM_REG_WORD(SIM_DMA_ENASET) = SimEnabled;
+    }
+    else if((ulAddress == SIM_DMA_ENACLR) || (ulAddress == SIM_DMA_CHIS))
+    {
+        /* Write-only here: reading 0 makes every write of a 1 visible */
+        SIM_REG_WORD(ulAddress) = 0;
+    }
+}
+
+void SIM_DmaComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter)
+{
+    if(ulAfter == ulBefore)
+    {
+        return;
+    }
+    if(ulAddress == SIM_DMA_CTLBASE)
+    {
+        SimTable = ((SimBusObject != NULL_PTR) && ((uint32)(uintptr_t)SimBusObject == ulAfter)) ?
+                   (SimDmaControl *)SimBusObject : NULL_PTR;
+    }
+    else if(ulAddress == SIM_DMA_ENASET)
+    {
+        SimEnabled |= ulAfter;
+        SIM_DmaRun();
+    }
+    else if(ulAddress == SIM_DMA_ENACLR)
+    {
+        SimEnabled &= ~ulAfter;
+        SIM_REG_WORD(SIM_DMA_ENASET) = SimEnabled;
+    }
+}
+
+void SIM_DmaProcess(uint64 ullNow)
+{
+    (void)ullNow;
+    SIM_DmaRun();
+}
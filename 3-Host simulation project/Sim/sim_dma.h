@@ -0,0 +1,57 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - uDMA
+ *
+ * File Name: sim_dma.h
+ *
+ * Description: Header file for the uDMA model. Only what the UART0 transmit
+ *              path uses is modelled: channel 9 with encoding 0, the primary
+ *              control structure in basic mode, and UARTDR as destination.
+ *              While the channel is enabled it moves one byte each time the
+ *              UART0 transmit FIFO has room, in no simulated time, and at the
+ *              end it clears the enable bit and pends the UART0 interrupt.
+ *              DMACHIS reads 0 here, the driver only ever clears it.
+ *
+ *              The control table is found through SIM_DmaBusAddress(),
+ *              which stands for DMA_BUS_ADDRESS() in the host build of dma.c
+ *              (dma_host.h): the 32-bit DMACTLBASE cannot hold a host pointer.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_DMA_H_
+#define SIM_DMA_H_
+
+#include "std_types.h"
+
+#define SIM_DMA_BASE                0x400FF000UL
+#define SIM_DMA_SIZE                0x1000UL
+
+/* Channel control structure as the host build of dma.c lays it out */
+typedef struct
+{
+    const volatile uint8 *SrcEnd;
+    volatile uint8 *DstEnd;
+    volatile uint32 Control;
+    uint32 Unused;
+} SimDmaControl;
+
+void SIM_DmaReset(void);
+
+/* Low 32 bits of the object, which is remembered as the control table when
+ * that value is then written to DMACTLBASE */
+uint32 SIM_DmaBusAddress(const volatile void *pvObject);
+
+/* Transfers completed and bytes moved since the reset */
+uint32 SIM_DmaGetTransfers(void);
+uint32 SIM_DmaGetBytes(void);
+
+/* Register access hooks called by the machine */
+void SIM_DmaPrepare(uint32 ulAddress);
+void SIM_DmaComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter);
+
+/* Moves the bytes the UART0 transmit FIFO has room for, called after the UART model */
+void SIM_DmaProcess(uint64 ullNow);
+
+#endif /* SIM_DMA_H_ */
@@ -0,0 +1,116 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - EEPROM
+ *
+ * File Name: sim_eeprom.c
+ *
+ * Description: Source file for the EEPROM model.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "sim_eeprom.h"
+#include "sim_clock.h"
+#include "sim_registers.h"
+
+#define SIM_EEPROM_EESIZE           (SIM_EEPROM_BASE + 0x000)
+#define SIM_EEPROM_EEBLOCK          (SIM_EEPROM_BASE + 0x004)
+#define SIM_EEPROM_EEOFFSET         (SIM_EEPROM_BASE + 0x008)
+#define SIM_EEPROM_EERDWR           (SIM_EEPROM_BASE + 0x010)
+#define SIM_EEPROM_EERDWRINC        (SIM_EEPROM_BASE + 0x014)
+#define SIM_EEPROM_EEDONE           (SIM_EEPROM_BASE + 0x018)
+
+#define SIM_EEPROM_EEDONE_WORKING   0x01
+
+static uint32 SimEeprom[SIM_EEPROM_BLOCKS][SIM_EEPROM_WORDS];
+static uint64 SimWriteCycles = SIM_US_TO_CYCLES(SIM_EEPROM_WRITE_US);
+static uint64 SimDoneAt = SIM_CLOCK_NEVER;
+static uint32 SimWrites = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint32 *SIM_EepromWord(void)
+{
+    return &SimEeprom[SIM_REG_WORD(SIM_EEPROM_EEBLOCK) % SIM_EEPROM_BLOCKS]
+                     [SIM_REG_WORD(SIM_EEPROM_EEOFFSET) % SIM_EEPROM_WORDS];
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_EepromReset(void)
+{
+    uint8 ucBlock;
+    uint8 ucOffset;
+    for(ucBlock = 0; ucBlock < SIM_EEPROM_BLOCKS; ucBlock++)
+    {
+        for(ucOffset = 0; ucOffset < SIM_EEPROM_WORDS; ucOffset++)
+        {
+            SimEeprom[ucBlock][ucOffset] = 0xFFFFFFFFUL;
+        }
+    }
+    SimDoneAt = SIM_CLOCK_NEVER;
+    SimWrites = 0;
+    SIM_REG_WORD(SIM_EEPROM_EESIZE) = (SIM_EEPROM_BLOCKS << 16) | (SIM_EEPROM_BLOCKS * SIM_EEPROM_WORDS);
+    SIM_REG_WORD(SIM_EEPROM_EEDONE) = 0;
+}
+
+void SIM_EepromSetWriteTime(uint32 ulMicroseconds)
+{
+    SimWriteCycles = SIM_US_TO_CYCLES(ulMicroseconds);
+}
+
+uint32 SIM_EepromRead(uint8 ucBlock, uint8 ucOffset)
+{
+    return SimEeprom[ucBlock % SIM_EEPROM_BLOCKS][ucOffset % SIM_EEPROM_WORDS];
+}
+
+uint32 SIM_EepromGetWrites(void)
+{
+    return SimWrites;
+}
+
+void SIM_EepromPrepare(uint32 ulAddress)
+{
+    if((ulAddress == SIM_EEPROM_EERDWR) || (ulAddress == SIM_EEPROM_EERDWRINC))
+    {
+        SIM_REG_WORD(ulAddress) = *SIM_EepromWord();
+    }
+}
+
+void SIM_EepromComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter)
+{
+    if((ulAddress != SIM_EEPROM_EERDWR) && (ulAddress != SIM_EEPROM_EERDWRINC))
+    {
+        return;
+    }
+    if(ulAfter != ulBefore)
+    {
+        *SIM_EepromWord() = ulAfter;
+        SimWrites++;
+        SimDoneAt = SIM_ClockCycles() + SimWriteCycles;
+        SIM_REG_WORD(SIM_EEPROM_EEDONE) |= SIM_EEPROM_EEDONE_WORKING;
+    }
+    if(ulAddress == SIM_EEPROM_EERDWRINC)
+    {
+        SIM_REG_WORD(SIM_EEPROM_EEOFFSET) = (SIM_REG_WORD(SIM_EEPROM_EEOFFSET) + 1) % SIM_EEPROM_WORDS;
+    }
+}
+
+uint64 SIM_EepromNextEvent(void)
+{
+    return SimDoneAt;
+}
+
+void SIM_EepromProcess(uint64 ullNow)
+{
+    if(SimDoneAt <= ullNow)
+    {
+        SimDoneAt = SIM_CLOCK_NEVER;
+        SIM_REG_WORD(SIM_EEPROM_EEDONE) &= ~SIM_EEPROM_EEDONE_WORKING;
+    }
+}
@@ -0,0 +1,45 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - EEPROM
+ *
+ * File Name: sim_eeprom.h
+ *
+ * Description: Header file for the EEPROM model: 32 blocks of 16 words read
+ *              and written through EEBLOCK/EEOFFSET and EERDWR/EERDWRINC.
+ *              A write keeps EEDONE.WORKING set for the programming time.
+ *              Words only count as written when their value changes, which is
+ *              also all the driver can tell apart on the register file.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_EEPROM_H_
+#define SIM_EEPROM_H_
+
+#include "std_types.h"
+
+#define SIM_EEPROM_BASE             0x400AF000UL
+#define SIM_EEPROM_SIZE             0x1000UL
+#define SIM_EEPROM_BLOCKS           32
+#define SIM_EEPROM_WORDS            16
+
+/* Programming time of one word */
+#define SIM_EEPROM_WRITE_US         100
+
+void SIM_EepromReset(void);
+
+void SIM_EepromSetWriteTime(uint32 ulMicroseconds);
+
+uint32 SIM_EepromRead(uint8 ucBlock, uint8 ucOffset);
+
+uint32 SIM_EepromGetWrites(void);
+
+/* Register access hooks called by the machine */
+void SIM_EepromPrepare(uint32 ulAddress);
+void SIM_EepromComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter);
+
+uint64 SIM_EepromNextEvent(void);
+void SIM_EepromProcess(uint64 ullNow);
+
+#endif /* SIM_EEPROM_H_ */
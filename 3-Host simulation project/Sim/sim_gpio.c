@@ -0,0 +1,185 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - GPIO
+ *
+ * File Name: sim_gpio.c
+ *
+ * Description: Source file for the GPIO ports A to F model.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "sim_gpio.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+
+#define SIM_GPIO_SIZE               0x1000UL
+#define SIM_GPIO_DATA_END           0x400
+#define SIM_GPIO_DIR                0x400
+#define SIM_GPIO_IS                 0x404
+#define SIM_GPIO_IBE                0x408
+#define SIM_GPIO_IEV                0x40C
+#define SIM_GPIO_IM                 0x410
+#define SIM_GPIO_RIS                0x414
+#define SIM_GPIO_MIS                0x418
+#define SIM_GPIO_ICR                0x41C
+
+#define SIM_GPIO_REG(port, offset)  SIM_REG_WORD(SimGpioBases[port] + (offset))
+
+static const uint32 SimGpioBases[SIM_GPIO_PORTS] =
+{
+    0x40004000UL, 0x40005000UL, 0x40006000UL, 0x40007000UL, 0x40024000UL, 0x40025000UL
+};
+
+static const uint16 SimGpioIrqs[SIM_GPIO_PORTS] = { 0, 1, 2, 3, 4, 30 };
+
+static uint8 SimGpioLatch[SIM_GPIO_PORTS];
+static uint8 SimGpioInputs[SIM_GPIO_PORTS];
+static SimGpioOutput SimOutputHook = NULL_PTR;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static sint8 SIM_GpioFind(uint32 ulAddress)
+{
+    uint8 ucPort;
+    for(ucPort = 0; ucPort < SIM_GPIO_PORTS; ucPort++)
+    {
+        if((ulAddress & ~(SIM_GPIO_SIZE - 1)) == SimGpioBases[ucPort])
+        {
+            return (sint8)ucPort;
+        }
+    }
+    return -1;
+}
+
+static uint8 SIM_GpioPins(uint8 ucPort)
+{
+    uint8 ucDirection = (uint8)SIM_GPIO_REG(ucPort, SIM_GPIO_DIR);
+    return (SimGpioLatch[ucPort] & ucDirection) | (SimGpioInputs[ucPort] & (uint8)~ucDirection);
+}
+
+static void SIM_GpioUpdateInterrupt(uint8 ucPort)
+{
+    uint32 ulMasked = SIM_GPIO_REG(ucPort, SIM_GPIO_RIS) & SIM_GPIO_REG(ucPort, SIM_GPIO_IM) & 0xFF;
+    SIM_GPIO_REG(ucPort, SIM_GPIO_MIS) = ulMasked;
+    if(ulMasked != 0)
+    {
+        SIM_NvicPend(SimGpioIrqs[ucPort]);
+    }
+}
+
+/* Latches the interrupt status of the input pins that changed from ucBefore */
+static void SIM_GpioDetect(uint8 ucPort, uint8 ucBefore, uint8 ucAfter)
+{
+    uint8 ucSense = (uint8)SIM_GPIO_REG(ucPort, SIM_GPIO_IS);
+    uint8 ucBoth = (uint8)SIM_GPIO_REG(ucPort, SIM_GPIO_IBE);
+    uint8 ucEvent = (uint8)SIM_GPIO_REG(ucPort, SIM_GPIO_IEV);
+    uint8 ucRising = (uint8)(~ucBefore & ucAfter);
+    uint8 ucFalling = (uint8)(ucBefore & ~ucAfter);
+    uint8 ucEdges = (uint8)(~ucSense & ((ucBoth & (ucRising | ucFalling)) |
+                                        (~ucBoth & ((ucEvent & ucRising) | (~ucEvent & ucFalling)))));
+    /* Level sensing stays set while the level is there */
+    uint8 ucLevels = (uint8)(ucSense & ((ucEvent & ucAfter) | (~ucEvent & ~ucAfter)));
+
+    SIM_GPIO_REG(ucPort, SIM_GPIO_RIS) |= (uint32)(ucEdges | ucLevels);
+    SIM_GpioUpdateInterrupt(ucPort);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_GpioReset(void)
+{
+    uint8 ucPort;
+    for(ucPort = 0; ucPort < SIM_GPIO_PORTS; ucPort++)
+    {
+        SimGpioLatch[ucPort] = 0;
+        SimGpioInputs[ucPort] = 0xFF;
+    }
+}
+
+void SIM_GpioSetOutputHook(SimGpioOutput pfOutput)
+{
+    SimOutputHook = pfOutput;
+}
+
+void SIM_GpioSetInput(uint8 ucPort, uint8 ucPin, uint8 ucLevel)
+{
+    uint8 ucBefore;
+    uint8 ucInputs;
+
+    if((ucPort >= SIM_GPIO_PORTS) || (ucPin > 7))
+    {
+        return;
+    }
+    ucBefore = SIM_GpioPins(ucPort);
+    ucInputs = ucLevel ? (uint8)(SimGpioInputs[ucPort] | (1U << ucPin)) : (uint8)(SimGpioInputs[ucPort] & ~(1U << ucPin));
+    SimGpioInputs[ucPort] = ucInputs;
+    SIM_GpioDetect(ucPort, ucBefore, SIM_GpioPins(ucPort));
+}
+
+uint8 SIM_GpioGetOutputs(uint8 ucPort)
+{
+    return (ucPort < SIM_GPIO_PORTS) ? (SimGpioLatch[ucPort] & (uint8)SIM_GPIO_REG(ucPort, SIM_GPIO_DIR)) : 0;
+}
+
+boolean SIM_GpioOwns(uint32 ulAddress)
+{
+    return (SIM_GpioFind(ulAddress) >= 0) ? TRUE : FALSE;
+}
+
+void SIM_GpioPrepare(uint32 ulAddress)
+{
+    sint8 cPort = SIM_GpioFind(ulAddress);
+    uint32 ulOffset = ulAddress & (SIM_GPIO_SIZE - 1);
+
+    if(cPort < 0)
+    {
+        return;
+    }
+    if(ulOffset < SIM_GPIO_DATA_END)
+    {
+        /* Address bits [9:2] mask the data bits of the access */
+        SIM_REG_WORD(ulAddress) = SIM_GpioPins((uint8)cPort) & (ulOffset >> 2);
+    }
+    else if(ulOffset == SIM_GPIO_ICR)
+    {
+        SIM_REG_WORD(ulAddress) = 0;
+    }
+}
+
+void SIM_GpioComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter)
+{
+    sint8 cPort = SIM_GpioFind(ulAddress);
+    uint32 ulOffset = ulAddress & (SIM_GPIO_SIZE - 1);
+    uint8 ucPort = (uint8)cPort;
+
+    if((cPort < 0) || (ulBefore == ulAfter))
+    {
+        return;
+    }
+    if(ulOffset < SIM_GPIO_DATA_END)
+    {
+        uint8 ucMask = (uint8)(ulOffset >> 2);
+        uint8 ucOutputs = SIM_GpioGetOutputs(ucPort);
+        SimGpioLatch[ucPort] = (uint8)((SimGpioLatch[ucPort] & ~ucMask) | (ulAfter & ucMask));
+        if((SimOutputHook != NULL_PTR) && (SIM_GpioGetOutputs(ucPort) != ucOutputs))
+        {
+            SimOutputHook(ucPort, ucOutputs, SIM_GpioGetOutputs(ucPort));
+        }
+    }
+    else if(ulOffset == SIM_GPIO_ICR)
+    {
+        SIM_GPIO_REG(ucPort, SIM_GPIO_RIS) &= ~ulAfter;
+        SIM_GPIO_REG(ucPort, SIM_GPIO_ICR) = 0;
+        SIM_GpioUpdateInterrupt(ucPort);
+    }
+    else if(ulOffset == SIM_GPIO_IM)
+    {
+        SIM_GpioUpdateInterrupt(ucPort);
+    }
+}
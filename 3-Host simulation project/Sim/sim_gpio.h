@@ -0,0 +1,47 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - GPIO
+ *
+ * File Name: sim_gpio.h
+ *
+ * Description: Header file for the GPIO ports A to F model. Reads of the data
+ *              register return the output latch on output pins and the input
+ *              level on input pins; an input change is checked against
+ *              GPIOIS/GPIOIBE/GPIOIEV and GPIOIM and pends the port interrupt.
+ *              Inputs idle high, as the buttons have their pull-ups enabled.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_GPIO_H_
+#define SIM_GPIO_H_
+
+#include "std_types.h"
+
+#define SIM_GPIO_PORTA              0
+#define SIM_GPIO_PORTB              1
+#define SIM_GPIO_PORTC              2
+#define SIM_GPIO_PORTD              3
+#define SIM_GPIO_PORTE              4
+#define SIM_GPIO_PORTF              5
+#define SIM_GPIO_PORTS              6
+
+/* Called when the driven level of any output pin of a port changes */
+typedef void (*SimGpioOutput)(uint8 ucPort, uint8 ucBefore, uint8 ucAfter);
+
+void SIM_GpioReset(void);
+
+void SIM_GpioSetOutputHook(SimGpioOutput pfOutput);
+
+void SIM_GpioSetInput(uint8 ucPort, uint8 ucPin, uint8 ucLevel);
+
+/* Levels of the output pins of a port (GPIODATA masked by GPIODIR) */
+uint8 SIM_GpioGetOutputs(uint8 ucPort);
+
+/* Register access hooks called by the machine */
+boolean SIM_GpioOwns(uint32 ulAddress);
+void SIM_GpioPrepare(uint32 ulAddress);
+void SIM_GpioComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter);
+
+#endif /* SIM_GPIO_H_ */
@@ -0,0 +1,397 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Machine
+ *
+ * File Name: sim_machine.c
+ *
+ * Description: Source file for the simulated board.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim_machine.h"
+#include "sim_clock.h"
+#include "sim_registers.h"
+#include "sim_nvic.h"
+#include "sim_uart.h"
+#include "sim_dma.h"
+#include "sim_adc.h"
+#include "sim_gpio.h"
+#include "sim_eeprom.h"
+#include "sim_script.h"
+#include "sim_thermal.h"
+#include "sim_mmio.h"
+#include "sim_replay.h"
+
+/* SYSCTL peripheral ready registers PRWD to PRWTIMER */
+#define SIM_SYSCTL_PR_FIRST         0x400FEA00UL
+#define SIM_SYSCTL_PR_LAST          0x400FEA5CUL
+
+/* SysTick and the interrupt control register of the core */
+#define SIM_SYSTICK_CTRL            0xE000E010UL
+#define SIM_SYSTICK_RELOAD          0xE000E014UL
+#define SIM_SYSTICK_CURRENT         0xE000E018UL
+#define SIM_SYSTICK_ENABLE          0x07
+#define SIM_NVIC_INTCTRL            0xE000ED04UL
+#define SIM_NVIC_PENDSTSET          0x04000000UL
+
+#define SIM_PERIPHERAL_BLOCK(address)   ((address) & ~0xFFFUL)
+
+/* Waited is the time since the previous read of the same register by the
+ * same call site, a busy-wait iteration if this access turns out a read */
+typedef struct
+{
+    boolean Pending;
+    uint32 Address;
+    uint32 Value;
+    const void *Caller;
+    uint64 At;
+    uint64 Waited;
+} SimAccess;
+
+static SimAccess SimLastAccess;
+static uint32 SimPollAddress = 0;
+static uint32 SimPollReads = 0;
+static boolean SimLastWasRead = FALSE;
+
+static uint64 SimTickPeriod = 0;
+static uint64 SimNextTick = SIM_CLOCK_NEVER;
+static uint64 SimEnd = SIM_CLOCK_NEVER;
+static SimEndHandler SimEndFun = NULL_PTR;
+static SimInterruptPoint SimPoint = NULL_PTR;
+static uint64 SimMonitorPeriod = 0;
+static uint64 SimMonitorAt = SIM_CLOCK_NEVER;
+static SimMonitor SimMonitorFun = NULL_PTR;
+static uint64 SimIdleCycles = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void SIM_MachinePrepare(uint32 ulAddress)
+{
+    switch(SIM_PERIPHERAL_BLOCK(ulAddress))
+    {
+    case SIM_SYSTICK_CTRL & ~0xFFFUL:
+        if((ulAddress == SIM_SYSTICK_CURRENT) && (SimNextTick != SIM_CLOCK_NEVER))
+        {
+            /* Counts down from the reload value, reaching 0 on the tick */
+            SIM_REG_WORD(SIM_SYSTICK_CURRENT) = (uint32)((SimNextTick - SIM_ClockCycles() - 1) % SimTickPeriod);
+        }
+        else if(ulAddress == SIM_NVIC_INTCTRL)
+        {
+            SIM_REG_WORD(SIM_NVIC_INTCTRL) = SIM_NvicIsPending(SIM_NVIC_SYSTICK) ? SIM_NVIC_PENDSTSET : 0;
+        }
+        else
+        {
+            SIM_NvicPrepare(ulAddress);
+        }
+        break;
+    case SIM_UART0_BASE:
+        SIM_UartPrepare(ulAddress);
+        break;
+    case SIM_DMA_BASE:
+        SIM_DmaPrepare(ulAddress);
+        break;
+    case SIM_ADC0_BASE:
+    case SIM_ADC1_BASE:
+        SIM_AdcPrepare(ulAddress);
+        break;
+    case SIM_EEPROM_BASE:
+        SIM_EepromPrepare(ulAddress);
+        break;
+    default:
+        if(SIM_GpioOwns(ulAddress))
+        {
+            SIM_GpioPrepare(ulAddress);
+        }
+        break;
+    }
+}
+
+/* The value left in the register after the access tells a read from a write */
+static void SIM_MachineComplete(void)
+{
+    uint32 ulAddress = SimLastAccess.Address;
+    uint32 ulBefore = SimLastAccess.Value;
+    uint32 ulAfter;
+
+    if(!SimLastAccess.Pending)
+    {
+        return;
+    }
+    SimLastAccess.Pending = FALSE;
+    ulAfter = SIM_REG_WORD(ulAddress);
+    SimLastWasRead = (ulAfter == ulBefore) ? TRUE : FALSE;
+    if(SIM_MmioIsEnabled())
+    {
+        SIM_MmioAccess(ulAddress, SimLastAccess.Caller, SimLastWasRead);
+        if(SimLastWasRead && (SimLastAccess.Waited != 0))
+        {
+            SIM_MmioPoll(ulAddress, SimLastAccess.Caller, SimLastAccess.Waited);
+        }
+    }
+
+    switch(SIM_PERIPHERAL_BLOCK(ulAddress))
+    {
+    case SIM_SYSTICK_CTRL & ~0xFFFUL:
+        SIM_NvicComplete(ulAddress, ulBefore, ulAfter);
+        break;
+    case SIM_UART0_BASE:
+        SIM_UartComplete(ulAddress, ulBefore, ulAfter);
+        break;
+    case SIM_DMA_BASE:
+        SIM_DmaComplete(ulAddress, ulBefore, ulAfter);
+        break;
+    case SIM_ADC0_BASE:
+    case SIM_ADC1_BASE:
+        SIM_AdcComplete(ulAddress, ulBefore, ulAfter);
+        break;
+    case SIM_EEPROM_BASE:
+        SIM_EepromComplete(ulAddress, ulBefore, ulAfter);
+        break;
+    default:
+        if(SIM_GpioOwns(ulAddress))
+        {
+            SIM_GpioComplete(ulAddress, ulBefore, ulAfter);
+        }
+        break;
+    }
+}
+
+static void SIM_MachineProcess(uint64 ullNow)
+{
+    if(SimNextTick <= ullNow)
+    {
+        /* Ticks missed while the exception was pending are lost, as on the core */
+        while(SimNextTick <= ullNow)
+        {
+            SimNextTick += SimTickPeriod;
+        }
+        SIM_NvicPend(SIM_NVIC_SYSTICK);
+    }
+    if(SimMonitorAt <= ullNow)
+    {
+        SimMonitorAt += SimMonitorPeriod;
+        SimMonitorFun();
+    }
+    SIM_ScriptProcess(ullNow);
+    SIM_UartProcess(ullNow);
+    SIM_DmaProcess(ullNow);
+    SIM_AdcProcess(ullNow);
+    SIM_EepromProcess(ullNow);
+    SIM_ThermalProcess(ullNow);
+    SIM_ReplayProcess(ullNow);
+}
+
+/* Next tick or peripheral event, the end of the run left out */
+static uint64 SIM_MachineNextDeviceEvent(void)
+{
+    uint64 ullNext = (SimMonitorAt < SimNextTick) ? SimMonitorAt : SimNextTick;
+    uint64 ullEvent;
+
+    ullEvent = SIM_ScriptNextEvent();
+    ullNext = (ullEvent < ullNext) ? ullEvent : ullNext;
+    ullEvent = SIM_UartNextEvent();
+    ullNext = (ullEvent < ullNext) ? ullEvent : ullNext;
+    ullEvent = SIM_AdcNextEvent();
+    ullNext = (ullEvent < ullNext) ? ullEvent : ullNext;
+    ullEvent = SIM_EepromNextEvent();
+    ullNext = (ullEvent < ullNext) ? ullEvent : ullNext;
+    ullEvent = SIM_ThermalNextEvent();
+    ullNext = (ullEvent < ullNext) ? ullEvent : ullNext;
+    ullEvent = SIM_ReplayNextEvent();
+    ullNext = (ullEvent < ullNext) ? ullEvent : ullNext;
+    return ullNext;
+}
+
+static void SIM_MachineHook(uint32 ulAddress, volatile uint32 *pulRegister, const void *pvCaller)
+{
+    uint64 ullNow;
+    uint64 ullNext;
+    uint64 ullWaited = 0;
+
+    (void)pulRegister;
+    SIM_MachineComplete();
+    ullNow = SIM_ClockCycles();
+
+    if((ulAddress == SimPollAddress) && SimLastWasRead)
+    {
+        SimPollReads++;
+        if(pvCaller == SimLastAccess.Caller)
+        {
+            ullWaited = ullNow - SimLastAccess.At;
+        }
+    }
+    else
+    {
+        SimPollAddress = ulAddress;
+        SimPollReads = 0;
+    }
+
+    /* A polling loop is skipped to the event it waits for, never to the end of
+     * the run: before SysTick starts, the cycle counter reads of the kernel
+     * object create hooks look like one */
+    ullNext = SIM_MachineNextDeviceEvent();
+    if((SimPollReads >= SIM_MACHINE_POLL_READS) && (ullNext != SIM_CLOCK_NEVER) && (ullNext > ullNow))
+    {
+        SimPollReads = 0;
+        SIM_MachineRunTo(ullNext);
+    }
+    else
+    {
+        SIM_MachineRunTo(ullNow + SIM_MACHINE_ACCESS_CYCLES);
+    }
+
+    /* Handlers and other tasks may have run above: finish their last access
+     * and present the register again */
+    SIM_MachineComplete();
+    SIM_MachinePrepare(ulAddress);
+    SimLastAccess.Address = ulAddress;
+    SimLastAccess.Value = SIM_REG_WORD(ulAddress);
+    SimLastAccess.Caller = pvCaller;
+    SimLastAccess.At = ullNow;
+    SimLastAccess.Waited = ullWaited;
+    SimLastAccess.Pending = TRUE;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_MachineInit(void)
+{
+    uint32 ulAddress;
+
+    SIM_RegistersReset();
+    SIM_ClockReset();
+    SIM_NvicReset();
+    SIM_UartReset();
+    SIM_DmaReset();
+    SIM_AdcReset();
+    SIM_GpioReset();
+    SIM_EepromReset();
+    SIM_ScriptReset();
+    SIM_ThermalReset();
+    SIM_ReplayReset();
+    SIM_MmioReset();
+
+    for(ulAddress = SIM_SYSCTL_PR_FIRST; ulAddress <= SIM_SYSCTL_PR_LAST; ulAddress += 4)
+    {
+        SIM_REG_WORD(ulAddress) = 0xFFFFFFFFUL;
+    }
+
+    SimLastAccess.Pending = FALSE;
+    SimPollAddress = 0;
+    SimPollReads = 0;
+    SimLastWasRead = FALSE;
+    SimTickPeriod = 0;
+    SimNextTick = SIM_CLOCK_NEVER;
+    SimEnd = SIM_CLOCK_NEVER;
+    SimIdleCycles = 0;
+    SimEndFun = NULL_PTR;
+    SimPoint = NULL_PTR;
+    SimMonitorAt = SIM_CLOCK_NEVER;
+    SimMonitorFun = NULL_PTR;
+    SIM_RegistersSetHook(SIM_MachineHook);
+}
+
+void SIM_MachineSetInterruptPoint(SimInterruptPoint pfPoint)
+{
+    SimPoint = pfPoint;
+}
+
+void SIM_MachineStartSysTick(uint32 ulPeriod)
+{
+    SimTickPeriod = ulPeriod;
+    SimNextTick = SIM_ClockCycles() + ulPeriod;
+    SIM_REG_WORD(SIM_SYSTICK_RELOAD) = ulPeriod - 1;
+    SIM_REG_WORD(SIM_SYSTICK_CTRL) = SIM_SYSTICK_ENABLE;
+}
+
+void SIM_MachineSetEnd(uint64 ullCycles, SimEndHandler pfHandler)
+{
+    SimEnd = ullCycles;
+    SimEndFun = pfHandler;
+}
+
+void SIM_MachineSetMonitor(uint64 ullPeriod, SimMonitor pfMonitor)
+{
+    SimMonitorPeriod = ullPeriod;
+    SimMonitorFun = pfMonitor;
+    SimMonitorAt = ((pfMonitor != NULL_PTR) && (ullPeriod != 0)) ? (SIM_ClockCycles() + ullPeriod) : SIM_CLOCK_NEVER;
+}
+
+uint64 SIM_MachineNextEvent(void)
+{
+    uint64 ullNext = SIM_MachineNextDeviceEvent();
+    return (SimEnd < ullNext) ? SimEnd : ullNext;
+}
+
+/* Re-entered from the interrupt point through the register accesses of the
+ * handlers and of the tasks switched to, so no state is kept across calls */
+void SIM_MachineRunTo(uint64 ullCycles)
+{
+    for(;;)
+    {
+        uint64 ullNow = SIM_ClockCycles();
+        uint64 ullNext = SIM_MachineNextEvent();
+        uint64 ullStop = (ullNext < ullCycles) ? ullNext : ullCycles;
+
+        if(ullStop > ullNow)
+        {
+            SIM_ClockAdvance(ullStop - ullNow);
+            ullNow = ullStop;
+        }
+        if(ullNow >= SimEnd)
+        {
+            SimEnd = SIM_CLOCK_NEVER;
+            if(SimEndFun != NULL_PTR)
+            {
+                SimEndFun();
+            }
+        }
+        SIM_MachineProcess(ullNow);
+
+        if(SimPoint != NULL_PTR)
+        {
+            SimPoint();
+        }
+        if(SIM_ClockCycles() >= ullCycles)
+        {
+            break;
+        }
+    }
+}
+
+void SIM_MachineExecute(uint32 ulCycles)
+{
+    /* The models see the last access before time moves on */
+    SIM_MachineComplete();
+    SIM_MachineRunTo(SIM_ClockCycles() + ulCycles);
+}
+
+void SIM_MachineIdle(void)
+{
+    uint64 ullNext = SIM_MachineNextEvent();
+
+    if(ullNext == SIM_CLOCK_NEVER)
+    {
+        fprintf(stderr, "sim: every task is blocked and no event is scheduled\n");
+        exit(EXIT_FAILURE);
+    }
+    if(ullNext <= SIM_ClockCycles())
+    {
+        ullNext = SIM_ClockCycles() + 1;
+    }
+    SimIdleCycles += ullNext - SIM_ClockCycles();
+    SIM_MachineRunTo(ullNext);
+}
+
+uint64 SIM_MachineGetIdleCycles(void)
+{
+    return SimIdleCycles;
+}
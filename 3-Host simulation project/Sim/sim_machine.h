@@ -0,0 +1,71 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Machine
+ *
+ * File Name: sim_machine.h
+ *
+ * Description: Header file for the simulated board that the host build of
+ *              the application runs on. Every register access of the target
+ *              code goes through the register hook: it costs a fixed number
+ *              of cycles, lets the peripheral models see the value read or
+ *              written, and is the point where due events (SysTick, script,
+ *              peripherals) are handled and interrupts are taken. Code between
+ *              two register accesses runs in zero simulated time unless it is
+ *              charged with SIM_MachineExecute(). A register read again and
+ *              again with the same value is a polling loop, so time jumps
+ *              straight to the next event instead.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_MACHINE_H_
+#define SIM_MACHINE_H_
+
+#include "std_types.h"
+
+/* Cost of one register access */
+#define SIM_MACHINE_ACCESS_CYCLES   4
+
+/* Unchanged reads of one register taken as a polling loop */
+#define SIM_MACHINE_POLL_READS      8
+
+/* Called wherever the running code can be interrupted, see port.c */
+typedef void (*SimInterruptPoint)(void);
+
+typedef void (*SimEndHandler)(void);
+
+typedef void (*SimMonitor)(void);
+
+/* Registers, clock, NVIC and peripheral models back to their reset state,
+ * with every peripheral clock gate reading ready */
+void SIM_MachineInit(void);
+
+void SIM_MachineSetInterruptPoint(SimInterruptPoint pfPoint);
+
+/* Pends the SysTick exception every ulPeriod cycles */
+void SIM_MachineStartSysTick(uint32 ulPeriod);
+
+/* Called once the simulated time reaches ullCycles; expected not to return */
+void SIM_MachineSetEnd(uint64 ullCycles, SimEndHandler pfHandler);
+
+/* Called every ullPeriod cycles of simulated time, e.g. for progress reports */
+void SIM_MachineSetMonitor(uint64 ullPeriod, SimMonitor pfMonitor);
+
+/* Time of the next event of any model, SIM_CLOCK_NEVER when none */
+uint64 SIM_MachineNextEvent(void);
+
+/* Moves time forward to ullCycles, handling every event on the way */
+void SIM_MachineRunTo(uint64 ullCycles);
+
+/* Charges ulCycles of code run outside the register accesses, handling the
+ * events due meanwhile like an access does */
+void SIM_MachineExecute(uint32 ulCycles);
+
+/* Nothing to run: sleeps until the next event like WFI */
+void SIM_MachineIdle(void);
+
+/* Cycles slept by SIM_MachineIdle() since the reset, the rest is CPU load */
+uint64 SIM_MachineGetIdleCycles(void);
+
+#endif /* SIM_MACHINE_H_ */
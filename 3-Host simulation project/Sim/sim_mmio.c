@@ -0,0 +1,179 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - MMIO Profile
+ *
+ * File Name: sim_mmio.c
+ *
+ * Description: Source file for the register access profile of the host
+ *              build, an open addressed table of register and call site
+ *              pairs.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+/* dladdr() */
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_mmio.h"
+#include "sim_clock.h"
+
+typedef struct
+{
+    uint32 Address;
+    const void *Caller;
+    uint32 Reads;
+    uint32 Writes;
+    uint32 PollReads;
+    uint64 PollCycles;
+} SimMmioSite;
+
+static SimMmioSite SimSites[SIM_MMIO_SITES];
+static uint32 SimSiteCount = 0;
+static uint32 SimDropped = 0;
+static boolean SimEnabled = FALSE;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* NULL_PTR once the table is full */
+static SimMmioSite *SIM_MmioSite(uint32 ulAddress, const void *pvCaller)
+{
+    uint32 ulIndex = (uint32)((ulAddress ^ ((uintptr_t)pvCaller * 0x9E3779B1UL)) & (SIM_MMIO_SITES - 1));
+    uint32 ulProbe;
+
+    for(ulProbe = 0; ulProbe < SIM_MMIO_SITES; ulProbe++)
+    {
+        SimMmioSite *pxSite = &SimSites[ulIndex];
+        if(pxSite->Caller == NULL_PTR)
+        {
+            if(SimSiteCount >= SIM_MMIO_SITES - 1)
+            {
+                break;
+            }
+            pxSite->Address = ulAddress;
+            pxSite->Caller = pvCaller;
+            SimSiteCount++;
+            return pxSite;
+        }
+        if((pxSite->Address == ulAddress) && (pxSite->Caller == pvCaller))
+        {
+            return pxSite;
+        }
+        ulIndex = (ulIndex + 1) & (SIM_MMIO_SITES - 1);
+    }
+    SimDropped++;
+    return NULL_PTR;
+}
+
+static int SIM_MmioCompare(const void *pvA, const void *pvB)
+{
+    const SimMmioSite *pxA = *(const SimMmioSite *const *)pvA;
+    const SimMmioSite *pxB = *(const SimMmioSite *const *)pvB;
+    uint32 ulAccessesA = pxA->Reads + pxA->Writes;
+    uint32 ulAccessesB = pxB->Reads + pxB->Writes;
+
+    if(pxA->PollCycles != pxB->PollCycles)
+    {
+        return (pxA->PollCycles > pxB->PollCycles) ? -1 : 1;
+    }
+    if(ulAccessesA != ulAccessesB)
+    {
+        return (ulAccessesA > ulAccessesB) ? -1 : 1;
+    }
+    return (pxA->Address < pxB->Address) ? -1 : (pxA->Address > pxB->Address);
+}
+
+/* Offset of the call site into the executable, which is position independent */
+static uintptr_t SIM_MmioOffset(const void *pvCaller)
+{
+    Dl_info xInfo;
+
+    if((dladdr(pvCaller, &xInfo) != 0) && (xInfo.dli_fbase != NULL_PTR))
+    {
+        return (uintptr_t)pvCaller - (uintptr_t)xInfo.dli_fbase;
+    }
+    return (uintptr_t)pvCaller;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_MmioReset(void)
+{
+    memset(SimSites, 0, sizeof(SimSites));
+    SimSiteCount = 0;
+    SimDropped = 0;
+}
+
+void SIM_MmioEnable(boolean bEnable)
+{
+    SimEnabled = bEnable;
+}
+
+boolean SIM_MmioIsEnabled(void)
+{
+    return SimEnabled;
+}
+
+void SIM_MmioAccess(uint32 ulAddress, const void *pvCaller, boolean bRead)
+{
+    SimMmioSite *pxSite = SIM_MmioSite(ulAddress, pvCaller);
+
+    if(pxSite == NULL_PTR)
+    {
+        return;
+    }
+    if(bRead)
+    {
+        pxSite->Reads++;
+    }
+    else
+    {
+        pxSite->Writes++;
+    }
+}
+
+void SIM_MmioPoll(uint32 ulAddress, const void *pvCaller, uint64 ullCycles)
+{
+    SimMmioSite *pxSite = SIM_MmioSite(ulAddress, pvCaller);
+
+    if(pxSite == NULL_PTR)
+    {
+        return;
+    }
+    pxSite->PollReads++;
+    pxSite->PollCycles += ullCycles;
+}
+
+void SIM_MmioReport(FILE *pxFile)
+{
+    SimMmioSite *apxSorted[SIM_MMIO_SITES];
+    uint32 ulCount = 0;
+    uint32 ulIndex;
+
+    for(ulIndex = 0; ulIndex < SIM_MMIO_SITES; ulIndex++)
+    {
+        if(SimSites[ulIndex].Caller != NULL_PTR)
+        {
+            apxSorted[ulCount++] = &SimSites[ulIndex];
+        }
+    }
+    qsort(apxSorted, ulCount, sizeof(apxSorted[0]), SIM_MmioCompare);
+
+    fprintf(pxFile, "# cycles=%llu hz=%lu dropped=%lu\n",
+            (unsigned long long)SIM_ClockCycles(), (unsigned long)SIM_CPU_CLOCK_HZ, (unsigned long)SimDropped);
+    fprintf(pxFile, "address,caller,reads,writes,poll_reads,poll_cycles\n");
+    for(ulIndex = 0; ulIndex < ulCount; ulIndex++)
+    {
+        fprintf(pxFile, "0x%08lX,0x%lx,%lu,%lu,%lu,%llu\n",
+                (unsigned long)apxSorted[ulIndex]->Address, (unsigned long)SIM_MmioOffset(apxSorted[ulIndex]->Caller),
+                (unsigned long)apxSorted[ulIndex]->Reads, (unsigned long)apxSorted[ulIndex]->Writes,
+                (unsigned long)apxSorted[ulIndex]->PollReads, (unsigned long long)apxSorted[ulIndex]->PollCycles);
+    }
+}
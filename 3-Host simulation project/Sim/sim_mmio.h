@@ -0,0 +1,50 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - MMIO Profile
+ *
+ * File Name: sim_mmio.h
+ *
+ * Description: Header file for the register access profile of the host
+ *              build. Every access of the target code is counted per
+ *              register and per call site (the return address into the
+ *              calling function) as a read or a write, as the machine tells
+ *              them apart. A read that finds the register unchanged since
+ *              the previous read of the same call site is a busy-wait
+ *              iteration: the cycles from that previous read, time skipped
+ *              by the machine over a polling loop included, are added to the
+ *              poll time of the site.
+ *
+ *              The report is one CSV line per register and call site, the
+ *              call site as an offset into the executable so addr2line can
+ *              name the function (see Tools/mmio_report.py).
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_MMIO_H_
+#define SIM_MMIO_H_
+
+#include <stdio.h>
+#include "std_types.h"
+
+/* Register and call site pairs kept, accesses of further pairs are counted as dropped */
+#define SIM_MMIO_SITES              2048
+
+/* Forgets every count, profiling stays as it was */
+void SIM_MmioReset(void);
+
+/* Off after the reset: the machine only calls the record functions when on */
+void SIM_MmioEnable(boolean bEnable);
+
+boolean SIM_MmioIsEnabled(void);
+
+void SIM_MmioAccess(uint32 ulAddress, const void *pvCaller, boolean bRead);
+
+/* One busy-wait read that took ullCycles since the previous read */
+void SIM_MmioPoll(uint32 ulAddress, const void *pvCaller, uint64 ullCycles);
+
+/* CSV report, the heaviest poll time first */
+void SIM_MmioReport(FILE *pxFile);
+
+#endif /* SIM_MMIO_H_ */
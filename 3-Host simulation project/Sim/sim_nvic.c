@@ -0,0 +1,144 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - NVIC
+ *
+ * File Name: sim_nvic.c
+ *
+ * Description: Source file for the simulated interrupt controller.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <string.h>
+#include "sim_nvic.h"
+#include "sim_registers.h"
+
+#define SIM_NVIC_EN0_ADDRESS        0xE000E100UL
+#define SIM_NVIC_DIS0_ADDRESS       0xE000E180UL
+#define SIM_NVIC_ENABLE_WORDS       5
+#define SIM_NVIC_PRI0_ADDRESS       0xE000E400UL
+#define SIM_NVIC_LOWEST_PRIORITY    0xE0
+
+static SimHandler SimHandlers[SIM_NVIC_VECTORS];
+static boolean SimPending[SIM_NVIC_VECTORS];
+static uint32 SimCounts[SIM_NVIC_VECTORS];
+static uint32 SimPendingCount = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static boolean SIM_NvicIsEnabled(uint16 usIrq)
+{
+    if(usIrq == SIM_NVIC_SYSTICK)
+    {
+        return TRUE;
+    }
+    return (*SIM_REG_LOCATION(SIM_NVIC_EN0_ADDRESS + 4 * (usIrq / 32)) & (1UL << (usIrq % 32))) ? TRUE : FALSE;
+}
+
+/* Only the implemented 3 priority bits of the byte are kept, like the hardware */
+static uint8 SIM_NvicPriority(uint16 usIrq)
+{
+    if(usIrq == SIM_NVIC_SYSTICK)
+    {
+        return SIM_NVIC_LOWEST_PRIORITY;
+    }
+    return (uint8)(*SIM_REG_LOCATION(SIM_NVIC_PRI0_ADDRESS + (usIrq & ~3U)) >> (8 * (usIrq & 3U))) & 0xE0;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_NvicReset(void)
+{
+    memset(SimHandlers, 0, sizeof(SimHandlers));
+    memset(SimPending, 0, sizeof(SimPending));
+    memset(SimCounts, 0, sizeof(SimCounts));
+    SimPendingCount = 0;
+}
+
+void SIM_NvicSetHandler(uint16 usIrq, SimHandler pfHandler)
+{
+    SimHandlers[usIrq] = pfHandler;
+}
+
+SimHandler SIM_NvicGetHandler(uint16 usIrq)
+{
+    return SimHandlers[usIrq];
+}
+
+void SIM_NvicPend(uint16 usIrq)
+{
+    if(!SimPending[usIrq])
+    {
+        SimPending[usIrq] = TRUE;
+        SimPendingCount++;
+    }
+}
+
+boolean SIM_NvicIsPending(uint16 usIrq)
+{
+    return SimPending[usIrq];
+}
+
+uint16 SIM_NvicTakePending(void)
+{
+    uint16 usIrq;
+    uint16 usBest = SIM_NVIC_NONE;
+    uint8 ucBestPriority = 0xFF;
+
+    if(SimPendingCount == 0)
+    {
+        return SIM_NVIC_NONE;
+    }
+
+    /* Equal priorities go to the lower interrupt number */
+    for(usIrq = 0; usIrq < SIM_NVIC_VECTORS; usIrq++)
+    {
+        if(SimPending[usIrq] && (SimHandlers[usIrq] != NULL_PTR) && SIM_NvicIsEnabled(usIrq) &&
+           (SIM_NvicPriority(usIrq) < ucBestPriority))
+        {
+            usBest = usIrq;
+            ucBestPriority = SIM_NvicPriority(usIrq);
+        }
+    }
+
+    if(usBest != SIM_NVIC_NONE)
+    {
+        SimPending[usBest] = FALSE;
+        SimPendingCount--;
+        SimCounts[usBest]++;
+    }
+    return usBest;
+}
+
+void SIM_NvicPrepare(uint32 ulAddress)
+{
+    /* Read 0 so that any write of a bit is seen */
+    if((ulAddress >= SIM_NVIC_DIS0_ADDRESS) && (ulAddress < SIM_NVIC_DIS0_ADDRESS + 4 * SIM_NVIC_ENABLE_WORDS))
+    {
+        SIM_REG_WORD(ulAddress) = 0;
+    }
+}
+
+void SIM_NvicComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter)
+{
+    if((ulAddress >= SIM_NVIC_EN0_ADDRESS) && (ulAddress < SIM_NVIC_EN0_ADDRESS + 4 * SIM_NVIC_ENABLE_WORDS))
+    {
+        /* Writing 0 to an enable bit leaves it as it is */
+        SIM_REG_WORD(ulAddress) = ulBefore | ulAfter;
+    }
+    else if((ulAddress >= SIM_NVIC_DIS0_ADDRESS) && (ulAddress < SIM_NVIC_DIS0_ADDRESS + 4 * SIM_NVIC_ENABLE_WORDS))
+    {
+        SIM_REG_WORD(ulAddress - SIM_NVIC_DIS0_ADDRESS + SIM_NVIC_EN0_ADDRESS) &= ~ulAfter;
+        SIM_REG_WORD(ulAddress) = 0;
+    }
+}
+
+uint32 SIM_NvicGetCount(uint16 usIrq)
+{
+    return SimCounts[usIrq];
+}
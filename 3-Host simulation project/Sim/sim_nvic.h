@@ -0,0 +1,57 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - NVIC
+ *
+ * File Name: sim_nvic.h
+ *
+ * Description: Header file for the simulated interrupt controller. The
+ *              peripheral models pend their interrupt numbers here, the
+ *              enable bits and priorities are the NVIC_ENn and NVIC_PRIn
+ *              registers written by the drivers, ENn setting and DISn
+ *              clearing the bits written to 1. Handlers never nest: the
+ *              port takes the pending interrupts one at a time, highest
+ *              priority first, whenever the code it interrupts allows it.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_NVIC_H_
+#define SIM_NVIC_H_
+
+#include "std_types.h"
+
+/* Peripheral interrupts of the TM4C123GH6PM */
+#define SIM_NVIC_IRQS               139
+
+/* The SysTick exception follows the peripheral interrupts, always enabled,
+ * at the lowest priority like the kernel configures it on the target */
+#define SIM_NVIC_SYSTICK            SIM_NVIC_IRQS
+#define SIM_NVIC_VECTORS            (SIM_NVIC_IRQS + 1)
+
+#define SIM_NVIC_NONE               0xFFFF
+
+typedef void (*SimHandler)(void);
+
+void SIM_NvicReset(void);
+
+void SIM_NvicSetHandler(uint16 usIrq, SimHandler pfHandler);
+
+SimHandler SIM_NvicGetHandler(uint16 usIrq);
+
+void SIM_NvicPend(uint16 usIrq);
+
+boolean SIM_NvicIsPending(uint16 usIrq);
+
+/* Highest priority interrupt both pending and enabled, taken off the pending
+ * set, or SIM_NVIC_NONE */
+uint16 SIM_NvicTakePending(void);
+
+/* Access hooks of the NVIC_ENn and NVIC_DISn registers */
+void SIM_NvicPrepare(uint32 ulAddress);
+void SIM_NvicComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter);
+
+/* Handler entries of one interrupt since the reset */
+uint32 SIM_NvicGetCount(uint16 usIrq);
+
+#endif /* SIM_NVIC_H_ */
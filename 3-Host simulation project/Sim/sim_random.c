@@ -0,0 +1,47 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Random
+ *
+ * File Name: sim_random.c
+ *
+ * Description: Source file for the pseudo random numbers of the simulation.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "sim_random.h"
+
+static uint64 SimState = 0x9E3779B97F4A7C15ULL;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_RandomSeed(uint64 ullSeed)
+{
+    /* One splitmix64 step, so that small seeds still give a well mixed state */
+    uint64 ullMixed = ullSeed + 0x9E3779B97F4A7C15ULL;
+    ullMixed = (ullMixed ^ (ullMixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    ullMixed = (ullMixed ^ (ullMixed >> 27)) * 0x94D049BB133111EBULL;
+    ullMixed ^= ullMixed >> 31;
+    SimState = (ullMixed != 0) ? ullMixed : 0x9E3779B97F4A7C15ULL;
+}
+
+uint64 SIM_RandomNext(void)
+{
+    SimState ^= SimState >> 12;
+    SimState ^= SimState << 25;
+    SimState ^= SimState >> 27;
+    return SimState * 0x2545F4914F6CDD1DULL;
+}
+
+uint32 SIM_RandomRange(uint32 ulMin, uint32 ulMax)
+{
+    return ulMin + (uint32)((SIM_RandomNext() >> 32) % ((uint64)ulMax - ulMin + 1));
+}
+
+boolean SIM_RandomChance(uint32 ulOdds)
+{
+    return (SIM_RandomRange(1, ulOdds) == 1) ? TRUE : FALSE;
+}
@@ -0,0 +1,31 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Random
+ *
+ * File Name: sim_random.h
+ *
+ * Description: Header file for the pseudo random numbers of the simulation.
+ *              The generator (xorshift64*) is private to the simulation and
+ *              only depends on the seed, so a run is reproduced exactly by
+ *              running it again with the same seed.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_RANDOM_H_
+#define SIM_RANDOM_H_
+
+#include "std_types.h"
+
+void SIM_RandomSeed(uint64 ullSeed);
+
+uint64 SIM_RandomNext(void);
+
+/* Uniform in [ulMin, ulMax] */
+uint32 SIM_RandomRange(uint32 ulMin, uint32 ulMax);
+
+/* TRUE once in ulOdds calls on average */
+boolean SIM_RandomChance(uint32 ulOdds);
+
+#endif /* SIM_RANDOM_H_ */
@@ -0,0 +1,38 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Register File
+ *
+ * File Name: sim_registers.c
+ *
+ * Description: Source file for the simulated TM4C123GH6PM register space.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <string.h>
+#include "sim_registers.h"
+
+volatile uint32 SIM_RegisterFile[2][SIM_REG_REGION_WORDS];
+
+static SimRegisterHook SimHook = NULL_PTR;
+
+void SIM_RegistersReset(void)
+{
+    memset((void *)SIM_RegisterFile, 0, sizeof(SIM_RegisterFile));
+}
+
+void SIM_RegistersSetHook(SimRegisterHook pfHook)
+{
+    SimHook = pfHook;
+}
+
+volatile uint32 *SIM_RegisterAccess(uint32 ulAddress)
+{
+    volatile uint32 *pulRegister = SIM_REG_LOCATION(ulAddress);
+    if(SimHook != NULL_PTR)
+    {
+        SimHook(ulAddress, pulRegister, __builtin_return_address(0));
+    }
+    return pulRegister;
+}
@@ -0,0 +1,60 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Register File
+ *
+ * File Name: sim_registers.h
+ *
+ * Description: Header file for the simulated TM4C123GH6PM register space.
+ *              The generated tm4c123gh6pm_registers.h maps every register
+ *              address through SIM_REG_ADDRESS() into this array.
+ *
+ *              The array is plain memory: a model only learns what the code
+ *              wrote when it looks at the word again, so the access hook is
+ *              called before each access and the models check the previous
+ *              access from there.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_REGISTERS_H_
+#define SIM_REGISTERS_H_
+
+#include "std_types.h"
+
+/* Peripherals live in 0x400xxxxx and the core registers in 0xE00xxxxx,
+ * each region is 1 MB so one word array per region covers all of them */
+#define SIM_REG_REGION_WORDS        (0x100000UL / 4)
+
+#define SIM_REG_LOCATION(address)   (&SIM_RegisterFile[((address) >> 29) & 0x1][((address) & 0xFFFFF) >> 2])
+#define SIM_REG_WORD(address)       (*SIM_REG_LOCATION(address))
+
+/* The target code reaches the registers through SIM_RegisterAccess() so the
+ * peripheral models see every access, the models themselves are built with
+ * SIM_REGISTERS_DIRECT and use the plain location */
+#ifdef SIM_REGISTERS_DIRECT
+#define SIM_REG_ADDRESS(address)    SIM_REG_LOCATION(address)
+#else
+#define SIM_REG_ADDRESS(address)    SIM_RegisterAccess(address)
+#endif
+
+/* Each access reaches its model before the next one, the barriers of the
+ * target code have nothing to wait for */
+#define __DSB()                     ((void)0)
+#define __ISB()                     ((void)0)
+
+/* Called before every access of the target code, with the address, the word
+ * accessed and the return address into the function making the access */
+typedef void (*SimRegisterHook)(uint32 ulAddress, volatile uint32 *pulRegister, const void *pvCaller);
+
+extern volatile uint32 SIM_RegisterFile[2][SIM_REG_REGION_WORDS];
+
+/* Clear every simulated register back to its reset value (zero) */
+void SIM_RegistersReset(void);
+
+/* NULL_PTR for plain memory, which is all the measurement demos need */
+void SIM_RegistersSetHook(SimRegisterHook pfHook);
+
+volatile uint32 *SIM_RegisterAccess(uint32 ulAddress);
+
+#endif /* SIM_REGISTERS_H_ */
@@ -0,0 +1,316 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Replay
+ *
+ * File Name: sim_replay.c
+ *
+ * Description: Source file for the replay of sensor traces recorded on the
+ *              board.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_replay.h"
+#include "sim_clock.h"
+#include "sim_adc.h"
+#include "sim_gpio.h"
+#include "sim_script.h"
+#include "sim_thermal.h"
+#include "tm4c123gh6pm_registers.h"
+
+#define SIM_REPLAY_HEADER_SIZE      24
+#define SIM_REPLAY_RECORD_SIZE      8
+
+/* Events and ids of Measurements/Recorder/recorder.h */
+#define SIM_REPLAY_EVENT_ADC        0x01
+#define SIM_REPLAY_EVENT_BUTTON     0x02
+#define SIM_REPLAY_ADCS             2
+#define SIM_REPLAY_PIN_PE4          0x44
+#define SIM_REPLAY_PIN_PF0          0x50
+#define SIM_REPLAY_PINS             256
+
+#define SIM_REPLAY_DWT_CYCCNTENA    0x00000001
+
+typedef enum
+{
+    SIM_REPLAY_ACTION_ADC,
+    SIM_REPLAY_ACTION_PIN
+} SimReplayType;
+
+typedef struct
+{
+    uint64 At;          /* DWT cycles of the board */
+    uint32 Order;       /* Keeps the trace order of actions at the same time */
+    SimReplayType Type;
+    uint16 Target;      /* AIN channel or button pin (port << 8 | pin) */
+    uint16 Value;       /* ADC code or pin level */
+} SimReplayAction;
+
+/* AIN channel of ADC0 and ADC1 as sampled by the application, and their seats */
+static const uint8 SimAdcChannels[SIM_REPLAY_ADCS] = { SIM_SCRIPT_DRIVER_AIN, SIM_SCRIPT_PASSENGER_AIN };
+static const uint8 SimAdcSeats[SIM_REPLAY_ADCS] = { SIM_THERMAL_DRIVER, SIM_THERMAL_PASSENGER };
+
+static SimReplayAction *SimActions = NULL_PTR;
+static uint32 SimActionsCount = 0;
+static uint32 SimActionsSize = 0;
+static uint32 SimNextAction = 0;
+static uint64 SimLastAt = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void SIM_ReplayAdd(uint64 ullAt, SimReplayType eType, uint16 usTarget, uint16 usValue)
+{
+    if(SimActionsCount == SimActionsSize)
+    {
+        SimActionsSize = (SimActionsSize == 0) ? 256 : (SimActionsSize * 2);
+        SimActions = realloc(SimActions, SimActionsSize * sizeof(SimReplayAction));
+        if(SimActions == NULL_PTR)
+        {
+            fprintf(stderr, "sim: out of memory for the replay\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    SimActions[SimActionsCount].At = ullAt;
+    SimActions[SimActionsCount].Order = SimActionsCount;
+    SimActions[SimActionsCount].Type = eType;
+    SimActions[SimActionsCount].Target = usTarget;
+    SimActions[SimActionsCount].Value = usValue;
+    SimActionsCount++;
+    SimLastAt = (ullAt > SimLastAt) ? ullAt : SimLastAt;
+}
+
+static int SIM_ReplayCompare(const void *pvA, const void *pvB)
+{
+    const SimReplayAction *pxA = pvA;
+    const SimReplayAction *pxB = pvB;
+    if(pxA->At != pxB->At)
+    {
+        return (pxA->At < pxB->At) ? -1 : 1;
+    }
+    return (pxA->Order < pxB->Order) ? -1 : 1;
+}
+
+static uint32 SIM_ReplayWord(const uint8 *pucBytes)
+{
+    return (uint32)pucBytes[0] | ((uint32)pucBytes[1] << 8) | ((uint32)pucBytes[2] << 16) | ((uint32)pucBytes[3] << 24);
+}
+
+/* Edge of a press taken by the handler at ullTime */
+static uint64 SIM_ReplayPress(uint8 ucId, uint64 ullTime)
+{
+    uint64 ullLead;
+
+    switch(ucId)
+    {
+    case SIM_REPLAY_PIN_PE4:
+        ullLead = SIM_REPLAY_LEAD_PE4_CYCLES;
+        break;
+    case SIM_REPLAY_PIN_PF0:
+        ullLead = SIM_REPLAY_LEAD_PF0_CYCLES;
+        break;
+    default:
+        ullLead = SIM_REPLAY_LEAD_PF4_CYCLES;
+        break;
+    }
+    return (ullTime > ullLead) ? (ullTime - ullLead) : 0;
+}
+
+/* Release of a press: after the usual hold, or half way to the next press of the pin */
+static void SIM_ReplayRelease(uint16 usPin, uint64 ullPress, uint64 ullNextPress)
+{
+    uint64 ullHold = SIM_MS_TO_CYCLES(SIM_SCRIPT_PRESS_MS);
+
+    if((ullNextPress - ullPress) / 2 < ullHold)
+    {
+        ullHold = (ullNextPress - ullPress) / 2;
+    }
+    SIM_ReplayAdd(ullPress + ullHold, SIM_REPLAY_ACTION_PIN, usPin, 1);
+}
+
+/* Cycles between the simulated clock and the DWT counter, which starts when
+ * the application enables it */
+static boolean SIM_ReplayOffset(uint64 *pullOffset)
+{
+    if(!(DWT_CTRL_REG & SIM_REPLAY_DWT_CYCCNTENA))
+    {
+        return FALSE;
+    }
+    *pullOffset = (uint32)((uint32)SIM_ClockCycles() - DWT_CYCCNT_REG);
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_ReplayReset(void)
+{
+    free(SimActions);
+    SimActions = NULL_PTR;
+    SimActionsCount = 0;
+    SimActionsSize = 0;
+    SimNextAction = 0;
+    SimLastAt = 0;
+}
+
+boolean SIM_ReplayLoad(const char *pcPath)
+{
+    uint8 aucHeader[SIM_REPLAY_HEADER_SIZE];
+    uint8 aucRecord[SIM_REPLAY_RECORD_SIZE];
+    uint64 aullPressed[SIM_REPLAY_PINS];
+    boolean abAdcSeen[SIM_REPLAY_ADCS] = { FALSE, FALSE };
+    uint64 aullAdcLast[SIM_REPLAY_ADCS];
+    uint64 ullTime;
+    uint32 ulRecords;
+    uint32 ulLost;
+    uint32 ulRecord;
+    uint32 ulSkipped = 0;
+    uint32 ulPin;
+    FILE *pxFile = fopen(pcPath, "rb");
+
+    if(pxFile == NULL_PTR)
+    {
+        perror(pcPath);
+        return FALSE;
+    }
+    if((fread(aucHeader, 1, sizeof(aucHeader), pxFile) != sizeof(aucHeader)) ||
+       (memcmp(aucHeader, SIM_REPLAY_MAGIC, 4) != 0))
+    {
+        fprintf(stderr, "%s: not a sensor trace\n", pcPath);
+        fclose(pxFile);
+        return FALSE;
+    }
+    if(SIM_ReplayWord(&aucHeader[4]) != SIM_CPU_CLOCK_HZ)
+    {
+        fprintf(stderr, "%s: recorded at %lu Hz, the simulation runs at %lu Hz\n", pcPath,
+                (unsigned long)SIM_ReplayWord(&aucHeader[4]), (unsigned long)SIM_CPU_CLOCK_HZ);
+        fclose(pxFile);
+        return FALSE;
+    }
+    ullTime = (uint64)SIM_ReplayWord(&aucHeader[8]) | ((uint64)SIM_ReplayWord(&aucHeader[12]) << 32);
+    ulRecords = SIM_ReplayWord(&aucHeader[16]);
+    ulLost = SIM_ReplayWord(&aucHeader[20]);
+
+    for(ulPin = 0; ulPin < SIM_REPLAY_PINS; ulPin++)
+    {
+        aullPressed[ulPin] = SIM_CLOCK_NEVER;
+    }
+
+    for(ulRecord = 0; ulRecord < ulRecords; ulRecord++)
+    {
+        uint8 ucEvent;
+        uint8 ucId;
+        uint16 usArg;
+
+        if(fread(aucRecord, 1, sizeof(aucRecord), pxFile) != sizeof(aucRecord))
+        {
+            fprintf(stderr, "%s: %lu of %lu records\n", pcPath, (unsigned long)ulRecord, (unsigned long)ulRecords);
+            fclose(pxFile);
+            return FALSE;
+        }
+        ullTime += SIM_ReplayWord(&aucRecord[0]);
+        ucEvent = aucRecord[4];
+        ucId = aucRecord[5];
+        usArg = (uint16)(aucRecord[6] | (aucRecord[7] << 8));
+
+        if((ucEvent == SIM_REPLAY_EVENT_ADC) && (ucId < SIM_REPLAY_ADCS))
+        {
+            /* The first sample is on the input from the start */
+            SIM_ReplayAdd(abAdcSeen[ucId] ? (aullAdcLast[ucId] + 1) : 0, SIM_REPLAY_ACTION_ADC,
+                          SimAdcChannels[ucId], usArg & SIM_ADC_MAX_CODE);
+            abAdcSeen[ucId] = TRUE;
+            aullAdcLast[ucId] = ullTime;
+        }
+        else if(ucEvent == SIM_REPLAY_EVENT_BUTTON)
+        {
+            uint64 ullPress = SIM_ReplayPress(ucId, ullTime);
+            uint16 usPin = (uint16)(((ucId >> 4) << 8) | (ucId & 0x0F));
+
+            if(aullPressed[ucId] != SIM_CLOCK_NEVER)
+            {
+                SIM_ReplayRelease(usPin, aullPressed[ucId], ullPress);
+            }
+            SIM_ReplayAdd(ullPress, SIM_REPLAY_ACTION_PIN, usPin, 0);
+            aullPressed[ucId] = ullPress;
+        }
+        else
+        {
+            ulSkipped++;
+        }
+    }
+    fclose(pxFile);
+
+    for(ulPin = 0; ulPin < SIM_REPLAY_PINS; ulPin++)
+    {
+        if(aullPressed[ulPin] != SIM_CLOCK_NEVER)
+        {
+            SIM_ReplayRelease((uint16)(((ulPin >> 4) << 8) | (ulPin & 0x0F)), aullPressed[ulPin], SIM_CLOCK_NEVER);
+        }
+    }
+    for(ulRecord = 0; ulRecord < SIM_REPLAY_ADCS; ulRecord++)
+    {
+        if(abAdcSeen[ulRecord])
+        {
+            SIM_ThermalReplaySensor(SimAdcSeats[ulRecord]);
+        }
+    }
+    qsort(SimActions, SimActionsCount, sizeof(SimReplayAction), SIM_ReplayCompare);
+
+    if(ulLost != 0)
+    {
+        fprintf(stderr, "%s: %lu records were lost on the board, the replay differs from the session\n",
+                pcPath, (unsigned long)ulLost);
+    }
+    if(ulSkipped != 0)
+    {
+        fprintf(stderr, "%s: %lu records of unknown events skipped\n", pcPath, (unsigned long)ulSkipped);
+    }
+
+    /* Inputs of time 0 are set before the application starts the counter */
+    SIM_ReplayProcess(0);
+    return TRUE;
+}
+
+uint64 SIM_ReplayEnd(void)
+{
+    return (SimActionsCount == 0) ? SIM_CLOCK_NEVER : (SimLastAt + SIM_MS_TO_CYCLES(SIM_REPLAY_TAIL_MS));
+}
+
+uint64 SIM_ReplayNextEvent(void)
+{
+    uint64 ullOffset;
+
+    if((SimNextAction >= SimActionsCount) || !SIM_ReplayOffset(&ullOffset))
+    {
+        return SIM_CLOCK_NEVER;
+    }
+    return SimActions[SimNextAction].At + ullOffset;
+}
+
+void SIM_ReplayProcess(uint64 ullNow)
+{
+    uint64 ullOffset = 0;
+
+    if((SimNextAction < SimActionsCount) && (SimActions[SimNextAction].At != 0) && !SIM_ReplayOffset(&ullOffset))
+    {
+        return;
+    }
+    while((SimNextAction < SimActionsCount) && (SimActions[SimNextAction].At + ullOffset <= ullNow))
+    {
+        const SimReplayAction *pxAction = &SimActions[SimNextAction++];
+        if(pxAction->Type == SIM_REPLAY_ACTION_ADC)
+        {
+            SIM_AdcSetInput((uint8)pxAction->Target, pxAction->Value);
+        }
+        else
+        {
+            SIM_GpioSetInput((uint8)(pxAction->Target >> 8), (uint8)(pxAction->Target & 0xFF), (uint8)pxAction->Value);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Replay
+ *
+ * File Name: sim_replay.h
+ *
+ * Description: Header file for the replay of sensor traces recorded on the
+ *              board (Measurements/Recorder of the application, extracted
+ *              from the UART0 capture by Tools/sensor_trace.py). Trace file,
+ *              all fields little endian:
+ *
+ *                  header   "SRT1", uint32 clock Hz, uint64 time of the first
+ *                           record, uint32 records, uint32 records lost
+ *                  record   uint32 cycles since the previous record,
+ *                           uint8 event, uint8 id, uint16 argument
+ *
+ *              Events and ids are the REC_EVENT_* and REC_ADC_* / REC_PIN()
+ *              values of recorder.h. Times are counts of the DWT cycle
+ *              counter of the board and are replayed against the one of the
+ *              simulation, so the handlers record the same samples at the
+ *              same times again:
+ *
+ *                  ADC      the code of a sample is put on the AIN input just
+ *                           after the handler read the previous one
+ *                  button   the pin goes low the handler lead before the
+ *                           handler took the edge, and high again after
+ *                           SIM_SCRIPT_PRESS_MS or before the next press
+ *
+ *              The sensors of the replayed seats are not driven by the
+ *              thermal model any more; it keeps following the heater outputs
+ *              for the control quality metrics.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_REPLAY_H_
+#define SIM_REPLAY_H_
+
+#include "std_types.h"
+
+#define SIM_REPLAY_MAGIC                "SRT1"
+
+/* Cycles from a falling edge on an idle core to the traceRECORD_INPUT() of
+ * the GPIO handler, the register accesses before it at 4 cycles each:
+ * GPIOPortE_Handler records first, GPIOPortF_Handler after one RIS read for
+ * PF0 and two for PF4 */
+#define SIM_REPLAY_LEAD_PE4_CYCLES      12
+#define SIM_REPLAY_LEAD_PF0_CYCLES      16
+#define SIM_REPLAY_LEAD_PF4_CYCLES      20
+
+/* Run time after the last record when neither -t nor the script ends the run */
+#define SIM_REPLAY_TAIL_MS              1000
+
+void SIM_ReplayReset(void);
+
+/* Reads a trace file; errors are printed with the file name */
+boolean SIM_ReplayLoad(const char *pcPath);
+
+/* Simulated time of the last record plus the tail, SIM_CLOCK_NEVER without a trace */
+uint64 SIM_ReplayEnd(void);
+
+uint64 SIM_ReplayNextEvent(void);
+void SIM_ReplayProcess(uint64 ullNow);
+
+#endif /* SIM_REPLAY_H_ */
@@ -0,0 +1,668 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Script
+ *
+ * File Name: sim_script.c
+ *
+ * Description: Source file for the stimulus scripts of the host build.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_script.h"
+#include "sim_clock.h"
+#include "sim_adc.h"
+#include "sim_gpio.h"
+#include "sim_uart.h"
+#include "sim_eeprom.h"
+#include "sim_random.h"
+#include "sim_thermal.h"
+
+#define SIM_SCRIPT_LINE_LENGTH      256
+
+/* Bytes of a "uart" line are spaced by one 8N1 frame at 9600 baud, the
+ * slowest rate, so that any rate UART0 is built for takes them in time */
+#define SIM_SCRIPT_UART_GAP_US      1042
+
+/* Random stimulus: sensors move by up to 1 degree per second within the
+ * normal range, and once an hour per seat on average read out of range for
+ * up to 5 seconds */
+#define SIM_SCRIPT_RANDOM_SENSOR_MS     1000
+#define SIM_SCRIPT_RANDOM_MIN_DEG       5
+#define SIM_SCRIPT_RANDOM_MAX_DEG       40
+#define SIM_SCRIPT_RANDOM_FAULT_ODDS    3600
+#define SIM_SCRIPT_RANDOM_FAULT_MAX_S   5
+#define SIM_SCRIPT_RANDOM_PRESS_MIN_S   5
+#define SIM_SCRIPT_RANDOM_PRESS_MAX_S   120
+#define SIM_SCRIPT_RANDOM_HOLD_MIN_MS   50
+#define SIM_SCRIPT_RANDOM_HOLD_MAX_MS   300
+#define SIM_SCRIPT_RANDOM_COMMAND_MIN_S 600
+#define SIM_SCRIPT_RANDOM_COMMAND_MAX_S 3600
+#define SIM_SCRIPT_RANDOM_COMMANDS      "tslqedkhibc"
+#define SIM_SCRIPT_SEATS                2
+
+/* Storms running at the same time */
+#define SIM_SCRIPT_STORMS               4
+
+typedef struct
+{
+    uint8 Channel;
+    sint32 Degrees;
+    uint64 FaultEnd;
+} SimRandomSeat;
+
+/* A button bouncing or a sensor swinging between two values at a fixed rate */
+typedef struct
+{
+    boolean Sensor;
+    uint32 Target;      /* Button pin (port << 8 | pin) or seat */
+    uint16 Codes[2];    /* ADC codes of the two sensor values */
+    double Degrees[2];
+    uint64 HalfPeriod;
+    uint64 Next;
+    uint64 End;
+    uint8 Phase;
+} SimStorm;
+
+typedef enum
+{
+    SIM_EVENT_ADC,
+    SIM_EVENT_PIN,
+    SIM_EVENT_UART,
+    SIM_EVENT_EEPROM_WRITE_TIME,
+    SIM_EVENT_THERMAL,
+    SIM_EVENT_END
+} SimEventType;
+
+typedef struct
+{
+    uint64 Time;
+    uint32 Order;       /* Keeps the file order of events at the same time */
+    SimEventType Type;
+    uint32 Arg1;
+    uint32 Arg2;
+    double Value;
+} SimEvent;
+
+static SimEvent *SimEvents = NULL_PTR;
+static uint32 SimEventsCount = 0;
+static uint32 SimEventsSize = 0;
+static uint32 SimNextEvent = 0;
+static uint64 SimEndTime = SIM_CLOCK_NEVER;
+
+static boolean SimRandomOn = FALSE;
+static SimRandomSeat SimRandomSeats[SIM_SCRIPT_SEATS];
+static uint64 SimRandomSensorAt = SIM_CLOCK_NEVER;
+static uint64 SimRandomPressAt = SIM_CLOCK_NEVER;
+static uint64 SimRandomReleaseAt = SIM_CLOCK_NEVER;
+static uint32 SimRandomPressedPin = 0;
+static uint64 SimRandomCommandAt = SIM_CLOCK_NEVER;
+
+static SimStorm SimStorms[SIM_SCRIPT_STORMS];
+static uint8 SimStormsCount = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void SIM_ScriptAdd(uint64 ullTime, SimEventType eType, uint32 ulArg1, uint32 ulArg2)
+{
+    if(SimEventsCount == SimEventsSize)
+    {
+        SimEventsSize = (SimEventsSize == 0) ? 64 : (SimEventsSize * 2);
+        SimEvents = realloc(SimEvents, SimEventsSize * sizeof(SimEvent));
+        if(SimEvents == NULL_PTR)
+        {
+            fprintf(stderr, "sim: out of memory for the script\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    SimEvents[SimEventsCount].Time = ullTime;
+    SimEvents[SimEventsCount].Order = SimEventsCount;
+    SimEvents[SimEventsCount].Type = eType;
+    SimEvents[SimEventsCount].Arg1 = ulArg1;
+    SimEvents[SimEventsCount].Arg2 = ulArg2;
+    SimEvents[SimEventsCount].Value = 0;
+    SimEventsCount++;
+}
+
+static int SIM_ScriptCompare(const void *pvA, const void *pvB)
+{
+    const SimEvent *pxA = pvA;
+    const SimEvent *pxB = pvB;
+    if(pxA->Time != pxB->Time)
+    {
+        return (pxA->Time < pxB->Time) ? -1 : 1;
+    }
+    return (pxA->Order < pxB->Order) ? -1 : 1;
+}
+
+static boolean SIM_ScriptParseTime(const char *pcText, uint64 *pullCycles)
+{
+    char *pcUnit;
+    double dValue = strtod(pcText, &pcUnit);
+
+    if((pcUnit == pcText) || (dValue < 0))
+    {
+        return FALSE;
+    }
+    if((*pcUnit == '\0') || (strcmp(pcUnit, "ms") == 0))
+    {
+        *pullCycles = (uint64)(dValue * SIM_MS_TO_CYCLES(1) + 0.5);
+    }
+    else if(strcmp(pcUnit, "us") == 0)
+    {
+        *pullCycles = (uint64)(dValue * SIM_US_TO_CYCLES(1) + 0.5);
+    }
+    else if(strcmp(pcUnit, "s") == 0)
+    {
+        *pullCycles = (uint64)(dValue * SIM_CPU_CLOCK_HZ + 0.5);
+    }
+    else
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Input pin packed as port << 8 | pin, from names such as "PF4" */
+static boolean SIM_ScriptParsePin(const char *pcText, uint32 *pulPin)
+{
+    if((strlen(pcText) != 3) || (toupper((unsigned char)pcText[0]) != 'P') ||
+       (toupper((unsigned char)pcText[1]) < 'A') || (toupper((unsigned char)pcText[1]) > 'F') ||
+       (pcText[2] < '0') || (pcText[2] > '7'))
+    {
+        return FALSE;
+    }
+    *pulPin = ((uint32)(toupper((unsigned char)pcText[1]) - 'A') << 8) | (uint32)(pcText[2] - '0');
+    return TRUE;
+}
+
+static boolean SIM_ScriptParseButton(const char *pcText, uint32 *pulPin)
+{
+    if(strcmp(pcText, "sw1") == 0)
+    {
+        *pulPin = (SIM_GPIO_PORTF << 8) | 4;
+    }
+    else if(strcmp(pcText, "sw2") == 0)
+    {
+        *pulPin = (SIM_GPIO_PORTF << 8) | 0;
+    }
+    else if(strcmp(pcText, "ext") == 0)
+    {
+        *pulPin = (SIM_GPIO_PORTE << 8) | 4;
+    }
+    else
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Smallest code the application converts back to at least the given degrees */
+static uint32 SIM_ScriptDegreesToCode(double dDegrees)
+{
+    double dCode = (dDegrees * SIM_ADC_MAX_CODE) / SIM_SCRIPT_FULL_SCALE_DEG;
+    uint32 ulCode;
+
+    if(dCode <= 0)
+    {
+        return 0;
+    }
+    ulCode = (uint32)dCode;
+    if((double)ulCode < dCode)
+    {
+        ulCode++;
+    }
+    return (ulCode > SIM_ADC_MAX_CODE) ? SIM_ADC_MAX_CODE : ulCode;
+}
+
+static boolean SIM_ScriptParseUart(uint64 ullTime, const char *pcText)
+{
+    uint32 ulIndex = 0;
+    while(*pcText != '\0')
+    {
+        uint8 ucByte = (uint8)*pcText++;
+        if(ucByte == '\\')
+        {
+            switch(*pcText++)
+            {
+            case 'r':  ucByte = '\r'; break;
+            case 'n':  ucByte = '\n'; break;
+            case 's':  ucByte = ' ';  break;
+            case '\\': ucByte = '\\'; break;
+            default:   return FALSE;
+            }
+        }
+        SIM_ScriptAdd(ullTime + ulIndex * SIM_US_TO_CYCLES(SIM_SCRIPT_UART_GAP_US), SIM_EVENT_UART, ucByte, 0);
+        ulIndex++;
+    }
+    return (ulIndex != 0) ? TRUE : FALSE;
+}
+
+/* One storm from its rate in Hz (full cycles) and its duration */
+static boolean SIM_ScriptAddStorm(uint64 ullTime, boolean bSensor, uint32 ulTarget, const double *pdDegrees,
+                                  const char *pcRate, const char *pcDuration)
+{
+    SimStorm *pxStorm;
+    double dRate = atof(pcRate);
+    uint64 ullDuration;
+
+    if((SimStormsCount == SIM_SCRIPT_STORMS) || (dRate <= 0) || !SIM_ScriptParseTime(pcDuration, &ullDuration))
+    {
+        return FALSE;
+    }
+    pxStorm = &SimStorms[SimStormsCount++];
+    pxStorm->Sensor = bSensor;
+    pxStorm->Target = ulTarget;
+    if(bSensor)
+    {
+        pxStorm->Degrees[0] = pdDegrees[0];
+        pxStorm->Degrees[1] = pdDegrees[1];
+        pxStorm->Codes[0] = (uint16)SIM_ScriptDegreesToCode(pdDegrees[0]);
+        pxStorm->Codes[1] = (uint16)SIM_ScriptDegreesToCode(pdDegrees[1]);
+    }
+    pxStorm->HalfPeriod = (uint64)((double)SIM_CPU_CLOCK_HZ / (2.0 * dRate));
+    pxStorm->HalfPeriod = (pxStorm->HalfPeriod != 0) ? pxStorm->HalfPeriod : 1;
+    pxStorm->Next = ullTime;
+    pxStorm->End = ullTime + ullDuration;
+    pxStorm->Phase = 0;
+    return TRUE;
+}
+
+static boolean SIM_ScriptParseLine(char *pcLine)
+{
+    char *pcTime = strtok(pcLine, " \t\r\n");
+    char *pcCommand = strtok(NULL, " \t\r\n");
+    char *pcArg1 = strtok(NULL, " \t\r\n");
+    char *pcArg2 = strtok(NULL, " \t\r\n");
+    char *pcArg3 = strtok(NULL, " \t\r\n");
+    char *pcArg4 = strtok(NULL, " \t\r\n");
+    char *pcArg5 = strtok(NULL, " \t\r\n");
+    uint64 ullTime;
+    uint32 ulValue;
+
+    if(pcTime == NULL_PTR)
+    {
+        return TRUE;
+    }
+    if((pcCommand == NULL_PTR) || !SIM_ScriptParseTime(pcTime, &ullTime))
+    {
+        return FALSE;
+    }
+
+    if((strcmp(pcCommand, "temp") == 0) && (pcArg1 != NULL_PTR) && (pcArg2 != NULL_PTR))
+    {
+        if(strcmp(pcArg1, "driver") == 0)
+        {
+            ulValue = SIM_SCRIPT_DRIVER_AIN;
+        }
+        else if(strcmp(pcArg1, "passenger") == 0)
+        {
+            ulValue = SIM_SCRIPT_PASSENGER_AIN;
+        }
+        else
+        {
+            return FALSE;
+        }
+        SIM_ScriptAdd(ullTime, SIM_EVENT_ADC, ulValue, SIM_ScriptDegreesToCode(atof(pcArg2)));
+    }
+    else if((strcmp(pcCommand, "adc") == 0) && (pcArg1 != NULL_PTR) && (pcArg2 != NULL_PTR))
+    {
+        SIM_ScriptAdd(ullTime, SIM_EVENT_ADC, (uint32)strtoul(pcArg1, NULL, 0), (uint32)strtoul(pcArg2, NULL, 0));
+    }
+    else if((strcmp(pcCommand, "press") == 0) && (pcArg1 != NULL_PTR) && SIM_ScriptParseButton(pcArg1, &ulValue))
+    {
+        uint64 ullHold = SIM_MS_TO_CYCLES((pcArg2 != NULL_PTR) ? strtoul(pcArg2, NULL, 0) : SIM_SCRIPT_PRESS_MS);
+        SIM_ScriptAdd(ullTime, SIM_EVENT_PIN, ulValue, 0);
+        SIM_ScriptAdd(ullTime + ullHold, SIM_EVENT_PIN, ulValue, 1);
+    }
+    else if((strcmp(pcCommand, "pin") == 0) && (pcArg1 != NULL_PTR) && (pcArg2 != NULL_PTR) &&
+            SIM_ScriptParsePin(pcArg1, &ulValue))
+    {
+        SIM_ScriptAdd(ullTime, SIM_EVENT_PIN, ulValue, (atoi(pcArg2) != 0) ? 1 : 0);
+    }
+    else if((strcmp(pcCommand, "uart") == 0) && (pcArg1 != NULL_PTR) && (pcArg2 == NULL_PTR))
+    {
+        return SIM_ScriptParseUart(ullTime, pcArg1);
+    }
+    else if((strcmp(pcCommand, "eeprom_write_us") == 0) && (pcArg1 != NULL_PTR))
+    {
+        SIM_ScriptAdd(ullTime, SIM_EVENT_EEPROM_WRITE_TIME, (uint32)strtoul(pcArg1, NULL, 0), 0);
+    }
+    else if((strcmp(pcCommand, "thermal") == 0) && (pcArg1 != NULL_PTR) && (pcArg2 != NULL_PTR))
+    {
+        SimThermalParam eParam = SIM_ThermalParamByName(pcArg2);
+        if(strcmp(pcArg1, "driver") == 0)
+        {
+            ulValue = SIM_THERMAL_DRIVER;
+        }
+        else if(strcmp(pcArg1, "passenger") == 0)
+        {
+            ulValue = SIM_THERMAL_PASSENGER;
+        }
+        else
+        {
+            return FALSE;
+        }
+        if((eParam == SIM_THERMAL_PARAMS) ||
+           ((pcArg3 == NULL_PTR) && (eParam != SIM_THERMAL_ON) && (eParam != SIM_THERMAL_OFF) && (eParam != SIM_THERMAL_CLEAR)))
+        {
+            return FALSE;
+        }
+        SIM_ScriptAdd(ullTime, SIM_EVENT_THERMAL, ulValue, (uint32)eParam);
+        SimEvents[SimEventsCount - 1].Value = (pcArg3 != NULL_PTR) ? atof(pcArg3) : 0;
+    }
+    else if((strcmp(pcCommand, "bounce") == 0) && (pcArg1 != NULL_PTR) && (pcArg2 != NULL_PTR) && (pcArg3 != NULL_PTR))
+    {
+        if(!SIM_ScriptParseButton(pcArg1, &ulValue))
+        {
+            return FALSE;
+        }
+        return SIM_ScriptAddStorm(ullTime, FALSE, ulValue, NULL_PTR, pcArg2, pcArg3);
+    }
+    else if((strcmp(pcCommand, "oscillate") == 0) && (pcArg1 != NULL_PTR) && (pcArg2 != NULL_PTR) &&
+            (pcArg3 != NULL_PTR) && (pcArg4 != NULL_PTR) && (pcArg5 != NULL_PTR))
+    {
+        double adDegrees[2];
+        if(strcmp(pcArg1, "driver") == 0)
+        {
+            ulValue = SIM_THERMAL_DRIVER;
+        }
+        else if(strcmp(pcArg1, "passenger") == 0)
+        {
+            ulValue = SIM_THERMAL_PASSENGER;
+        }
+        else
+        {
+            return FALSE;
+        }
+        adDegrees[0] = atof(pcArg2);
+        adDegrees[1] = atof(pcArg3);
+        return SIM_ScriptAddStorm(ullTime, TRUE, ulValue, adDegrees, pcArg4, pcArg5);
+    }
+    else if(strcmp(pcCommand, "end") == 0)
+    {
+        SIM_ScriptAdd(ullTime, SIM_EVENT_END, 0, 0);
+        if(ullTime < SimEndTime)
+        {
+            SimEndTime = ullTime;
+        }
+    }
+    else
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static uint64 SIM_ScriptRandomSeconds(uint32 ulMin, uint32 ulMax)
+{
+    return SIM_MS_TO_CYCLES(SIM_RandomRange(ulMin * 1000, ulMax * 1000));
+}
+
+static void SIM_ScriptRandomSensor(SimRandomSeat *pxSeat, uint64 ullNow)
+{
+    sint32 lDegrees;
+
+    if((pxSeat->FaultEnd == SIM_CLOCK_NEVER) && SIM_RandomChance(SIM_SCRIPT_RANDOM_FAULT_ODDS))
+    {
+        /* Below 5 or above 40 degrees, as far as the 0..45 sensor range goes */
+        pxSeat->FaultEnd = ullNow + SIM_ScriptRandomSeconds(1, SIM_SCRIPT_RANDOM_FAULT_MAX_S);
+        lDegrees = SIM_RandomChance(2) ? (sint32)SIM_RandomRange(0, SIM_SCRIPT_RANDOM_MIN_DEG - 1)
+                                       : (sint32)SIM_RandomRange(SIM_SCRIPT_RANDOM_MAX_DEG + 1, SIM_SCRIPT_FULL_SCALE_DEG);
+        SIM_AdcSetInput(pxSeat->Channel, (uint16)SIM_ScriptDegreesToCode(lDegrees));
+        return;
+    }
+    if(pxSeat->FaultEnd != SIM_CLOCK_NEVER)
+    {
+        if(ullNow < pxSeat->FaultEnd)
+        {
+            return;
+        }
+        pxSeat->FaultEnd = SIM_CLOCK_NEVER;
+    }
+
+    pxSeat->Degrees += (sint32)SIM_RandomRange(0, 2) - 1;
+    if(pxSeat->Degrees < SIM_SCRIPT_RANDOM_MIN_DEG)
+    {
+        pxSeat->Degrees = SIM_SCRIPT_RANDOM_MIN_DEG;
+    }
+    if(pxSeat->Degrees > SIM_SCRIPT_RANDOM_MAX_DEG)
+    {
+        pxSeat->Degrees = SIM_SCRIPT_RANDOM_MAX_DEG;
+    }
+    SIM_AdcSetInput(pxSeat->Channel, (uint16)SIM_ScriptDegreesToCode(pxSeat->Degrees));
+}
+
+/* A button storm presses on phase 0 and releases on phase 1, a sensor storm
+ * swings between its two values; a thermal seat reads them as a fault */
+static void SIM_ScriptStormEdge(SimStorm *pxStorm, boolean bLast)
+{
+    if(!pxStorm->Sensor)
+    {
+        SIM_GpioSetInput((uint8)(pxStorm->Target >> 8), (uint8)(pxStorm->Target & 0xFF), bLast ? 1 : pxStorm->Phase);
+    }
+    else if(SIM_ThermalIsOn((uint8)pxStorm->Target))
+    {
+        SIM_ThermalSet((uint8)pxStorm->Target, bLast ? SIM_THERMAL_CLEAR : SIM_THERMAL_FAULT, pxStorm->Degrees[pxStorm->Phase]);
+        if(!bLast)
+        {
+            SIM_AdcSetInput((pxStorm->Target == SIM_THERMAL_DRIVER) ? SIM_SCRIPT_DRIVER_AIN : SIM_SCRIPT_PASSENGER_AIN,
+                            pxStorm->Codes[pxStorm->Phase]);
+        }
+    }
+    else
+    {
+        SIM_AdcSetInput((pxStorm->Target == SIM_THERMAL_DRIVER) ? SIM_SCRIPT_DRIVER_AIN : SIM_SCRIPT_PASSENGER_AIN,
+                        pxStorm->Codes[bLast ? 0 : pxStorm->Phase]);
+    }
+}
+
+static uint64 SIM_ScriptStormsNextEvent(void)
+{
+    uint64 ullNext = SIM_CLOCK_NEVER;
+    uint8 ucStorm;
+    for(ucStorm = 0; ucStorm < SimStormsCount; ucStorm++)
+    {
+        ullNext = (SimStorms[ucStorm].Next < ullNext) ? SimStorms[ucStorm].Next : ullNext;
+    }
+    return ullNext;
+}
+
+static void SIM_ScriptStormsProcess(uint64 ullNow)
+{
+    SimStorm *pxStorm;
+    uint8 ucStorm;
+
+    for(ucStorm = 0; ucStorm < SimStormsCount; ucStorm++)
+    {
+        pxStorm = &SimStorms[ucStorm];
+        while(pxStorm->Next <= ullNow)
+        {
+            if(pxStorm->Next >= pxStorm->End)
+            {
+                SIM_ScriptStormEdge(pxStorm, TRUE);
+                pxStorm->Next = SIM_CLOCK_NEVER;
+                break;
+            }
+            SIM_ScriptStormEdge(pxStorm, FALSE);
+            pxStorm->Phase ^= 1;
+            pxStorm->Next += pxStorm->HalfPeriod;
+        }
+    }
+}
+
+static uint64 SIM_ScriptRandomNextEvent(void)
+{
+    uint64 ullNext = SimRandomSensorAt;
+    ullNext = (SimRandomPressAt < ullNext) ? SimRandomPressAt : ullNext;
+    ullNext = (SimRandomReleaseAt < ullNext) ? SimRandomReleaseAt : ullNext;
+    ullNext = (SimRandomCommandAt < ullNext) ? SimRandomCommandAt : ullNext;
+    return ullNext;
+}
+
+static void SIM_ScriptRandomProcess(uint64 ullNow)
+{
+    static const uint32 aulButtons[] =
+    {
+        (SIM_GPIO_PORTF << 8) | 4, (SIM_GPIO_PORTF << 8) | 0, (SIM_GPIO_PORTE << 8) | 4
+    };
+    uint8 ucSeat;
+
+    if(SimRandomSensorAt <= ullNow)
+    {
+        for(ucSeat = 0; ucSeat < SIM_SCRIPT_SEATS; ucSeat++)
+        {
+            /* A seat under the thermal model has its sensor driven by the model */
+            if(!SIM_ThermalIsOn(ucSeat))
+            {
+                SIM_ScriptRandomSensor(&SimRandomSeats[ucSeat], ullNow);
+            }
+        }
+        SimRandomSensorAt += SIM_MS_TO_CYCLES(SIM_SCRIPT_RANDOM_SENSOR_MS);
+    }
+    if(SimRandomReleaseAt <= ullNow)
+    {
+        SIM_GpioSetInput((uint8)(SimRandomPressedPin >> 8), (uint8)(SimRandomPressedPin & 0xFF), 1);
+        SimRandomReleaseAt = SIM_CLOCK_NEVER;
+    }
+    if(SimRandomPressAt <= ullNow)
+    {
+        SimRandomPressedPin = aulButtons[SIM_RandomRange(0, 2)];
+        SIM_GpioSetInput((uint8)(SimRandomPressedPin >> 8), (uint8)(SimRandomPressedPin & 0xFF), 0);
+        SimRandomReleaseAt = ullNow + SIM_MS_TO_CYCLES(SIM_RandomRange(SIM_SCRIPT_RANDOM_HOLD_MIN_MS,
+                                                                       SIM_SCRIPT_RANDOM_HOLD_MAX_MS));
+        SimRandomPressAt = SimRandomReleaseAt + SIM_ScriptRandomSeconds(SIM_SCRIPT_RANDOM_PRESS_MIN_S,
+                                                                         SIM_SCRIPT_RANDOM_PRESS_MAX_S);
+    }
+    if(SimRandomCommandAt <= ullNow)
+    {
+        SIM_UartReceive((uint8)SIM_SCRIPT_RANDOM_COMMANDS[SIM_RandomRange(0, sizeof(SIM_SCRIPT_RANDOM_COMMANDS) - 2)]);
+        SimRandomCommandAt = ullNow + SIM_ScriptRandomSeconds(SIM_SCRIPT_RANDOM_COMMAND_MIN_S,
+                                                              SIM_SCRIPT_RANDOM_COMMAND_MAX_S);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_ScriptReset(void)
+{
+    free(SimEvents);
+    SimEvents = NULL_PTR;
+    SimEventsCount = 0;
+    SimEventsSize = 0;
+    SimNextEvent = 0;
+    SimEndTime = SIM_CLOCK_NEVER;
+    SimRandomOn = FALSE;
+    SimRandomSensorAt = SIM_CLOCK_NEVER;
+    SimRandomPressAt = SIM_CLOCK_NEVER;
+    SimRandomReleaseAt = SIM_CLOCK_NEVER;
+    SimRandomCommandAt = SIM_CLOCK_NEVER;
+    SimStormsCount = 0;
+}
+
+void SIM_ScriptRandom(uint64 ullSeed)
+{
+    SIM_RandomSeed(ullSeed);
+    SimRandomOn = TRUE;
+    SimRandomSeats[0].Channel = SIM_SCRIPT_DRIVER_AIN;
+    SimRandomSeats[1].Channel = SIM_SCRIPT_PASSENGER_AIN;
+    SimRandomSeats[0].Degrees = (sint32)SIM_RandomRange(SIM_SCRIPT_RANDOM_MIN_DEG, SIM_SCRIPT_RANDOM_MAX_DEG);
+    SimRandomSeats[1].Degrees = (sint32)SIM_RandomRange(SIM_SCRIPT_RANDOM_MIN_DEG, SIM_SCRIPT_RANDOM_MAX_DEG);
+    SimRandomSeats[0].FaultEnd = SIM_CLOCK_NEVER;
+    SimRandomSeats[1].FaultEnd = SIM_CLOCK_NEVER;
+    SimRandomSensorAt = SIM_ClockCycles();
+    SimRandomPressAt = SIM_ClockCycles() + SIM_ScriptRandomSeconds(SIM_SCRIPT_RANDOM_PRESS_MIN_S,
+                                                                   SIM_SCRIPT_RANDOM_PRESS_MAX_S);
+    SimRandomReleaseAt = SIM_CLOCK_NEVER;
+    SimRandomCommandAt = SIM_ClockCycles() + SIM_ScriptRandomSeconds(SIM_SCRIPT_RANDOM_COMMAND_MIN_S,
+                                                                     SIM_SCRIPT_RANDOM_COMMAND_MAX_S);
+}
+
+boolean SIM_ScriptLoad(const char *pcPath)
+{
+    char acLine[SIM_SCRIPT_LINE_LENGTH];
+    uint32 ulLine = 0;
+    boolean bOk = TRUE;
+    FILE *pxFile = fopen(pcPath, "r");
+
+    if(pxFile == NULL_PTR)
+    {
+        perror(pcPath);
+        return FALSE;
+    }
+    while(fgets(acLine, sizeof(acLine), pxFile) != NULL_PTR)
+    {
+        char *pcComment = strchr(acLine, '#');
+        ulLine++;
+        if(pcComment != NULL_PTR)
+        {
+            *pcComment = '\0';
+        }
+        if(!SIM_ScriptParseLine(acLine))
+        {
+            fprintf(stderr, "%s:%lu: bad event\n", pcPath, (unsigned long)ulLine);
+            bOk = FALSE;
+        }
+    }
+    fclose(pxFile);
+
+    qsort(SimEvents, SimEventsCount, sizeof(SimEvent), SIM_ScriptCompare);
+    return bOk;
+}
+
+uint64 SIM_ScriptEnd(void)
+{
+    return SimEndTime;
+}
+
+uint64 SIM_ScriptNextEvent(void)
+{
+    uint64 ullNext = (SimNextEvent < SimEventsCount) ? SimEvents[SimNextEvent].Time : SIM_CLOCK_NEVER;
+    uint64 ullRandom = SimRandomOn ? SIM_ScriptRandomNextEvent() : SIM_CLOCK_NEVER;
+    uint64 ullStorm = SIM_ScriptStormsNextEvent();
+    ullNext = (ullRandom < ullNext) ? ullRandom : ullNext;
+    return (ullStorm < ullNext) ? ullStorm : ullNext;
+}
+
+void SIM_ScriptProcess(uint64 ullNow)
+{
+    while((SimNextEvent < SimEventsCount) && (SimEvents[SimNextEvent].Time <= ullNow))
+    {
+        const SimEvent *pxEvent = &SimEvents[SimNextEvent++];
+        switch(pxEvent->Type)
+        {
+        case SIM_EVENT_ADC:
+            SIM_AdcSetInput((uint8)pxEvent->Arg1, (uint16)pxEvent->Arg2);
+            break;
+        case SIM_EVENT_PIN:
+            SIM_GpioSetInput((uint8)(pxEvent->Arg1 >> 8), (uint8)(pxEvent->Arg1 & 0xFF), (uint8)pxEvent->Arg2);
+            break;
+        case SIM_EVENT_UART:
+            SIM_UartReceive((uint8)pxEvent->Arg1);
+            break;
+        case SIM_EVENT_EEPROM_WRITE_TIME:
+            SIM_EepromSetWriteTime(pxEvent->Arg1);
+            break;
+        case SIM_EVENT_THERMAL:
+            SIM_ThermalSet((uint8)pxEvent->Arg1, (SimThermalParam)pxEvent->Arg2, pxEvent->Value);
+            break;
+        case SIM_EVENT_END:
+            /* Reached through SIM_ScriptEnd() by the machine end time */
+            break;
+        }
+    }
+    if(SimRandomOn)
+    {
+        SIM_ScriptRandomProcess(ullNow);
+    }
+    SIM_ScriptStormsProcess(ullNow);
+}
@@ -0,0 +1,70 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Script
+ *
+ * File Name: sim_script.h
+ *
+ * Description: Header file for the stimulus scripts of the host build. One
+ *              event per line, '#' starts a comment:
+ *
+ *                  <time> <command> [arguments]
+ *
+ *              The time is in milliseconds unless suffixed with us, ms or s.
+ *              Commands:
+ *                  temp driver|passenger <degrees>  sensor input of a seat
+ *                  adc <channel> <code>             raw code on AIN<channel>
+ *                  press sw1|sw2|ext [hold ms]      button low, then released
+ *                  pin P<port><pin> 0|1             level of an input pin
+ *                  uart <text>                      bytes on U0RX, \r \n \s \\ escapes
+ *                  eeprom_write_us <us>             word programming time
+ *                  thermal driver|passenger <param> [value]
+ *                                                   seat thermal model, see sim_thermal.h
+ *                  bounce sw1|sw2|ext <hz> <duration>
+ *                                                   button pressed and released hz times a second
+ *                  oscillate driver|passenger <low> <high> <hz> <duration>
+ *                                                   sensor swinging between two temperatures
+ *                  end                              stops the simulation
+ *
+ *              The durations take the same units as the time. Up to 4
+ *              storms (bounce, oscillate) can be given per script; a storm
+ *              on a seat under the thermal model reads as a sensor fault.
+ *
+ *              The random stimulus of the soak runs can be added on top:
+ *              sensor random walks with short out of range faults, button
+ *              presses every few seconds to minutes and a console command
+ *              every 10 to 60 minutes, all drawn from the seeded generator.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_SCRIPT_H_
+#define SIM_SCRIPT_H_
+
+#include "std_types.h"
+
+/* AIN channels of the seat temperature sensors, PD0 and PD1 */
+#define SIM_SCRIPT_DRIVER_AIN       7
+#define SIM_SCRIPT_PASSENGER_AIN    6
+
+/* Full scale of the sensors as converted by the application */
+#define SIM_SCRIPT_FULL_SCALE_DEG   45
+
+#define SIM_SCRIPT_PRESS_MS         100
+
+void SIM_ScriptReset(void);
+
+/* Reads and sorts the events of a script file; errors are printed with the
+ * line number */
+boolean SIM_ScriptLoad(const char *pcPath);
+
+/* Starts the random stimulus, the same seed gives the same events */
+void SIM_ScriptRandom(uint64 ullSeed);
+
+/* Time of the "end" event, SIM_CLOCK_NEVER when the script has none */
+uint64 SIM_ScriptEnd(void);
+
+uint64 SIM_ScriptNextEvent(void);
+void SIM_ScriptProcess(uint64 ullNow);
+
+#endif /* SIM_SCRIPT_H_ */
@@ -0,0 +1,379 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Thermal
+ *
+ * File Name: sim_thermal.c
+ *
+ * Description: Source file for the thermal model of the two seats.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include <math.h>
+#include <string.h>
+#include "sim_thermal.h"
+#include "sim_clock.h"
+#include "sim_adc.h"
+#include "sim_gpio.h"
+#include "sim_script.h"
+
+#define SIM_THERMAL_STEP_S          (SIM_THERMAL_STEP_MS / 1000.0)
+#define SIM_THERMAL_LOG_STEPS       (1000 / SIM_THERMAL_STEP_MS)
+
+/* The ripple is taken over the last 10 minutes in the band, in 1 minute buckets */
+#define SIM_THERMAL_RIPPLE_BUCKETS  10
+#define SIM_THERMAL_BUCKET_STEPS    (60 * 1000 / SIM_THERMAL_STEP_MS)
+
+/* Heater pins of the seats, set by GPIO_BlueLedOn() / GPIO_GreenLedOn() and the Ex versions */
+#define SIM_THERMAL_BLUE_PIN        2
+#define SIM_THERMAL_GREEN_PIN       3
+
+typedef struct
+{
+    const char *Name;
+    uint8 Channel;
+    uint8 Port;
+    boolean On;
+    boolean Faulted;
+    boolean Replayed;
+    double Params[SIM_THERMAL_PARAMS];
+    double Seat;
+    double Sensor;
+    uint8 Level;
+    /* Step response metrics */
+    boolean HasTarget;
+    uint64 TargetAt;
+    uint64 FirstInBandAt;
+    uint64 LastEntryAt;
+    boolean InBand;
+    boolean Rising;                 /* Step up from the seat temperature to the target */
+    double Peak;                    /* Furthest seat temperature in the direction of the step */
+    double BandMin[SIM_THERMAL_RIPPLE_BUCKETS];    /* Seat extremes since the last entry into the band */
+    double BandMax[SIM_THERMAL_RIPPLE_BUCKETS];
+    uint8 Bucket;
+    uint8 Buckets;
+    uint32 BucketSteps;
+    double Energy;
+} SimThermalSeat;
+
+static const char *const SimParamNames[SIM_THERMAL_PARAMS] =
+{
+    "on", "off", "fault", "clear", "ambient", "initial", "mass", "loss", "lag",
+    "power_low", "power_medium", "power_high", "target", "band"
+};
+
+/* A seat cushion of ~17 minutes time constant reaching ~45 degrees over the
+ * ambient on HIGH, read by a sensor lagging 20 s behind */
+static const double SimDefaults[SIM_THERMAL_PARAMS] =
+{
+    0, 0, 0, 0, 15.0, 15.0, 2000.0, 2.0, 20.0, 30.0, 60.0, 90.0, 0, 2.0
+};
+
+static SimThermalSeat SimSeats[SIM_THERMAL_SEATS] =
+{
+    { "driver",    SIM_SCRIPT_DRIVER_AIN,    SIM_GPIO_PORTF },
+    { "passenger", SIM_SCRIPT_PASSENGER_AIN, SIM_GPIO_PORTE },
+};
+
+static uint64 SimNextStep = SIM_CLOCK_NEVER;
+static uint32 SimSteps = 0;
+static FILE *SimLog = NULL_PTR;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint8 SIM_ThermalLevel(const SimThermalSeat *pxSeat)
+{
+    uint8 ucPins = SIM_GpioGetOutputs(pxSeat->Port);
+    uint8 ucBlue = (ucPins >> SIM_THERMAL_BLUE_PIN) & 1;
+    uint8 ucGreen = (ucPins >> SIM_THERMAL_GREEN_PIN) & 1;
+
+    if(ucBlue)
+    {
+        return ucGreen ? 3 : 2;
+    }
+    return ucGreen;
+}
+
+static double SIM_ThermalPower(const SimThermalSeat *pxSeat)
+{
+    return (pxSeat->Level == 0) ? 0 : pxSeat->Params[SIM_THERMAL_POWER_LOW + pxSeat->Level - 1];
+}
+
+static uint16 SIM_ThermalCode(double dDegrees)
+{
+    double dCode = (dDegrees * SIM_ADC_MAX_CODE) / SIM_SCRIPT_FULL_SCALE_DEG;
+    if(dCode <= 0)
+    {
+        return 0;
+    }
+    return (dCode >= SIM_ADC_MAX_CODE) ? SIM_ADC_MAX_CODE : (uint16)ceil(dCode);
+}
+
+static void SIM_ThermalTrack(SimThermalSeat *pxSeat, uint64 ullNow)
+{
+    boolean bInBand = (fabs(pxSeat->Seat - pxSeat->Params[SIM_THERMAL_TARGET]) <= pxSeat->Params[SIM_THERMAL_BAND]) ? TRUE : FALSE;
+
+    if(bInBand && !pxSeat->InBand)
+    {
+        pxSeat->LastEntryAt = ullNow;
+        pxSeat->Bucket = 0;
+        pxSeat->Buckets = 0;
+        pxSeat->BucketSteps = SIM_THERMAL_BUCKET_STEPS;
+        if(pxSeat->FirstInBandAt == SIM_CLOCK_NEVER)
+        {
+            pxSeat->FirstInBandAt = ullNow;
+        }
+    }
+    pxSeat->InBand = bInBand;
+    if(bInBand)
+    {
+        /* A full bucket starts the next one, the oldest of the ring is dropped */
+        if(pxSeat->BucketSteps == SIM_THERMAL_BUCKET_STEPS)
+        {
+            pxSeat->Bucket = (pxSeat->Buckets == 0) ? 0 : ((pxSeat->Bucket + 1) % SIM_THERMAL_RIPPLE_BUCKETS);
+            pxSeat->Buckets = (pxSeat->Buckets < SIM_THERMAL_RIPPLE_BUCKETS) ? (pxSeat->Buckets + 1) : pxSeat->Buckets;
+            pxSeat->BandMin[pxSeat->Bucket] = pxSeat->Seat;
+            pxSeat->BandMax[pxSeat->Bucket] = pxSeat->Seat;
+            pxSeat->BucketSteps = 0;
+        }
+        pxSeat->BucketSteps++;
+        if(pxSeat->Seat < pxSeat->BandMin[pxSeat->Bucket])
+        {
+            pxSeat->BandMin[pxSeat->Bucket] = pxSeat->Seat;
+        }
+        if(pxSeat->Seat > pxSeat->BandMax[pxSeat->Bucket])
+        {
+            pxSeat->BandMax[pxSeat->Bucket] = pxSeat->Seat;
+        }
+    }
+    if(pxSeat->Rising ? (pxSeat->Seat > pxSeat->Peak) : (pxSeat->Seat < pxSeat->Peak))
+    {
+        pxSeat->Peak = pxSeat->Seat;
+    }
+}
+
+static void SIM_ThermalStep(SimThermalSeat *pxSeat, uint64 ullNow)
+{
+    double dLag = pxSeat->Params[SIM_THERMAL_LAG];
+    double dPower;
+
+    pxSeat->Level = SIM_ThermalLevel(pxSeat);
+    dPower = SIM_ThermalPower(pxSeat);
+
+    pxSeat->Seat += SIM_THERMAL_STEP_S * (dPower - pxSeat->Params[SIM_THERMAL_LOSS] * (pxSeat->Seat - pxSeat->Params[SIM_THERMAL_AMBIENT])) /
+                    pxSeat->Params[SIM_THERMAL_MASS];
+    pxSeat->Sensor = (dLag > 0) ? (pxSeat->Sensor + (pxSeat->Seat - pxSeat->Sensor) * (1.0 - exp(-SIM_THERMAL_STEP_S / dLag)))
+                                : pxSeat->Seat;
+    pxSeat->Energy += dPower * SIM_THERMAL_STEP_S;
+    if(!pxSeat->Replayed)
+    {
+        SIM_AdcSetInput(pxSeat->Channel, SIM_ThermalCode(pxSeat->Faulted ? pxSeat->Params[SIM_THERMAL_FAULT] : pxSeat->Sensor));
+    }
+
+    if(pxSeat->HasTarget)
+    {
+        SIM_ThermalTrack(pxSeat, ullNow);
+    }
+    if((SimLog != NULL_PTR) && ((SimSteps % SIM_THERMAL_LOG_STEPS) == 0))
+    {
+        fprintf(SimLog, "%.1f,%s,%u,%.1f,%.3f,%.3f\n", (double)ullNow / SIM_CPU_CLOCK_HZ, pxSeat->Name,
+                pxSeat->Level, dPower, pxSeat->Seat, pxSeat->Sensor);
+    }
+}
+
+static double SIM_ThermalRipple(const SimThermalSeat *pxSeat)
+{
+    double dMin;
+    double dMax;
+    uint8 ucBucket;
+
+    if(!pxSeat->HasTarget || !pxSeat->InBand || (pxSeat->Buckets == 0))
+    {
+        return -1.0;
+    }
+    dMin = pxSeat->BandMin[0];
+    dMax = pxSeat->BandMax[0];
+    for(ucBucket = 1; ucBucket < pxSeat->Buckets; ucBucket++)
+    {
+        dMin = (pxSeat->BandMin[ucBucket] < dMin) ? pxSeat->BandMin[ucBucket] : dMin;
+        dMax = (pxSeat->BandMax[ucBucket] > dMax) ? pxSeat->BandMax[ucBucket] : dMax;
+    }
+    return dMax - dMin;
+}
+
+static double SIM_ThermalSince(uint64 ullFrom, uint64 ullTo)
+{
+    return (ullTo == SIM_CLOCK_NEVER) ? -1.0 : (double)(ullTo - ullFrom) / SIM_CPU_CLOCK_HZ;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_ThermalReset(void)
+{
+    uint8 ucSeat;
+    for(ucSeat = 0; ucSeat < SIM_THERMAL_SEATS; ucSeat++)
+    {
+        SimSeats[ucSeat].On = FALSE;
+        SimSeats[ucSeat].Faulted = FALSE;
+        SimSeats[ucSeat].Replayed = FALSE;
+        memcpy(SimSeats[ucSeat].Params, SimDefaults, sizeof(SimDefaults));
+        SimSeats[ucSeat].Seat = SimDefaults[SIM_THERMAL_INITIAL];
+        SimSeats[ucSeat].Sensor = SimDefaults[SIM_THERMAL_INITIAL];
+        SimSeats[ucSeat].Level = 0;
+        SimSeats[ucSeat].HasTarget = FALSE;
+        SimSeats[ucSeat].Energy = 0;
+    }
+    SimNextStep = SIM_CLOCK_NEVER;
+    SimSteps = 0;
+}
+
+SimThermalParam SIM_ThermalParamByName(const char *pcName)
+{
+    uint8 ucParam;
+    for(ucParam = 0; ucParam < SIM_THERMAL_PARAMS; ucParam++)
+    {
+        if(strcmp(pcName, SimParamNames[ucParam]) == 0)
+        {
+            break;
+        }
+    }
+    return (SimThermalParam)ucParam;
+}
+
+void SIM_ThermalSet(uint8 ucSeat, SimThermalParam eParam, double dValue)
+{
+    SimThermalSeat *pxSeat = &SimSeats[ucSeat % SIM_THERMAL_SEATS];
+
+    switch(eParam)
+    {
+    case SIM_THERMAL_ON:
+        pxSeat->On = TRUE;
+        if(!pxSeat->Replayed)
+        {
+            SIM_AdcSetInput(pxSeat->Channel, SIM_ThermalCode(pxSeat->Sensor));
+        }
+        if(SimNextStep == SIM_CLOCK_NEVER)
+        {
+            SimNextStep = SIM_ClockCycles() + SIM_MS_TO_CYCLES(SIM_THERMAL_STEP_MS);
+        }
+        break;
+    case SIM_THERMAL_OFF:
+        pxSeat->On = FALSE;
+        break;
+    case SIM_THERMAL_FAULT:
+        pxSeat->Params[eParam] = dValue;
+        pxSeat->Faulted = TRUE;
+        break;
+    case SIM_THERMAL_CLEAR:
+        pxSeat->Faulted = FALSE;
+        break;
+    case SIM_THERMAL_INITIAL:
+        pxSeat->Params[eParam] = dValue;
+        pxSeat->Seat = dValue;
+        pxSeat->Sensor = dValue;
+        break;
+    case SIM_THERMAL_TARGET:
+        pxSeat->Params[eParam] = dValue;
+        pxSeat->HasTarget = TRUE;
+        pxSeat->TargetAt = SIM_ClockCycles();
+        pxSeat->FirstInBandAt = SIM_CLOCK_NEVER;
+        pxSeat->LastEntryAt = SIM_CLOCK_NEVER;
+        pxSeat->InBand = FALSE;
+        pxSeat->Rising = (dValue >= pxSeat->Seat) ? TRUE : FALSE;
+        pxSeat->Peak = pxSeat->Seat;
+        pxSeat->Energy = 0;
+        break;
+    case SIM_THERMAL_MASS:
+    case SIM_THERMAL_LOSS:
+        /* Both divide or scale the temperature change, keep them positive */
+        pxSeat->Params[eParam] = (dValue > 0) ? dValue : pxSeat->Params[eParam];
+        break;
+    default:
+        if(eParam < SIM_THERMAL_PARAMS)
+        {
+            pxSeat->Params[eParam] = dValue;
+        }
+        break;
+    }
+}
+
+boolean SIM_ThermalIsOn(uint8 ucSeat)
+{
+    return SimSeats[ucSeat % SIM_THERMAL_SEATS].On;
+}
+
+void SIM_ThermalReplaySensor(uint8 ucSeat)
+{
+    SimSeats[ucSeat % SIM_THERMAL_SEATS].Replayed = TRUE;
+}
+
+void SIM_ThermalGetMetrics(uint8 ucSeat, SimThermalMetrics *pxMetrics)
+{
+    const SimThermalSeat *pxSeat = &SimSeats[ucSeat % SIM_THERMAL_SEATS];
+    double dOvershoot = pxSeat->Rising ? (pxSeat->Peak - pxSeat->Params[SIM_THERMAL_TARGET])
+                                       : (pxSeat->Params[SIM_THERMAL_TARGET] - pxSeat->Peak);
+
+    pxMetrics->Target = pxSeat->Params[SIM_THERMAL_TARGET];
+    pxMetrics->RiseTime = pxSeat->HasTarget ? SIM_ThermalSince(pxSeat->TargetAt, pxSeat->FirstInBandAt) : -1.0;
+    pxMetrics->SettlingTime = (pxSeat->HasTarget && pxSeat->InBand) ? SIM_ThermalSince(pxSeat->TargetAt, pxSeat->LastEntryAt) : -1.0;
+    pxMetrics->Ripple = SIM_ThermalRipple(pxSeat);
+    pxMetrics->Overshoot = (pxSeat->HasTarget && (dOvershoot > 0)) ? dOvershoot : 0;
+    pxMetrics->EnergyJ = pxSeat->Energy;
+    pxMetrics->SeatC = pxSeat->Seat;
+    pxMetrics->SensorC = pxSeat->Sensor;
+}
+
+void SIM_ThermalSetLog(FILE *pxFile)
+{
+    SimLog = pxFile;
+    if(SimLog != NULL_PTR)
+    {
+        fprintf(SimLog, "time_s,seat,level,power_w,seat_c,sensor_c\n");
+    }
+}
+
+void SIM_ThermalReport(FILE *pxFile)
+{
+    SimThermalMetrics xMetrics;
+    uint8 ucSeat;
+
+    for(ucSeat = 0; ucSeat < SIM_THERMAL_SEATS; ucSeat++)
+    {
+        if(!SimSeats[ucSeat].On)
+        {
+            continue;
+        }
+        SIM_ThermalGetMetrics(ucSeat, &xMetrics);
+        fprintf(pxFile, "THERMAL %s target=%.1f rise_s=%.1f settling_s=%.1f overshoot_c=%.2f ripple_c=%.2f energy_j=%.0f seat_c=%.2f sensor_c=%.2f\n",
+                SimSeats[ucSeat].Name, xMetrics.Target, xMetrics.RiseTime, xMetrics.SettlingTime, xMetrics.Overshoot,
+                xMetrics.Ripple, xMetrics.EnergyJ, xMetrics.SeatC, xMetrics.SensorC);
+    }
+}
+
+uint64 SIM_ThermalNextEvent(void)
+{
+    return SimNextStep;
+}
+
+void SIM_ThermalProcess(uint64 ullNow)
+{
+    uint8 ucSeat;
+
+    while(SimNextStep <= ullNow)
+    {
+        for(ucSeat = 0; ucSeat < SIM_THERMAL_SEATS; ucSeat++)
+        {
+            if(SimSeats[ucSeat].On)
+            {
+                SIM_ThermalStep(&SimSeats[ucSeat], SimNextStep);
+            }
+        }
+        SimSteps++;
+        SimNextStep += SIM_MS_TO_CYCLES(SIM_THERMAL_STEP_MS);
+    }
+}
@@ -0,0 +1,93 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Thermal
+ *
+ * File Name: sim_thermal.h
+ *
+ * Description: Header file for the thermal model of the two seats. Each seat
+ *              is a lumped thermal mass heated by the power of the intensity
+ *              the application drives on its heater pins (blue and green LED)
+ *              and losing heat to the ambient air; the sensor follows the seat
+ *              temperature with a first order lag and feeds the ADC input of
+ *              the seat. With no sensor lag the plant is first order.
+ *
+ *                  mass * dT/dt   = power(level) - loss * (T - ambient)
+ *                  lag  * dS/dt   = T - S
+ *
+ *              Given a target temperature, the model measures the rise and
+ *              settling times, the overshoot, the ripple and the heater energy.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_THERMAL_H_
+#define SIM_THERMAL_H_
+
+#include <stdio.h>
+#include "std_types.h"
+
+#define SIM_THERMAL_DRIVER          0
+#define SIM_THERMAL_PASSENGER       1
+#define SIM_THERMAL_SEATS           2
+
+/* Heater levels, as decoded from the pins: green LOW, blue MEDIUM, both HIGH */
+#define SIM_THERMAL_LEVELS          4
+
+#define SIM_THERMAL_STEP_MS         100
+
+typedef enum
+{
+    SIM_THERMAL_ON,
+    SIM_THERMAL_OFF,
+    SIM_THERMAL_FAULT,              /* degrees C read instead of the sensor, the seat keeps its model */
+    SIM_THERMAL_CLEAR,              /* ends the fault */
+    SIM_THERMAL_AMBIENT,            /* degrees C */
+    SIM_THERMAL_INITIAL,            /* degrees C of seat and sensor */
+    SIM_THERMAL_MASS,               /* J/K */
+    SIM_THERMAL_LOSS,               /* W/K */
+    SIM_THERMAL_LAG,                /* s, 0 for no sensor lag */
+    SIM_THERMAL_POWER_LOW,          /* W */
+    SIM_THERMAL_POWER_MEDIUM,       /* W */
+    SIM_THERMAL_POWER_HIGH,         /* W */
+    SIM_THERMAL_TARGET,             /* degrees C, starts the step response metrics */
+    SIM_THERMAL_BAND,               /* degrees C around the target counted as settled */
+    SIM_THERMAL_PARAMS
+} SimThermalParam;
+
+typedef struct
+{
+    double Target;
+    double RiseTime;                /* s from the target to the first time within the band, -1 if never */
+    double SettlingTime;            /* s from the target to the last entry into the band, -1 if not settled */
+    double Overshoot;               /* degrees C of the seat past the target, 0 if none */
+    double Ripple;                  /* degrees C peak to peak of the seat over the last 10 minutes settled, -1 if not settled */
+    double EnergyJ;                 /* heater energy since the target */
+    double SeatC;
+    double SensorC;
+} SimThermalMetrics;
+
+void SIM_ThermalReset(void);
+
+/* Parameter names used by the scripts, SIM_THERMAL_PARAMS when unknown */
+SimThermalParam SIM_ThermalParamByName(const char *pcName);
+
+void SIM_ThermalSet(uint8 ucSeat, SimThermalParam eParam, double dValue);
+
+boolean SIM_ThermalIsOn(uint8 ucSeat);
+
+/* The sensor input of the seat comes from a replayed trace (see sim_replay.h),
+ * the model only runs for the metrics */
+void SIM_ThermalReplaySensor(uint8 ucSeat);
+
+void SIM_ThermalGetMetrics(uint8 ucSeat, SimThermalMetrics *pxMetrics);
+
+/* One CSV line per second and seat: time_s,seat,level,power_w,seat_c,sensor_c */
+void SIM_ThermalSetLog(FILE *pxFile);
+
+void SIM_ThermalReport(FILE *pxFile);
+
+uint64 SIM_ThermalNextEvent(void);
+void SIM_ThermalProcess(uint64 ullNow);
+
+#endif /* SIM_THERMAL_H_ */
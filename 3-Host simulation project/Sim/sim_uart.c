@@ -0,0 +1,302 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - UART0
+ *
+ * File Name: sim_uart.c
+ *
+ * Description: Source file for the UART0 model.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#include "sim_uart.h"
+#include "sim_clock.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+
+#define SIM_UART_DR                 (SIM_UART0_BASE + 0x000)
+#define SIM_UART_RSR                (SIM_UART0_BASE + 0x004)
+#define SIM_UART_FR                 (SIM_UART0_BASE + 0x018)
+#define SIM_UART_IBRD               (SIM_UART0_BASE + 0x024)
+#define SIM_UART_FBRD               (SIM_UART0_BASE + 0x028)
+#define SIM_UART_LCRH               (SIM_UART0_BASE + 0x02C)
+#define SIM_UART_CTL                (SIM_UART0_BASE + 0x030)
+#define SIM_UART_IFLS               (SIM_UART0_BASE + 0x034)
+#define SIM_UART_IM                 (SIM_UART0_BASE + 0x038)
+#define SIM_UART_RIS                (SIM_UART0_BASE + 0x03C)
+#define SIM_UART_MIS                (SIM_UART0_BASE + 0x040)
+#define SIM_UART_ICR                (SIM_UART0_BASE + 0x044)
+#define SIM_UART_DMACTL             (SIM_UART0_BASE + 0x048)
+
+#define SIM_UART_FR_BUSY            0x08
+#define SIM_UART_FR_RXFE            0x10
+#define SIM_UART_FR_TXFF            0x20
+#define SIM_UART_FR_RXFF            0x40
+#define SIM_UART_FR_TXFE            0x80
+#define SIM_UART_RSR_OE             0x08
+#define SIM_UART_LCRH_PEN           0x02
+#define SIM_UART_LCRH_STP2          0x08
+#define SIM_UART_LCRH_FEN           0x10
+#define SIM_UART_LCRH_WLEN_POS      5
+#define SIM_UART_CTL_UARTEN         0x001
+#define SIM_UART_CTL_HSE            0x020
+#define SIM_UART_CTL_TXE            0x100
+#define SIM_UART_CTL_RXE            0x200
+#define SIM_UART_INT_TX             0x20
+#define SIM_UART_DMACTL_TXDMAE      0x02
+#define SIM_UART_IFLS_TX_MASK       0x07
+#define SIM_UART_IFLS_RESET         0x12
+
+#define SIM_UART_FIFO_DEPTH         16
+
+/* Transmit FIFO entries at or under each TXIFLSEL level: 1/8, 1/4, 1/2, 3/4, 7/8 */
+static const uint8 SimTxLevels[8] = { 2, 4, 8, 12, 14, 8, 8, 8 };
+
+/* Set in UARTDR before each access: still there afterwards means it was read */
+#define SIM_UART_READ_MARK          0x80000000UL
+
+typedef struct
+{
+    uint8 Data[SIM_UART_FIFO_DEPTH];
+    uint8 Head;
+    uint8 Count;
+} SimUartFifo;
+
+static SimUartFifo SimTxFifo;
+static SimUartFifo SimRxFifo;
+static boolean SimTxShifting = FALSE;
+static uint8 SimTxShiftByte = 0;
+static uint64 SimTxDoneAt = SIM_CLOCK_NEVER;
+static uint32 SimTxBytes = 0;
+static uint32 SimRxOverruns = 0;
+static SimUartOutput SimOutput = NULL_PTR;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint8 SIM_UartDepth(void)
+{
+    return (SIM_REG_WORD(SIM_UART_LCRH) & SIM_UART_LCRH_FEN) ? SIM_UART_FIFO_DEPTH : 1;
+}
+
+static void SIM_UartPush(SimUartFifo *pxFifo, uint8 ucByte)
+{
+    pxFifo->Data[(pxFifo->Head + pxFifo->Count) % SIM_UART_FIFO_DEPTH] = ucByte;
+    pxFifo->Count++;
+}
+
+static uint8 SIM_UartPop(SimUartFifo *pxFifo)
+{
+    uint8 ucByte = pxFifo->Data[pxFifo->Head];
+    pxFifo->Head = (pxFifo->Head + 1) % SIM_UART_FIFO_DEPTH;
+    pxFifo->Count--;
+    return ucByte;
+}
+
+static void SIM_UartUpdateFlags(void)
+{
+    uint8 ucDepth = SIM_UartDepth();
+    uint32 ulFlags = 0;
+
+    ulFlags |= (SimTxFifo.Count == 0) ? SIM_UART_FR_TXFE : 0;
+    ulFlags |= (SimTxFifo.Count >= ucDepth) ? SIM_UART_FR_TXFF : 0;
+    ulFlags |= (SimRxFifo.Count == 0) ? SIM_UART_FR_RXFE : 0;
+    ulFlags |= (SimRxFifo.Count >= ucDepth) ? SIM_UART_FR_RXFF : 0;
+    ulFlags |= (SimTxShifting || (SimTxFifo.Count != 0)) ? SIM_UART_FR_BUSY : 0;
+    SIM_REG_WORD(SIM_UART_FR) = ulFlags;
+
+    /* The interrupt line stays up as long as a raised flag is unmasked */
+    SIM_REG_WORD(SIM_UART_MIS) = SIM_REG_WORD(SIM_UART_RIS) & SIM_REG_WORD(SIM_UART_IM);
+    if(SIM_REG_WORD(SIM_UART_MIS) != 0)
+    {
+        SIM_NvicPend(SIM_UART0_IRQ);
+    }
+}
+
+/* Entries under which the transmit interrupt is raised, the holding register
+ * going empty without FEN */
+static uint8 SIM_UartTxLevel(void)
+{
+    if(!(SIM_REG_WORD(SIM_UART_LCRH) & SIM_UART_LCRH_FEN))
+    {
+        return 0;
+    }
+    return SimTxLevels[SIM_REG_WORD(SIM_UART_IFLS) & SIM_UART_IFLS_TX_MASK];
+}
+
+/* Moves the next byte of the transmit FIFO to the shift register */
+static void SIM_UartStartShift(uint64 ullStart)
+{
+    if(SimTxFifo.Count != 0)
+    {
+        /* TXRIS is raised when the FIFO passes through the level, not while it sits under it */
+        if(SimTxFifo.Count == SIM_UartTxLevel() + 1)
+        {
+            SIM_REG_WORD(SIM_UART_RIS) |= SIM_UART_INT_TX;
+        }
+        SimTxShiftByte = SIM_UartPop(&SimTxFifo);
+        SimTxShifting = TRUE;
+        SimTxDoneAt = ullStart + SIM_UartFrameCycles();
+    }
+    else
+    {
+        SimTxShifting = FALSE;
+        SimTxDoneAt = SIM_CLOCK_NEVER;
+    }
+}
+
+static void SIM_UartTransmit(uint8 ucByte)
+{
+    uint32 ulControl = SIM_REG_WORD(SIM_UART_CTL);
+
+    /* A full FIFO drops the write, as the hardware does */
+    if(((ulControl & (SIM_UART_CTL_UARTEN | SIM_UART_CTL_TXE)) != (SIM_UART_CTL_UARTEN | SIM_UART_CTL_TXE)) ||
+       (SimTxFifo.Count >= SIM_UartDepth()))
+    {
+        return;
+    }
+    SIM_UartPush(&SimTxFifo, ucByte);
+    if(!SimTxShifting)
+    {
+        SIM_UartStartShift(SIM_ClockCycles());
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SIM_UartReset(void)
+{
+    SimTxFifo.Head = SimTxFifo.Count = 0;
+    SimRxFifo.Head = SimRxFifo.Count = 0;
+    SimTxShifting = FALSE;
+    SimTxDoneAt = SIM_CLOCK_NEVER;
+    SimTxBytes = 0;
+    SimRxOverruns = 0;
+    SIM_REG_WORD(SIM_UART_IFLS) = SIM_UART_IFLS_RESET;
+    SIM_UartUpdateFlags();
+}
+
+void SIM_UartSetOutput(SimUartOutput pfOutput)
+{
+    SimOutput = pfOutput;
+}
+
+void SIM_UartReceive(uint8 ucByte)
+{
+    if(!(SIM_REG_WORD(SIM_UART_CTL) & SIM_UART_CTL_RXE))
+    {
+        return;
+    }
+    if(SimRxFifo.Count >= SIM_UartDepth())
+    {
+        SIM_REG_WORD(SIM_UART_RSR) |= SIM_UART_RSR_OE;
+        SimRxOverruns++;
+    }
+    else
+    {
+        SIM_UartPush(&SimRxFifo, ucByte);
+    }
+    SIM_UartUpdateFlags();
+}
+
+/* Start bit, data bits, parity and stop bits, each one 16 (or 8 with HSE)
+ * sample clocks of IBRD + FBRD/64 system clocks */
+uint64 SIM_UartFrameCycles(void)
+{
+    uint32 ulLineControl = SIM_REG_WORD(SIM_UART_LCRH);
+    uint64 ullDivisor = ((uint64)SIM_REG_WORD(SIM_UART_IBRD) * 64) + (SIM_REG_WORD(SIM_UART_FBRD) & 0x3F);
+    uint64 ullBits = 1 + 5 + ((ulLineControl >> SIM_UART_LCRH_WLEN_POS) & 0x3) +
+                     ((ulLineControl & SIM_UART_LCRH_PEN) ? 1 : 0) + ((ulLineControl & SIM_UART_LCRH_STP2) ? 2 : 1);
+    uint64 ullSampling = (SIM_REG_WORD(SIM_UART_CTL) & SIM_UART_CTL_HSE) ? 8 : 16;
+
+    if(ullDivisor == 0)
+    {
+        return 1;
+    }
+    return (ullBits * ullSampling * ullDivisor) / 64;
+}
+
+boolean SIM_UartTxDmaRequest(void)
+{
+    uint32 ulControl = SIM_REG_WORD(SIM_UART_CTL);
+
+    return ((SIM_REG_WORD(SIM_UART_DMACTL) & SIM_UART_DMACTL_TXDMAE) &&
+            ((ulControl & (SIM_UART_CTL_UARTEN | SIM_UART_CTL_TXE)) == (SIM_UART_CTL_UARTEN | SIM_UART_CTL_TXE)) &&
+            (SimTxFifo.Count < SIM_UartDepth())) ? TRUE : FALSE;
+}
+
+void SIM_UartDmaWrite(uint8 ucByte)
+{
+    SIM_UartTransmit(ucByte);
+    SIM_UartUpdateFlags();
+}
+
+uint32 SIM_UartGetTxBytes(void)
+{
+    return SimTxBytes;
+}
+
+uint32 SIM_UartGetRxOverruns(void)
+{
+    return SimRxOverruns;
+}
+
+void SIM_UartPrepare(uint32 ulAddress)
+{
+    if(ulAddress == SIM_UART_DR)
+    {
+        SIM_REG_WORD(SIM_UART_DR) = SIM_UART_READ_MARK | ((SimRxFifo.Count != 0) ? SimRxFifo.Data[SimRxFifo.Head] : 0);
+    }
+    else if(ulAddress == SIM_UART_ICR)
+    {
+        /* Write-only: reading 0 makes every write of a 1 visible */
+        SIM_REG_WORD(SIM_UART_ICR) = 0;
+    }
+}
+
+void SIM_UartComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter)
+{
+    if(ulAddress == SIM_UART_DR)
+    {
+        if(ulAfter & SIM_UART_READ_MARK)
+        {
+            if(SimRxFifo.Count != 0)
+            {
+                (void)SIM_UartPop(&SimRxFifo);
+            }
+        }
+        else
+        {
+            SIM_UartTransmit((uint8)ulAfter);
+        }
+    }
+    else if(ulAddress == SIM_UART_ICR)
+    {
+        SIM_REG_WORD(SIM_UART_RIS) &= ~ulAfter;
+    }
+    SIM_UartUpdateFlags();
+}
+
+uint64 SIM_UartNextEvent(void)
+{
+    return SimTxDoneAt;
+}
+
+void SIM_UartProcess(uint64 ullNow)
+{
+    while(SimTxShifting && (SimTxDoneAt <= ullNow))
+    {
+        SimTxBytes++;
+        if(SimOutput != NULL_PTR)
+        {
+            SimOutput(SimTxShiftByte);
+        }
+        /* Back to back frames keep the line timing exact */
+        SIM_UartStartShift(SimTxDoneAt);
+    }
+    SIM_UartUpdateFlags();
+}
@@ -0,0 +1,61 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - UART0
+ *
+ * File Name: sim_uart.h
+ *
+ * Description: Header file for the UART0 model. Bytes written to UARTDR go
+ *              through the transmit FIFO (one entry deep unless FEN is set)
+ *              and the shift register at the baud rate programmed in
+ *              UARTIBRD/UARTFBRD, then to the output function. Received
+ *              bytes are pushed by the script; UARTFR follows both FIFOs.
+ *              The transmit interrupt (TXRIS) is raised when the FIFO drains
+ *              through the UARTIFLS level and pends IRQ 5 while unmasked in
+ *              UARTIM, until cleared in UARTICR. With TXDMAE set in
+ *              UARTDMACTL the transmit FIFO also requests bytes from the
+ *              uDMA model (sim_dma.h) while it has room.
+ *
+ * Author: Omar Talaat
+ *
+ *******************************************************************************/
+
+#ifndef SIM_UART_H_
+#define SIM_UART_H_
+
+#include "std_types.h"
+
+#define SIM_UART0_BASE              0x4000C000UL
+#define SIM_UART0_SIZE              0x1000UL
+#define SIM_UART0_IRQ               5
+
+typedef void (*SimUartOutput)(uint8 ucByte);
+
+void SIM_UartReset(void);
+
+/* Called with every transmitted byte when its stop bit is done */
+void SIM_UartSetOutput(SimUartOutput pfOutput);
+
+/* Byte arriving on U0RX, dropped like an overrun when the receive FIFO is full */
+void SIM_UartReceive(uint8 ucByte);
+
+/* Cycles to send one frame with the current line settings */
+uint64 SIM_UartFrameCycles(void);
+
+/* TXDMAE set and room in the transmit FIFO */
+boolean SIM_UartTxDmaRequest(void);
+
+/* Byte written to UARTDR by the uDMA model */
+void SIM_UartDmaWrite(uint8 ucByte);
+
+uint32 SIM_UartGetTxBytes(void);
+
+uint32 SIM_UartGetRxOverruns(void);
+
+/* Register access hooks called by the machine */
+void SIM_UartPrepare(uint32 ulAddress);
+void SIM_UartComplete(uint32 ulAddress, uint32 ulBefore, uint32 ulAfter);
+
+uint64 SIM_UartNextEvent(void);
+void SIM_UartProcess(uint64 ullNow);
+
+#endif /* SIM_UART_H_ */
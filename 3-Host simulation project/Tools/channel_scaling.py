@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Run the scaling benchmark from 2 to 64 heating channels and show where the design stops scaling.
+
+seat_scaling runs the seat tasks of Seat/seat.c with the tasks, queues and
+semaphores of one seat of main.c for every channel. For every channel count
+the table gives the CPU load, the heap taken on the host and per channel by
+tasks (TCB and stack), queues, semaphores and error event groups (one per 11
+channels), the task stacks in bytes of the target against the target heap
+(configTOTAL_HEAP_SIZE of the application), and the overruns and worst
+lateness of the intensity control loops and of the display loop. The
+channel counts where the control loops first miss their period and where the
+stacks alone outgrow the target heap are reported at the end.
+
+    channel_scaling.py
+    channel_scaling.py -b build/seat_scaling --channels 2,3,4,5,6 --seconds 120 -o scaling.json
+
+The channel counts are run in parallel (sim_runner.py, -J); every number of
+the table is simulated, none depends on the other runs sharing the machine.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+from sim_runner import RunError, add_jobs_argument, run_all, run_metrics
+
+HOST_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+APP_CONFIG = os.path.join(HOST_DIR, "..", "1-Application project", "FreeRTOS_Proj1", "FreeRTOSConfig.h")
+
+# StackType_t of the Cortex-M4 port
+TARGET_STACK_WORD_BYTES = 4
+
+
+def target_heap_size():
+    """configTOTAL_HEAP_SIZE of the application, None when it cannot be read."""
+    try:
+        with open(APP_CONFIG) as f:
+            match = re.search(r"#define\s+configTOTAL_HEAP_SIZE\s+\(\(size_t\)\((\d+)\)\)", f.read())
+    except OSError:
+        return None
+    return int(match.group(1)) if match else None
+
+
+def run_channels(binary, channels, seconds):
+    return run_metrics([binary, "-n", str(channels), "-t", str(seconds)], "%d channels" % channels)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-b", "--binary", default=os.path.join(HOST_DIR, "build", "seat_scaling"),
+                        help="seat_scaling executable")
+    parser.add_argument("--channels", default="2,4,8,16,32,64", help="channel counts to run")
+    parser.add_argument("--seconds", type=int, default=60, help="simulated seconds of every run")
+    parser.add_argument("-o", "--output", help="JSON file receiving the metrics of every run")
+    add_jobs_argument(parser)
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    heap_limit = target_heap_size()
+    results = []
+    late = None
+    outgrown = None
+
+    print("%8s %7s %9s %8s %7s %7s %7s %7s %12s %10s %13s %13s %7s" % (
+        "channels", "cpu_%", "heap_used", "heap/ch", "tasks", "queues", "sems", "groups", "target_stack",
+        "ctl_overrun", "ctl_late_us", "disp_late_us", "starved"))
+    counts = [int(count) for count in args.channels.split(",")]
+    try:
+        runs = run_all(lambda channels: run_channels(args.binary, channels, args.seconds), counts, args.jobs)
+    except RunError as error:
+        sys.exit(str(error))
+    for channels, metrics in zip(counts, runs):
+        results.append(metrics)
+        per_channel = metrics["per_channel"]
+        control = metrics["control_loops"]
+        display = metrics["display_loop"]
+        stack_bytes = metrics["stack_words"] * TARGET_STACK_WORD_BYTES
+        starved = control["starved"] + metrics["sensor_loops"]["starved"] + display["starved"]
+        print("%8d %7.1f %9d %8d %7d %7d %7d %7d %12d %10d %13d %13d %7d" % (
+            channels, metrics["cpu_load_pct"], metrics["heap"]["used"], per_channel["heap"],
+            per_channel["tasks"], per_channel["queues"], per_channel["semaphores"], per_channel["event_groups"],
+            stack_bytes,
+            control["overruns"], control["max_late_us"], display["max_late_us"], starved))
+        if late is None and control["max_late_us"] >= control["period_ms"] * 1000:
+            late = channels
+        if outgrown is None and heap_limit is not None and stack_bytes > heap_limit:
+            outgrown = channels
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump({"seconds": args.seconds, "target_heap": heap_limit, "runs": results}, f, indent=2)
+            f.write("\n")
+    if late is None:
+        print("the control loops were never late by a whole period")
+    else:
+        print("the control loops were first late by a whole period at %d channels" % late)
+    if heap_limit is not None:
+        if outgrown is None:
+            print("the task stacks fit the %d byte target heap at every count" % heap_limit)
+        else:
+            print("the task stacks alone outgrow the %d byte target heap at %d channels" % (heap_limit, outgrown))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
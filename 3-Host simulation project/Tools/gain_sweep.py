@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Sweep the intensity thresholds of the control tasks and keep the Pareto-optimal sets.
+
+The intensity control task of every seat (vSeatIntensityTask) drives HIGH,
+MEDIUM or LOW when the seat is at least SEAT_HIGH/MED/LOW_INTENSITY_DIFF
+degrees under the required temperature (10/5/2 in seat.h). Every set of the
+grid with high > medium > low is run on every scenario script (and seed)
+under the thermal model with seat_heater -g, all in parallel (sim_runner.py).
+Over every seat given a target a set scores:
+
+    overshoot_c   the largest overshoot past the target
+    settling_s    the longest settling time, none when a seat never settled
+    energy_wh     the heater energy from the targets on, added up
+
+All three are better when lower, differences under RESOLUTION count as
+ties. The sets no other set beats on all three at once are the Pareto
+front (rank 1), the front of the rest is rank 2, and so on. The table lists
+every set by rank; the front is then printed as the #defines of seat.h, to
+paste over the current ones.
+
+    gain_sweep.py                                                  # Scenarios/suite/*.txt
+    gain_sweep.py --high 8,10,12 --medium 4,5,6 --low 1,2 Scenarios/suite/level_changes.txt
+    gain_sweep.py -r 1 -r 2 -o sweep.json
+"""
+
+import argparse
+import glob
+import itertools
+import json
+import math
+import os
+import re
+import sys
+
+from sim_runner import RunError, add_jobs_argument, run_all, run_metrics
+
+HOST_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+APP_SEAT = os.path.join(HOST_DIR, "..", "1-Application project", "FreeRTOS_Proj1", "Seat", "seat.h")
+
+LEVELS = ("high", "medium", "low")
+DEFINES = ("SEAT_HIGH_INTENSITY_DIFF", "SEAT_MED_INTENSITY_DIFF", "SEAT_LOW_INTENSITY_DIFF")
+OBJECTIVES = ("overshoot_c", "settling_s", "energy_wh")
+
+# Smallest difference of each objective that tells two sets apart: the model
+# steps 100 ms and the control tasks see whole degrees
+RESOLUTION = {"overshoot_c": 0.05, "settling_s": 1.0, "energy_wh": 0.05}
+
+
+def firmware_diffs():
+    """(high, medium, low) of seat.h, None when they cannot be read."""
+    try:
+        with open(APP_SEAT) as f:
+            source = f.read()
+    except OSError:
+        return None
+    values = [re.search(r"#define\s+%s\s+(\d+)" % name, source) for name in DEFINES]
+    return tuple(int(match.group(1)) for match in values) if all(values) else None
+
+
+def grid(high, medium, low):
+    return [diffs for diffs in itertools.product(high, medium, low) if diffs[0] > diffs[1] > diffs[2]]
+
+
+def run_set(binary, diffs, script, seed):
+    command = [binary, "-s", script, "-g", ",".join(str(diff) for diff in diffs)]
+    if seed is not None:
+        command += ["-r", str(seed)]
+    return run_metrics(command, "%s with -g %d,%d,%d" % ((script,) + diffs))
+
+
+def score(runs):
+    """Objectives of one set over the metrics of its runs, None without any seat given a target."""
+    seats = [seat for metrics in runs for seat in (metrics["seats"] or {}).values() if seat["target_c"] is not None]
+    if not seats:
+        return None
+    settling = [seat["settling_s"] for seat in seats]
+    return {
+        "overshoot_c": max(seat["overshoot_c"] for seat in seats),
+        "settling_s": math.inf if None in settling else max(settling),
+        "energy_wh": sum(seat["energy_j"] or 0.0 for seat in seats) / 3600.0,
+        "seats": len(seats),
+        "unsettled": settling.count(None),
+    }
+
+
+def dominates(a, b):
+    return (all(a[key] <= b[key] + RESOLUTION[key] for key in OBJECTIVES) and
+            any(a[key] < b[key] - RESOLUTION[key] for key in OBJECTIVES))
+
+
+def rank(scores):
+    """Pareto rank of every entry of scores, 1 for the front."""
+    ranks = [0] * len(scores)
+    left = set(range(len(scores)))
+    level = 0
+    while left:
+        level += 1
+        front = [i for i in left if not any(dominates(scores[j], scores[i]) for j in left if j != i)]
+        for i in front:
+            ranks[i] = level
+        left -= set(front)
+    return ranks
+
+
+def number(value, fmt):
+    return "-" if value is None or math.isinf(value) else fmt % value
+
+
+def print_defines(diffs, result, current):
+    print("/* Intensity thresholds of Tools/gain_sweep.py: overshoot %s C, settling %s s, %s Wh%s */" % (
+        number(result["overshoot_c"], "%.2f"), number(result["settling_s"], "%.1f"),
+        number(result["energy_wh"], "%.2f"), ", the current ones" if diffs == current else ""))
+    for name, diff in zip(DEFINES, diffs):
+        print("#define %-32s%d" % (name, diff))
+
+
+def parse_list(text):
+    return [int(value) for value in text.split(",")]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("scripts", nargs="*", help="scenario scripts, Scenarios/suite/*.txt by default")
+    parser.add_argument("-b", "--binary", default=os.path.join(HOST_DIR, "build", "seat_heater"),
+                        help="seat_heater executable")
+    parser.add_argument("--high", type=parse_list, default="6,8,10,12", help="HIGH thresholds in degrees")
+    parser.add_argument("--medium", type=parse_list, default="3,5,7", help="MEDIUM thresholds in degrees")
+    parser.add_argument("--low", type=parse_list, default="1,2,3", help="LOW thresholds in degrees")
+    parser.add_argument("-r", "--seed", type=int, action="append", dest="seeds",
+                        help="add the random stimulus drawn from this seed, once per seed when repeated")
+    parser.add_argument("-o", "--output", help="JSON file receiving the score and rank of every set")
+    add_jobs_argument(parser)
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    scripts = args.scripts or sorted(glob.glob(os.path.join(HOST_DIR, "Scenarios", "suite", "*.txt")))
+    if not scripts:
+        sys.exit("no scenario scripts")
+    sets = grid(args.high, args.medium, args.low)
+    current = firmware_diffs()
+    if current is not None and current not in sets:
+        sets.append(current)
+    seeds = args.seeds or [None]
+    runs = [(diffs, script, seed) for diffs in sets for script in scripts for seed in seeds]
+
+    try:
+        metrics = run_all(lambda run: run_set(args.binary, *run), runs, args.jobs)
+    except RunError as error:
+        sys.exit(str(error))
+    per_set = len(scripts) * len(seeds)
+    scores = [score(metrics[index * per_set:(index + 1) * per_set]) for index in range(len(sets))]
+    if any(result is None for result in scores):
+        sys.exit("no seat of the scripts is given a thermal target, nothing to score")
+    ranks = rank(scores)
+
+    order = sorted(range(len(sets)), key=lambda i: (ranks[i], scores[i]["settling_s"], scores[i]["energy_wh"]))
+    print("%4s %4s %6s %4s %11s %11s %10s %10s" % ("rank", "high", "medium", "low", "overshoot_c", "settling_s",
+                                                 "energy_wh", "unsettled"))
+    for i in order:
+        print("%4d %4d %6d %4d %11s %11s %10s %10s%s" % (
+            (ranks[i],) + sets[i] + (number(scores[i]["overshoot_c"], "%.2f"), number(scores[i]["settling_s"], "%.1f"),
+                                     number(scores[i]["energy_wh"], "%.2f"),
+                                     "%d/%d" % (scores[i]["unsettled"], scores[i]["seats"]),
+                                     "  current" if sets[i] == current else "")))
+
+    front = [i for i in order if ranks[i] == 1]
+    print("\n%d of %d sets on the Pareto front over %d run(s) each:\n" % (len(front), len(sets), per_set))
+    for i in front:
+        print_defines(sets[i], scores[i], current)
+        print()
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump({"scripts": scripts, "seeds": seeds, "current": current,
+                       "sets": [dict(zip(LEVELS, sets[i]), rank=ranks[i],
+                                     **{key: (None if isinstance(value, float) and math.isinf(value) else value)
+                                        for key, value in scores[i].items()}) for i in order]}, f, indent=2)
+            f.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
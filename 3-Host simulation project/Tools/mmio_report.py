@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Rank the register pollers of a host run from its register access profile.
+
+Run seat_heater with `-m mmio.csv`: every register access of the target code
+is counted per register and per call site, and the time spent re-reading a
+register that did not change (a busy-wait loop) is summed per call site. The
+call sites are named with addr2line from the debug information of the
+executable and the registers from tm4c123gh6pm_registers.h of the
+application. The first table ranks the busy-wait loops by the simulated time
+they spent waiting, the best candidates for interrupt-driven I/O; the second
+gives the accesses per register and the third per function.
+
+    mmio_report.py mmio.csv
+    mmio_report.py mmio.csv -b build/seat_heater --top 20 -o pollers.json
+"""
+
+import argparse
+import collections
+import json
+import os
+import re
+import subprocess
+import sys
+
+HOST_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+APP_REGISTERS = os.path.join(HOST_DIR, "..", "1-Application project", "FreeRTOS_Proj1", "tm4c123gh6pm_registers.h")
+
+REGISTER_DEFINE = re.compile(r"#define\s+(\w+)\s+\(\*\(\(volatile uint32 \*\)(0x[0-9A-Fa-f]+)\)\)")
+HEADER_LINE = re.compile(r"#\s*cycles=(\d+)\s+hz=(\d+)\s+dropped=(\d+)")
+
+
+def read_registers(path):
+    """Register names by address, the first name when several share one."""
+    names = {}
+    try:
+        with open(path) as f:
+            for match in REGISTER_DEFINE.finditer(f.read()):
+                names.setdefault(int(match.group(2), 16), match.group(1))
+    except OSError:
+        pass
+    return names
+
+
+def read_profile(path):
+    run = {"cycles": 0, "hz": 1, "dropped": 0}
+    sites = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            match = HEADER_LINE.match(line)
+            if match:
+                run = {"cycles": int(match.group(1)), "hz": int(match.group(2)), "dropped": int(match.group(3))}
+                continue
+            if not line or line.startswith("address"):
+                continue
+            address, caller, reads, writes, poll_reads, poll_cycles = line.split(",")
+            sites.append({"address": int(address, 16), "caller": caller, "reads": int(reads),
+                          "writes": int(writes), "poll_reads": int(poll_reads), "poll_cycles": int(poll_cycles)})
+    return run, sites
+
+
+def resolve_callers(binary, callers):
+    """Function and source line of every call site, the offset itself when addr2line cannot tell."""
+    names = {caller: (caller, "?") for caller in callers}
+    if not callers:
+        return names
+    try:
+        result = subprocess.run(["addr2line", "-f", "-e", binary] + list(callers),
+                                stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+    except OSError:
+        return names
+    lines = result.stdout.splitlines()
+    for index, caller in enumerate(callers):
+        if 2 * index + 1 >= len(lines):
+            break
+        function = lines[2 * index]
+        location = lines[2 * index + 1].split(" (")[0]
+        if function != "??":
+            names[caller] = (function, os.path.basename(location))
+    return names
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("profile", help="register access profile written by seat_heater -m")
+    parser.add_argument("-b", "--binary", default=os.path.join(HOST_DIR, "build", "seat_heater"),
+                        help="seat_heater executable that wrote the profile")
+    parser.add_argument("--registers", default=APP_REGISTERS, help="register header of the application")
+    parser.add_argument("--top", type=int, default=15, help="rows of every table")
+    parser.add_argument("-o", "--output", help="JSON file receiving the ranked busy-wait loops")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    registers = read_registers(args.registers)
+    run, sites = read_profile(args.profile)
+    callers = resolve_callers(args.binary, sorted(set(site["caller"] for site in sites)))
+    cycles_per_us = run["hz"] / 1e6
+
+    def register_name(address):
+        return registers.get(address, "0x%08X" % address)
+
+    # Call sites of one source line (a driver function inlined in several places) are one loop
+    loops = {}
+    for site in sites:
+        function, line = callers[site["caller"]]
+        key = (function, line, site["address"])
+        if key not in loops:
+            loops[key] = {"function": function, "line": line, "register": register_name(site["address"]),
+                          "reads": 0, "writes": 0, "poll_reads": 0, "poll_cycles": 0}
+        for count in ("reads", "writes", "poll_reads", "poll_cycles"):
+            loops[key][count] += site[count]
+    sites = list(loops.values())
+
+    pollers = sorted((site for site in sites if site["poll_cycles"]), key=lambda site: -site["poll_cycles"])
+    print("busy-wait loops over %.3f simulated s" % (run["cycles"] / run["hz"]))
+    print("%-28s %-20s %-18s %10s %10s %10s %7s %10s" % ("function", "line", "register", "reads", "polls",
+                                                        "wait_ms", "run_%", "avg_us"))
+    for site in pollers[:args.top]:
+        print("%-28s %-20s %-18s %10d %10d %10.3f %7.3f %10.3f" % (
+            site["function"][:28], site["line"][:20], site["register"][:18], site["reads"], site["poll_reads"],
+            site["poll_cycles"] / cycles_per_us / 1000, 100.0 * site["poll_cycles"] / max(run["cycles"], 1),
+            site["poll_cycles"] / cycles_per_us / site["poll_reads"]))
+
+    by_register = collections.defaultdict(lambda: [0, 0, 0])
+    by_function = collections.defaultdict(lambda: [0, 0, 0])
+    for site in sites:
+        for totals in (by_register[site["register"]], by_function[site["function"]]):
+            totals[0] += site["reads"]
+            totals[1] += site["writes"]
+            totals[2] += site["poll_cycles"]
+    for title, totals in (("register", by_register), ("function", by_function)):
+        print("\n%-28s %12s %12s %10s" % (title, "reads", "writes", "wait_ms"))
+        for name, (reads, writes, wait) in sorted(totals.items(), key=lambda item: (-item[1][2], -sum(item[1][:2])))[:args.top]:
+            print("%-28s %12d %12d %10.3f" % (name[:28], reads, writes, wait / cycles_per_us / 1000))
+
+    if run["dropped"]:
+        print("\n%d accesses not profiled, the site table was full" % run["dropped"])
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump({"simulated_s": run["cycles"] / run["hz"], "pollers": [
+                {key: site[key] for key in ("function", "line", "register", "reads", "writes", "poll_reads",
+                                            "poll_cycles")} for site in pollers]}, f, indent=2)
+            f.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""Fail when a benchmark metric got worse than its checked-in baseline.
+
+The benchmark scenarios of Scenarios/suite/ are run on the host build (see
+scenario_suite.py) and their button latency, CPU load, peak heap use and
+heater energy are compared with Baselines/perf_baseline.json, and so are the
+flash (code + ro data) and RAM (rw data) of the image, read from the linker
+map of the board build as by trace_levels.py. Every metric is
+better when lower. It may grow by its tolerance, the larger of a share of
+the baseline ("pct") and an absolute amount ("abs"), and never past its
+"max" when one is set (e.g. the flash left to FreeRTOS_Proj1.out next to the
+other code). The host runs are deterministic, so the tolerances only absorb
+changes too small to matter. A metric measured without a baseline, or in
+the baseline but not measured, fails the gate as well.
+
+    perf_gate.py                                            # exit status 1 on a regression
+    perf_gate.py --map Release/FreeRTOS_Proj1.map           # another map than that of the Debug build
+    perf_gate.py --update                                   # take the current numbers as the baseline
+"""
+
+import argparse
+import glob
+import json
+import os
+import sys
+
+from scenario_suite import revision, run_suite
+from sim_runner import RunError, add_jobs_argument
+from trace_levels import read_map
+
+HOST_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_BASELINE = os.path.join(HOST_DIR, "Baselines", "perf_baseline.json")
+DEFAULT_MAP = os.path.join(os.path.dirname(HOST_DIR), "1-Application project", "FreeRTOS_Proj1",
+                           "Debug", "FreeRTOS_Proj1.map")
+
+# Tolerance of a new metric, by the last part of its name
+DEFAULT_TOLERANCES = {
+    "cpu_load_pct": {"pct": 10, "abs": 0.1},
+    "p99": {"pct": 10, "abs": 5},
+    "max": {"pct": 10, "abs": 5},
+    "heap_peak": {"abs": 64},
+    "energy_j": {"pct": 2},
+    "total_wh": {"pct": 2},
+    "flash": {"abs": 256},
+    "ram": {"abs": 64},
+}
+
+
+def scenario_metrics(name, metrics):
+    """Flat {metric: value} of one scenario run."""
+    values = {
+        "%s.cpu_load_pct" % name: metrics["cpu_load_pct"],
+        "%s.heap_peak" % name: metrics["heap"]["peak"],
+    }
+    latency = metrics["button_latency_us"]
+    if latency and latency["count"]:
+        values["%s.button_latency_us.p99" % name] = latency["p99"]
+        values["%s.button_latency_us.max" % name] = latency["max"]
+    for seat, seat_metrics in (metrics["seats"] or {}).items():
+        if seat_metrics.get("energy_j") is not None:
+            values["%s.%s.energy_j" % (name, seat)] = seat_metrics["energy_j"]
+    if metrics.get("energy"):
+        values["%s.total_wh" % name] = metrics["energy"]["total_wh"]
+    return values
+
+
+def collect(binary, scripts, map_path, jobs):
+    values = {}
+    for name, metrics in run_suite(binary, scripts, [None], jobs).items():
+        values.update(scenario_metrics(name, metrics))
+    _, (flash, ram) = read_map(map_path)
+    values["image.flash"] = flash
+    values["image.ram"] = ram
+    return values
+
+
+def allowed(entry):
+    tolerance = entry.get("tolerance", {})
+    return max(tolerance.get("abs", 0), abs(entry["value"]) * tolerance.get("pct", 0) / 100.0)
+
+
+def compare(baseline, current):
+    """Rows of (metric, baseline, current, allowed, status), status one of
+    ok, better, WORSE, OVER MAX, MISSING, NO BASELINE."""
+    rows = []
+    for name in sorted(set(baseline) | set(current)):
+        entry = baseline.get(name)
+        value = current.get(name)
+        if entry is None:
+            rows.append((name, None, value, None, "NO BASELINE"))
+            continue
+        if value is None:
+            rows.append((name, entry["value"], None, allowed(entry), "MISSING"))
+            continue
+        limit = allowed(entry)
+        if "max" in entry and value > entry["max"]:
+            status = "OVER MAX"
+        elif value > entry["value"] + limit:
+            status = "WORSE"
+        elif value < entry["value"] - limit:
+            status = "better"
+        else:
+            status = "ok"
+        rows.append((name, entry["value"], value, limit, status))
+    return rows
+
+
+def number(value):
+    if value is None:
+        return "-"
+    return "%d" % value if float(value).is_integer() else "%.3f" % value
+
+
+def change(base, value):
+    if base is None or value is None:
+        return "-"
+    if base == 0:
+        return "%+g" % (value - base)
+    return "%+.1f%%" % (100.0 * (value - base) / abs(base))
+
+
+def update(path, baseline, current):
+    """Current values, the tolerances and limits of the old baseline kept."""
+    metrics = {}
+    for name, value in sorted(current.items()):
+        entry = dict(baseline.get(name, {}))
+        entry["value"] = value
+        entry.setdefault("tolerance", DEFAULT_TOLERANCES.get(name.rsplit(".", 1)[-1], {"pct": 5}))
+        metrics[name] = entry
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    with open(path, "w") as f:
+        json.dump({"revision": revision(), "metrics": metrics}, f, indent=2, sort_keys=True)
+        f.write("\n")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("scripts", nargs="*", help="scenario scripts, Scenarios/suite/*.txt by default")
+    parser.add_argument("-b", "--binary", default=os.path.join(HOST_DIR, "build", "seat_heater"),
+                        help="seat_heater executable")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE, help="baseline JSON file")
+    parser.add_argument("--map", default=DEFAULT_MAP,
+                        help="linker map of the board build, for the flash and RAM of the image")
+    parser.add_argument("--update", action="store_true", help="write the current numbers as the new baseline")
+    add_jobs_argument(parser)
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    scripts = args.scripts or sorted(glob.glob(os.path.join(HOST_DIR, "Scenarios", "suite", "*.txt")))
+    if not scripts:
+        sys.exit("no scenario scripts")
+
+    baseline = {}
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)["metrics"]
+    elif not args.update:
+        sys.exit("%s: no baseline, make one with --update" % args.baseline)
+
+    # The image is gated like every other metric, there is no running without it
+    if not os.path.isfile(args.map):
+        sys.exit("%s: no linker map, build the CCS project or give its map with --map" % args.map)
+
+    try:
+        current = collect(args.binary, scripts, args.map, args.jobs)
+    except RunError as error:
+        sys.exit(str(error))
+    if args.update:
+        update(args.baseline, baseline, current)
+        print("baseline of %d metrics written to %s" % (len(current), args.baseline))
+        return 0
+
+    rows = compare(baseline, current)
+    print("%-40s %12s %12s %9s %10s  %s" % ("metric", "baseline", "current", "change", "allowed", "status"))
+    for name, base, value, limit, status in rows:
+        print("%-40s %12s %12s %9s %10s  %s" % (name, number(base), number(value), change(base, value),
+                                                  "-" if limit is None else "+" + number(limit), status))
+
+    failed = [row for row in rows if row[4] in ("WORSE", "OVER MAX", "MISSING", "NO BASELINE")]
+    if not failed:
+        print("no regression against %s" % os.path.relpath(args.baseline))
+        return 0
+    print("\n%d metric(s) regressed:" % len(failed))
+    for name, base, value, limit, status in failed:
+        if status == "MISSING":
+            print("  %s: not measured any more (baseline %s)" % (name, number(base)))
+        elif status == "NO BASELINE":
+            print("  %s: %s has no baseline, take it with --update" % (name, number(value)))
+        elif status == "OVER MAX":
+            print("  %s: %s is over the limit of %s" % (name, number(value), number(baseline[name]["max"])))
+        else:
+            print("  %s: %s -> %s (%s, allowed +%s)" % (name, number(base), number(value), change(base, value),
+                                                      number(limit)))
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
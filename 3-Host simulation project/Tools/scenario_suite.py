@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Run the benchmark scenarios on the host build and collect their metrics.
+
+Every scenario script is run by seat_heater with -j, and the JSON metrics
+of all of them are written to one file, labelled with the firmware
+revision, with a summary table on stdout.  Two result files from two
+revisions compare field by field.  The runs go in parallel on every core
+(sim_runner.py); with several -r seeds every scenario is run once per seed
+and named <scenario>@<seed>.
+
+    scenario_suite.py                                  # Scenarios/suite/*.txt
+    scenario_suite.py -b build/seat_heater -o results.json Scenarios/suite/cold_start.txt
+    scenario_suite.py -r 1 -r 2 -r 3 -J 8
+"""
+
+import argparse
+import glob
+import json
+import os
+import subprocess
+import sys
+
+from sim_runner import RunError, add_jobs_argument, run_all, run_metrics
+
+HOST_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def revision():
+    """git describe of the tree, or "unknown" outside a work tree."""
+    try:
+        return subprocess.check_output(["git", "describe", "--always", "--dirty"], cwd=HOST_DIR,
+                                       stderr=subprocess.DEVNULL, text=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def run_scenario(binary, script, seed):
+    """Metrics of one scenario run, the UART output is dropped."""
+    command = [binary, "-s", script]
+    if seed is not None:
+        command += ["-r", str(seed)]
+    return run_metrics(command, script if seed is None else "%s with seed %d" % (script, seed))
+
+
+def run_suite(binary, scripts, seeds, jobs):
+    """{name: metrics} of every script with every seed, in the order of the scripts."""
+    runs = [(script, seed) for script in scripts for seed in seeds]
+    results = {}
+    for metrics in run_all(lambda run: run_scenario(binary, *run), runs, jobs):
+        name = metrics["scenario"] if len(seeds) == 1 else "%s@%d" % (metrics["scenario"], metrics["seed"])
+        results[name] = metrics
+    return results
+
+
+def number(value, fmt="%.1f"):
+    return "-" if value is None else fmt % value
+
+
+def print_summary(results):
+    print("%-16s %-10s %9s %11s %9s %8s %8s %7s %6s %8s" % ("scenario", "seat", "rise_s", "settling_s",
+                                                             "overshoot", "ripple", "btn_p99", "cpu_%", "queue",
+                                                             "wh"))
+    for name, metrics in results.items():
+        latency = metrics["button_latency_us"]
+        queues = metrics["queues"] or {}
+        peak = max([queue["peak"] for queue in queues.values()] or [0])
+        energy = metrics.get("energy") or {}
+        seats = metrics["seats"] or {"-": {}}
+        for seat, values in seats.items():
+            print("%-16s %-10s %9s %11s %9s %8s %8s %7.1f %6d %8s" % (
+                name, seat, number(values.get("rise_s")), number(values.get("settling_s")),
+                number(values.get("overshoot_c"), "%.2f"), number(values.get("ripple_c"), "%.2f"),
+                number(latency and latency["p99"], "%d"), metrics["cpu_load_pct"], peak,
+                number(energy.get(seat, {}).get("heater_wh"), "%.2f")))
+        # Heaters of every seat, on or not in the model, and the MCU
+        if energy:
+            print("%-16s %-10s %73s" % (name, "total", number(energy["total_wh"], "%.2f")))
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("scripts", nargs="*", help="scenario scripts, Scenarios/suite/*.txt by default")
+    parser.add_argument("-b", "--binary", default=os.path.join(HOST_DIR, "build", "seat_heater"),
+                        help="seat_heater executable")
+    parser.add_argument("-o", "--output", default="results.json", help="JSON file receiving the metrics")
+    parser.add_argument("-r", "--seed", type=int, action="append", dest="seeds",
+                        help="add the random stimulus drawn from this seed, once per seed when repeated")
+    add_jobs_argument(parser)
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    scripts = args.scripts or sorted(glob.glob(os.path.join(HOST_DIR, "Scenarios", "suite", "*.txt")))
+    if not scripts:
+        sys.exit("no scenario scripts")
+
+    try:
+        results = run_suite(args.binary, scripts, args.seeds or [None], args.jobs)
+    except RunError as error:
+        sys.exit(str(error))
+
+    with open(args.output, "w") as f:
+        json.dump({"revision": revision(), "scenarios": results}, f, indent=2)
+        f.write("\n")
+    print_summary(results)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""Turn the recorder frames of a UART0 capture into a sensor trace for replay.
+
+Send the 'r' console command to the board and capture UART0: once a second the
+board sends the ADC samples and button edges its handlers took as a "REC1"
+frame (Measurements/Recorder/recorder.h), between the text of the other
+commands. The frames are joined, their 32-bit DWT time stamps unwrapped, and
+the records written as a trace file replayed by `seat_heater -R` (format in
+Sim/sim_replay.h). The drains come once a second, far inside the 268 s wrap
+of the counter at 16 MHz. `--dump` prints a trace as text.
+
+    sensor_trace.py capture.bin -o session.rec
+    sensor_trace.py --dump session.rec
+"""
+
+import argparse
+import struct
+import sys
+
+FRAME_MAGIC = b"REC1"
+FRAME_HEADER = struct.Struct("<4sIIH")
+RECORD = struct.Struct("<IBBH")
+
+TRACE_MAGIC = b"SRT1"
+TRACE_HEADER = struct.Struct("<4sIQII")
+
+EVENT_ADC = 0x01
+EVENT_BUTTON = 0x02
+
+ADC_NAMES = {0: "driver", 1: "passenger"}
+# REC_PIN(port, pin) of the buttons handled in main.c
+BUTTON_NAMES = {0x54: "sw1", 0x50: "sw2", 0x44: "ext"}
+
+FULL_SCALE_DEG = 45
+ADC_MAX_CODE = 0x0FFF
+
+
+def parse_frames(data):
+    """(clock Hz, [(time stamp, event, id, arg)], records lost) of every frame in a capture."""
+    clock_hz = None
+    records = []
+    lost = 0
+    offset = data.find(FRAME_MAGIC)
+    while offset >= 0:
+        if offset + FRAME_HEADER.size > len(data):
+            break
+        _, frame_hz, frame_lost, count = FRAME_HEADER.unpack_from(data, offset)
+        end = offset + FRAME_HEADER.size + count * RECORD.size
+        if end > len(data):
+            print("capture ends inside a frame, %d records dropped" % count, file=sys.stderr)
+            break
+        if clock_hz is not None and frame_hz != clock_hz:
+            raise ValueError("frames of %d Hz and %d Hz in one capture" % (clock_hz, frame_hz))
+        clock_hz = frame_hz
+        lost += frame_lost
+        records.extend(RECORD.unpack_from(data, offset + FRAME_HEADER.size + index * RECORD.size)
+                       for index in range(count))
+        offset = data.find(FRAME_MAGIC, end)
+    if clock_hz is None:
+        raise ValueError("no %r frame found in input" % FRAME_MAGIC.decode())
+    return clock_hz, records, lost
+
+
+def write_trace(path, clock_hz, records, lost):
+    """Cycles from the first record to the last."""
+    first = records[0][0] if records else 0
+    previous = first
+    span = 0
+    with open(path, "wb") as f:
+        f.write(TRACE_HEADER.pack(TRACE_MAGIC, clock_hz, first, len(records), lost))
+        for stamp, event, ident, arg in records:
+            # The counter is 32 bits, the delta since the previous record unwraps it
+            delta = (stamp - previous) & 0xFFFFFFFF
+            f.write(RECORD.pack(delta, event, ident, arg))
+            span += delta
+            previous = stamp
+    return span
+
+
+def read_trace(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, clock_hz, time, count, lost = TRACE_HEADER.unpack_from(data, 0)
+    if magic != TRACE_MAGIC:
+        raise ValueError("%s: not a sensor trace" % path)
+    records = []
+    for index in range(count):
+        delta, event, ident, arg = RECORD.unpack_from(data, TRACE_HEADER.size + index * RECORD.size)
+        time += delta
+        records.append((time, event, ident, arg))
+    return clock_hz, records, lost
+
+
+def describe(event, ident, arg):
+    if event == EVENT_ADC:
+        return "adc    %-9s %4d  %.1f C" % (ADC_NAMES.get(ident, ident), arg, arg * FULL_SCALE_DEG / ADC_MAX_CODE)
+    if event == EVENT_BUTTON:
+        return "press  %s" % BUTTON_NAMES.get(ident, "P%c%d" % (ord("A") + (ident >> 4), ident & 0x0F))
+    return "event 0x%02X id %d arg %d" % (event, ident, arg)
+
+
+def dump(path):
+    clock_hz, records, lost = read_trace(path)
+    print("%d records at %d Hz, %d lost" % (len(records), clock_hz, lost))
+    for time, event, ident, arg in records:
+        print("%12.6f  %s" % (time / clock_hz, describe(event, ident, arg)))
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="UART0 capture, or a trace file with --dump")
+    parser.add_argument("-o", "--output", help="trace file to write")
+    parser.add_argument("--dump", action="store_true", help="print the records of a trace file")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    try:
+        if args.dump:
+            dump(args.input)
+            return 0
+        with open(args.input, "rb") as f:
+            clock_hz, records, lost = parse_frames(f.read())
+    except ValueError as error:
+        sys.exit(str(error))
+    if not args.output:
+        sys.exit("no output file, give -o")
+    span = write_trace(args.output, clock_hz, records, lost)
+    print("%d records over %.3f s written to %s" % (len(records), span / clock_hz, args.output))
+    if lost:
+        print("%d records were lost on the board, the replay will differ" % lost, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
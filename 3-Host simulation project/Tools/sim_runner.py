@@ -0,0 +1,96 @@
+"""Run independent host simulations in parallel and collect their JSON metrics.
+
+Every run is a seat_heater or seat_scaling process of its own: its simulated
+clock, RAM, kernel and peripherals are those of the process, and the only
+files it writes (UART output, metrics) go to a temporary directory of the
+run, so runs share nothing and any number of them can go at once. A host
+process uses one core at a time, the kernel threads of the port taking turns,
+so the runs scale with the cores until the memory bandwidth runs out.
+
+The worker threads only wait for their process; the results come back in the
+order of the runs, whatever order they finished in, so the tools print and
+merge them as they did one after another.
+"""
+
+import json
+import os
+import resource
+import subprocess
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+
+class RunError(Exception):
+    """A simulation could not be started, exited with an error or wrote no metrics."""
+
+
+def default_jobs():
+    """Cores this process may run on."""
+    try:
+        return len(os.sched_getaffinity(0))
+    except AttributeError:
+        return os.cpu_count() or 1
+
+
+def add_jobs_argument(parser):
+    parser.add_argument("-J", "--jobs", type=int, default=default_jobs(),
+                        help="simulations run at once, the cores of the machine by default (%(default)d)")
+
+
+def run_metrics(command, label, files=None):
+    """JSON metrics of one run of command, given -j and -o into a directory of its own.
+
+    files maps names to contents written in that directory first; a "{name}"
+    in the command is replaced by the path of the file. The UART output is
+    dropped.
+    """
+    with tempfile.TemporaryDirectory() as work:
+        paths = {}
+        for name, content in (files or {}).items():
+            paths[name] = os.path.join(work, name)
+            with open(paths[name], "w") as f:
+                f.write(content)
+        metrics = os.path.join(work, "metrics.json")
+        argv = [part.format(**paths) for part in command] + ["-o", os.devnull, "-j", metrics]
+        try:
+            result = subprocess.run(argv, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+        except OSError as error:
+            raise RunError("%s failed: cannot run %s: %s" % (label, argv[0], error.strerror or error))
+        if result.returncode != 0 or not os.path.exists(metrics):
+            raise RunError("%s failed:\n%s" % (label, result.stderr))
+        with open(metrics) as f:
+            return json.load(f)
+
+
+def children_cpu():
+    usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+    return usage.ru_utime + usage.ru_stime
+
+
+def run_all(function, items, jobs):
+    """[function(item) for item in items], up to jobs of them at once.
+
+    The first failure cancels the runs not started yet and is raised. The
+    wall time against the CPU time of the simulations goes to stderr: their
+    ratio is the number of cores kept busy, the speedup over one job.
+    """
+    items = list(items)
+    jobs = max(1, min(jobs, len(items) or 1))
+    start = time.monotonic()
+    cpu = children_cpu()
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        futures = [pool.submit(function, item) for item in items]
+        try:
+            results = [future.result() for future in futures]
+        except BaseException:
+            for future in futures:
+                future.cancel()
+            raise
+    wall = time.monotonic() - start
+    cpu = children_cpu() - cpu
+    if len(items) > 1:
+        print("%d runs on %d jobs in %.1f s, %.1f s of CPU, %.1f cores busy" % (
+            len(items), jobs, wall, cpu, cpu / wall if wall > 0 else 0.0), file=sys.stderr)
+    return results
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Suggest task stack sizes from the stack reports of the board.
+
+Send `k` to the console over UART0 and save the reply; several captures
+(e.g. from different test sessions) can be given, the worst use of each
+task is kept.  Every task gets its measured use plus a safety margin,
+rounded up to the stack alignment, and the saving against the sizes in
+main.c is printed.
+
+    stack_sizing.py capture1.txt capture2.txt
+    stack_sizing.py capture.txt --apply        # rewrite the xTaskCreate() sizes in main.c
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+DEFAULT_MAIN = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                            "..", "..", "1-Application project", "FreeRTOS_Proj1", "main.c")
+
+STACK_LINE = re.compile(r"STACK (\d+),(\d+),(\d+),(.*?)\r?$")
+TASK_CREATE = re.compile(r'xTaskCreate\(\s*(\w+)\s*,\s*"([^"]*)"\s*,\s*(\d+)\s*,')
+
+# Names are cut to configMAX_TASK_NAME_LEN - 1 characters by the kernel
+TASK_NAME_LEN = 15
+
+# Words of one 64-bit aligned stack slot pair
+STACK_ALIGN_WORDS = 2
+
+
+def read_reports(paths):
+    used = {}
+    for path in paths:
+        with open(path, "r", errors="replace") as f:
+            for line in f:
+                match = STACK_LINE.search(line)
+                if match:
+                    name = match.group(4)
+                    used[name] = max(used.get(name, 0), int(match.group(2)))
+    return used
+
+
+def read_task_creates(main_path):
+    with open(main_path, "r", newline="") as f:
+        source = f.read()
+    tasks = []
+    for match in TASK_CREATE.finditer(source):
+        if source.rfind("//", source.rfind("\n", 0, match.start()), match.start()) >= 0:
+            continue  # Commented out task
+        tasks.append((match.group(1), match.group(2), int(match.group(3)), match.start(3), match.end(3)))
+    return source, tasks
+
+
+def suggest(used_words, margin_percent, margin_words, minimum_words):
+    words = used_words * (100 + margin_percent) / 100.0 + margin_words
+    words = int(math.ceil(words / STACK_ALIGN_WORDS)) * STACK_ALIGN_WORDS
+    return max(words, minimum_words)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("captures", nargs="+", help="UART captures holding STACK lines")
+    parser.add_argument("--main", default=DEFAULT_MAIN, help="main.c with the xTaskCreate() calls")
+    parser.add_argument("--margin-percent", type=int, default=25,
+                        help="margin over the measured use for paths not hit while measuring (default 25)")
+    parser.add_argument("--margin-words", type=int, default=26,
+                        help="fixed margin, default is one exception frame with the FPU context (26 words)")
+    parser.add_argument("--minimum", type=int, default=48, help="smallest suggested size in words (default 48)")
+    parser.add_argument("--apply", action="store_true", help="write the suggested sizes into main.c")
+    args = parser.parse_args()
+
+    used = read_reports(args.captures)
+    if not used:
+        sys.exit("no STACK lines found in the captures")
+    source, tasks = read_task_creates(args.main)
+
+    print("%-34s %8s %8s %9s %7s" % ("task", "current", "used", "suggested", "saved"))
+    total_saved = 0
+    edits = []
+    for function, name, current, start, end in tasks:
+        measured = used.get(name[:TASK_NAME_LEN])
+        if measured is None:
+            print("%-34s %8d %8s %9s %7s" % (name[:34], current, "-", "-", "-"))
+            continue
+        suggested = suggest(measured, args.margin_percent, args.margin_words, args.minimum)
+        total_saved += current - suggested
+        edits.append((start, end, suggested))
+        flag = "  ** used over current" if measured >= current else ""
+        print("%-34s %8d %8d %9d %7d%s" % (name[:34], current, measured, suggested, current - suggested, flag))
+
+    # Kernel tasks are sized in FreeRTOSConfig.h, report them only
+    known = set(name[:TASK_NAME_LEN] for _, name, _, _, _ in tasks)
+    for name in sorted(set(used) - known):
+        print("%-34s %8s %8d %9d %7s" % (name, "config", used[name],
+                                         suggest(used[name], args.margin_percent, args.margin_words, args.minimum), "-"))
+
+    print("total saved: %d words (%d bytes)" % (total_saved, total_saved * 4))
+
+    if args.apply:
+        for start, end, suggested in sorted(edits, reverse=True):
+            source = source[:start] + str(suggested) + source[end:]
+        with open(args.main, "w", newline="") as f:
+            f.write(source)
+        print("updated %s" % args.main)
+
+
+if __name__ == "__main__":
+    main()
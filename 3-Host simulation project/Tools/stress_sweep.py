@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Find the interrupt storm rate at which the control loop stops meeting its period.
+
+A storm script is run on the host build for every rate, from no storm up:
+SW1 bouncing (every bounce is a press and a release, two edges and one
+GPIOPortF_Handler entry) or a sensor swinging in and out of its valid range.
+The deadline overruns and worst lateness of the control loops, the starved
+periodic loops and the event group and queue saturation counters of each run
+are printed. The breaking rate is the lowest one where a control loop ended a
+whole period later than without the storm, or where a periodic loop starved.
+
+The control loops are the intensity tasks: the heater tasks are paced by the
+intensity queue they share with the display task, not by their own period,
+and overrun without any storm. The sensors are read every 500 ms, so an
+oscillation at a whole multiple of 2 Hz is always sampled on the same level;
+the default oscillation rates are chosen off those.
+
+    stress_sweep.py                                        # SW1 bounce, 10 Hz to 10 kHz
+    stress_sweep.py --storm oscillate --rates 0.3,1.3,17.3
+    stress_sweep.py -b build/seat_heater --seconds 60 -o sweep.json
+
+The rates are run in parallel (sim_runner.py, -J) and judged in order.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+from sim_runner import RunError, add_jobs_argument, run_all, run_metrics
+
+HOST_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# The driver seat on MEDIUM under the thermal model, the passenger seat at a fixed reading
+BASE_SCRIPT = """\
+0       thermal driver ambient 15
+0       thermal driver initial 15
+0       thermal driver on
+0       temp passenger 20
+1s      press sw1
+1500ms  press sw1
+"""
+
+STORM_START_S = 5
+
+DEFAULT_RATES = {
+    "bounce": "10,30,100,300,1000,3000,10000",
+    "oscillate": "0.3,0.7,1.3,3.7,13.3,101.3",
+}
+
+
+def storm_line(storm, rate, seconds):
+    if storm == "bounce":
+        return "%ds bounce sw1 %g %ds\n" % (STORM_START_S, rate, seconds)
+    return "%ds oscillate driver 2 44 %g %ds\n" % (STORM_START_S, rate, seconds)
+
+
+def run_rate(binary, storm, rate, seconds):
+    """Metrics of one run, rate 0 is the run without a storm."""
+    script = BASE_SCRIPT
+    if rate > 0:
+        script += storm_line(storm, rate, seconds)
+    script += "%ds end\n" % (STORM_START_S + seconds + 5)
+    return run_metrics([binary, "-s", "{script}"], "%s at %g Hz" % (storm, rate), {"script": script})
+
+
+def summarize(metrics, patterns):
+    loops = metrics["loops"]
+    control = {name: loop for name, loop in loops.items() if any(p in name for p in patterns)}
+    events = metrics["events"] or {}
+    queues = metrics["queues"] or {}
+    return {
+        "control_period_ms": min([loop["period_ms"] for loop in control.values()] or [0]),
+        "control_overruns": sum(loop["overruns"] for loop in control.values()),
+        "control_max_late_us": max([loop["max_late_us"] for loop in control.values()] or [0]),
+        "starved": sorted(name for name, loop in loops.items() if loop["starved"]),
+        "queue_full": sum(queue["full"] for queue in queues.values()),
+        "send_full": events.get("send_full", 0),
+        "group_coalesced": events.get("group_coalesced", 0),
+        "pend_failed": events.get("pend_failed", 0),
+        "cpu_load_pct": metrics["cpu_load_pct"],
+    }
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-b", "--binary", default=os.path.join(HOST_DIR, "build", "seat_heater"),
+                        help="seat_heater executable")
+    parser.add_argument("--storm", choices=("bounce", "oscillate"), default="bounce")
+    parser.add_argument("--rates", help="storm rates in Hz, by default %s for bounce and %s for oscillate"
+                        % (DEFAULT_RATES["bounce"], DEFAULT_RATES["oscillate"]))
+    parser.add_argument("--seconds", type=int, default=20, help="storm duration in simulated seconds")
+    parser.add_argument("--loops", default="Inten",
+                        help="name parts of the control loops (task names are cut to 15 characters)")
+    parser.add_argument("-o", "--output", help="JSON file receiving the summary of every rate")
+    add_jobs_argument(parser)
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    patterns = args.loops.split(",")
+    rates = [0.0] + [float(rate) for rate in (args.rates or DEFAULT_RATES[args.storm]).split(",")]
+
+    print("%8s %9s %12s %6s %9s %9s %9s %7s  %s" % ("rate_hz", "overruns", "max_late_us", "q_full",
+                                                   "send_full", "coalesced", "pend_fail", "cpu_%", "starved"))
+    try:
+        runs = run_all(lambda rate: run_rate(args.binary, args.storm, rate, args.seconds), rates, args.jobs)
+    except RunError as error:
+        sys.exit(str(error))
+    results = []
+    breaking = None
+    for rate, metrics in zip(rates, runs):
+        summary = summarize(metrics, patterns)
+        summary["rate_hz"] = rate
+        results.append(summary)
+        print("%8g %9d %12d %6d %9d %9d %9d %7.1f  %s" % (
+            rate, summary["control_overruns"], summary["control_max_late_us"], summary["queue_full"],
+            summary["send_full"], summary["group_coalesced"], summary["pend_failed"], summary["cpu_load_pct"],
+            ", ".join(summary["starved"]) or "-"))
+        if breaking is None and rate > 0 and (summary["starved"] or summary["control_max_late_us"] >
+                                              results[0]["control_max_late_us"] + summary["control_period_ms"] * 1000):
+            breaking = rate
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump({"storm": args.storm, "seconds": args.seconds, "breaking_rate_hz": breaking,
+                       "rates": results}, f, indent=2)
+            f.write("\n")
+    if breaking is None:
+        print("the control loops kept their period at every rate")
+    else:
+        print("the control loops first missed their period at %g Hz" % breaking)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
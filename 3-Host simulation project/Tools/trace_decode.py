@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Decode a seat heater trace frame into a Chrome / Perfetto JSON trace.
+
+The input is either the file written by trace_demo or a raw UART0 capture
+taken after sending the 't' console command; any text around the frame is
+skipped.  The output loads in chrome://tracing or https://ui.perfetto.dev.
+
+    trace_decode.py capture.bin -o trace.json
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+FRAME_MAGIC = b"TRC1"
+HEADER = struct.Struct("<4sIIHH")
+EVENT = struct.Struct("<IBBH")
+
+EVENT_TASK_SWITCH = 0x01
+EVENT_ISR_ENTER = 0x02
+EVENT_ISR_EXIT = 0x03
+EVENT_QUEUE_SEND = 0x04
+EVENT_QUEUE_RECEIVE = 0x05
+EVENT_QUEUE_SEND_FROM_ISR = 0x06
+EVENT_QUEUE_RECEIVE_FROM_ISR = 0x07
+
+QUEUE_EVENT_NAMES = {
+    EVENT_QUEUE_SEND: "send",
+    EVENT_QUEUE_RECEIVE: "receive",
+    EVENT_QUEUE_SEND_FROM_ISR: "send from ISR",
+    EVENT_QUEUE_RECEIVE_FROM_ISR: "receive from ISR",
+}
+
+# NVIC interrupt numbers recorded by the handlers in main.c
+ISR_NAMES = {
+    4: "GPIOPortE_Handler",
+    5: "UART0_Handler",
+    14: "ADC0_Handler",
+    30: "GPIOPortF_Handler",
+    48: "ADC1_Handler",
+}
+
+# Queue numbers given with vQueueSetQueueNumber() in main.c
+QUEUE_NAMES = {
+    0: "xDriverMutex",
+    1: "xPassengerMutex",
+    2: "xDriverTempSemphr",
+    3: "xPassengerTempSemphr",
+    4: "xDriverErrorSemaphore",
+    5: "xPassengerErrorSemaphore",
+    6: "xDriverIntensityQueue",
+    7: "xPassengerIntensityQueue",
+    8: "xDriverDiagnosticsQueue",
+    9: "xPassengerDiagnosticsQueue",
+    10: "xUart0Mutex",
+}
+
+QUEUE_TYPE_BASE = 0
+
+PID = 1
+TID_TASKS = 1
+TID_ISRS = 2
+TID_QUEUES = 3
+
+
+def queue_name(number, queue_type):
+    # Kernel owned queues (the timer command queue) keep queue number 0
+    if number == 0 and queue_type == QUEUE_TYPE_BASE:
+        return "Timer queue"
+    return QUEUE_NAMES.get(number, "queue %d" % number)
+
+
+def parse_frame(data):
+    start = data.find(FRAME_MAGIC)
+    if start < 0:
+        raise ValueError("no %r frame found in input" % FRAME_MAGIC.decode())
+    offset = start
+    _, clock_hz, lost, names_count, events_count = HEADER.unpack_from(data, offset)
+    offset += HEADER.size
+
+    names = {}
+    for _ in range(names_count):
+        number, length = data[offset], data[offset + 1]
+        names[number] = data[offset + 2:offset + 2 + length].decode("ascii", "replace")
+        offset += 2 + length
+
+    events = []
+    for _ in range(events_count):
+        if offset + EVENT.size > len(data):
+            raise ValueError("frame truncated after %d of %d events" % (len(events), events_count))
+        events.append(EVENT.unpack_from(data, offset))
+        offset += EVENT.size
+    return clock_hz, lost, names, events
+
+
+def unwrap(events):
+    """Turn the 32-bit cycle stamps into a monotonic 64-bit count."""
+    previous = None
+    base = 0
+    for stamp, event, ident, arg in events:
+        if previous is not None and stamp < previous:
+            base += 1 << 32
+        previous = stamp
+        yield base + stamp, event, ident, arg
+
+
+def to_chrome(clock_hz, lost, names, events):
+    def us(cycles):
+        return cycles * 1e6 / clock_hz
+
+    def task_name(number):
+        return names.get(number, "task %d" % number)
+
+    out = [
+        {"name": "process_name", "ph": "M", "pid": PID, "args": {"name": "TM4C123GH6PM seat heater"}},
+        {"name": "thread_name", "ph": "M", "pid": PID, "tid": TID_TASKS, "args": {"name": "Tasks"}},
+        {"name": "thread_name", "ph": "M", "pid": PID, "tid": TID_ISRS, "args": {"name": "Interrupts"}},
+        {"name": "thread_name", "ph": "M", "pid": PID, "tid": TID_QUEUES, "args": {"name": "Queues"}},
+    ]
+    running = None
+    first = None
+    last = 0
+    open_isrs = []
+
+    for cycles, event, ident, arg in unwrap(events):
+        if first is None:
+            first = cycles
+        cycles -= first
+        last = cycles
+        if event == EVENT_TASK_SWITCH:
+            if running is not None and running[0] == ident:
+                continue  # Switched back to the task that was already running
+            if running is not None:
+                out.append({"name": task_name(running[0]), "ph": "X", "pid": PID, "tid": TID_TASKS,
+                            "ts": us(running[1]), "dur": us(cycles - running[1])})
+            running = (ident, cycles)
+        elif event == EVENT_ISR_ENTER:
+            open_isrs.append(ident)
+            out.append({"name": ISR_NAMES.get(ident, "IRQ %d" % ident), "ph": "B", "pid": PID,
+                        "tid": TID_ISRS, "ts": us(cycles)})
+        elif event == EVENT_ISR_EXIT:
+            # An exit whose enter was overwritten in the ring has nothing to close
+            if ident in open_isrs:
+                open_isrs.remove(ident)
+                out.append({"name": ISR_NAMES.get(ident, "IRQ %d" % ident), "ph": "E", "pid": PID,
+                            "tid": TID_ISRS, "ts": us(cycles)})
+        elif event in QUEUE_EVENT_NAMES:
+            queue_type, waiting = arg >> 8, arg & 0xFF
+            name = queue_name(ident, queue_type)
+            out.append({"name": "%s %s" % (QUEUE_EVENT_NAMES[event], name), "ph": "i", "s": "t",
+                        "pid": PID, "tid": TID_QUEUES, "ts": us(cycles),
+                        "args": {"queue": name, "type": queue_type, "messages_waiting": waiting}})
+        else:
+            out.append({"name": "unknown event 0x%02x" % event, "ph": "i", "s": "t", "pid": PID,
+                        "tid": TID_QUEUES, "ts": us(cycles), "args": {"id": ident, "arg": arg}})
+
+    if running is not None:
+        out.append({"name": task_name(running[0]), "ph": "X", "pid": PID, "tid": TID_TASKS,
+                    "ts": us(running[1]), "dur": us(last - running[1])})
+    for ident in open_isrs:
+        out.append({"name": ISR_NAMES.get(ident, "IRQ %d" % ident), "ph": "E", "pid": PID,
+                    "tid": TID_ISRS, "ts": us(last)})
+
+    return {"traceEvents": out, "displayTimeUnit": "ns",
+            "otherData": {"clock_hz": clock_hz, "events": len(events), "lost_events": lost}}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="binary trace frame or raw UART capture")
+    parser.add_argument("-o", "--output", default="-", help="JSON output file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        clock_hz, lost, names, events = parse_frame(f.read())
+    trace = to_chrome(clock_hz, lost, names, events)
+
+    if args.output == "-":
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    print("%d events decoded, %d lost before the drain" % (len(events), lost), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Compare the image size of builds made at different trace levels.
+
+Build the CCS project once per TRACE_CATEGORIES value (Project Properties >
+Build > ARM Compiler > Predefined Symbols, e.g. TRACE_CATEGORIES=0x10) and
+keep the linker map of each one.  The module summary of every map is read
+and the flash (code + ro data) and RAM (rw data) of each object is printed
+side by side, with the change against the first map.
+
+    trace_levels.py full=Full.map counters=Counters.map off=Off.map
+    trace_levels.py Debug/FreeRTOS_Proj1.map --all     # every module, not only the changed ones
+"""
+
+import argparse
+import os
+import re
+import sys
+
+SUMMARY_START = "MODULE SUMMARY"
+MODULE_LINE = re.compile(r"^\s+(\S+\.obj)\s+(\d+)\s+(\d+)\s+(\d+)\s*$")
+TOTAL_LINE = re.compile(r"^\s+Grand Total:\s+(\d+)\s+(\d+)\s+(\d+)\s*$")
+LIBRARY_LINE = re.compile(r"^\s+\S.*\.lib\s*$")
+
+
+def read_map(path):
+    """Return {module: (flash, ram)} and the grand (flash, ram) of one map."""
+    modules = {}
+    total = None
+    in_summary = False
+    library = False
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            if SUMMARY_START in line:
+                in_summary = True
+                continue
+            if not in_summary:
+                continue
+            match = TOTAL_LINE.match(line)
+            if match:
+                code, ro, rw = (int(v) for v in match.groups())
+                total = (code + ro, rw)
+                break
+            if LIBRARY_LINE.match(line):
+                library = True
+                continue
+            if line.strip().endswith("\\"):
+                library = False
+                continue
+            match = MODULE_LINE.match(line)
+            if match:
+                name = match.group(1)
+                code, ro, rw = (int(v) for v in match.groups()[1:])
+                # The run time library objects are summed under one name
+                key = "(runtime library)" if library else name
+                flash, ram = modules.get(key, (0, 0))
+                modules[key] = (flash + code + ro, ram + rw)
+    if total is None:
+        sys.exit("%s: no module summary found" % path)
+    return modules, total
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("maps", nargs="+", help="[label=]linker map, the first one is the reference")
+    parser.add_argument("--all", action="store_true", help="list the modules that did not change too")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    builds = []
+    for arg in args.maps:
+        label, sep, path = arg.partition("=")
+        if not sep:
+            label, path = os.path.splitext(os.path.basename(arg))[0], arg
+        builds.append((label,) + read_map(path))
+
+    names = sorted(set().union(*(modules for _, modules, _ in builds)))
+    reference = builds[0][1]
+
+    header = "%-30s" % "module"
+    for label, _, _ in builds:
+        header += " %15s" % (label + " flash/ram")
+    print(header)
+
+    for name in names:
+        sizes = [modules.get(name, (0, 0)) for _, modules, _ in builds]
+        if not args.all and all(size == sizes[0] for size in sizes):
+            continue
+        row = "%-30s" % name
+        for index, (flash, ram) in enumerate(sizes):
+            if index == 0:
+                row += " %15s" % ("%d/%d" % (flash, ram))
+            else:
+                base = reference.get(name, (0, 0))
+                row += " %15s" % ("%+d/%+d" % (flash - base[0], ram - base[1]))
+        print(row)
+
+    row = "%-30s" % "TOTAL"
+    for index, (_, _, (flash, ram)) in enumerate(builds):
+        if index == 0:
+            row += " %15s" % ("%d/%d" % (flash, ram))
+        else:
+            base = builds[0][2]
+            row += " %15s" % ("%+d/%+d" % (flash - base[0], ram - base[1]))
+    print(row)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())